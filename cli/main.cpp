@@ -0,0 +1,142 @@
+// mdn_cli - runs MDN scripts without a gui
+//
+//  mdn_cli [options] script...
+//
+//  Each script is run in turn, in one workspace, so later scripts see numbers made by earlier
+//  ones.  A script of '-' is read from standard input.  See ScriptEngine::help() for statements.
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mdn/ScriptEngine.hpp>
+#include <mdn/ThreadPool.hpp>
+
+#include "mdn_config.h"
+
+using namespace mdn;
+
+namespace {
+
+void printUsage(std::ostream& os) {
+    os << "Usage: mdn_cli [options] script...\n"
+       << "Runs MDN scripts, '-' reads a script from standard input.\n\n"
+       << "Options:\n"
+       << "  -s, --serial   run one statement at a time\n"
+       << "  -q, --quiet    do not print statement timing\n"
+       << "  -h, --help     show this message and the statement list\n\n"
+       << ScriptEngine::help();
+}
+
+
+// Prints a statement's result, with its timing unless quiet
+void printResult(const ScriptResult& result, bool quiet) {
+    std::ostream& os = result.ok ? std::cout : std::cerr;
+    if (!quiet || !result.ok) {
+        os << "[" << std::setw(4) << result.line << "] " << std::left << std::setw(40)
+            << result.text << std::right;
+        if (result.ok) {
+            os << std::fixed << std::setprecision(3) << std::setw(12)
+                << result.seconds*1000.0 << " ms  wave " << result.wave;
+        } else {
+            os << "  FAILED";
+        }
+        os << '\n';
+    }
+    if (!result.output.empty()) {
+        os << result.output;
+        if (result.output.back() != '\n') {
+            os << '\n';
+        }
+    }
+}
+
+} // end anonymous namespace
+
+
+int main(int argc, char** argv) {
+    bool parallel = true;
+    bool quiet = false;
+    std::vector<std::string> scripts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "-s" || arg == "--serial") {
+            parallel = false;
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(std::cout);
+            return 0;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Unknown option '" << arg << "'\n\n";
+            printUsage(std::cerr);
+            return 2;
+        } else {
+            scripts.push_back(arg);
+        }
+    }
+    if (scripts.empty()) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    if (!quiet) {
+        std::cout << "mdn_cli " << MDN_VERSION_STRING << ", "
+            << (parallel ? ThreadPool::shared().size() : 0) << " worker threads\n";
+    }
+
+    ScriptEngine engine;
+    int nStatements = 0;
+    double busySeconds = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const std::string& path : scripts) {
+        std::ostringstream text;
+        if (path == "-") {
+            text << std::cin.rdbuf();
+        } else {
+            std::ifstream ifs(path);
+            if (!ifs.is_open()) {
+                std::cerr << "Cannot open script '" << path << "'\n";
+                return 2;
+            }
+            text << ifs.rdbuf();
+        }
+
+        std::vector<ScriptStatement> statements;
+        try {
+            statements = ScriptEngine::parse(text.str());
+        } catch (const std::exception& e) {
+            std::cerr << path << ": " << e.what() << '\n';
+            return 2;
+        }
+
+        bool ok = true;
+        engine.run(
+            statements,
+            parallel,
+            [&](const ScriptResult& result) {
+                printResult(result, quiet);
+                ok = ok && result.ok;
+                busySeconds += result.seconds;
+                ++nStatements;
+            }
+        );
+        if (!ok) {
+            std::cerr << path << ": stopped after a failed statement\n";
+            return 1;
+        }
+    }
+
+    if (!quiet) {
+        const double wall = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+        std::cout << nStatements << " statements, " << std::fixed << std::setprecision(3)
+            << wall << " s elapsed, " << busySeconds << " s in statements\n";
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "Autosave.hpp"
+
+#include <memory>
+#include <sstream>
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <mdn/Logger.hpp>
+
+#include "Project.hpp"
+
+
+mdn::gui::Autosave::Watcher::Watcher(Mdn2d* ref, ChangeLog& log, std::string name):
+    MdnObserver(ref),
+    m_log(log),
+    m_name(std::move(name))
+{}
+
+
+void mdn::gui::Autosave::Watcher::digitsChanged(const DigitJournal::Writes& writes) {
+    m_log.append(m_name, writes);
+}
+
+
+std::string mdn::gui::Autosave::basePath(const Project& project) {
+    if (!project.path().empty()) {
+        return project.path() + "/" + project.name() + ".mdnproj";
+    }
+    QDir dir(unsavedFolder());
+    dir.mkpath(".");
+    return dir.filePath(QString::fromStdString(project.name())).toStdString();
+}
+
+
+QString mdn::gui::Autosave::unsavedFolder() {
+    return
+        QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+        + QStringLiteral("/autosave");
+}
+
+
+QStringList mdn::gui::Autosave::orphans() {
+    QStringList result;
+    QDir dir(unsavedFolder());
+    const QString ext = QString::fromStdString(ChangeLog::static_snapshotPath(""));
+    for (const QString& file : dir.entryList(QStringList("*" + ext), QDir::Files)) {
+        result.append(dir.filePath(file.left(file.size() - ext.size())));
+    }
+    Log_Debug2("Found " << result.size() << " orphaned autosaves");
+    return result;
+}
+
+
+std::unique_ptr<mdn::gui::Project> mdn::gui::Autosave::recover(
+    MainWindow* parent, const std::string& basePath
+) {
+    Log_Debug2_H("basePath=" << basePath);
+    std::string snapshot;
+    if (!ChangeLog::static_readSnapshot(basePath, snapshot)) {
+        Log_Debug2_T("No snapshot");
+        return nullptr;
+    }
+    std::istringstream in(snapshot, std::ios::binary);
+    std::unique_ptr<Project> proj = Project::loadBinary(parent, in);
+    if (!proj) {
+        Log_Debug2_T("Snapshot did not load");
+        return nullptr;
+    }
+    Project& project = *proj;
+    int n = ChangeLog::static_replay(
+        basePath,
+        [&project](const std::string& name, const ChangeLog::Writes& writes) {
+            Mdn2d* mdn = project.getMdn(name);
+            if (!mdn) {
+                Log_Warn("Autosave record for unknown number '" << name << "', skipped");
+                return;
+            }
+            for (const auto& [xy, digit] : writes) {
+                mdn->setValue(xy, digit);
+            }
+        }
+    );
+    Log_Debug2_T("Replayed " << n << " operations");
+    return proj;
+}
+
+
+void mdn::gui::Autosave::discard(const std::string& basePath) {
+    Log_Debug2("basePath=" << basePath);
+    QFile::remove(QString::fromStdString(ChangeLog::static_snapshotPath(basePath)));
+    QFile::remove(QString::fromStdString(ChangeLog::static_logPath(basePath)));
+}
+
+
+mdn::gui::Autosave::Autosave(Project* project, QObject* parent):
+    QObject(parent),
+    m_project(project),
+    m_log(new ChangeLog(basePath(*project)))
+{
+    Log_Debug2_H("basePath=" << m_log->basePath());
+    connect(m_project, &Project::tabsAboutToChange, this, &Autosave::onTabsAboutToChange);
+    connect(m_project, &Project::tabsChanged, this, &Autosave::onTabsChanged);
+    connect(m_project, &Project::bulkFinished, this, &Autosave::onBulkFinished);
+    connect(&m_timer, &QTimer::timeout, this, &Autosave::onTimer);
+    compact();
+    attach();
+    m_timer.start(checkIntervalMs);
+    Log_Debug2_T("");
+}
+
+
+mdn::gui::Autosave::~Autosave() {
+    Log_Debug2_H("");
+    m_timer.stop();
+    detach();
+    m_log->discard();
+    Log_Debug2_T("");
+}
+
+
+void mdn::gui::Autosave::compact() {
+    Log_Debug3_H("");
+    if (m_project->bulkBusy()) {
+        m_compactPending = true;
+        Log_Debug3_T("Deferred, bulk job running");
+        return;
+    }
+    m_compactPending = false;
+    // Only the copies are taken here, the log's worker encodes and writes them
+    auto snapshot = std::make_shared<const Project::Snapshot>(m_project->snapshot());
+    m_log->compact([snapshot]() {
+        std::ostringstream out(std::ios::binary);
+        Project::saveBinary(*snapshot, out);
+        return out.str();
+    });
+    m_sinceCompact.restart();
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::Autosave::onTabsAboutToChange() {
+    detach();
+}
+
+
+void mdn::gui::Autosave::onTabsChanged() {
+    // Tabs added, removed or renamed - a fresh snapshot keeps the log's names valid
+    detach();
+    compact();
+    attach();
+}
+
+
+void mdn::gui::Autosave::onTimer() {
+    const std::size_t bytes = m_log->logBytes();
+    if (
+        bytes >= compactLogBytes
+        || (bytes > 0 && m_sinceCompact.elapsed() >= compactIntervalMs)
+    ) {
+        Log_Debug3("Compacting log of " << bytes << " bytes");
+        compact();
+    }
+}
+
+
+void mdn::gui::Autosave::onBulkFinished() {
+    if (m_compactPending) {
+        compact();
+    }
+}
+
+
+void mdn::gui::Autosave::attach() {
+    for (const std::string& name : m_project->toc()) {
+        Mdn2d* mdn = m_project->getMdn(name);
+        if (!mdn) {
+            continue;
+        }
+        m_watchers.emplace_back(new Watcher(mdn, *m_log, name));
+        mdn->registerObserver(m_watchers.back().get());
+    }
+    Log_Debug3("Watching " << m_watchers.size() << " numbers");
+}
+
+
+void mdn::gui::Autosave::detach() {
+    for (std::unique_ptr<Watcher>& watcher : m_watchers) {
+        // Numbers that have since been destroyed said farewell, leaving get() null
+        if (Mdn2d* mdn = watcher->get()) {
+            mdn->unregisterObserver(watcher.get());
+        }
+    }
+    m_watchers.clear();
+}
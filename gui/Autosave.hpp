@@ -0,0 +1,116 @@
+#pragma once
+
+// Autosave
+//  Keeps a crash-recovery copy of the open project, using a ChangeLog beside the project file
+//  (<folder>/<name>.mdnproj.autosave and .wal), or in the application data folder until the
+//  project is first saved.  Every completed operation on a number is appended to the log by a
+//  worker thread, and the log is compacted into a full MDNPRJ snapshot periodically, and whenever
+//  the tabs or config change.  Destroying the Autosave is a clean shutdown and removes the files,
+//  so files found later were left by an abnormal exit, see recover and orphans.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include <mdn/ChangeLog.hpp>
+#include <mdn/MdnObserver.hpp>
+
+namespace mdn {
+namespace gui {
+
+class MainWindow;
+class Project;
+
+class Autosave : public QObject {
+    Q_OBJECT
+
+    // Forwards one number's completed operations to the log, under the number's tab name
+    class Watcher : public MdnObserver {
+        ChangeLog& m_log;
+        std::string m_name;
+
+    public:
+        Watcher(Mdn2d* ref, ChangeLog& log, std::string name);
+        void digitsChanged(const DigitJournal::Writes& writes) override;
+    };
+
+    Project* m_project;
+
+    std::unique_ptr<ChangeLog> m_log;
+
+    // One per number in m_project, rebuilt when the tabs change
+    std::vector<std::unique_ptr<Watcher>> m_watchers;
+
+    // Checks whether the log is due for compacting
+    QTimer m_timer;
+
+    // Time since the last snapshot
+    QElapsedTimer m_sinceCompact;
+
+    // A snapshot was asked for while a bulk job changed the tabs, taken when it finishes
+    bool m_compactPending = false;
+
+
+public:
+
+    // How often the log size is checked
+    static constexpr int checkIntervalMs = 10000;
+
+    // A non-empty log is compacted once this old
+    static constexpr int compactIntervalMs = 120000;
+
+    // A log is compacted as soon as it reaches this size
+    static constexpr std::size_t compactLogBytes = std::size_t(16) << 20;
+
+    // Base path of the autosave files for project
+    static std::string basePath(const Project& project);
+
+    // Folder holding autosaves of projects never saved
+    static QString unsavedFolder();
+
+    // Base paths of autosaves left in unsavedFolder by an abnormal exit
+    static QStringList orphans();
+
+    // Rebuilds a project from the autosave at basePath: loads the snapshot, then replays the log.
+    //  Returns null if there is no usable snapshot.
+    static std::unique_ptr<Project> recover(MainWindow* parent, const std::string& basePath);
+
+    // Removes the autosave files at basePath
+    static void discard(const std::string& basePath);
+
+
+    // Starts autosaving project, writing the first snapshot straight away
+    Autosave(Project* project, QObject* parent=nullptr);
+
+    // Clean shutdown, removes the autosave files
+    ~Autosave() override;
+
+    // Snapshot the project now, emptying the log.  The numbers are copied here and encoded by
+    //  the log's worker.  While a bulk job changes the tabs the snapshot waits for it to finish.
+    void compact();
+
+
+private slots:
+    void onTabsAboutToChange();
+    void onTabsChanged();
+    void onTimer();
+    void onBulkFinished();
+
+
+private:
+
+    // Registers a Watcher on every number in the project
+    void attach();
+
+    // Unregisters all Watchers
+    void detach();
+
+};
+
+} // end namespace gui
+} // end namespace mdn
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include <QChar>
 #include <QColor>
 #include <QTabBar>
@@ -42,6 +45,23 @@ public:
         return s;
     }
 
+    // Heatmap shade for a block of digits: white when empty, shading towards blue for positive
+    //  digits and red for negative ones as the block fills up.  density is the fraction of
+    //  non-zero digits, balance their mean sign, -1 to 1.
+    static QRgb heatmapColour(float density, float balance) {
+        if (density <= 0.0f) {
+            return qRgb(255, 255, 255);
+        }
+        // sqrt and a floor, so sparse blocks still show up
+        const float a = std::max(0.25f, std::sqrt(std::min(density, 1.0f)));
+        const float p = (std::clamp(balance, -1.0f, 1.0f) + 1.0f)/2.0f;
+        auto channel = [a, p](int neg, int pos) {
+            const float c = neg + p*(pos - neg);
+            return static_cast<int>(255.0f + a*(c - 255.0f) + 0.5f);
+        };
+        return qRgb(channel(200, 40), channel(50, 90), channel(40, 200));
+    }
+
     static void setTabPeekHighlight(QTabWidget* tabs, int idx, bool on) {
         if (!tabs) return;
         auto* b = tabs->tabBar();
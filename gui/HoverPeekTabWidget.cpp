@@ -1,13 +1,43 @@
 #include "HoverPeekTabWidget.hpp"
+#include <algorithm>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QLabel>
+#include <QPainter>
 #include <QTabBar>
 #include <QSignalBlocker>
 
+#include <mdn/DensityMap.hpp>
 #include <mdn/Logger.hpp>
+#include <mdn/Mdn2d.hpp>
+#include <mdn/ThreadPool.hpp>
 
+#include "GuiTools.hpp"
 #include "HoverPeekTabBar.hpp"
 #include "MarkerWidget.hpp"
 #include "NumberDisplayWidget.hpp"
 
+namespace {
+
+// Paints map one pixel per cell, see GuiTools::heatmapColour
+QImage heatmapImage(const mdn::DensityMap& map) {
+    if (map.empty()) {
+        return QImage();
+    }
+    QImage image(map.cols, map.rows, QImage::Format_RGB32);
+    for (int row = 0; row < map.rows; ++row) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+        for (int col = 0; col < map.cols; ++col) {
+            const std::size_t i = map.index(col, row);
+            line[col] = mdn::gui::GuiTools::heatmapColour(map.density[i], map.balance[i]);
+        }
+    }
+    return image;
+}
+
+} // end anonymous namespace
+
 mdn::gui::HoverPeekTabWidget::HoverPeekTabWidget(QWidget* parent) :
     QTabWidget(parent)
 {
@@ -111,6 +141,13 @@ void mdn::gui::HoverPeekTabWidget::onCurrentChangedGuard(int index) {
         return;
     }
     m_lastRealIndex = index;
+
+    // The page being left keeps its last look as a thumbnail
+    NumberDisplayWidget* shown = ndwAt(index);
+    if (m_shownPage && m_shownPage != shown) {
+        captureWindow(m_shownPage);
+    }
+    m_shownPage = shown;
     Log_Debug2_T("");
 }
 
@@ -162,7 +199,9 @@ void mdn::gui::HoverPeekTabWidget::onCommitIndex(int idx) {
     }
 
     // Make this the permanent selection and end preview if any
-    endPreviewHighlight(currentIndex());
+    endPreviewHighlight(m_previewIndex);
+    m_previewIndex = -1;
+    hidePeek();
     if (m_lastPermanentIndex != idx) {
         m_lastPermanentIndex = idx;
         Log_Debug3("emit changedActiveIndex(idx=" << idx << ")");
@@ -236,32 +275,31 @@ void mdn::gui::HoverPeekTabWidget::moveIndex(int from, int to) {
 
 
 void mdn::gui::HoverPeekTabWidget::restoreIfPreviewing() {
-    // If there is a pending hover target, switch to it now (this is the delayed "preview")
+    // If there is a pending hover target, peek at it now (this is the delayed "preview")
     Log_Debug2_H("");
     if (m_pendingHoverIndex >= 0 && m_pendingHoverIndex < count()) {
         if (!m_previewActive) {
             m_lastPermanentIndex = currentIndex();
             m_previewActive = true;
+            refreshThumbnails();
             Log_Debug3("emit beganPreview(m_pendingHoverIndex=" << m_pendingHoverIndex << ")");
             emit beganPreview(m_pendingHoverIndex);
         }
         // Change preview highlight
-        endPreviewHighlight(currentIndex());
-        setCurrentIndex(m_pendingHoverIndex);
-        beginPreviewHighlight(m_pendingHoverIndex);
+        endPreviewHighlight(m_previewIndex);
+        m_previewIndex = m_pendingHoverIndex;
+        beginPreviewHighlight(m_previewIndex);
+        showPeek(m_previewIndex);
         m_pendingHoverIndex = -1;
         Log_Debug2_T("");
         return;
     }
 
-    // Otherwise, restore original tab if we are in preview mode
+    // Otherwise, end the preview if there is one
     if (m_previewActive) {
-        const int curr = currentIndex();
-        endPreviewHighlight(curr);
-        if (m_lastPermanentIndex >= 0 && m_lastPermanentIndex < count()
-            && m_lastPermanentIndex != curr) {
-            setCurrentIndex(m_lastPermanentIndex);
-        }
+        endPreviewHighlight(m_previewIndex);
+        m_previewIndex = -1;
+        hidePeek();
         m_previewActive = false;
         int currentIdx = currentIndex();
         Log_Debug3("emit endedPreview(currentIndex=" << currentIdx << ")");
@@ -307,3 +345,195 @@ mdn::gui::NumberDisplayWidget* mdn::gui::HoverPeekTabWidget::ndwAt(int idx) cons
     Log_Debug4("idx=" << idx);
     return qobject_cast<NumberDisplayWidget*>(widget(idx));
 }
+
+
+mdn::gui::HoverPeekTabWidget::Thumbnail& mdn::gui::HoverPeekTabWidget::thumbnailFor(
+    NumberDisplayWidget* page
+) {
+    Thumbnail& thumb = m_thumbnails[page];
+    if (thumb.page.isNull()) {
+        // New, or left by a destroyed page at the same address
+        thumb = Thumbnail();
+        thumb.page = page;
+    }
+    return thumb;
+}
+
+
+void mdn::gui::HoverPeekTabWidget::captureWindow(NumberDisplayWidget* page) {
+    const Mdn2d* mdn = page->model();
+    if (!mdn) {
+        return;
+    }
+    Thumbnail& thumb = thumbnailFor(page);
+    const long long event = mdn->event();
+    if (thumb.windowEvent == event && !thumb.window.isNull()) {
+        return;
+    }
+    Log_Debug3("Grabbing " << mdn->name() << " at event " << event);
+    thumb.window = page->grab().toImage().scaled(
+        thumbnailWidth, thumbnailHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation
+    );
+    thumb.windowEvent = event;
+}
+
+
+void mdn::gui::HoverPeekTabWidget::requestHeatmap(NumberDisplayWidget* page) {
+    const Mdn2d* mdn = page->model();
+    if (!mdn) {
+        return;
+    }
+    Thumbnail& thumb = thumbnailFor(page);
+    const long long event = mdn->event();
+    if (thumb.pending || thumb.heatmapEvent == event) {
+        return;
+    }
+    thumb.pending = true;
+
+    // One cell per pixel, or square blocks of digits when the number is larger than that
+    const Rect bounds = mdn->bounds();
+    int cols = 0;
+    int rows = 0;
+    if (bounds.isValid()) {
+        const int scale = std::max({
+            1,
+            (bounds.width() + thumbnailWidth - 1)/thumbnailWidth,
+            (bounds.height() + thumbnailHeight - 1)/thumbnailHeight
+        });
+        cols = (bounds.width() + scale - 1)/scale;
+        rows = (bounds.height() + scale - 1)/scale;
+    }
+    Log_Debug3(
+        "Heatmap for " << mdn->name() << " at event " << event << ", " << cols << "x" << rows
+    );
+
+    // The copy shares digit storage with mdn, so it is cheap here, and the worker reads it while
+    //  the gui carries on editing the original
+    auto copy = std::make_shared<const Mdn2d>(*mdn, mdn->name() + "_thumbnail");
+    const QWidget* key = page;
+    QPointer<HoverPeekTabWidget> guard(this);
+    ThreadPool::shared().submit([copy, bounds, cols, rows, key, event, guard]() {
+        const QImage heatmap = heatmapImage(copy->getDensityMap(bounds, cols, rows));
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app) {
+            return;
+        }
+        QMetaObject::invokeMethod(
+            app,
+            [key, event, heatmap, guard]() {
+                if (guard) {
+                    guard->onThumbnailReady(key, event, heatmap);
+                }
+            },
+            Qt::QueuedConnection
+        );
+    });
+}
+
+
+void mdn::gui::HoverPeekTabWidget::refreshThumbnails() {
+    Log_Debug3_H("");
+    for (auto it = m_thumbnails.begin(); it != m_thumbnails.end();) {
+        if (it->page.isNull()) {
+            it = m_thumbnails.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (int i = 0; i < count(); ++i) {
+        if (NumberDisplayWidget* page = ndwAt(i)) {
+            requestHeatmap(page);
+        }
+    }
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::HoverPeekTabWidget::onThumbnailReady(
+    const QWidget* page, long long event, const QImage& heatmap
+) {
+    Log_Debug3_H("event=" << event);
+    auto it = m_thumbnails.find(page);
+    if (it == m_thumbnails.end() || it->page.isNull() || !it->pending) {
+        Log_Debug3_T("Page is gone");
+        return;
+    }
+    it->pending = false;
+    it->heatmap = heatmap;
+    it->heatmapEvent = event;
+    if (m_previewActive && m_previewIndex >= 0 && widget(m_previewIndex) == page) {
+        showPeek(m_previewIndex);
+    }
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::HoverPeekTabWidget::showPeek(int idx) {
+    Log_Debug3_H("idx=" << idx);
+    NumberDisplayWidget* page = ndwAt(idx);
+    if (!page || !page->model() || idx == currentIndex()) {
+        // Nothing to show, or the page is already on display
+        hidePeek();
+        Log_Debug3_T("No peek");
+        return;
+    }
+    Thumbnail& thumb = thumbnailFor(page);
+    const long long event = page->model()->event();
+    if (thumb.heatmapEvent != event) {
+        requestHeatmap(page);
+    }
+
+    // Prefer the page as it was last seen, with the heatmap inset as an overview.  Once the
+    //  number has changed, show the heatmap alone, even a stale one, until its update arrives.
+    QPixmap pixmap;
+    if (thumb.windowEvent == event && !thumb.window.isNull()) {
+        pixmap = QPixmap::fromImage(thumb.window);
+        if (!thumb.heatmap.isNull()) {
+            const QImage inset = thumb.heatmap.scaled(
+                pixmap.width()/3, pixmap.height()/3, Qt::KeepAspectRatio, Qt::FastTransformation
+            );
+            const QPoint at(
+                pixmap.width() - inset.width() - 4, pixmap.height() - inset.height() - 4
+            );
+            QPainter painter(&pixmap);
+            painter.drawImage(at, inset);
+            painter.setPen(palette().color(QPalette::Mid));
+            painter.drawRect(QRect(at, inset.size()).adjusted(-1, -1, 0, 0));
+        }
+    } else if (!thumb.heatmap.isNull()) {
+        pixmap = QPixmap::fromImage(thumb.heatmap.scaled(
+            thumbnailWidth, thumbnailHeight, Qt::KeepAspectRatio, Qt::FastTransformation
+        ));
+    }
+
+    if (!m_peekPopup) {
+        m_peekPopup = new QLabel(this, Qt::ToolTip);
+        m_peekPopup->setFrameShape(QFrame::Box);
+        m_peekPopup->setAlignment(Qt::AlignCenter);
+    }
+    if (pixmap.isNull()) {
+        m_peekPopup->setPixmap(QPixmap());
+        m_peekPopup->setText(
+            thumb.pending || thumb.heatmapEvent != event ? tr("Preparing preview...") : tr("Empty")
+        );
+    } else {
+        m_peekPopup->setPixmap(pixmap);
+    }
+    m_peekPopup->adjustSize();
+
+    // Beside the tab, on the side facing the pages
+    const QRect tab = tabBar()->tabRect(idx);
+    const QPoint at = tabPosition() == QTabWidget::South
+        ? tabBar()->mapToGlobal(tab.topLeft()) - QPoint(0, m_peekPopup->height())
+        : tabBar()->mapToGlobal(tab.bottomLeft());
+    m_peekPopup->move(at);
+    m_peekPopup->show();
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::HoverPeekTabWidget::hidePeek() {
+    if (m_peekPopup) {
+        m_peekPopup->hide();
+    }
+}
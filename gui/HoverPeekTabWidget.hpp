@@ -1,13 +1,23 @@
 #pragma once
+#include <QHash>
+#include <QImage>
 #include <QTabWidget>
 #include <QTimer>
 #include <QPointer>
 
 #include "HoverPeekTabBar.hpp"
 
-// A QTabWidget that preview-switches pages while hovering tabs.
-// The switch is temporary until the user clicks a tab ("commit").
+class QLabel;
+
+// A QTabWidget that previews pages while hovering tabs.
+// The preview is a popup thumbnail; the page only switches when the user clicks a tab ("commit").
 // You can mark a "plus" tab (by index) to be ignored by previews.
+//
+// Thumbnails are cached per page, so hovering never touches the number itself.  Each holds:
+//  * a density / sign heatmap of the whole number, made on the shared ThreadPool from a
+//    copy-on-write copy, and
+//  * an image of the page as last displayed, grabbed when the page stops being current.
+// Both are tagged with the number's event(), and regenerated only once it has moved on.
 
 namespace mdn {
 namespace gui {
@@ -53,6 +63,7 @@ private slots:
     void onHoverIndex(int idx);
     void onHoverEnd();
     void onCommitIndex(int idx);
+    void onThumbnailReady(const QWidget* page, long long event, const QImage& heatmap);
 
 protected:
     void tabInserted(int index) override {
@@ -70,7 +81,52 @@ private:
     void endPreviewHighlight(int idx);
     NumberDisplayWidget* ndwAt(int idx) const;
 
+    // Thumbnails
+    // Returns the cache entry for page, creating it if needed
+    struct Thumbnail;
+    Thumbnail& thumbnailFor(NumberDisplayWidget* page);
+    // Grabs the page as displayed, if it has changed since the last grab
+    void captureWindow(NumberDisplayWidget* page);
+    // Starts a heatmap job for page, if it has changed and none is running
+    void requestHeatmap(NumberDisplayWidget* page);
+    // requestHeatmap for every page
+    void refreshThumbnails();
+    // Shows the thumbnail popup for tab idx, or hides it
+    void showPeek(int idx);
+    void hidePeek();
+
 private:
+    // Largest thumbnail, in pixels
+    static constexpr int thumbnailWidth = 320;
+    static constexpr int thumbnailHeight = 200;
+
+    struct Thumbnail {
+        // The page this describes, null once it is destroyed
+        QPointer<QWidget> page;
+
+        // Event the heatmap was made from, -1 for none
+        long long heatmapEvent { -1 };
+        QImage heatmap;
+
+        // Event the window image was grabbed at, -1 for none
+        long long windowEvent { -1 };
+        QImage window;
+
+        // True while a heatmap job is running
+        bool pending { false };
+    };
+
+    QHash<const QWidget*, Thumbnail> m_thumbnails;
+
+    // Popup showing the thumbnail of the hovered tab
+    QLabel* m_peekPopup = nullptr;
+
+    // Tab whose thumbnail is showing, -1 for none
+    int m_previewIndex { -1 };
+
+    // The page currently shown, grabbed when it is switched away from
+    QPointer<NumberDisplayWidget> m_shownPage;
+
     QTimer m_restoreTimer;
     int    m_hoverDelayMs { 120 };  // adjust to taste
     int    m_plusTabIndex { -1 };   // index of "+" tab (ignored for previews)
@@ -25,7 +25,10 @@
 
 #include <mdn/Logger.hpp>
 #include <mdn/Carryover.hpp>
+#include <mdn/ChangeLog.hpp>
+#include <mdn/ScriptEngine.hpp>
 
+#include "Autosave.hpp"
 #include "GuiTools.hpp"
 #include "HelpDialog.hpp"
 #include "HoverPeekTabWidget.hpp"
@@ -34,6 +37,7 @@
 #include "NumberDisplayWidget.hpp"
 #include "OpsController.hpp"
 #include "ProjectPropertiesDialog.hpp"
+#include "ProjectWorkspace.hpp"
 #include "StatusDisplayWidget.hpp"
 
 int mdn::gui::MainWindow::nStartMdnDefault = 3;
@@ -269,6 +273,37 @@ void mdn::gui::MainWindow::onProjectTabsAboutToChange()
 }
 
 
+void mdn::gui::MainWindow::onProjectBulkProgress(const QString& label, int done, int total) {
+    if (done < total) {
+        showStatus(tr("%1: %2 of %3 tabs").arg(label).arg(done).arg(total), 0);
+    } else {
+        showStatus(tr("%1: done").arg(label), 2000);
+    }
+}
+
+
+void mdn::gui::MainWindow::onProjectBulkStarted(const QString& label) {
+    Log_Debug2("label=" << label.toStdString());
+    // Pool threads are changing the tabs, nothing may edit them until the job finishes
+    if (m_splitter) {
+        m_splitter->setEnabled(false);
+    }
+    menuBar()->setEnabled(false);
+}
+
+
+void mdn::gui::MainWindow::onProjectBulkFinished(const QString& label, const QString& error) {
+    Log_Debug2("label=" << label.toStdString() << ", error=" << error.toStdString());
+    if (m_splitter) {
+        m_splitter->setEnabled(true);
+    }
+    menuBar()->setEnabled(true);
+    if (!error.isEmpty()) {
+        showStatus(tr("%1 failed: %2").arg(label).arg(error), 0);
+    }
+}
+
+
 void mdn::gui::MainWindow::onProjectTabsChanged(int currentIndex)
 {
     Log_Debug2_H("currentIndex=" << currentIndex);
@@ -525,6 +560,9 @@ bool mdn::gui::MainWindow::saveProjectToPath(const QString& path) {
     m_globalConfig.setParentPath(parentPath);
     m_globalConfig.setParentName(parentPath);
 
+    // Saved, so autosave beside the file from here on
+    startAutosave();
+
     setWindowTitle(baseName);
     showStatus(tr("Project saved"), 2000);
     Log_Debug2_T("ok")
@@ -532,6 +570,17 @@ bool mdn::gui::MainWindow::saveProjectToPath(const QString& path) {
 }
 
 
+void mdn::gui::MainWindow::startAutosave() {
+    Log_Debug2_H("");
+    // The old autosave, if any, is cleanly discarded first
+    m_autosave.reset();
+    if (m_project) {
+        m_autosave.reset(new Autosave(m_project));
+    }
+    Log_Debug2_T("");
+}
+
+
 bool mdn::gui::MainWindow::onOpenProject() {
     Log_Debug2_H("");
     bool result = openProject(true);
@@ -840,7 +889,46 @@ void mdn::gui::MainWindow::onSplitterMoved(int pos, int index) {
 
 
 void mdn::gui::MainWindow::onCommandSubmitted(const QString& text) {
+    Log_Debug2_H("text=[" << text.toStdString() << "]");
     m_command->appendLine(QStringLiteral("» %1").arg(text));
+    if (!m_project) {
+        m_command->appendLine(tr("No project open"));
+        Log_Debug2_T("No project");
+        return;
+    }
+
+    // Same interpreter as mdn_cli, numbers are the project's tabs, by name
+    std::vector<ScriptStatement> statements;
+    try {
+        statements = ScriptEngine::parse(text.toStdString());
+    } catch (const std::exception& e) {
+        m_command->appendLine(QString::fromStdString(e.what()));
+        Log_Debug2_T("Parse failed");
+        return;
+    }
+    m_command->setBusy(true);
+    ProjectWorkspace workspace(*m_project);
+    ScriptEngine engine(workspace);
+    // Tab storage is not thread-safe, so statements run one at a time
+    engine.run(
+        statements,
+        false,
+        [this](const ScriptResult& result) {
+            QString output = QString::fromStdString(result.output);
+            while (output.endsWith('\n')) {
+                output.chop(1);
+            }
+            if (!output.isEmpty()) {
+                m_command->appendLine(output);
+            }
+            if (result.ok) {
+                m_command->appendLine(tr("(%1 ms)").arg(result.seconds*1000.0, 0, 'f', 3));
+            }
+        }
+    );
+    m_command->setBusy(false);
+    syncTabsToProject();
+    Log_Debug2_T("");
 }
 
 
@@ -1282,6 +1370,9 @@ void mdn::gui::MainWindow::setGlobalConfig(Mdn2dConfig c, bool force) {
     if (m_project) {
         m_globalConfig.setParent(*m_project);
         m_project->setConfig(m_globalConfig, true);
+        if (m_autosave) {
+            m_autosave->compact();
+        }
     }
     updateStatusFraxisText(c.fraxis(), false);
     updateStatusSignConventionText(c.signConvention(), false);
@@ -1299,6 +1390,9 @@ void mdn::gui::MainWindow::updateGlobalConfig(Mdn2dConfig c, UpdateGlobalConfigE
     if (m_project) {
         m_globalConfig.setParent(*m_project);
         m_project->setConfig(m_globalConfig, true);
+        if (m_autosave) {
+            m_autosave->compact();
+        }
     }
     updateStatusFraxisText(
         c.fraxis(),
@@ -1510,6 +1604,38 @@ void mdn::gui::MainWindow::slotDebugShowAllTabs() {
 }
 
 
+void mdn::gui::MainWindow::onEditUndo() {
+    if (m_project) {
+        Mdn2d* mdn = m_project->activeMdn();
+        if (mdn && mdn->undo()) {
+            int activeIndex = m_project->activeIndex();
+            if (auto* ndw = qobject_cast<NumberDisplayWidget*>(m_tabWidget->widget(activeIndex))) {
+                ndw->update();
+            }
+            showStatus(tr("Undo"), 2000);
+        } else {
+            showStatus(tr("Nothing to undo"), 2000);
+        }
+    }
+}
+
+
+void mdn::gui::MainWindow::onEditRedo() {
+    if (m_project) {
+        Mdn2d* mdn = m_project->activeMdn();
+        if (mdn && mdn->redo()) {
+            int activeIndex = m_project->activeIndex();
+            if (auto* ndw = qobject_cast<NumberDisplayWidget*>(m_tabWidget->widget(activeIndex))) {
+                ndw->update();
+            }
+            showStatus(tr("Redo"), 2000);
+        } else {
+            showStatus(tr("Nothing to redo"), 2000);
+        }
+    }
+}
+
+
 void mdn::gui::MainWindow::onEditCopy() {
     if (m_project) {
         m_project->copySelection();
@@ -1687,6 +1813,11 @@ void mdn::gui::MainWindow::createMenus() {
     fileMenu->addAction("E&xit", this, &mdn::gui::MainWindow::close);
 
     QMenu* editMenu = menuBar()->addMenu("&Edit");
+    QAction* actUndo = editMenu->addAction("Undo", this, &mdn::gui::MainWindow::onEditUndo);
+    QAction* actRedo = editMenu->addAction("Redo", this, &mdn::gui::MainWindow::onEditRedo);
+    actUndo->setShortcut(QKeySequence::Undo);
+    actRedo->setShortcut(QKeySequence::Redo);
+    editMenu->addSeparator();
     editMenu->addAction("Select All", this, &mdn::gui::MainWindow::onSelectAll);
     editMenu->addAction("Copy", this, &mdn::gui::MainWindow::onEditCopy);
     editMenu->addAction("Cut", this, &mdn::gui::MainWindow::onEditCut);
@@ -2312,6 +2443,12 @@ bool mdn::gui::MainWindow::createNewProjectFromConfig(Mdn2dConfig& cfg, bool req
                 this, &mdn::gui::MainWindow::onProjectTabsAboutToChange);
         connect(m_project, &mdn::gui::Project::tabsChanged,
                 this, &mdn::gui::MainWindow::onProjectTabsChanged);
+        connect(m_project, &mdn::gui::Project::bulkStarted,
+                this, &mdn::gui::MainWindow::onProjectBulkStarted);
+        connect(m_project, &mdn::gui::Project::bulkProgress,
+                this, &mdn::gui::MainWindow::onProjectBulkProgress);
+        connect(m_project, &mdn::gui::Project::bulkFinished,
+                this, &mdn::gui::MainWindow::onProjectBulkFinished);
         if (m_ops) {
             m_ops->resetModel(m_project);
             connect(m_ops, &OpsController::requestStatus,
@@ -2328,6 +2465,7 @@ bool mdn::gui::MainWindow::createNewProjectFromConfig(Mdn2dConfig& cfg, bool req
     }
     m_globalConfig.setParent(*m_project);
     setGlobalConfig(m_globalConfig, true);
+    startAutosave();
 
     Log_Debug3_T("");
     return true;
@@ -2350,6 +2488,12 @@ bool mdn::gui::MainWindow::createNewProject(Mdn2dConfig* cfg, bool requireConfir
                 this, &mdn::gui::MainWindow::onProjectTabsAboutToChange);
         connect(m_project, &mdn::gui::Project::tabsChanged,
                 this, &mdn::gui::MainWindow::onProjectTabsChanged);
+        connect(m_project, &mdn::gui::Project::bulkStarted,
+                this, &mdn::gui::MainWindow::onProjectBulkStarted);
+        connect(m_project, &mdn::gui::Project::bulkProgress,
+                this, &mdn::gui::MainWindow::onProjectBulkProgress);
+        connect(m_project, &mdn::gui::Project::bulkFinished,
+                this, &mdn::gui::MainWindow::onProjectBulkFinished);
         if (m_ops) {
             m_ops->resetModel(m_project);
             connect(m_ops, &OpsController::requestStatus,
@@ -2363,6 +2507,7 @@ bool mdn::gui::MainWindow::createNewProject(Mdn2dConfig* cfg, bool requireConfir
             );
         }
         onProjectTabsChanged(0);
+        startAutosave();
     }
     Log_Debug3_T("");
     return true;
@@ -2393,7 +2538,32 @@ bool mdn::gui::MainWindow::openProject(bool requireConfirm) {
         return false;
     }
 
-    std::unique_ptr<Project> ptr = Project::loadFromFile(this, path.toStdString());
+    // Autosave files beside the project mean it was not closed normally
+    std::unique_ptr<Project> ptr;
+    QFileInfo pathInfo(path);
+    const std::string autosaveBase =
+        (pathInfo.absolutePath() + "/" + pathInfo.baseName() + ".mdnproj").toStdString();
+    if (ChangeLog::static_exists(autosaveBase)) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this,
+            tr("Recover Project"),
+            tr(
+                "This project was not closed normally.\n\n"
+                "Recover the changes made since it was last saved?"
+            ),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::Yes
+        );
+        if (reply == QMessageBox::Yes) {
+            ptr = Autosave::recover(this, autosaveBase);
+            if (!ptr) {
+                showStatus(tr("Autosave unreadable, opening saved project"), 2000);
+            }
+        }
+    }
+    if (!ptr) {
+        ptr = Project::loadFromFile(this, path.toStdString());
+    }
     if (!ptr.get()) {
         // Load failed
         showStatus(tr("Failed to read file"), 2000);
@@ -2409,6 +2579,12 @@ bool mdn::gui::MainWindow::openProject(bool requireConfirm) {
             this, &mdn::gui::MainWindow::onProjectTabsAboutToChange);
     connect(m_project, &mdn::gui::Project::tabsChanged,
             this, &mdn::gui::MainWindow::onProjectTabsChanged);
+    connect(m_project, &mdn::gui::Project::bulkStarted,
+            this, &mdn::gui::MainWindow::onProjectBulkStarted);
+    connect(m_project, &mdn::gui::Project::bulkProgress,
+            this, &mdn::gui::MainWindow::onProjectBulkProgress);
+    connect(m_project, &mdn::gui::Project::bulkFinished,
+            this, &mdn::gui::MainWindow::onProjectBulkFinished);
 
 
     // Remember the folder path of the opened project
@@ -2422,12 +2598,55 @@ bool mdn::gui::MainWindow::openProject(bool requireConfirm) {
     onProjectTabsChanged(m_project->activeIndex());
     m_globalConfig.setParent(*m_project);
     setGlobalConfig(m_globalConfig);
+    startAutosave();
     showStatus(tr("Project loaded"), 2000);
     Log_Debug2_T("ok")
     return true;
 }
 
 
+bool mdn::gui::MainWindow::recoverProject(const QString& basePath) {
+    Log_Debug2_H("basePath=" << basePath.toStdString());
+    if (!confirmedCloseProject(false)) {
+        Log_Debug2_T("Did not succeed in closing existing project");
+        return false;
+    }
+
+    std::unique_ptr<Project> ptr = Autosave::recover(this, basePath.toStdString());
+    if (!ptr.get()) {
+        showStatus(tr("Failed to recover project"), 2000);
+        Log_Debug2_T("Recovery failed");
+        return false;
+    }
+    m_project = ptr.release();
+    m_globalConfig = m_project->config();
+    m_globalConfig.setParent(*m_project);
+    setGlobalConfig(m_globalConfig);
+
+    connect(m_project, &mdn::gui::Project::tabsAboutToChange,
+            this, &mdn::gui::MainWindow::onProjectTabsAboutToChange);
+    connect(m_project, &mdn::gui::Project::tabsChanged,
+            this, &mdn::gui::MainWindow::onProjectTabsChanged);
+    connect(m_project, &mdn::gui::Project::bulkStarted,
+            this, &mdn::gui::MainWindow::onProjectBulkStarted);
+    connect(m_project, &mdn::gui::Project::bulkProgress,
+            this, &mdn::gui::MainWindow::onProjectBulkProgress);
+    connect(m_project, &mdn::gui::Project::bulkFinished,
+            this, &mdn::gui::MainWindow::onProjectBulkFinished);
+
+    setWindowTitle(QString::fromStdString(m_project->name()));
+    onProjectTabsChanged(m_project->activeIndex());
+    startAutosave();
+    if (Autosave::basePath(*m_project) != basePath.toStdString()) {
+        // Renamed since it was autosaved, the new autosave lives elsewhere
+        Autosave::discard(basePath.toStdString());
+    }
+    showStatus(tr("Project recovered"), 2000);
+    Log_Debug2_T("ok")
+    return true;
+}
+
+
 bool mdn::gui::MainWindow::confirmedCloseProject(bool requireConfirm) {
     Log_Debug2_H("");
     if (!m_project) {
@@ -2497,6 +2716,8 @@ bool mdn::gui::MainWindow::closeProject() {
 
     disconnect(m_project, nullptr, this, nullptr);
 
+    // A clean close, the autosave is no longer needed
+    m_autosave.reset();
     delete m_project;
     m_project = nullptr;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include <QAction>
 #include <QHBoxLayout>
 #include <QLineEdit>
@@ -27,6 +29,7 @@
 namespace mdn {
 namespace gui {
 
+class Autosave;
 class StatusDisplayWidget;
 class HoverPeekTabWidget;
 
@@ -79,6 +82,9 @@ private slots:
     void onTabContextMenu(const QPoint& pos);
     void onProjectTabsAboutToChange();
     void onProjectTabsChanged(int currentIndex);
+    void onProjectBulkStarted(const QString& label);
+    void onProjectBulkProgress(const QString& label, int done, int total);
+    void onProjectBulkFinished(const QString& label, const QString& error);
     void onProjectProperties();
     void onTabPeek(int idx);
     void onTabPeekEnd();
@@ -151,6 +157,8 @@ private slots:
     void slotDebugShowAllTabs();
 
     // Edit menu
+    void onEditUndo();
+    void onEditRedo();
     void onEditCopy();
     void onEditPaste();
     void onEditCut();
@@ -188,6 +196,9 @@ public:
     //  requireConfirm - ask user if they want to save any existing project before deleting
     bool openProject(bool requireConfirm);
 
+    // Rebuild a project from the autosave at basePath, left by an abnormal exit
+    bool recoverProject(const QString& basePath);
+
     // Returns true if m_project has been successfully closed and user wishe to proceed
     bool confirmedCloseProject(bool requireConfirm);
     // Does the dirty work of actually closing the project
@@ -206,6 +217,9 @@ private:
     // Save project to the given path
     bool saveProjectToPath(const QString& path);
 
+    // (Re)starts autosaving m_project, at its current location
+    void startAutosave();
+
     // Fraxis helpers
     void updateStatusFraxisText(mdn::Fraxis f, bool echoToStatusBar);
     void buildFraxisMenu();
@@ -298,6 +312,9 @@ private:
 
     Project* m_project{nullptr};
 
+    // Crash recovery copy of m_project, reset before m_project is closed
+    std::unique_ptr<Autosave> m_autosave;
+
     QWidget* m_tabCorner{nullptr};
 
     QToolButton* m_tabSaveBtn{nullptr};
@@ -1,5 +1,8 @@
 #include "NumberDisplayWidget.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include <QFontMetrics>
 #include <QGuiApplication>
 #include <QStyle>
@@ -8,10 +11,23 @@
 #include "CellLineEdit.hpp"
 #include "GuiTools.hpp"
 #include "Project.hpp"
+#include <mdn/DigitPyramid.hpp>
 #include <mdn/Selection.hpp>
 #include <mdn/Tools.hpp>
 
 constexpr double mdn::gui::NumberDisplayWidget::kEdgeGuardFrac;
+constexpr int mdn::gui::NumberDisplayWidget::kOverviewTilePx;
+
+namespace {
+
+// Overview coordinates span far more than an int when scaled up
+int clampToInt(long long v) {
+    return static_cast<int>(std::clamp<long long>(
+        v, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()
+    ));
+}
+
+} // end anonymous namespace
 
 
 std::string mdn::gui::NumberDisplayWidget::EditModeToString(EditMode m) {
@@ -44,6 +60,7 @@ void mdn::gui::NumberDisplayWidget::setModel(Mdn2d* model, Selection* sel) {
     Log_Debug2_H("model=" << model->name());
     m_model = model;
     m_selection = sel;
+    m_areaEvent = -1;
     if (m_selection) {
         m_cursorX = m_selection->cursor1().x();
         m_cursorY = m_selection->cursor1().y();
@@ -66,6 +83,7 @@ void mdn::gui::NumberDisplayWidget::decreaseFont() {
 
 
 void mdn::gui::NumberDisplayWidget::resetFont() {
+    setOverviewLevel(-1);
     emit requestFontSizeChange(11);
     // setFontPointSize(11);
 }
@@ -92,6 +110,51 @@ void mdn::gui::NumberDisplayWidget::setFontPointSize(int pt) {
 }
 
 
+void mdn::gui::NumberDisplayWidget::setOverviewLevel(int level) {
+    level = std::clamp(level, -1, DigitPyramid::maxLevel);
+    if (level == m_overviewLevel) {
+        return;
+    }
+    Log_Debug3_H("level=" << level);
+    if (m_editing) {
+        cancelCellEdit();
+    }
+    m_overviewLevel = level;
+    if (inOverview()) {
+        const int tileSize = DigitPyramid::static_tileSize(level);
+        emit requestStatus(
+            tr("Overview, each square is %1 x %1 digits").arg(tileSize), 2000, false
+        );
+    }
+    update();
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::NumberDisplayWidget::overviewAllBounds() {
+    Log_Debug3_H("");
+    if (!m_model) {
+        Log_Debug3_T("No model");
+        return;
+    }
+    const Rect b = m_model->bounds();
+    if (b.isInvalid()) {
+        setOverviewLevel(-1);
+        centreViewOnOrigin();
+        Log_Debug3_T("No digits");
+        return;
+    }
+    centreViewOn(
+        clampToInt((static_cast<long long>(b.min().x()) + b.max().x())/2),
+        clampToInt((static_cast<long long>(b.min().y()) + b.max().y())/2)
+    );
+    setOverviewLevel(DigitPyramid::static_levelFor(
+        b, std::max(1, width()/kOverviewTilePx), std::max(1, height()/kOverviewTilePx)
+    ));
+    Log_Debug3_T("");
+}
+
+
 void mdn::gui::NumberDisplayWidget::cancelCellEdit() {
     Log_Debug3_H("");
     if (m_cellEditor) {
@@ -202,6 +265,11 @@ void mdn::gui::NumberDisplayWidget::paintEvent(QPaintEvent* event) {
         "Model and Selection are not set"
     );
 
+    if (inOverview()) {
+        paintOverview(painter);
+        return;
+    }
+
     const mdn::Rect& selRect = m_selection->rect();
     const mdn::Coord& anchor = m_selection->cursor0();
     const mdn::Coord& cursor = m_selection->cursor1();
@@ -227,8 +295,13 @@ void mdn::gui::NumberDisplayWidget::paintEvent(QPaintEvent* event) {
         false // No need to fix ordering
     );
 
-    VecVecDigit rows;
-    m_model->getAreaRows(m_viewBounds, rows);
+    const int stride = m_viewBounds.width();
+    if (m_areaWindow.min() != m_viewBounds.min() || m_areaWindow.max() != m_viewBounds.max()) {
+        m_areaWindow = m_viewBounds;
+        m_areaDigits.resize(static_cast<std::size_t>(stride)*m_viewBounds.height());
+        m_areaEvent = -1;
+    }
+    m_areaEvent = m_model->getAreaDigits(m_viewBounds, m_areaDigits.data(), stride, m_areaEvent);
 
     const Rect& modelBounds = m_model->bounds();
     const Rect viewIbounds = Rect::Intersection(m_viewBounds, modelBounds);
@@ -260,7 +333,7 @@ void mdn::gui::NumberDisplayWidget::paintEvent(QPaintEvent* event) {
     for (int vy = 0; vy < m_rows; ++vy) {
 
         int rowI = m_rows - 1 - vy;
-        const VecDigit& currentRow = rows[rowI];
+        const Digit* currentRow = m_areaDigits.data() + static_cast<std::size_t>(rowI)*stride;
 
         for (int vx = 0; vx < m_cols; ++vx) {
             // Convert view cell (vx,vy) to model coordinate (x,y).
@@ -503,7 +576,12 @@ void mdn::gui::NumberDisplayWidget::keyPressEvent_gridScope(QKeyEvent* e) {
             return;
         }
         if (e->key() == Qt::Key_A) {
-            selectAllBounds();
+            // Ctrl+Shift+A shows the whole number zoomed out instead
+            if (shift) {
+                overviewAllBounds();
+            } else {
+                selectAllBounds();
+            }
             e->accept();
             return;
         }
@@ -747,6 +825,17 @@ void mdn::gui::NumberDisplayWidget::keyPressEvent_digitEditScope(QKeyEvent* e) {
 
 
 void mdn::gui::NumberDisplayWidget::mousePressEvent(QMouseEvent* e) {
+    if (inOverview() && e->button() == Qt::LeftButton) {
+        // Drill down to the digits under the pointer
+        int mx{0};
+        int my{0};
+        overviewPixelToModel(e->pos().x(), e->pos().y(), mx, my);
+        setOverviewLevel(-1);
+        centreViewOn(mx, my);
+        setBothCursors(mx, my);
+        e->accept();
+        return;
+    }
     if (e->button() == Qt::LeftButton) {
         int mx{0};
         int my{0};
@@ -857,12 +946,20 @@ void mdn::gui::NumberDisplayWidget::wheelEvent(QWheelEvent* e) {
         }
     }
 
+    // In the overview, scroll the same distance on screen, so by tiles rather than digits
+    long long scale = 1;
+    if (inOverview()) {
+        scale =
+            static_cast<long long>(DigitPyramid::static_tileSize(m_overviewLevel))
+            * std::max(1, m_cellSize) / kOverviewTilePx;
+    }
+
     // Apply scroll (positive deltas move the view to reveal content in that direction)
     // Vertical: +dy => show higher Y -> increase originY
     // Horizontal: +dx => show larger X -> increase originX
     if (dxCells != 0 || dyCells != 0) {
-        m_viewOriginX += dxCells;
-        m_viewOriginY += dyCells;
+        m_viewOriginX = clampToInt(m_viewOriginX + dxCells*scale);
+        m_viewOriginY = clampToInt(m_viewOriginY + dyCells*scale);
         update();
         e->accept();
         return;
@@ -1001,7 +1098,109 @@ void mdn::gui::NumberDisplayWidget::drawAxes(QPainter& painter, const QRect& wid
 }
 
 
+void mdn::gui::NumberDisplayWidget::paintOverview(QPainter& painter) {
+    const int level = m_overviewLevel;
+    const long long tileSize = DigitPyramid::static_tileSize(level);
+    const Coord centre(m_viewOriginX + m_cols/2, m_viewOriginY + m_rows/2);
+    const Coord centreTile = DigitPyramid::static_tileOf(centre, level);
+    const long long halfX = width()/(2*kOverviewTilePx) + 1;
+    const long long halfY = height()/(2*kOverviewTilePx) + 1;
+    const Rect window(
+        clampToInt((centreTile.x() - halfX)*tileSize),
+        clampToInt((centreTile.y() - halfY)*tileSize),
+        clampToInt((centreTile.x() + halfX + 1)*tileSize - 1),
+        clampToInt((centreTile.y() + halfY + 1)*tileSize - 1)
+    );
+    const Overview overview = m_model->getOverview(window, level);
+
+    painter.fillRect(rect(), QColor(GuiTools::heatmapColour(0.0f, 0.0f)));
+    const float area = static_cast<float>(tileSize)*static_cast<float>(tileSize);
+    const QSize tilePx(kOverviewTilePx, kOverviewTilePx);
+    for (int row = 0; row < overview.rows(); ++row) {
+        const int ty = overview.tiles.max().y() - row;
+        for (int col = 0; col < overview.cols(); ++col) {
+            const OverviewTile& tile = overview.cells[overview.index(col, row)];
+            if (tile.nonZero == 0) {
+                continue;
+            }
+            const int tx = overview.tiles.min().x() + col;
+            const QRgb colour = GuiTools::heatmapColour(
+                tile.nonZero/area, static_cast<float>(tile.balance)/tile.nonZero
+            );
+            painter.fillRect(QRect(overviewTileToPixel(tx, ty), tilePx), QColor(colour));
+        }
+    }
+
+    // Cursor tile
+    const Coord cursorTile = DigitPyramid::static_tileOf(m_selection->cursor1(), level);
+    painter.fillRect(
+        QRect(overviewTileToPixel(cursorTile.x(), cursorTile.y()), tilePx), m_theme.cursorFill
+    );
+
+    // Axes run along the bottom of tile row 0 and the left of tile column 0
+    const QPoint origin = overviewTileToPixel(0, 0);
+    painter.setPen(m_theme.axisPen);
+    const int xAxisPx = origin.y() + kOverviewTilePx;
+    if (0 <= xAxisPx && xAxisPx <= height()) {
+        painter.drawLine(0, xAxisPx, width(), xAxisPx);
+    }
+    if (0 <= origin.x() && origin.x() <= width()) {
+        painter.drawLine(origin.x(), 0, origin.x(), height());
+    }
+
+    if (hasFocus()) {
+        QPen ring(QColor(70,120,255), 2);
+        painter.setPen(ring);
+        painter.drawRect(rect().adjusted(1,1,-2,-2));
+    }
+}
+
+
+QPoint mdn::gui::NumberDisplayWidget::overviewTileToPixel(int tx, int ty) const {
+    const Coord centre(m_viewOriginX + m_cols/2, m_viewOriginY + m_rows/2);
+    const Coord centreTile = DigitPyramid::static_tileOf(centre, m_overviewLevel);
+    // Keep far off-screen tiles within range of QPoint
+    constexpr long long limit = 1 << 20;
+    const long long px =
+        width()/2 + (static_cast<long long>(tx) - centreTile.x())*kOverviewTilePx;
+    const long long py =
+        height()/2 + (static_cast<long long>(centreTile.y()) - ty)*kOverviewTilePx;
+    return QPoint(
+        static_cast<int>(std::clamp(px, -limit, limit)),
+        static_cast<int>(std::clamp(py, -limit, limit))
+    );
+}
+
+
+void mdn::gui::NumberDisplayWidget::overviewPixelToModel(
+    int px, int py, int& mx, int& my
+) const {
+    const Coord centre(m_viewOriginX + m_cols/2, m_viewOriginY + m_rows/2);
+    const Coord centreTile = DigitPyramid::static_tileOf(centre, m_overviewLevel);
+    const long long tileSize = DigitPyramid::static_tileSize(m_overviewLevel);
+    const long long dx = px - width()/2;
+    const long long dy = py - height()/2;
+    // Floor division, pixels left of or above the centre tile's corner belong to earlier tiles
+    const long long tx = centreTile.x() + (dx >= 0 ? dx : dx - kOverviewTilePx + 1)/kOverviewTilePx;
+    const long long ty = centreTile.y() - (dy >= 0 ? dy : dy - kOverviewTilePx + 1)/kOverviewTilePx;
+    mx = clampToInt(tx*tileSize + tileSize/2);
+    my = clampToInt(ty*tileSize + tileSize/2);
+}
+
+
 void mdn::gui::NumberDisplayWidget::adjustFontBy(int deltaPts) {
+    // Zooming out past the smallest font enters the overview, zooming in from its finest level
+    //  returns to digits
+    if (inOverview()) {
+        if (deltaPts != 0) {
+            setOverviewLevel(m_overviewLevel + (deltaPts > 0 ? -1 : 1));
+        }
+        return;
+    }
+    if (deltaPts < 0 && fontPointSize() <= m_minPt) {
+        setOverviewLevel(0);
+        return;
+    }
     emit requestFontSizeChange(fontPointSize() + deltaPts);
 }
 
@@ -87,6 +87,17 @@ public:
     }
     void setFontPointSize(int pt);
 
+    // Overview, zooming out beyond the smallest font: the number is drawn as a heatmap of digit
+    //  pyramid tiles, each kOverviewTilePx across, see Mdn2dRules::getOverview.  Clicking a tile
+    //  drills down to its digits.
+    inline bool inOverview() const {
+        return m_overviewLevel >= 0;
+    }
+    // Shows tiles of the given pyramid level about the same centre, -1 returns to digits
+    void setOverviewLevel(int level);
+    // Overview at the finest level that fits the whole number, centred on it
+    void overviewAllBounds();
+
     // Visible grid metrics
     inline int visibleCols() const {
         return m_cols;
@@ -174,6 +185,11 @@ private:
     void recalcGridGeometry();
     void ensureCursorVisible();
     void drawAxes(QPainter& p, const QRect& widgetRect);
+    void paintOverview(QPainter& p);
+    // Pixel position of the top-left of the overview tile at (tx, ty)
+    QPoint overviewTileToPixel(int tx, int ty) const;
+    // Model coordinate under a pixel in the overview
+    void overviewPixelToModel(int px, int py, int& mx, int& my) const;
     void adjustFontBy(int deltaPts);
     void pixelToModel(int px, int py, int& mx, int& my) const;
 public:
@@ -229,6 +245,12 @@ private:
     int m_viewOriginY{0};
     Rect m_viewBounds;
 
+    // Digits of m_areaWindow as of m_areaEvent, kept between repaints and refetched only when
+    //  the window moves or the number changes
+    std::vector<Digit> m_areaDigits;
+    Rect m_areaWindow;
+    long long m_areaEvent{-1};
+
     // Cached for painting (not the source of truth)
     int m_cursorX{0};
     int m_cursorY{0};
@@ -237,6 +259,11 @@ private:
     int m_minPt{8};
     int m_maxPt{48};
 
+    // Overview: pyramid level shown, -1 shows digits.  The view stays centred on the middle of
+    //  the digit window, m_viewOrigin + (m_cols, m_rows)/2.
+    static constexpr int kOverviewTilePx = 4;
+    int m_overviewLevel{-1};
+
     static constexpr double kEdgeGuardFrac = 0.10;
     double m_lastCursorFracX{0.5};
     double m_lastCursorFracY{0.5};
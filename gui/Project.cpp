@@ -1,10 +1,15 @@
 #include "Project.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <fstream>
+#include <future>
 #include <limits>
+#include <memory>
+#include <sstream>
 
 #include <QClipboard>
 #include <QGuiApplication>
@@ -18,6 +23,7 @@
 #include <mdn/MdnException.hpp>
 #include <mdn/Rect.hpp>
 #include <mdn/SignConvention.hpp>
+#include <mdn/ThreadPool.hpp>
 #include <mdn/Tools.hpp>
 
 #include "Clipboard.hpp"
@@ -238,6 +244,14 @@ mdn::gui::Project::Project(MainWindow* parent, Mdn2dConfig& cfg, int nStartMdn):
 }
 
 
+mdn::gui::Project::~Project() {
+    // Pool workers may still be changing tabs, the queued completion is dropped with this object
+    if (m_bulkJob.valid()) {
+        m_bulkJob.wait();
+    }
+}
+
+
 std::string mdn::gui::Project::requestMdnNameChange(
     const std::string& origName,
     const std::string& newName
@@ -320,8 +334,139 @@ mdn::Mdn2dConfigImpact mdn::gui::Project::assessConfigChange(Mdn2dConfig config)
 }
 
 
+bool mdn::gui::Project::parallelForEachMdn(
+    const QString& label,
+    std::function<void(int, Mdn2d&)> job,
+    std::function<void()> finished
+) {
+    Log_Debug3_H("label=" << label.toStdString() << ", size=" << m_data.size());
+    // Gather the tabs first, m_data is not modified while the jobs run
+    auto tabs = std::make_shared<std::vector<std::pair<int, Mdn2d*>>>();
+    tabs->reserve(m_data.size());
+    for (auto& [index, tgt] : m_data) {
+        tabs->emplace_back(index, &tgt);
+    }
+    const bool started = internal_parallelFor(
+        label,
+        static_cast<int>(tabs->size()),
+        [tabs, job = std::move(job)](int i) { job((*tabs)[i].first, *(*tabs)[i].second); },
+        std::move(finished)
+    );
+    Log_Debug3_T("started=" << started);
+    return started;
+}
+
+
+bool mdn::gui::Project::internal_parallelFor(
+    const QString& label,
+    int n,
+    std::function<void(int)> job,
+    std::function<void()> finished
+) {
+    Log_Debug3_H("label=" << label.toStdString() << ", n=" << n);
+    if (m_bulkBusy) {
+        Log_Warn("Bulk job '" << label.toStdString() << "' refused, another is running");
+        Log_Debug3_T("Busy");
+        return false;
+    }
+    if (n <= 0) {
+        if (finished) {
+            finished();
+        }
+        Log_Debug3_T("Nothing to do");
+        return true;
+    }
+    m_bulkBusy = true;
+    emit bulkStarted(label);
+    emit bulkProgress(label, 0, n);
+
+    // The whole loop is a pool task, and the gui thread goes back to the event loop.  Tabs are
+    //  changed through their locking interface, and the window disables editing until
+    //  bulkFinished, so nothing reads or writes a tab mid-change.
+    ThreadPool& pool = ThreadPool::shared();
+    m_bulkJob = pool.submit(
+        [this, &pool, label, n, job = std::move(job), finished = std::move(finished)]() {
+            std::atomic<int> done(0);
+            std::exception_ptr error;
+            try {
+                pool.parallelFor(
+                    0,
+                    n,
+                    [this, &job, &done, &label, n](int i0, int i1) {
+                        for (int i = i0; i < i1; ++i) {
+                            job(i);
+                            emit bulkProgress(label, ++done, n);
+                        }
+                    }
+                );
+            } catch (...) {
+                error = std::current_exception();
+            }
+            QMetaObject::invokeMethod(
+                this,
+                [this, label, n, finished, error]() {
+                    internal_bulkComplete(label, n, finished, error);
+                },
+                Qt::QueuedConnection
+            );
+        }
+    );
+    Log_Debug3_T("Started");
+    return true;
+}
+
+
+void mdn::gui::Project::internal_bulkComplete(
+    const QString& label,
+    int n,
+    const std::function<void()>& finished,
+    std::exception_ptr error
+) {
+    Log_Debug3_H("label=" << label.toStdString());
+    m_bulkBusy = false;
+    if (m_bulkJob.valid()) {
+        m_bulkJob.get();
+    }
+    QString message;
+    if (error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            message = QString::fromStdString(e.what());
+        } catch (...) {
+            message = "unknown error";
+        }
+        Log_Error("Bulk job '" << label.toStdString() << "' failed: " << message.toStdString());
+    } else if (finished) {
+        finished();
+    }
+    emit bulkProgress(label, n, n);
+    emit bulkFinished(label, message);
+    Log_Debug3_T("");
+}
+
+
+void mdn::gui::Project::internal_applyConfig(const Mdn2dConfig& config) {
+    // Sign convention changes run a full carryover cleanup, and precision changes purge digits,
+    //  each tab is independent, so they are spread across the thread pool
+    parallelForEachMdn(
+        "Applying config",
+        [config](int, Mdn2d& tgt) { tgt.setConfig(config); },
+        [this, config]() {
+            m_config = config;
+            Log_Debug("Changed config to " << config);
+        }
+    );
+}
+
+
 void mdn::gui::Project::setConfig(Mdn2dConfig config, bool ignoreSignConventionChanges) {
     Log_Debug2_H("config=" << config);
+    if (m_bulkBusy) {
+        Log_Warn("Config change refused while a bulk job changes the tabs");
+        Log_Debug2_T("Busy");
+        return;
+    }
     // Ensure parent is set correctly
     config.setParent(*this);
     m_name = config.parentName();
@@ -370,10 +515,7 @@ void mdn::gui::Project::setConfig(Mdn2dConfig config, bool ignoreSignConventionC
             );
 
             if (reply == QMessageBox::Yes) {
-                for (auto& [index, tgt] : m_data) {
-                    tgt.setConfig(config);
-                }
-                m_config = config;
+                internal_applyConfig(config);
                 Log_Debug(
                     "Changing config to: " << config << ", impact: "
                         << Mdn2dConfigImpactToName(impact)
@@ -392,11 +534,8 @@ void mdn::gui::Project::setConfig(Mdn2dConfig config, bool ignoreSignConventionC
         }
         case Mdn2dConfigImpact::PossiblePolymorphism: {
             if (ignoreSignConventionChanges) {
-                for (auto& [index, tgt] : m_data) {
-                    tgt.setConfig(config);
-                }
-                m_config = config;
-                Log_Debug("Ignoring changed signConvention - Changed config to " << config);
+                internal_applyConfig(config);
+                Log_Debug("Ignoring changed signConvention - Changing config to " << config);
                 Log_Debug2_T("");
                 return;
             }
@@ -419,10 +558,7 @@ void mdn::gui::Project::setConfig(Mdn2dConfig config, bool ignoreSignConventionC
             );
 
             if (reply == QMessageBox::Yes) {
-                for (auto& [index, tgt] : m_data) {
-                    tgt.setConfig(config);
-                }
-                m_config = config;
+                internal_applyConfig(config);
                 Log_Debug(
                     "Changing config to: " << config << ", impact: "
                         << Mdn2dConfigImpactToName(impact)
@@ -924,6 +1060,7 @@ void mdn::gui::Project::insertMdn(Mdn2d&& mdn, int index) {
     Log_Debug2("Inserting {'" << newName << "'," << index << "} into data");
     m_data.try_emplace(index, std::move(mdn));
     Mdn2d& newEntry = m_data[index];
+    newEntry.enableJournal();
     Log_Debug2("Inserting {'" << newName << "'," << index << "} into indices");
     m_addressingNameToIndex.insert({newName, index});
     m_addressingIndexToName.insert({index, newName});
@@ -1347,6 +1484,39 @@ std::unique_ptr<mdn::gui::Project> mdn::gui::Project::loadFromFile(
 
 
 void mdn::gui::Project::saveBinary(std::ostream& out) const {
+    saveBinary(snapshot(), out);
+}
+
+
+mdn::gui::Project::Snapshot mdn::gui::Project::snapshot() const {
+    Snapshot snap;
+    snap.name = m_name;
+    snap.config = m_config;
+    snap.activeIndex = m_activeIndex;
+
+    // We persist tabs in ascending gui index to be stable/readable
+    // We also store each tab's name explicitly from addressing maps.
+    // (Project rebuilds addressing when inserting/appending.)
+    std::vector<int> indices;
+    indices.reserve(m_data.size());
+    for (const auto& kv : m_data) indices.push_back(kv.first);
+    std::sort(indices.begin(), indices.end());
+
+    snap.tabs.reserve(indices.size());
+    snap.mdns.reserve(indices.size());
+    for (int idx : indices) {
+        auto itName = m_addressingIndexToName.find(idx);
+        std::string tabName = (itName != m_addressingIndexToName.end()) ? itName->second
+                                                                        : std::string{};
+        snap.tabs.emplace_back(idx, std::move(tabName));
+        const Mdn2d& src = m_data.at(idx);
+        snap.mdns.emplace_back(src, src.name());
+    }
+    return snap;
+}
+
+
+void mdn::gui::Project::saveBinary(const Snapshot& snap, std::ostream& out) {
     // Magic + version so we can evolve: "MDNPRJ"
     const char magic[8] = {'M','D','N','P','R','J','\0','\0'};
     out.write(magic, 8);
@@ -1354,43 +1524,49 @@ void mdn::gui::Project::saveBinary(std::ostream& out) const {
     GuiTools::binaryWrite(out, version);
 
     // Name
-    GuiTools::binaryWriteString(out, m_name);
+    GuiTools::binaryWriteString(out, snap.name);
 
     // Global config (store the 5 knobs your dialog manipulates)
     // base, precision, signConvention, fraxisCascadeDepth, fraxis
-    GuiTools::binaryWrite(out, static_cast<int32_t>(m_config.base()));
-    GuiTools::binaryWrite(out, static_cast<int32_t>(m_config.precision()));
-    GuiTools::binaryWrite(out, static_cast<int32_t>(static_cast<int>(m_config.signConvention())));
-    GuiTools::binaryWrite(out, static_cast<int32_t>(m_config.fraxisCascadeDepth()));
-    GuiTools::binaryWrite(out, static_cast<int32_t>(static_cast<int>(m_config.fraxis())));
+    const Mdn2dConfig& config = snap.config;
+    GuiTools::binaryWrite(out, static_cast<int32_t>(config.base()));
+    GuiTools::binaryWrite(out, static_cast<int32_t>(config.precision()));
+    GuiTools::binaryWrite(out, static_cast<int32_t>(static_cast<int>(config.signConvention())));
+    GuiTools::binaryWrite(out, static_cast<int32_t>(config.fraxisCascadeDepth()));
+    GuiTools::binaryWrite(out, static_cast<int32_t>(static_cast<int>(config.fraxis())));
 
     // Active tab index
-    GuiTools::binaryWrite(out, static_cast<int32_t>(m_activeIndex));
-    Log_Debug4("Got activeIndex=" << m_activeIndex);
+    GuiTools::binaryWrite(out, static_cast<int32_t>(snap.activeIndex));
+    Log_Debug4("Got activeIndex=" << snap.activeIndex);
 
     // Count
-    const uint32_t count = static_cast<uint32_t>(m_data.size());
+    const uint32_t count = static_cast<uint32_t>(snap.mdns.size());
     GuiTools::binaryWrite(out, count);
 
-    // We persist tabs in ascending gui index to be stable/readable
-    // We also store each tab's name explicitly from addressing maps.
-    // (Project rebuilds addressing when inserting/appending.)
-    std::vector<int> indices; indices.reserve(count);
-    indices.reserve(count);
-    for (const auto& kv : m_data) indices.push_back(kv.first);
-    std::sort(indices.begin(), indices.end());
+    // Encode the tab payloads in parallel, then write them in order.  Encoding is quick next to a
+    //  bulk job, so this waits for it, with the calling thread encoding too.
+    std::vector<std::string> payloads(snap.mdns.size());
+    ThreadPool::shared().parallelFor(
+        0,
+        static_cast<int>(snap.mdns.size()),
+        [&snap, &payloads](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                std::ostringstream oss(std::ios::binary);
+                snap.mdns[i].saveBinary(oss);
+                payloads[i] = oss.str();
+            }
+        }
+    );
 
-    for (int idx : indices) {
+    for (std::size_t i = 0; i < snap.mdns.size(); ++i) {
+        const auto& [idx, tabName] = snap.tabs[i];
         // Tab header
         GuiTools::binaryWrite(out, static_cast<int32_t>(idx));
-        auto itName = m_addressingIndexToName.find(idx);
-        std::string tabName = (itName != m_addressingIndexToName.end()) ? itName->second
-                                                                        : std::string{};
         GuiTools::binaryWriteString(out, tabName);
 
         // Payload
-        const Mdn2d& num = m_data.at(idx);
-        num.saveBinary(out);  // <<=== call into Mdn2d's binary saver
+        out.write(payloads[i].data(), static_cast<std::streamsize>(payloads[i].size()));
+        std::string().swap(payloads[i]);
         if (!out) {
             Log_ErrorQ("Failed while writing Mdn2d payload for tab " << idx);
             return;
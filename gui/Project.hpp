@@ -1,5 +1,8 @@
 #pragma once
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -56,6 +59,12 @@ protected:
     // Current active tab data
     mutable int m_activeIndex;
 
+    // True while a bulk per-tab job runs on the thread pool, gui thread only
+    bool m_bulkBusy = false;
+
+    // The running bulk job, waited on by the destructor
+    std::future<void> m_bulkJob;
+
 
     // *** Protected member functions
 
@@ -74,8 +83,43 @@ protected:
     // Consider using indexOfMdn - checkName defers to that one anyway
     bool checkName(const std::string& name) const;
 
+    // Start job(i) for i in [0, n) on the shared ThreadPool and return straight away, the event
+    //  loop keeps running.  bulkStarted is emitted first, then bulkProgress as jobs complete, from
+    //  the pool's threads.  Completion comes back to the gui thread as a queued call: finished()
+    //  runs there if no job threw, then bulkFinished is emitted.  Jobs must change tabs only
+    //  through their public, locking, interface.  Returns false if a bulk job is already running.
+    bool internal_parallelFor(
+        const QString& label,
+        int n,
+        std::function<void(int)> job,
+        std::function<void()> finished
+    );
+
+    // Completion of internal_parallelFor, on the gui thread
+    void internal_bulkComplete(
+        const QString& label,
+        int n,
+        const std::function<void()>& finished,
+        std::exception_ptr error
+    );
+
+    // Apply config to every Mdn2d tab in parallel, m_config is set when all tabs are done
+    void internal_applyConfig(const Mdn2dConfig& config);
+
 public:
 
+    // Everything saveBinary writes, copied so it can be encoded on another thread.  The numbers
+    //  share their digits with the tabs until either side changes them, so taking one is cheap.
+    struct Snapshot {
+        std::string name;
+        Mdn2dConfig config;
+        int activeIndex = 0;
+        // Tab index and name of each number, in ascending index
+        std::vector<std::pair<int, std::string>> tabs;
+        std::vector<Mdn2d> mdns;
+    };
+
+
     // *** Constructors
 
     // Construct a project given its name and the number of empty Mdns to start with
@@ -84,11 +128,24 @@ public:
     // Construct a project given config
     Project(MainWindow* parent, Mdn2dConfig& cfg, int nStartMdn);
 
+    // Waits for any bulk job still running
+    ~Project();
+
 signals:
     void tabsAboutToChange();
     void tabsChanged(int currentIndex);
     void mdnContentChanged();
 
+    // A bulk per-tab job has started, the tabs must not be edited until bulkFinished
+    void bulkStarted(const QString& label);
+
+    // Progress of a bulk per-tab job: 'done' of 'total' tabs are complete.  Emitted from pool
+    //  threads, so receivers on the gui thread get it queued.
+    void bulkProgress(const QString& label, int done, int total);
+
+    // A bulk per-tab job has finished, error is empty on success
+    void bulkFinished(const QString& label, const QString& error);
+
 public:
 
 
@@ -170,9 +227,25 @@ public:
         // Assess the impact of changing the config to the given value
         Mdn2dConfigImpact assessConfigChange(Mdn2dConfig config) const;
 
-        // Setter for m_config requires resetting of the Mdn2d's
+        // Setter for m_config requires resetting of the Mdn2d's.  Changes that touch digits run
+        //  as a bulk job, and m_config changes when it finishes.  Ignored while a bulk job runs.
         void setConfig(Mdn2dConfig config, bool ignoreSignConvention=false);
 
+        // Start job(index, mdn) on every Mdn2d tab, in parallel, returning straight away.  Jobs
+        //  for different tabs must be independent.  finished() runs on the gui thread once every
+        //  tab is done.  Progress and completion are reported by the bulk signals, using the
+        //  given label.  Returns false, doing nothing, if a bulk job is already running.
+        bool parallelForEachMdn(
+            const QString& label,
+            std::function<void(int, Mdn2d&)> job,
+            std::function<void()> finished = {}
+        );
+
+        // True while a bulk job runs, the tabs are being changed by the thread pool
+        inline bool bulkBusy() const {
+            return m_bulkBusy;
+        }
+
 
         // *** MDN Accessors
 
@@ -376,6 +449,12 @@ public:
 
         // Lower-level (stream) variants, handy for unit tests
         void saveBinary(std::ostream& out) const;
+
+        // Copy of the project for a later saveBinary, gui thread only
+        Snapshot snapshot() const;
+
+        // Writes snapshot as saveBinary would have when it was taken, safe on any thread
+        static void saveBinary(const Snapshot& snapshot, std::ostream& out);
         static std::unique_ptr<Project> loadBinary(MainWindow* parent, std::istream& in);
 
 
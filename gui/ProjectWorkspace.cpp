@@ -0,0 +1,47 @@
+#include "ProjectWorkspace.hpp"
+
+#include <mdn/Logger.hpp>
+#include <mdn/MdnException.hpp>
+
+
+mdn::gui::ProjectWorkspace::ProjectWorkspace(Project& project) :
+    m_project(project)
+{}
+
+
+mdn::Mdn2dConfig mdn::gui::ProjectWorkspace::config() const {
+    return m_project.config();
+}
+
+
+void mdn::gui::ProjectWorkspace::setConfig(const Mdn2dConfig& config) {
+    m_project.setConfig(config);
+}
+
+
+mdn::Mdn2d* mdn::gui::ProjectWorkspace::find(const std::string& name) {
+    return m_project.getMdn(name);
+}
+
+
+mdn::Mdn2d& mdn::gui::ProjectWorkspace::obtain(const std::string& name) {
+    Log_Debug3_H("name=" << name);
+    Mdn2d* num = m_project.getMdn(name);
+    if (!num) {
+        Log_Debug3("Appending new tab");
+        m_project.appendMdn(Mdn2d::NewInstance(m_project.config(), name));
+        num = m_project.getMdn(name);
+    }
+    if (!num) {
+        InvalidState err("Failed to create tab '" + name + "'");
+        Log_Error(err.what());
+        throw err;
+    }
+    Log_Debug3_T("");
+    return *num;
+}
+
+
+std::vector<std::string> mdn::gui::ProjectWorkspace::names() const {
+    return m_project.toc();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dConfig.hpp>
+#include <mdn/ScriptEngine.hpp>
+
+#include "Project.hpp"
+
+namespace mdn {
+namespace gui {
+
+// Lets the ScriptEngine run statements over a project's tabs - numbers are tabs, by name, and
+//  new numbers are appended as new tabs.  Not thread-safe, run the engine serially.
+class ProjectWorkspace : public ScriptWorkspace {
+
+    // The project holding the tabs
+    Project& m_project;
+
+
+public:
+
+    explicit ProjectWorkspace(Project& project);
+
+    Mdn2dConfig config() const override;
+
+    // Goes through Project::setConfig, so the user is asked before digits are lost
+    void setConfig(const Mdn2dConfig& config) override;
+
+    Mdn2d* find(const std::string& name) override;
+    Mdn2d& obtain(const std::string& name) override;
+    std::vector<std::string> names() const override;
+
+};
+
+} // end namespace gui
+} // end namespace mdn
@@ -1,9 +1,12 @@
 #include <QApplication>
+#include <QMessageBox>
 
 #include <mdn/Logger.hpp>
 #include <mdn/Mdn2dConfig.hpp>
+#include <mdn/ResultCache.hpp>
 
 #include "mdn_config.h"
+#include "Autosave.hpp"
 #include "QtLoggingBridge.hpp"
 #include "LoggerConfigurator.hpp"
 #include "MainWindow.hpp"
@@ -15,8 +18,38 @@ using namespace mdn::gui;
 
 // One iteration of WelcomeDialog --> RunApplication
 bool runLauncher(QApplication& app) {
-    // Show launcher first
     Log_Debug2_H("");
+
+    // Unsaved projects left behind by an abnormal exit
+    const QStringList orphans = Autosave::orphans();
+    if (!orphans.isEmpty()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            nullptr,
+            "Recover Project",
+            "MDN Research did not close normally last time.\n\n"
+            "Recover the unsaved project?",
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::Yes
+        );
+        if (reply == QMessageBox::Yes) {
+            mdn::gui::MainWindow mainApp;
+            mainApp.show();
+            if (mainApp.recoverProject(orphans.front())) {
+                mainApp.centreView(0);
+                bool result = (app.exec() == 0);
+                Log_Debug2_T("result=" << result);
+                return result;
+            }
+            // Unreadable, do not ask again
+            Autosave::discard(orphans.front().toStdString());
+        } else {
+            for (const QString& basePath : orphans) {
+                Autosave::discard(basePath.toStdString());
+            }
+        }
+    }
+
+    // Show launcher first
     WelcomeDialog launcher;
     const int rc = launcher.exec();
     const auto choice = launcher.choice();
@@ -119,6 +152,9 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    // Interactive sessions repeat operations, e.g. redoing a division after an undo
+    ResultCache::shared().setBudget(std::size_t(256) << 20);
+
     bool dontStop = true;
 
     while (dontStop) {
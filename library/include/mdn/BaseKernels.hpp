@@ -0,0 +1,106 @@
+#pragma once
+
+// Base kernels
+//  Digit arithmetic with the base known at compile time.  Carries divide by the base, and a
+//  runtime divisor costs an integer division per digit.  A FixedBase<B> kernel lets the compiler
+//  use multiply-high for the division, and power-of-two bases use shifts and masks.  Other bases
+//  fall back to RuntimeBase, which behaves the same with the divisor read from the config.
+//
+//  Dispatch once per operation, not per digit:
+//
+//      static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+//          for (...) { carry = kernel.carry(sum); rem = kernel.rem(sum); ... }
+//      });
+//
+//  carry and rem match C++ / and % - they truncate toward zero, so rem has the sign of the sum.
+
+#include <utility>
+
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+template <int Base>
+struct FixedBase {
+
+    static_assert(Base >= 2, "Base must be at least 2");
+
+    static constexpr bool isPowerOfTwo = (Base & (Base - 1)) == 0;
+
+    // log2(Base), only meaningful when isPowerOfTwo
+    static constexpr int shift = []() {
+        int s = 0;
+        while ((1 << s) < Base) {
+            ++s;
+        }
+        return s;
+    }();
+
+    constexpr int base() const { return Base; }
+
+    // sum / Base
+    constexpr long long carry(long long sum) const {
+        if constexpr (isPowerOfTwo) {
+            // Bias negative sums by Base-1 so the arithmetic shift truncates toward zero
+            const long long bias = (sum >> 63) & static_cast<long long>(Base - 1);
+            return (sum + bias) >> shift;
+        } else {
+            return sum / Base;
+        }
+    }
+
+    // sum % Base
+    constexpr long long rem(long long sum) const {
+        if constexpr (isPowerOfTwo) {
+            return sum - (carry(sum) << shift);
+        } else {
+            return sum % Base;
+        }
+    }
+
+    // True when value is a valid digit, i.e. within +/- (Base-1)
+    constexpr bool isDigit(long long value) const {
+        return value < Base && value > -Base;
+    }
+
+};
+
+
+// Fallback for bases without a FixedBase kernel
+struct RuntimeBase {
+
+    int m_base;
+
+    constexpr int base() const { return m_base; }
+
+    constexpr long long carry(long long sum) const { return sum / m_base; }
+
+    constexpr long long rem(long long sum) const { return sum % m_base; }
+
+    constexpr bool isDigit(long long value) const {
+        return value < m_base && value > -m_base;
+    }
+
+};
+
+
+// Calls fn(kernel) with the kernel for base, and returns its result
+template <class Fn>
+decltype(auto) static_dispatchBase(int base, Fn&& fn) {
+    switch (base) {
+        case 2:
+            return std::forward<Fn>(fn)(FixedBase<2>{});
+        case 8:
+            return std::forward<Fn>(fn)(FixedBase<8>{});
+        case 10:
+            return std::forward<Fn>(fn)(FixedBase<10>{});
+        case 16:
+            return std::forward<Fn>(fn)(FixedBase<16>{});
+        case 32:
+            return std::forward<Fn>(fn)(FixedBase<32>{});
+        default:
+            return std::forward<Fn>(fn)(RuntimeBase{base});
+    }
+}
+
+} // end namespace mdn
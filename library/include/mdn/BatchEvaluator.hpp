@@ -0,0 +1,114 @@
+#pragma once
+
+// Batch evaluator
+//  Evaluates many small, independent operations in one call, e.g. a parameter sweep of products
+//  over operand pairs:
+//
+//      BatchEvaluator batch(config);
+//      const std::vector<BatchResult>& out = batch.evaluate(BatchOperation::Multiply, pairs);
+//      for (const BatchResult& r : out) { ... r.value, r.seconds ... }
+//
+//  Items run in parallel on a ThreadPool, idle threads claim the next chunk of items as they
+//  finish, so uneven items (a slow quotient among quick sums) balance out.  Result numbers are
+//  created once and reused by later calls, each item on fresh digit storage.  They have a fixed
+//  name, so no item pays for framework naming, and items skip the per-operation locking of the
+//  public Mdn2d interface.
+//
+//  Rules:
+//      * Operands must not be modified while evaluate runs, they are read without locks
+//      * The same operand may appear in any number of pairs
+//      * One evaluate at a time per BatchEvaluator - results are overwritten by the next call
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mdn/Fraxis.hpp>
+#include <mdn/GlobalConfig.hpp>
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dConfig.hpp>
+#include <mdn/ThreadPool.hpp>
+
+namespace mdn {
+
+enum class BatchOperation {
+    Plus,
+    Minus,
+    Multiply,
+    Divide
+};
+
+
+// The outcome of one item
+struct MDN_API BatchResult {
+
+    // The result of the operation, owned and reused by the BatchEvaluator
+    Mdn2d value;
+
+    // Divide only, the remainder and its magnitude, remMag is negative when the division failed
+    Mdn2d remainder;
+    long double remMag = 0.0;
+
+    // False when the item threw, error holds the message
+    bool ok = true;
+    std::string error;
+
+    // Wall time spent on the item
+    double seconds = 0.0;
+
+    BatchResult(const Mdn2dConfig& config);
+
+};
+
+
+class MDN_API BatchEvaluator {
+
+    // Configuration for the result numbers
+    Mdn2dConfig m_config;
+
+    // Runs the items
+    ThreadPool& m_pool;
+
+    // Result slots of the last batch, reused by the next
+    std::vector<BatchResult> m_results;
+
+
+public:
+
+    // Operand pairs, lhs op rhs
+    using Pairs = std::vector<std::pair<const Mdn2d*, const Mdn2d*>>;
+
+
+    // *** Constructors
+
+        // Construct, results use config, items run on pool
+        BatchEvaluator(const Mdn2dConfig& config, ThreadPool& pool=ThreadPool::shared());
+
+
+    // *** Member Functions
+
+        // Evaluates op on every pair, result i = *pairs[i].first op *pairs[i].second, and
+        //  returns the results.  Divide uses fraxis.  An item that throws, or has a null
+        //  operand, leaves ok false and its message in error, the rest of the batch still runs.
+        const std::vector<BatchResult>& evaluate(
+            BatchOperation op, const Pairs& pairs, Fraxis fraxis=Fraxis::Default
+        );
+
+        // Results of the last batch
+        const std::vector<BatchResult>& results() const { return m_results; }
+
+        // Configuration of the results
+        const Mdn2dConfig& config() const { return m_config; }
+
+        // Change the configuration of future results, drops the result slots
+        void setConfig(const Mdn2dConfig& config);
+
+
+private:
+
+    // Evaluates item i into m_results[i]
+    void internal_evaluate(BatchOperation op, const Pairs& pairs, int i, Fraxis fraxis);
+
+};
+
+} // end namespace mdn
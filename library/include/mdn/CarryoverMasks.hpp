@@ -0,0 +1,76 @@
+#pragma once
+
+// Carryover masks
+//  Output of the row carryover classification kernel, Mdn2dRules::static_checkCarryoverRow.  A row
+//  segment of n digits is classified in one pass, and each Carryover type gets a bitmask with one
+//  bit per digit position:
+//
+//      bit (i % 64) of word (i / 64) is set when position i has that carryover type
+//
+//  Positions with no bits set in any of the masks are Carryover::Invalid.
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+struct MDN_API CarryoverMasks {
+
+    // Number of digit positions held by each mask word
+    static constexpr int wordBits = 64;
+
+    // Number of words required to hold n digit positions
+    static int nWords(int n) {
+        return (n + wordBits - 1) / wordBits;
+    }
+
+    // Position of the lowest set bit in a non-zero word
+    static int lowestBit(uint64_t word) {
+        #if defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanForward64(&idx, word);
+            return static_cast<int>(idx);
+        #else
+            return __builtin_ctzll(word);
+        #endif
+    }
+
+    // Call fn(i) for each position i set in the given mask
+    template <class Function>
+    static void forEachSet(const std::vector<uint64_t>& mask, Function fn) {
+        const int nw = static_cast<int>(mask.size());
+        for (int w = 0; w < nw; ++w) {
+            uint64_t word = mask[w];
+            while (word) {
+                fn(w*wordBits + lowestBit(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // Abs(p) exceeds the base, or p is opposite in sign to both axial digits
+    std::vector<uint64_t> required;
+
+    // p is positive, and exactly one axial digit is negative
+    std::vector<uint64_t> optionalPositive;
+
+    // p is negative, and exactly one axial digit is positive
+    std::vector<uint64_t> optionalNegative;
+
+    // Size the masks for n digit positions, all cleared
+    void reset(int n) {
+        const int nw = nWords(n);
+        required.assign(nw, 0);
+        optionalPositive.assign(nw, 0);
+        optionalNegative.assign(nw, 0);
+    }
+
+};
+
+} // end namespace mdn
@@ -0,0 +1,182 @@
+#pragma once
+
+// Change log
+//  Write-ahead log for crash recovery.  A snapshot of the whole document, plus an append-only log
+//  of the digit changes made since, both kept beside a base path:
+//
+//      <base>.autosave     snapshot, opaque bytes supplied by the owner (e.g. an MDNPRJ file)
+//      <base>.wal          records, one per completed operation
+//
+//  Appends are queued and written by a worker thread, so the caller never waits on the disk, and a
+//  snapshot can be encoded there too, so it need not wait on serialising either.
+//  compact replaces the snapshot and empties the log, in queue order, so every record lands in
+//  exactly one of the two.  After an abnormal exit, load the snapshot and replay the log onto it.
+//  A clean shutdown calls discard, so leftover files mean the last session did not end well.
+//
+//  Both files start with a magic and a generation, bumped by each compact.  The snapshot is
+//  replaced before the log is emptied, and a log is only replayed onto the snapshot of its own
+//  generation, so a crash part way through compacting never replays stale records.  Each record
+//  is checksummed, replay stops at the first torn or damaged record:
+//      uint32 payload bytes, uint32 checksum, payload
+//      payload: uint32 name length, name, uint32 n, n * (int32 x, int32 y, int8 digit)
+//  Records are flushed to the operating system as they are written, which survives the program
+//  crashing, but not the machine.
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <mdn/DigitJournal.hpp>
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+class MDN_API ChangeLog {
+
+public:
+
+    using Writes = DigitJournal::Writes;
+
+    // Receives each record on replay: the name of the number, and its new digits
+    using ReplayFn = std::function<void(const std::string& name, const Writes& writes)>;
+
+    // Produces snapshot bytes, called on the worker thread
+    using EncodeFn = std::function<std::string()>;
+
+
+private:
+
+    // One queued write, a record, or a snapshot when isSnapshot - given as bytes, or by encode
+    struct Job {
+        bool isSnapshot = false;
+        std::string name;
+        Writes writes;
+        std::string snapshot;
+        EncodeFn encode;
+    };
+
+    // Base path, files are this plus an extension
+    std::string m_basePath;
+
+    // The open log, written by the worker only
+    std::FILE* m_file;
+
+    // Generation of the open log, worker thread only
+    std::uint64_t m_generation;
+
+    // Jobs waiting for the worker
+    std::deque<Job> m_jobs;
+
+    // Guards everything below
+    mutable std::mutex m_mutex;
+
+    // Signals the worker when a job arrives, or when stopping
+    std::condition_variable m_condition;
+
+    // Signals waiters when the queue drains
+    std::condition_variable m_drained;
+
+    // True while the worker holds a job taken from m_jobs
+    bool m_busy;
+
+    // When true, the worker finishes the queue and exits
+    bool m_stopping;
+
+    // Bytes written to the log since the last snapshot
+    std::size_t m_logBytes;
+
+    // Set when a write fails, autosave is then best effort
+    bool m_failed;
+
+    // Writes m_jobs in order
+    std::thread m_worker;
+
+
+public:
+
+    // File paths for a base path
+    static std::string static_logPath(const std::string& basePath);
+    static std::string static_snapshotPath(const std::string& basePath);
+
+    // True if a snapshot or log exists for basePath, i.e. it was not discarded
+    static bool static_exists(const std::string& basePath);
+
+    // Reads the snapshot for basePath into snapshot, returns false if there is none
+    static bool static_readSnapshot(const std::string& basePath, std::string& snapshot);
+
+    // Calls fn for every intact record in the log for basePath, in order, returns the number of
+    //  records replayed
+    static int static_replay(const std::string& basePath, const ReplayFn& fn);
+
+
+    // *** Constructors
+
+        // Starts a fresh log for basePath, replacing any existing one.  Call compact to write the
+        //  first snapshot.
+        ChangeLog(std::string basePath);
+
+        ChangeLog(const ChangeLog&) = delete;
+        ChangeLog& operator=(const ChangeLog&) = delete;
+
+        // Finishes queued writes and stops the worker, leaves the files in place
+        ~ChangeLog();
+
+
+    // *** Member Functions
+
+        const std::string& basePath() const { return m_basePath; }
+
+        // Queues a record of the digits number 'name' now holds at the coords it changed
+        void append(const std::string& name, const Writes& writes);
+
+        // Queues snapshot to replace the current snapshot, emptying the log
+        void compact(std::string snapshot);
+
+        // As above, with the snapshot produced by encode on the worker thread, so the caller
+        //  does not wait for it.  encode must only use data it owns, e.g. copies of the numbers.
+        //  If it throws, the snapshot is not replaced and the log is kept.
+        void compact(EncodeFn encode);
+
+        // Blocks until every queued job is written
+        void flush();
+
+        // Flushes, then removes both files - call on a clean shutdown
+        void discard();
+
+        // Bytes written to the log since the last snapshot
+        std::size_t logBytes() const;
+
+        // True if any write has failed
+        bool failed() const;
+
+
+private:
+
+    // Add a job to the queue and wake the worker
+    void internal_enqueue(Job&& job);
+
+    // Worker thread main loop
+    void internal_workerLoop();
+
+    // Writes one job, worker thread only.  Returns the bytes written, 0 on failure.
+    std::size_t internal_write(const Job& job);
+
+    // Opens the log afresh for m_generation, truncating it.  Worker thread only, once started.
+    bool internal_openLog();
+
+    // Reads the generation from a file header, returns false if the file is missing or not
+    //  of the expected kind
+    static bool static_readHeader(std::FILE* file, const char* magic, std::uint64_t& generation);
+
+    // Checksum of a record payload, FNV-1a
+    static std::uint32_t static_checksum(const char* data, std::size_t size);
+
+};
+
+} // end namespace mdn
@@ -0,0 +1,47 @@
+#pragma once
+
+// Cleanup report
+//  Outcome of a carryover cleanup, see Mdn2dRules::carryoverCleanupWithReport.  A cleanup works in
+//  waves: each wave checks every queued coord once, carrying over those that need it, and the
+//  digits it touches (and their left and lower neighbours, whose carryover status they feed) are
+//  queued for the next wave.
+
+#include <mdn/CleanupStatus.hpp>
+#include <mdn/CoordTypes.hpp>
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+struct MDN_API CleanupReport {
+
+    // How the cleanup finished
+    CleanupStatus status = CleanupStatus::Converged;
+
+    // Number of waves run
+    int waves = 0;
+
+    // Number of carryovers started, cascades within a carryover are not counted separately
+    long long carries = 0;
+
+    // Largest number of coords queued for a single wave
+    int peakWorkingSet = 0;
+
+    // Coords whose digits were changed
+    CoordSet changed;
+
+    // True when the cleanup finished with no carryovers left to do
+    bool converged() const { return status == CleanupStatus::Converged; }
+
+    friend std::ostream& operator<<(std::ostream& os, const CleanupReport& r) {
+        return os
+            << "(" << r.status
+            << ", waves:" << r.waves
+            << ", carries:" << r.carries
+            << ", peak:" << r.peakWorkingSet
+            << ", changed:" << r.changed.size()
+            << ")";
+    }
+
+};
+
+} // end namespace mdn
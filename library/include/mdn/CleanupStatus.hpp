@@ -0,0 +1,57 @@
+#pragma once
+
+// NAMED_ENUM
+// Text flag to indicate this is one of the classes that needs to be replaced with NamedEnum
+
+#include <vector>
+#include <string>
+
+#include <mdn/Logger.hpp>
+
+// CleanupStatus
+//  How a carryover cleanup finished
+
+namespace mdn {
+
+enum class CleanupStatus {
+    Converged,      // No carryovers remain to be done
+    Oscillating,    // A wave repeated an earlier wave's state, carrying on would loop forever
+    IterationLimit  // Ran out of waves, see Mdn2dConfig::maxCleanupWaves
+};
+
+const std::vector<std::string> CleanupStatusNames(
+    {
+        "Converged",
+        "Oscillating",
+        "IterationLimit"
+    }
+);
+
+inline std::string CleanupStatusToName(CleanupStatus cleanupStatus) {
+    int fi = int(cleanupStatus);
+    return CleanupStatusNames[fi];
+}
+
+inline CleanupStatus NameToCleanupStatus(const std::string& name) {
+    for (std::size_t i = 0; i < CleanupStatusNames.size(); ++i) {
+        if (CleanupStatusNames[i] == name) {
+            return static_cast<CleanupStatus>(i);
+        }
+    }
+    std::ostringstream oss;
+    oss << "Invalid CleanupStatus type: " << name << " expecting:" << std::endl;
+    if (CleanupStatusNames.size()) {
+        oss << CleanupStatusNames[0];
+    }
+    for (auto iter = CleanupStatusNames.cbegin() + 1; iter != CleanupStatusNames.cend(); ++iter) {
+        oss << ", " << *iter;
+    }
+    throw std::invalid_argument(oss.str());
+}
+
+inline std::ostream& operator<<(std::ostream& os, const CleanupStatus& s) {
+    os << CleanupStatusToName(s);
+    return os;
+}
+
+} // end namespace mdn
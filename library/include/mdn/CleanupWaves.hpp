@@ -0,0 +1,85 @@
+#pragma once
+
+// Cleanup waves
+//  States of the waves a carryover cleanup has run, see Mdn2dRules::locked_carryoverCleanup.  A
+//  wave's state is its coords, in visiting order, and the pivot, x and y axial digits each coord's
+//  carryover check reads.  A wave that starts from exactly the state of an earlier one will repeat
+//  it, so the cleanup is oscillating.
+//
+//  States are filed by hash, and a matching hash is only a candidate: the states are compared in
+//  full, so a collision never ends a cleanup that would have converged.
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <mdn/Coord.hpp>
+#include <mdn/Digit.hpp>
+
+namespace mdn {
+
+struct CleanupWaves {
+
+    struct State {
+        // Wave coords, in visiting order
+        std::vector<Coord> coords;
+
+        // Pivot, x axial and y axial digit of each coord, three per coord
+        std::vector<Digit> digits;
+
+        bool operator==(const State& rhs) const {
+            return coords == rhs.coords && digits == rhs.digits;
+        }
+    };
+
+    // States seen so far, by hash
+    std::unordered_map<uint64_t, std::vector<State>> seen;
+
+    // FNV-1a style mixing over each coord and its digits
+    static uint64_t static_hash(const State& state) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 1099511628211ull;
+            hash ^= hash >> 29;
+        };
+        for (std::size_t i = 0; i < state.coords.size(); ++i) {
+            const Coord& xy = state.coords[i];
+            mix(static_cast<uint32_t>(xy.x()));
+            mix(static_cast<uint32_t>(xy.y()));
+            mix(
+                uint64_t(static_cast<uint8_t>(state.digits[3*i]))
+              | (uint64_t(static_cast<uint8_t>(state.digits[3*i + 1])) << 8)
+              | (uint64_t(static_cast<uint8_t>(state.digits[3*i + 2])) << 16)
+            );
+        }
+        mix(state.coords.size());
+        return hash;
+    }
+
+    // Records state filed under hash, returns true if an identical state was recorded before
+    bool repeats(uint64_t hash, State&& state) {
+        std::vector<State>& candidates = seen[hash];
+        for (const State& candidate : candidates) {
+            if (candidate == state) {
+                return true;
+            }
+        }
+        candidates.push_back(std::move(state));
+        return false;
+    }
+
+    // As above, hashing state itself
+    bool repeats(State&& state) {
+        const uint64_t hash = static_hash(state);
+        return repeats(hash, std::move(state));
+    }
+
+    // Forget every state
+    void clear() {
+        seen.clear();
+    }
+
+};
+
+} // end namespace mdn
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -210,10 +211,19 @@ inline const Coord& CardinalDirectionToCoord(CardinalDirection cd) {
 namespace std {
     template <>
     struct hash<mdn::Coord> {
+        // Packs both components into 64 bits and mixes them (splitmix64 finaliser).  std::hash<int>
+        //  is the identity on common platforms, so combining x and y with shifts and xor put a
+        //  dense block of digits into a handful of buckets.
         std::size_t operator()(const mdn::Coord& c) const noexcept {
-            std::size_t h1 = std::hash<int>{}(c.x());
-            std::size_t h2 = std::hash<int>{}(c.y());
-            return h1 ^ (h2 << 1);
+            std::uint64_t h =
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.x())) << 32)
+                | static_cast<std::uint32_t>(c.y());
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return static_cast<std::size_t>(h);
         }
     };
 
@@ -0,0 +1,37 @@
+#pragma once
+
+// Density map
+//  A downsampled summary of the digits of a number over a window, for thumbnails and overviews.
+//  The window is divided into cols x rows cells, each covering a near-equal block of coordinates.
+//  A cell holds the fraction of its coordinates with a non-zero digit (density, 0..1), and the
+//  balance of those digits' signs (-1 all negative, +1 all positive, 0 for an empty cell).  Cells
+//  are stored row by row, starting from the top (highest y) row, as the digits are displayed.
+
+#include <cstddef>
+#include <vector>
+
+#include <mdn/Rect.hpp>
+
+namespace mdn {
+
+struct DensityMap {
+
+    // Coordinates summarised, invalid if the map is empty
+    Rect window = Rect::GetInvalid();
+
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<float> density;
+    std::vector<float> balance;
+
+    bool empty() const { return density.empty(); }
+
+    // Index into density and balance of the cell at (col, row), row 0 being the top
+    std::size_t index(int col, int row) const {
+        return static_cast<std::size_t>(row)*cols + col;
+    }
+
+};
+
+} // end namespace mdn
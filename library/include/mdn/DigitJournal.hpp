@@ -0,0 +1,171 @@
+#pragma once
+
+// Digit journal
+//  Undo / redo history of one number, as digit deltas rather than copies.  While a number has a
+//  journal, every digit it changes is noted as (coord, old digit, new digit), a coord touched more
+//  than once keeps its first old and last new digit.  When an operation completes the notes are
+//  sealed into a step, so undo and redo cost the digits that step changed, not the whole number.
+//
+//  Steps are stored compactly, as runs of neighbouring digits along a row:
+//      int32 y, int32 x0, uint32 n, n old digits, n new digits
+//  Steps over spillBytes, and the oldest steps once memory use exceeds the memory budget, are
+//  moved to a temporary file, which is removed when the journal is destroyed.  Dropped steps leave
+//  dead space in the file, it is rewritten with just the live steps once the dead space outgrows
+//  them.  At most maxSteps are kept for undo, the oldest are dropped.
+//
+//  See Mdn2dBase::enableJournal, undo, redo.
+
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mdn/Coord.hpp>
+#include <mdn/Digit.hpp>
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+class MDN_API DigitJournal {
+
+public:
+
+    // Digit writes that apply one step, in either direction
+    using Writes = std::vector<std::pair<Coord, Digit>>;
+
+
+private:
+
+    // One sealed step, either in memory or in the temporary file
+    struct Step {
+        std::vector<char> data;
+        long offset = -1;
+        std::size_t size = 0;
+        std::size_t nDigits = 0;
+
+        bool spilled() const { return offset >= 0; }
+    };
+
+    // Changes since the last seal, coord -> (first old, last new)
+    std::unordered_map<Coord, std::pair<Digit, Digit>> m_pending;
+
+    // Sealed steps, most recent at the back
+    std::deque<Step> m_undo;
+    std::deque<Step> m_redo;
+
+    // Limits
+    std::size_t m_memoryBudget;
+    std::size_t m_spillBytes;
+    std::size_t m_maxSteps;
+
+    // Bytes of step data held in memory, and in the temporary file
+    std::size_t m_memoryBytes;
+    std::size_t m_spilledBytes;
+
+    // Bytes written to the temporary file, live steps and dropped ones
+    std::size_t m_fileBytes;
+
+    // Spilled steps, opened on first use
+    std::FILE* m_file;
+
+    // True while a step is being applied, so its writes are not recorded
+    bool m_applying;
+
+
+public:
+
+    static constexpr std::size_t defaultMemoryBudget = std::size_t(32) << 20;
+    static constexpr std::size_t defaultSpillBytes = std::size_t(1) << 20;
+    static constexpr std::size_t defaultMaxSteps = 256;
+
+
+    // *** Constructors
+
+        DigitJournal(
+            std::size_t memoryBudget=defaultMemoryBudget,
+            std::size_t spillBytes=defaultSpillBytes,
+            std::size_t maxSteps=defaultMaxSteps
+        );
+
+        DigitJournal(const DigitJournal&) = delete;
+        DigitJournal& operator=(const DigitJournal&) = delete;
+
+        // Closes, and so removes, the temporary file
+        ~DigitJournal();
+
+
+    // *** Member Functions
+
+        // Notes that the digit at xy went from oldDigit to newDigit, ignored while applying
+        void record(const Coord& xy, Digit oldDigit, Digit newDigit) {
+            if (m_applying) {
+                return;
+            }
+            auto [it, inserted] = m_pending.try_emplace(xy, oldDigit, newDigit);
+            if (!inserted) {
+                it->second.second = newDigit;
+            }
+        }
+
+        // True if changes are waiting to be sealed
+        bool hasPending() const { return !m_pending.empty(); }
+
+        // Seals the pending changes into an undo step, clearing the redo history.  Returns false,
+        //  and adds nothing, when no digit ended up different.  When given, sealed receives the
+        //  step's new digits, in row order.
+        bool seal(Writes* sealed=nullptr);
+
+        // Undo / redo availability
+        bool canUndo() const { return !m_undo.empty(); }
+        bool canRedo() const { return !m_redo.empty(); }
+        std::size_t undoSize() const { return m_undo.size(); }
+        std::size_t redoSize() const { return m_redo.size(); }
+
+        // Takes the last step for undo, or the last undone step for redo, and fills writes with
+        //  the digits that apply it.  Moves the step to the other history.  Returns false when
+        //  there is no such step.  Bracket the writes with beginApply / endApply.
+        bool takeUndo(Writes& writes);
+        bool takeRedo(Writes& writes);
+
+        // Pauses, and resumes, recording
+        void beginApply() { m_applying = true; }
+        void endApply() { m_applying = false; }
+
+        // Drops all steps and pending changes
+        void clear();
+
+        // Bytes of step data in memory, and in the temporary file
+        std::size_t memoryBytes() const { return m_memoryBytes; }
+        std::size_t spilledBytes() const { return m_spilledBytes; }
+
+        // Size of the temporary file, spilledBytes plus the space left by dropped steps
+        std::size_t fileBytes() const { return m_fileBytes; }
+
+
+private:
+
+    // Encodes the pending changes into step, and their new digits into sealed when given.  Returns
+    //  false if none remain.
+    bool internal_encode(Step& step, Writes* sealed);
+
+    // Fills writes from step, old digits when undoing, new digits otherwise
+    void internal_decode(const Step& step, bool undoing, Writes& writes);
+
+    // Moves step's data to the temporary file, returns false, leaving it in memory, on failure
+    bool internal_spill(Step& step);
+
+    // Spills the oldest in-memory steps until within the memory budget, and drops the oldest
+    //  undo steps beyond maxSteps.  Compacts the temporary file when needed.
+    void internal_enforceLimits();
+
+    // Rewrites the temporary file with only the spilled steps, leaves it as is on failure
+    void internal_compact();
+
+    // Removes step from the byte counts, before it is dropped
+    void internal_forget(const Step& step);
+
+};
+
+} // end namespace mdn
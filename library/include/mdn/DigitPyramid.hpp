@@ -0,0 +1,147 @@
+#pragma once
+
+// Digit pyramid
+//  Multi-resolution summary of a number's digits, for drawing numbers far too large to fetch digit
+//  by digit.  Level L divides the plane into square tiles of tileSize(L) = 4 << L digits, and each
+//  tile records how many non-zero digits it holds, their sign balance, their largest magnitude and
+//  the number of polymorphic nodes among them.  Tiles without digits are not stored, so a sparse
+//  number costs little at any level.  Levels are built on first use, each from the one below.
+//
+//  Once built, the owning Mdn2dBase keeps it in step one digit at a time, see change, at the cost
+//  of one tile update per built level.  Removing a tile's largest digit only marks its
+//  maxMagnitude stale, it is recomputed from the level below, or from the digits, when next read.
+//  Polymorphic nodes depend on the number as a whole, so their counts are replaced in bulk, see
+//  setPolymorphic.
+//
+//  See Mdn2dRules::getOverview.
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <mdn/Coord.hpp>
+#include <mdn/CoordTypes.hpp>
+#include <mdn/Digit.hpp>
+#include <mdn/GlobalConfig.hpp>
+#include <mdn/Rect.hpp>
+
+namespace mdn {
+
+// Summary of one tile
+struct OverviewTile {
+    int nonZero = 0;
+    // Positive digits minus negative digits
+    int balance = 0;
+    int maxMagnitude = 0;
+    int polymorphic = 0;
+};
+
+// Tiles of one level covering a window, row by row from the top (highest y) row, as displayed
+struct Overview {
+    int level = 0;
+    int tileSize = 0;
+
+    // Tile coordinates covered, tile (tx, ty) holds digits tileSize*tx .. tileSize*(tx + 1) - 1
+    //  along x, likewise along y.  Invalid when empty.
+    Rect tiles = Rect::GetInvalid();
+
+    std::vector<OverviewTile> cells;
+
+    int cols() const { return tiles.isValid() ? tiles.width() : 0; }
+    int rows() const { return tiles.isValid() ? tiles.height() : 0; }
+
+    // Index into cells of the tile at (col, row), row 0 being the top
+    std::size_t index(int col, int row) const {
+        return static_cast<std::size_t>(row)*cols() + col;
+    }
+};
+
+
+class MDN_API DigitPyramid {
+
+public:
+
+    // Returns the digit at a coordinate, used to recompute stale maxima at level 0
+    using DigitFn = std::function<Digit(const Coord&)>;
+
+    // Level 0 tiles are 1 << baseShift digits across
+    static constexpr int baseShift = 2;
+
+    // Coarsest level, tiles 2^30 digits across
+    static constexpr int maxLevel = 28;
+
+
+private:
+
+    struct Tile {
+        int nonZero = 0;
+        int positive = 0;
+        int maxMagnitude = 0;
+        // When true, maxMagnitude is an upper bound only
+        bool stale = false;
+    };
+
+    using Level = std::unordered_map<Coord, Tile>;
+    using Counts = std::unordered_map<Coord, int>;
+
+    // Built levels, finest first
+    std::vector<Level> m_levels;
+
+    // Polymorphic node counts per built level, and the event they were set for
+    std::vector<Counts> m_polymorphic;
+    long long m_polymorphicEvent;
+
+
+public:
+
+    // Digits across one tile at level
+    static int static_tileSize(int level) { return 1 << (level + baseShift); }
+
+    // Tile holding xy at level
+    static Coord static_tileOf(const Coord& xy, int level) {
+        const int shift = level + baseShift;
+        return Coord(xy.x() >> shift, xy.y() >> shift);
+    }
+
+    // Finest level at which window spans at most maxCols x maxRows tiles, maxLevel if none does
+    static int static_levelFor(const Rect& window, int maxCols, int maxRows);
+
+
+    // *** Constructors
+
+        // An empty pyramid, feed it the digits with change(xy, 0, digit)
+        DigitPyramid();
+
+
+    // *** Member Functions
+
+        // Notes that the digit at xy went from oldDigit to newDigit
+        void change(const Coord& xy, Digit oldDigit, Digit newDigit);
+
+        // Flips the sign of every digit
+        void negate();
+
+        // Replaces the polymorphic node counts with nodes, found at event
+        void setPolymorphic(const CoordSet& nodes, long long event);
+
+        // Event of the last setPolymorphic, -1 for never
+        long long polymorphicEvent() const { return m_polymorphicEvent; }
+
+        // Number of levels built so far
+        int levels() const { return static_cast<int>(m_levels.size()); }
+
+        // Tiles at level covering window, building the level if needed
+        Overview overview(const Rect& window, int level, const DigitFn& digitAt);
+
+
+private:
+
+    // Builds levels up to and including level
+    void internal_ensureLevel(int level);
+
+    // Brings a stale maxMagnitude up to date, returns it
+    int internal_resolveMax(int level, const Coord& tile, Tile& data, const DigitFn& digitAt);
+
+};
+
+} // end namespace mdn
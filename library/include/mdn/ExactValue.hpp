@@ -0,0 +1,120 @@
+#pragma once
+
+// Exact value
+//  An exact signed value in a given base:
+//
+//      value = mantissa x base^exponent
+//
+//  The mantissa is an arbitrary-precision integer, so the value never overflows or rounds.  Row
+//  and column values of an Mdn2d are built with Horner's method over the sorted non-zero digits,
+//  and compared or summed exactly.  toLongDouble gives the rounded view.
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mdn/Digit.hpp>
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+class MDN_API ExactValue {
+
+    // Base of the exponent
+    int m_base;
+
+    // Power of base that multiplies the mantissa
+    int m_exponent;
+
+    // Sign of the mantissa, false when zero
+    bool m_negative;
+
+    // Mantissa magnitude, little-endian 32-bit limbs, no leading zero limbs, empty when zero
+    std::vector<uint32_t> m_limbs;
+
+
+public:
+
+    // Digit terms of a row or column: (position, digit), in any order
+    using Terms = std::vector<std::pair<int, Digit>>;
+
+    // Sum of digit x base^position over terms, by Horner's method.  Sorts terms.
+    static ExactValue static_fromDigits(int base, Terms& terms);
+
+
+    // *** Constructors
+
+        // Construct zero
+        ExactValue(int base=10);
+
+
+    // *** Member Functions
+
+        int base() const { return m_base; }
+        int exponent() const { return m_exponent; }
+        const std::vector<uint32_t>& limbs() const { return m_limbs; }
+        bool isZero() const { return m_limbs.empty(); }
+
+        // -1, 0 or 1
+        int sign() const { return isZero() ? 0 : (m_negative ? -1 : 1); }
+
+        // Returns |*this|
+        ExactValue abs() const;
+
+        // Change the sign
+        ExactValue& negate();
+
+        // Exact sum
+        //  Exceptions
+        //      * BaseMismatch - rhs has a different base
+        ExactValue& operator+=(const ExactValue& rhs);
+
+        // Compare |*this| with |rhs|, returns -1, 0 or 1
+        //  Exceptions
+        //      * BaseMismatch - rhs has a different base
+        int compareMagnitude(const ExactValue& rhs) const;
+
+        // Compare *this with rhs, returns -1, 0 or 1
+        int compare(const ExactValue& rhs) const;
+
+        // Nearest long double, may be +/- inf or 0 when out of range
+        long double toLongDouble() const;
+
+        // Decimal mantissa with the exponent, e.g. "-1234 x 16^-3"
+        std::string toString() const;
+
+
+private:
+
+    // Approximate log2 of the magnitude, for quick comparisons, *this must not be zero
+    long double internal_log2Estimate() const;
+
+    // Lower the exponent to newExponent, scaling the mantissa up to keep the same value
+    void internal_lowerExponent(int newExponent);
+
+    // Mantissa magnitude operations
+    void internal_mulSmall(uint32_t factor);
+    void internal_addSmall(uint32_t value);
+    void internal_subSmall(uint32_t value);
+    static int static_compareLimbs(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    static void static_addLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    // a -= b, requires |a| >= |b|
+    static void static_subLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    // Strip leading zero limbs, and reset the sign and exponent of zero
+    void internal_normalise();
+
+    // Throws BaseMismatch if rhs has a different base
+    void internal_checkBase(const ExactValue& rhs) const;
+
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ExactValue& v) {
+    os << v.toString();
+    return os;
+}
+
+} // end namespace mdn
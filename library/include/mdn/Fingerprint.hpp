@@ -0,0 +1,73 @@
+#pragma once
+
+// Fingerprint
+//  128-bit hash of the digits of a number.  Digits are folded in by addition, so the order they
+//  are visited in does not matter, and an unordered digit store gives the same fingerprint however
+//  it is laid out.  Equal digits always give equal fingerprints, different digits collide with a
+//  chance of about 2^-128 per pair, so a match still needs a digit comparison to be certain.
+//
+//  Usable as a key, e.g. to spot duplicate numbers or memoize results:
+//      std::unordered_map<Fingerprint, Mdn2d> memo;
+
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+#include <mdn/Coord.hpp>
+
+namespace mdn {
+
+struct Fingerprint {
+
+    std::uint64_t lo = 0;
+    std::uint64_t hi = 0;
+
+    // Folds in digit d at xy
+    void add(const Coord& xy, int d) {
+        const std::uint64_t key =
+            (static_cast<std::uint64_t>(static_cast<std::uint32_t>(xy.x())) << 32)
+            | static_cast<std::uint32_t>(xy.y());
+        const std::uint64_t value = static_cast<std::uint64_t>(static_cast<std::int64_t>(d));
+        lo += mix(key ^ mix(value + 0x9e3779b97f4a7c15ULL));
+        hi += mix(mix(key + 0xd1b54a32d192ed03ULL) ^ (value * 0x8cb92ba72f3d8dd7ULL));
+    }
+
+    bool operator==(const Fingerprint& rhs) const { return lo == rhs.lo && hi == rhs.hi; }
+    bool operator!=(const Fingerprint& rhs) const { return !(*this == rhs); }
+    bool operator<(const Fingerprint& rhs) const {
+        return hi != rhs.hi ? hi < rhs.hi : lo < rhs.lo;
+    }
+
+    // splitmix64 finaliser, see std::hash<Coord>
+    static std::uint64_t mix(std::uint64_t h) {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Fingerprint& f) {
+        std::ios_base::fmtflags flags(os.flags());
+        const char fill = os.fill('0');
+        os << std::hex << std::setw(16) << f.hi << std::setw(16) << f.lo;
+        os.fill(fill);
+        os.flags(flags);
+        return os;
+    }
+
+};
+
+} // end namespace mdn
+
+namespace std {
+    template <>
+    struct hash<mdn::Fingerprint> {
+        // Both halves are already well mixed
+        std::size_t operator()(const mdn::Fingerprint& f) const noexcept {
+            return static_cast<std::size_t>(f.lo ^ (f.hi * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// Line values
+//  Exact values of the rows, or of the columns, of an Mdn2d, kept alongside its digits.  Values
+//  are built on demand.  Once ranked, every non-zero line also sits in the ranking, largest
+//  magnitude first, so the biggest rows or columns are found without assembling them all.
+//
+//  Writers hold the exclusive lock and only note which lines they touch, in dirty.  Readers bring
+//  those lines up to date before use, see Mdn2dBase::internal_refreshLines.
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <mdn/ExactValue.hpp>
+
+namespace mdn {
+
+// Orders (magnitude, line) pairs by descending magnitude, then descending line
+struct LineRankOrder {
+    bool operator()(
+        const std::pair<ExactValue, int>& a, const std::pair<ExactValue, int>& b
+    ) const {
+        const int cmp = a.first.compareMagnitude(b.first);
+        return cmp != 0 ? cmp > 0 : a.second > b.second;
+    }
+};
+
+struct LineValues {
+
+    // Value of each line built so far, non-zero lines only
+    std::map<int, ExactValue> values;
+
+    // (|value|, line) for every line in values, only maintained while ranked
+    std::set<std::pair<ExactValue, int>, LineRankOrder> ranking;
+
+    // True once every non-zero line has its value and rank
+    bool ranked = false;
+
+    // Lines whose digits changed since their values were built, may repeat
+    std::vector<int> dirty;
+
+    // Drop everything
+    void clear() {
+        values.clear();
+        ranking.clear();
+        ranked = false;
+        dirty.clear();
+    }
+
+    // Note a change to line.  Nothing is recorded while nothing is built, and a backlog larger
+    //  than the lines it would save is cheaper to drop.
+    void markDirty(int line) {
+        if (values.empty() && !ranked) {
+            return;
+        }
+        if (dirty.size() >= 4*values.size() + 64) {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            if (dirty.size() >= values.size()) {
+                clear();
+                return;
+            }
+        }
+        dirty.push_back(line);
+    }
+
+    // Change the sign of every value, magnitudes and so the ranking are unaffected
+    void negate() {
+        for (auto& [line, value] : values) {
+            value.negate();
+        }
+    }
+
+};
+
+} // end namespace mdn
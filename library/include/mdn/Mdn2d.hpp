@@ -3,6 +3,7 @@
 #include <mdn/GlobalConfig.hpp>
 #include <mdn/Mdn2dRules.hpp>
 #include <mdn/Mdn2dIO.hpp>
+#include <mdn/ScratchArena.hpp>
 
 namespace mdn {
 
@@ -11,6 +12,15 @@ class Selection;
 // Represents a 2D Multi-Dimensional Number (MDN).
 class MDN_API Mdn2d : public Mdn2dRules {
 
+    // *** Friends
+
+    // Runs many operations without per-operation locking
+    friend class BatchEvaluator;
+
+    // Stores and hands back operation results
+    friend class ResultCache;
+
+
 protected:
 
     // Lazy-evaluation selection
@@ -27,6 +37,10 @@ public:
         // Construct from a configuration
         Mdn2d(Mdn2dConfig config, std::string nameIn="");
 
+        // Construct a scratch number, with storage allocated from the given memory resource
+        //  Must be destroyed before its ScratchArena is reset, see ScratchArena
+        Mdn2d(Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource);
+
 
         // *** Rule of five
 
@@ -83,6 +97,8 @@ public:
             //      * rem - the remainder - caller should initilise this to *this before first
             //          iteration
             //      * remMag - the getTotalMagnitude value of rem
+            //      * fraxis - X, Y, or Default to alternate between them, starting with X on every
+            //          call
             //  Returns the absolute magnitude of rem (abs(rem.getTotalValue), goal is to reach zero
             //  A negative value means division failed
             void divideIterate(
@@ -104,6 +120,35 @@ public:
                 ) const;
             public:
 
+            // Speculative division: runs the X, Y and alternating strategies of divideIterate side
+            //  by side, each on its own copy of ans and rem, for up to nIters iterations.  Each
+            //  strategy remembers the iteration with its smallest remainder magnitude, and the
+            //  best of these is kept: writes its ans, rem and remMag, and returns its fraxis
+            //  (Fraxis::Default for alternating), so the result is never worse than divideIterate
+            //  with Fraxis::Default over nIters.
+            //  The X and Y strategies stop early when they stall - no improvement on their best
+            //  remMag for stallIters iterations - while trailing the best of any strategy.  Once
+            //  any strategy reaches zero, they all stop.
+            //  Returns Fraxis::Invalid, with a negative remMag, if every strategy failed.
+            Fraxis divideSpeculative(
+                int nIters,
+                const Mdn2d& rhs,
+                Mdn2d& ans,
+                Mdn2d& rem,
+                long double& remMag,
+                int stallIters=8
+            ) const;
+            protected:
+                Fraxis locked_divideSpeculative(
+                    int nIters,
+                    const Mdn2d& rhs,
+                    Mdn2d& ans,
+                    Mdn2d& rem,
+                    long double& remMag,
+                    int stallIters
+                ) const;
+            public:
+
 
             // Division: *this / rhs = ans, overwrites ans
             void divide(const Mdn2d& rhs, Mdn2d& ans, Fraxis fraxis=Fraxis::Default) const;
@@ -111,6 +156,15 @@ public:
                 const Mdn2d& rhs, Mdn2d& ans, Fraxis fraxis=Fraxis::Default
             ) const; public:
 
+            // Division: *this / rhs = ans, overwrites ans and rem, rem gets the remainder, and
+            //  remMag its magnitude, negative when division failed
+            void divide(
+                const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, Fraxis fraxis
+            ) const;
+            protected: CoordSet locked_divide(
+                const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, Fraxis fraxis
+            ) const; public:
+
 
         // *** Addition / subtraction
 
@@ -291,12 +345,57 @@ public:
             protected: CoordSet locked_multiply(long long value); public:
 
 
+        // *** Region operations
+        //  Each works on the digits within region only, as if they were a number of their own: they
+        //  are lifted out, transformed and added back, carrying as far beyond region as the result
+        //  needs.  Digits outside region are otherwise untouched, and no copy of the number is
+        //  made.  Adding back is serial, on a large region the parallel work is the cleanup that
+        //  follows, whose large colour classes run on the shared ThreadPool - see carryoverCleanup.
+
+            // Negates the digits within region
+            void negateRegion(const Rect& region);
+            protected: CoordSet locked_negateRegion(const Rect& region); public:
+
+            // Multiplies the digits within region by value
+            void multiplyRegion(const Rect& region, long long value);
+            protected: CoordSet locked_multiplyRegion(const Rect& region, long long value); public:
+
+            // Moves the digits within region by xy, adding them onto any digits already there
+            void shiftRegion(const Rect& region, const Coord& xy);
+            protected: CoordSet locked_shiftRegion(const Rect& region, const Coord& xy); public:
+
+            // Swaps x and y of the digits within region, about region's min corner, adding them
+            //  onto any digits already there
+            void transposeRegion(const Rect& region);
+            protected: CoordSet locked_transposeRegion(const Rect& region); public:
+
+            // Carries over the digits within region that need it under sign convention sc, see
+            //  carryoverCleanup.  Returns the changed coords, which may lie beyond region.
+            CoordSet carryoverCleanupRegion(
+                const Rect& region, SignConvention sc = SignConvention::Invalid
+            );
+            protected: CoordSet locked_carryoverCleanupRegion(
+                const Rect& region, SignConvention sc
+            ); public:
+
+
+        // *** Identity
+
+            // 128-bit hash of the canonical form, shared by every polymorphic state of the same
+            //  number, see Fingerprint.  Kept until the digits or config change.
+            Fingerprint fingerprint() const;
+            protected: Fingerprint locked_fingerprint() const; public:
+
+
     // *** Member Operators
 
         // Equality comparison
         //  The rules layer brings carryovers, allowing us to find equivalence between different
         //  states of polymorphism.  But for now, equivalence only works with a default sign
         //  convention (Mdn2dConfig)
+        //  Configs are compared first, then fingerprints, and only matching fingerprints go on to
+        //  a digit comparison of the canonical forms.  The positive cleanup is not a unique normal
+        //  form, some equal values settle on different digits and still compare unequal.
         bool operator==(const Mdn2d& rhs) const;
 
         // Inequality comparison.
@@ -343,6 +442,13 @@ protected:
             // Apply default to fraxis as required
             void internal_checkFraxis(Fraxis& fraxis) const;
 
+            // Builds the canonical form and fingerprint, unless they are cached.  Caller also holds
+            //  m_valueCacheMutex.
+            void internal_buildCanonical() const;
+
+            // Digits of the canonical form, once built
+            const DigitStore& internal_canonicalRaw() const;
+
             // Execute the fraxis propagation algorithm on a single digit
             //  dX, dY, c - constants to guide propagation:
             //      x Direction: -1, 0, -1
@@ -364,9 +470,37 @@ protected:
             // // plusEquals variant: *this += rhs x scalar, used in mdn x mdn algorithm
             // Mdn2d& internal_plusEquals(const Mdn2d& rhs, int scalar);
 
-            // Creates a copy of *this and performs a multiply and shift, used in mdn x mdn
-            //  return = (*this x value).shift(xy)
-            Mdn2d internal_copyMultiplyAndShift(int value, const Coord& shiftXY) const;
+            // Integer addition at xy with symmetric carryover, all locked_add variants end up here
+            //  Changed coords are added to changed, one set for the whole cascade
+            void internal_add(const Coord& xy, long long value, bool overwrite, CoordSet& changed);
+
+            // internal_add with a base kernel from static_dispatchBase (see BaseKernels.hpp), for
+            //  loops that dispatch once and then add many digits
+            template <class Kernel>
+            void internal_add(
+                const Kernel& kernel,
+                const Coord& xy,
+                long long value,
+                bool overwrite,
+                CoordSet& changed
+            );
+
+            // Multiply the full Mdn2d by an integer in a single row sweep, with the int64 row
+            //  buffers allocated from arena.  0, 1 and -1 take fast paths.
+            CoordSet internal_multiplyScalar(long long value, ScratchArena& arena);
+
+            // Engine for the region operations: lifts the digits within region out of the number,
+            //  then adds each back at place(xy), times factor, with carryover.  Returns the changed
+            //  coords.
+            template <class Place>
+            CoordSet internal_transformRegion(const Rect& region, long long factor, Place place);
+
+            // Copies *this into out and performs a multiply and shift, used in mdn x mdn
+            //  out = (*this x value).shift(xy)
+            //  out is normally a scratch number, with temporaries allocated from arena
+            void internal_copyMultiplyAndShift(
+                int value, const Coord& shiftXY, Mdn2d& out, ScratchArena& arena
+            ) const;
 
             int internal_checkOverwrite(const Coord& xy, bool overwrite) const;
             template <class Type>
@@ -1,20 +1,32 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <mdn/CoordTypes.hpp>
+#include <mdn/DensityMap.hpp>
+#include <mdn/DigitJournal.hpp>
+#include <mdn/DigitPyramid.hpp>
+#include <mdn/ExactValue.hpp>
+#include <mdn/Fingerprint.hpp>
 #include <mdn/GlobalConfig.hpp>
+#include <mdn/LineValues.hpp>
 #include <mdn/LockTracker.hpp>
 #include <mdn/Mdn2dConfig.hpp>
 #include <mdn/Mdn2dConfigImpact.hpp>
 #include <mdn/MdnObserver.hpp>
+#include <mdn/PackedDigits.hpp>
 #include <mdn/PrecisionStatus.hpp>
 #include <mdn/Rect.hpp>
+#include <mdn/RunIndex.hpp>
 #include <mdn/TextOptions.hpp>
 
 namespace mdn {
@@ -22,6 +34,58 @@ namespace mdn {
 class Mdn2d;
 struct TextWriteOptions;
 
+// Allocator-aware storage for digits and addressing, so scratch numbers can draw on a ScratchArena
+using DigitStore = std::pmr::unordered_map<Coord, Digit>;
+using CoordIndexSet = std::pmr::unordered_set<Coord>;
+using CoordIndex = std::pmr::map<int, CoordIndexSet>;
+
+// Digits and addressing of an Mdn2dBase.  Copies of a number share one DigitData, until either of
+//  them writes, see Mdn2dBase::internal_detach.
+struct DigitData {
+
+    // Sparse coordinate-to-digit mapping
+    DigitStore raw;
+
+    // Addressing
+    //  xIndex[x value] = CoordSet of non-zeroes in this column
+    //  yIndex[y value] = Coordset of non-zeroes in this row
+    CoordIndex xIndex;
+    CoordIndex yIndex;
+
+    // Full index
+    CoordIndexSet index;
+
+    // Construct empty, storage allocated from resource
+    DigitData(std::pmr::memory_resource* resource):
+        raw(resource), xIndex(resource), yIndex(resource), index(resource)
+    {}
+
+    // Deep copy of other, storage allocated from resource
+    DigitData(const DigitData& other, std::pmr::memory_resource* resource):
+        raw(other.raw, resource),
+        xIndex(other.xIndex, resource),
+        yIndex(other.yIndex, resource),
+        index(other.index, resource)
+    {}
+
+    // New empty DigitData, the shared block and the storage both allocated from resource
+    static std::shared_ptr<DigitData> NewInstance(std::pmr::memory_resource* resource) {
+        return std::allocate_shared<DigitData>(
+            std::pmr::polymorphic_allocator<DigitData>(resource), resource
+        );
+    }
+
+    // New deep copy of other, allocated from resource
+    static std::shared_ptr<DigitData> Duplicate(
+        const DigitData& other, std::pmr::memory_resource* resource
+    ) {
+        return std::allocate_shared<DigitData>(
+            std::pmr::polymorphic_allocator<DigitData>(resource), other, resource
+        );
+    }
+
+};
+
 // Digit layer of 2d multi dimensional numbers, establishes:
 //  * 2-dimensional digit representation
 //  * sparse storage and addressing
@@ -49,23 +113,19 @@ protected:
 
     // Empty CoordSet for functions that return references, but no reference exists for null
     const CoordSet m_nullCoordSet;
+    const CoordIndexSet m_nullCoordIndexSet;
 
     // *** Data & addressing
 
     // Name of this number
     std::string m_name;
 
-    // Sparse coordinate-to-digit mapping
-    std::unordered_map<Coord, Digit> m_raw;
-
-    // Addressing
-    //  m_xIndex[x value] = CoordSet of non-zeroes in this column
-    //  m_yIndex[y value] = Coordset of non-zeroes in this row
-    mutable std::map<int, CoordSet> m_xIndex;
-    mutable std::map<int, CoordSet> m_yIndex;
+    // Memory resource for the digits and addressing, a ScratchArena's for scratch numbers
+    std::pmr::memory_resource* m_resource;
 
-    // Full index
-    mutable CoordSet m_index;
+    // Digits and addressing, shared with copies of this number until either side writes.  Never
+    //  null.  Anything that changes it calls internal_detach first.
+    mutable std::shared_ptr<DigitData> m_data;
 
     // Observers
     mutable std::unordered_map<int, MdnObserver*> m_observers;
@@ -82,10 +142,37 @@ protected:
         // Event number for tracking derived, demand-driven data
         long long m_event;
 
+        // Exact values, built on demand and kept in step with the digits, see LineValues.  Guarded
+        //  by m_valueCacheMutex, as readers share the lock.
+        mutable std::mutex m_valueCacheMutex;
+        mutable LineValues m_rowValues;
+        mutable LineValues m_colValues;
+        mutable std::optional<ExactValue> m_totalValue;
+        mutable std::optional<ExactValue> m_totalMagnitude;
+
+        // Canonical form - the digits under SignConvention::Positive after a full cleanup - and its
+        //  fingerprint, built on demand by Mdn2d and dropped whenever the digits or config change.
+        //  m_fingerprint is set once built, m_canonical stays null when the digits are already
+        //  canonical.  Also guarded by m_valueCacheMutex.
+        mutable std::shared_ptr<const DigitData> m_canonical;
+        mutable std::optional<Fingerprint> m_fingerprint;
+
+        // Multi-resolution summary of the digits, built on the first overview request and then
+        //  kept in step with each digit change.  Dropped with the value cache, guarded likewise.
+        mutable std::unique_ptr<DigitPyramid> m_pyramid;
+
+        // Runs of non-zero digits along each row and column, for jump.  Lines are indexed on
+        //  first use, see RunIndex, guarded by m_valueCacheMutex.
+        mutable RunIndex m_rowRuns;
+        mutable RunIndex m_colRuns;
+
         // Coordinates that have changed during the current operation (only applicable in overwrite
         //  mode)
         mutable CoordSet m_affected;
 
+        // Undo / redo history, null until enableJournal.  Not copied, see DigitJournal.
+        std::unique_ptr<DigitJournal> m_journal;
+
 
 public:
 
@@ -112,6 +199,11 @@ public:
 
         Mdn2dBase(Mdn2dConfig config, std::string nameIn="");
 
+        // Construct with digits and addressing allocated from the given memory resource
+        //  For scratch numbers, see ScratchArena.  Copies and moves of this number allocate from
+        //  the default resource, so results can safely outlive the arena.
+        Mdn2dBase(Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource);
+
 
         // *** Rule of five
 
@@ -181,12 +273,24 @@ public:
             protected: bool locked_nonZero(const Coord& xy) const; public:
 
             // Returns non-zero coordinates along the given row
-            const CoordSet& nonZeroOnRow(const Coord& xy) const;
-            protected: const CoordSet& locked_nonZeroOnRow(const Coord& xy) const; public:
+            const CoordIndexSet& nonZeroOnRow(const Coord& xy) const;
+            protected: const CoordIndexSet& locked_nonZeroOnRow(const Coord& xy) const; public:
 
             // Returns non-zero coordinates along the given row
-            const CoordSet& nonZeroOnCol(const Coord& xy) const;
-            protected: const CoordSet& locked_nonZeroOnCol(const Coord& xy) const; public:
+            const CoordIndexSet& nonZeroOnCol(const Coord& xy) const;
+            protected: const CoordIndexSet& locked_nonZeroOnCol(const Coord& xy) const; public:
+
+            // Summarises the digits within window as a cols x rows DensityMap, cols and rows are
+            //  limited to the window's size.  Returns an empty map for an invalid window.
+            DensityMap getDensityMap(const Rect& window, int cols, int rows) const;
+            protected: DensityMap locked_getDensityMap(
+                const Rect& window, int cols, int rows
+            ) const; public:
+
+            // Returns the event number, incremented by each completed operation that modifies
+            //  this number.  Compare against a remembered value to spot stale derived data.
+            long long event() const;
+            protected: long long locked_event() const; public:
 
 
         // *** Navigation
@@ -200,6 +304,15 @@ public:
             Coord jump(const Coord& xy, CardinalDirection cd) const;
             protected: Coord locked_jump(const Coord& xy, CardinalDirection cd) const; public:
 
+            // Jumps from each of from in direction cd under a single lock, out[i] is the jump from
+            //  from[i].  For moving a whole selection edge across many rows or columns at once.
+            void jump(
+                const std::vector<Coord>& from, CardinalDirection cd, std::vector<Coord>& out
+            ) const;
+            protected: void locked_jump(
+                const std::vector<Coord>& from, CardinalDirection cd, std::vector<Coord>& out
+            ) const; public:
+
 
         // *** Value Getters
 
@@ -216,6 +329,27 @@ public:
             protected: long double locked_getTotalMagnitude() const; public:
 
 
+        // *** Exact Value Getters
+        //  The long double value getters are views of these.  Values are cached until the digits
+        //  change.
+
+            // Sum of digit x base^x along row y
+            ExactValue getRowExact(int y) const;
+            protected: ExactValue locked_getRowExact(int y) const; public:
+
+            // Sum of digit x base^y along column x
+            ExactValue getColExact(int x) const;
+            protected: ExactValue locked_getColExact(int x) const; public:
+
+            // Sum of all row values
+            ExactValue getTotalExact() const;
+            protected: ExactValue locked_getTotalExact() const; public:
+
+            // Sum of all row absolute values
+            ExactValue getTotalMagnitudeExact() const;
+            protected: ExactValue locked_getTotalMagnitudeExact() const; public:
+
+
         // *** Row Getters
 
             long double getRowValue(const Coord& xy) const;
@@ -248,6 +382,13 @@ public:
             void locked_getRow(const Coord& xy, int width, VecDigit& out) const;
             public:
 
+            // As getRow, but packs the digits as they are gathered, in the packing chosen by the
+            //  base (see PackedDigits.hpp).  out.width is width.
+            void getRowPacked(const Coord& xy, int width, PackedRow& out) const;
+            protected:
+            void locked_getRowPacked(const Coord& xy, int width, PackedRow& out) const;
+            public:
+
             // Write out a continuous range for a rows covering an area from Coord c0 to Coord c1
             //  Returns bounds of output digits
             Rect getAreaRows(VecVecDigit& out) const;
@@ -259,6 +400,20 @@ public:
             void locked_getAreaRows(const Rect& window, VecVecDigit& out) const;
             public:
 
+            // Write the digits in window into a caller-owned buffer, without allocating.  Rows
+            //  run from window.min().y() upwards, as getAreaRows, row r starting at out + r*stride,
+            //  stride >= window.width().  Only the non-zero digits in the window are visited.
+            //  Returns the event the buffer reflects.  When that equals sinceEvent, nothing is
+            //  written, the buffer already holds these digits - pass -1 after moving the window.
+            long long getAreaDigits(
+                const Rect& window, Digit* out, std::ptrdiff_t stride, long long sinceEvent=-1
+            ) const;
+            protected:
+            long long locked_getAreaDigits(
+                const Rect& window, Digit* out, std::ptrdiff_t stride, long long sinceEvent
+            ) const;
+            public:
+
 
         // *** Column Getters
 
@@ -267,8 +422,8 @@ public:
 
             // If all the columns calculated their total value, account for negative digits, this
             //  function finds the one with the largest absolute magnitude (positive or negative)
-            //  xy gets set to the position of the head of the column (furthest right, x+ digit),
-            //  and val contains the value (signed).  Tie breaker - prefers higher x values.
+            //  xy gets set to the position of the head of the column (furthest up, y+ digit), and
+            //  val contains the value (signed).  Tie breaker - prefers higher x values.
             //  Returns false if no non-zeroes.
             bool getColMagMax(Coord& xy, long double& val) const;
             protected: bool locked_getColMagMax(Coord& xy, long double& val) const; public:
@@ -337,6 +492,42 @@ public:
                 void locked_setRow(const Coord& xy, const VecDigit& row);
             public:
 
+            // As setRow, from a packed row in any packing
+            //  Exceptions
+            //      * InvalidArgument - row.data does not match row.packing and row.width
+            void setRowPacked(const Coord& xy, const PackedRow& row);
+            protected:
+                void locked_setRowPacked(const Coord& xy, const PackedRow& row);
+            public:
+
+
+        // *** Undo / redo
+
+            // Start keeping an undo / redo history of digit changes, each completed operation is
+            //  one step.  Does nothing if already enabled.  See DigitJournal for the limits.
+            void enableJournal(
+                std::size_t memoryBudget=DigitJournal::defaultMemoryBudget,
+                std::size_t spillBytes=DigitJournal::defaultSpillBytes,
+                std::size_t maxSteps=DigitJournal::defaultMaxSteps
+            );
+
+            // Stop keeping the history, and drop it
+            void disableJournal();
+
+            bool journalEnabled() const;
+
+            // True if there is a step to undo, or redo
+            bool canUndo() const;
+            bool canRedo() const;
+
+            // Reverts the digits changed by the last step, returns false if there is none
+            bool undo();
+            protected: bool locked_undo(); public:
+
+            // Re-applies the last undone step, returns false if there is none
+            bool redo();
+            protected: bool locked_redo(); public:
+
 
         // *** Mdn2dIO functionality hooks
 
@@ -450,21 +641,21 @@ public:
             bool hasBounds() const;
             protected: bool locked_hasBounds() const; public:
 
-            // Retuns bounds of non zero entries in m_raw
+            // Retuns bounds of non zero entries in m_data->raw
             const Rect& bounds() const;
             protected: const Rect& locked_bounds() const; public:
 
 
         // *** Direct access to underlying data
 
-        const std::unordered_map<Coord, Digit>&  data_raw();
-        const std::unordered_map<Coord, Digit>&  locked_data_raw();
-        const std::map<int, CoordSet>&  data_xIndex();
-        const std::map<int, CoordSet>&  locked_data_xIndex();
-        const std::map<int, CoordSet>&  data_yIndex();
-        const std::map<int, CoordSet>&  locked_data_yIndex();
-        const CoordSet&  data_index();
-        const CoordSet&  locked_data_index();
+        const DigitStore&  data_raw();
+        const DigitStore&  locked_data_raw();
+        const CoordIndex&  data_xIndex();
+        const CoordIndex&  locked_data_xIndex();
+        const CoordIndex&  data_yIndex();
+        const CoordIndex&  locked_data_yIndex();
+        const CoordIndexSet&  data_index();
+        const CoordIndexSet&  locked_data_index();
         const std::unordered_map<int, MdnObserver*>&  data_observers();
         const std::unordered_map<int, MdnObserver*>&  locked_data_observers();
 
@@ -534,6 +725,61 @@ protected:
             // Clears all addressing and bounds data
             virtual void internal_clearMetadata() const;
 
+            // Drops all cached exact values
+            void internal_clearValueCache() const;
+
+            // Gives this number its own copy of m_data, if it is shared, ready to write
+            void internal_detach() const;
+
+            // Replaces m_data with other's digits and addressing - shared when both use the same
+            //  memory resource, copied otherwise so scratch memory never outlives its arena
+            void internal_shareData(const Mdn2dBase& other);
+
+            // Replaces m_data with an empty DigitData
+            void internal_resetData();
+
+            // Notes that the digit at xy has changed from oldDigit to newDigit, so its row and
+            //  column values are out of date, and the journal has the change
+            void internal_valueChanged(const Coord& xy, Digit oldDigit, Digit newDigit);
+
+            // Runs of non-zero digits along row y (row true) or column x, indexing it if needed
+            const RunIndex::Runs& internal_lineRuns(bool row, int line) const;
+
+            // Journals every digit as going away (removing) or arriving, for changes that bypass
+            //  internal_valueChanged.  Does nothing without a journal.
+            void internal_journalDigits(bool removing);
+
+            // Writes value at xy with no precision or base checks, for restoring journaled digits
+            void internal_restoreDigit(const Coord& xy, Digit value);
+
+            // Restores writes from the journal, as one completed operation
+            void internal_applyJournal(const DigitJournal::Writes& writes);
+
+            // Seals the journal's pending changes into a step, and reports its digits to the
+            //  observers
+            void internal_sealJournal();
+
+            // Notes that every digit has changed sign, so do the cached values
+            void internal_negateValueCache();
+
+            // Tiles of the digit pyramid at level covering window, building the pyramid if
+            //  needed.  Polymorphic counts are filled from polymorphicNodes when given, and are
+            //  zero otherwise.  Caller holds at least the read lock.
+            Overview internal_overview(
+                const Rect& window, int level, const CoordSet* polymorphicNodes
+            ) const;
+
+            // Drops the canonical form and its fingerprint
+            void internal_clearCanonical() const;
+
+            // Rebuilds the out of date row (alongRow) or column values, and ranks every non-zero
+            //  line when rank is true.  Caller holds m_valueCacheMutex.
+            void internal_refreshLines(bool alongRow, bool rank) const;
+
+            // Exact value of row y (alongRow) or column x, from the cache when available.  Caller
+            //  holds m_valueCacheMutex, and has refreshed the lines.
+            ExactValue internal_lineExact(bool alongRow, int line) const;
+
             // Sets value at xy without checking in range of base
             //  Returns true if carryover status might change:
             //      * Value goes from zero to non-zero
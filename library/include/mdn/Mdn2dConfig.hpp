@@ -34,6 +34,11 @@ public:
         return 20;
     }
 
+    // Return default maxCleanupWaves
+    static int defaultMaxCleanupWaves() {
+        return 200;
+    }
+
     // Return framework parent, controls Mdn2d naming
     Mdn2dFramework& parent();
 
@@ -96,6 +101,11 @@ private:
     // Affects 1) fractional addition, 2) divide direction
     Fraxis m_fraxis;
 
+    // Maximum number of waves a carryover cleanup may run before giving up, -1 for no limit
+    //  Not part of the text format, (b:10, p:16, s:Positive, c:20, f:X)
+    //  A performance setting, not part of the number, so does not affect operator== or operator!=
+    int m_maxCleanupWaves;
+
 
 public:
 
@@ -185,6 +195,15 @@ public:
     void setFraxis(std::string newName) { m_fraxis = NameToFraxis(newName); }
     void setFraxis(Fraxis fraxisIn) { m_fraxis = fraxisIn; }
 
+    int maxCleanupWaves() const { return m_maxCleanupWaves; }
+    bool maxCleanupWavesIsDefault() const {
+        return m_maxCleanupWaves == defaultMaxCleanupWaves();
+    }
+    // Negative values mean no limit
+    void setMaxCleanupWaves(int newVal) {
+        m_maxCleanupWaves = newVal < 0 ? -1 : newVal;
+    }
+
     // Returns true if all settings are valid, false if something failed
     bool checkConfig() const;
 
@@ -254,7 +273,7 @@ public:
     // Fraxis m_fraxis;
 
         // From the perspective of an Mdn2d, look for compatibility
-        //  Does not compare parent, name or path
+        //  Does not compare parent, name, path or maxCleanupWaves
         bool operator==(const Mdn2dConfig& rhs) const;
         bool operator!=(const Mdn2dConfig& rhs) const;
 };
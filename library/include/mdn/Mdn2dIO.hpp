@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <istream>
 #include <ostream>
 #include <string>
@@ -34,6 +35,21 @@ class MDN_API Mdn2dIO {
 
     static char internal_identifyDelim(const std::string& ascii);
 
+    // Formats the text rows of src, passing each line, without a newline, to emit in output
+    //  order.  The line and row buffers are reused, so memory does not grow with window height.
+    static void internal_formatRows(
+        const Mdn2dBase& src,
+        const TextWriteOptions& opt,
+        const std::function<void(const std::string&)>& emit
+    );
+
+    // Writes the text rows of src to os, separated by '\n', flushing in large chunks
+    static void internal_streamRows(
+        const Mdn2dBase& src,
+        std::ostream& os,
+        const TextWriteOptions& opt
+    );
+
 
 public:
     // -------- Text -> strings --------
@@ -90,6 +106,9 @@ public:
     );
 
     // -------- Binary I/O --------
+    // Writes version 2: the version 1 header, then one byte giving the DigitPacking, and rows
+    //  packed by base (see PackedDigits.hpp).  Version 1 rows are one int8_t per digit.  Both
+    //  versions load.
     static void saveBinary(
         const Mdn2dBase& src,
         std::ostream& os
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <array>
+
 #include <mdn/Carryover.hpp>
+#include <mdn/CarryoverMasks.hpp>
+#include <mdn/CleanupReport.hpp>
+#include <mdn/CleanupWaves.hpp>
 #include <mdn/GlobalConfig.hpp>
 #include <mdn/Mdn2dBase.hpp>
+#include <mdn/ThreadPool.hpp>
 
 namespace mdn {
 
@@ -26,6 +32,16 @@ public:
     // Check for the type of carryover, given the pivot digit and x and y axial digits
     static Carryover static_checkCarryover(Digit p, Digit x, Digit y, Digit base);
 
+    // Check for the type of carryover along a row segment of n digits, all in one pass
+    //  p - pivot digits, p[0 .. n-1]
+    //  x - axial digits in x, i.e. the pivot's right neighbour, x[0 .. n-1]
+    //  y - axial digits in y, i.e. the pivot's upper neighbour, y[0 .. n-1]
+    //  Results are written to masks, one bit per position, see CarryoverMasks.  Uses SIMD when the
+    //  build supports it (SSE2 by default, AVX2 with the Simd build option), else scalar.
+    static void static_checkCarryoverRow(
+        const Digit* p, const Digit* x, const Digit* y, int n, Digit base, CarryoverMasks& masks
+    );
+
 
     // *** Constructors
 
@@ -35,6 +51,9 @@ public:
         // Construct from a configuration
         Mdn2dRules(Mdn2dConfig config, std::string nameIn="");
 
+        // Construct with storage allocated from the given memory resource, see ScratchArena
+        Mdn2dRules(Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource);
+
 
         // *** Rule of five
 
@@ -78,6 +97,9 @@ public:
 
             // Given set of suspicious coords, check if any need carryovers, and if so, do them
             //  Returns set of coordinates that actually have changed
+            //  Works in waves, each wave visits its coords in colour class order - see
+            //  internal_orderCleanupWave.  Large colour classes are checked on the shared
+            //  ThreadPool, the final state is identical to the single-threaded result.
             CoordSet carryoverCleanup(const CoordSet& coords,
                 SignConvention sc = SignConvention::Invalid
             );
@@ -87,6 +109,17 @@ public:
                 );
             public:
 
+            // As carryoverCleanup, and reports how it went: waves, carries, convergence status
+            //  Waves are capped by Mdn2dConfig::maxCleanupWaves
+            CleanupReport carryoverCleanupWithReport(
+                const CoordSet& coords, SignConvention sc = SignConvention::Invalid
+            );
+            protected:
+                void locked_carryoverCleanup(
+                    const CoordSet& coords, SignConvention sc, CleanupReport& report
+                );
+            public:
+
             // Given all the non-zero coords, check if any need carryovers, and if so, do them
             //  Returns set of coordinates that actually have changed
             CoordSet carryoverCleanupAll(SignConvention sc = SignConvention::Invalid);
@@ -94,6 +127,12 @@ public:
                 CoordSet locked_carryoverCleanupAll(SignConvention sc = SignConvention::Invalid);
             public:
 
+            // As carryoverCleanupAll, and reports how it went, see carryoverCleanupWithReport
+            CleanupReport carryoverCleanupAllWithReport(SignConvention sc = SignConvention::Invalid);
+            protected:
+                void locked_carryoverCleanupAll(SignConvention sc, CleanupReport& report);
+            public:
+
             // General shift interface
             void shift(int xDigits, int yDigits);
             void shift(const Coord& xy);
@@ -120,6 +159,15 @@ public:
             const CoordSet& getPolymorphicNodes() const;
             protected: const CoordSet& locked_getPolymorphicNodes() const; public:
 
+            // Returns the digit pyramid's tiles at level covering window, for drawing the number
+            //  zoomed out, see DigitPyramid.  Choose level with DigitPyramid::static_levelFor.  The
+            //  pyramid is built on first use, then kept up to date digit by digit.  Tiles count
+            //  polymorphic nodes only withPolymorphism, which needs a full scan after each change.
+            Overview getOverview(const Rect& window, int level, bool withPolymorphism=false) const;
+            protected: Overview locked_getOverview(
+                const Rect& window, int level, bool withPolymorphism
+            ) const; public:
+
 
 protected:
 
@@ -128,6 +176,50 @@ protected:
         // Find all the 'Optional' carryovers, create m_polymorphicNodes data
         void internal_polymorphicScan() const;
 
+        // Put the coords of one cleanup wave in visiting order: by colour class, (x - y) mod 3,
+        //  then by y, then by x.  A carryover at xy touches xy, xy+x and xy+y, so the footprints of
+        //  two coords in the same colour class never overlap.  classStart gets the first index of
+        //  each class in wave, and classStart[3] = wave.size().
+        void internal_orderCleanupWave(
+            const CoordSet& coords, std::vector<Coord>& wave, std::array<int, 4>& classStart
+        ) const;
+
+        // Exact state of a cleanup wave: its coords, and the digits their carryover checks read
+        //  A repeat means the cleanup is oscillating, see CleanupWaves
+        void internal_cleanupWaveState(
+            const std::vector<Coord>& wave, CleanupWaves::State& state
+        ) const;
+
+        // Carry over each coord in wave[begin .. end) that needs it, in order
+        //  wrongSign - Optional carryover type that must be carried over, set by SignConvention
+        //  buffer - affected coords are merged into it
+        //  Returns the number of carryovers
+        int internal_cleanupClass(
+            const std::vector<Coord>& wave,
+            int begin,
+            int end,
+            Carryover wrongSign,
+            CoordSet& buffer
+        );
+
+        // As internal_cleanupClass, with wave[begin .. end) all in the same colour class
+        //  Each coord is checked in parallel on pool, then carryovers are applied in order.  Gives
+        //  the same result as internal_cleanupClass.
+        int internal_cleanupClassParallel(
+            const std::vector<Coord>& wave,
+            int begin,
+            int end,
+            Carryover wrongSign,
+            CoordSet& buffer,
+            ThreadPool& pool
+        );
+
+        // Classify every non-zero digit by its carryover type, adding it to the matching set
+        //  Dense rows go through static_checkCarryoverRow, sparse rows are checked digit-by-digit
+        void internal_classifyRows(
+            CoordSet& required, CoordSet& optionalPositive, CoordSet& optionalNegative
+        ) const;
+
         // Perform a blind single carryover at xy without any checks
         void internal_oneCarryover(const Coord& xy);
 
@@ -106,6 +106,13 @@ public:
         : MdnException("Read error: " + description) {};
 };
 
+// Write error
+class MDN_API WriteError : public MdnException {
+public:
+    WriteError(const std::string& description)
+        : MdnException("Write error: " + description) {};
+};
+
 // Cannot perform the operation for the given described reason
 class MDN_API InvalidOperation : public MdnException {
 public:
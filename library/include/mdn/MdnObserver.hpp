@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mdn/DigitJournal.hpp>
 #include <mdn/Logger.hpp>
 
 namespace mdn {
@@ -53,6 +54,11 @@ public:
     // The observed object has been modified
     virtual void modified() const {}
 
+    // The observed object completed an operation, writes holds the new digit at every coord it
+    //  changed.  Only reported while the object keeps a journal, see Mdn2dBase::enableJournal.
+    //  Called with the object locked, from whichever thread did the work.
+    virtual void digitsChanged(const DigitJournal::Writes& /*writes*/) {}
+
     // The observed object is being reallocated to a new address
     virtual void reallocating(Mdn2d* newRef) {
         m_ref = newRef;
@@ -0,0 +1,99 @@
+#pragma once
+
+// Packed digits
+//  A Digit is an int8_t, but the digits of base b only span -(b-1)..(b-1), so small bases fit in
+//  fewer bits.  Rows of digits are packed by base for binary IO and bulk row transfer:
+//
+//      Packing     Bases   Layout
+//      Byte        9..32   one int8_t per digit
+//      Nibble      3..8    4-bit two's complement, two digits per byte, low nibble first
+//      BitPlanes   2       two planes of one bit per digit: non-zero plane, then negative plane
+//
+//  Within a byte, nibbles and plane bits fill from the lowest bit up, and a packed row of n digits
+//  takes PackedDigits::bytes(packing, n) bytes.  Trailing bits of the last byte are zero.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <mdn/Digit.hpp>
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+// Stored as a uint8_t in binary files, do not reorder
+enum class DigitPacking : uint8_t {
+    Byte,
+    Nibble,
+    BitPlanes
+};
+
+
+// A row of digits in packed form
+struct MDN_API PackedRow {
+
+    // How the digits are packed
+    DigitPacking packing = DigitPacking::Byte;
+
+    // Number of digits
+    int width = 0;
+
+    // Packed bytes, size is PackedDigits::bytes(packing, width)
+    std::vector<uint8_t> data;
+
+};
+
+
+// Packing and unpacking kernels
+struct MDN_API PackedDigits {
+
+    // Densest packing that holds every digit of the given base
+    static DigitPacking forBase(int base);
+
+    // Returns true when code is a valid DigitPacking, for checking values read from files
+    static bool isValid(uint8_t code);
+
+    // Number of bytes needed to hold n packed digits
+    static std::size_t bytes(DigitPacking packing, int n);
+
+    // Set digit i of a zero-filled packed row holding n digits, d must fit the packing
+    static void put(DigitPacking packing, int n, int i, Digit d, uint8_t* out) {
+        switch (packing) {
+            case DigitPacking::Byte:
+                out[i] = static_cast<uint8_t>(d);
+                break;
+            case DigitPacking::Nibble:
+                out[i >> 1] |= static_cast<uint8_t>((d & 0x0F) << ((i & 1) << 2));
+                break;
+            case DigitPacking::BitPlanes: {
+                const uint8_t bit = static_cast<uint8_t>(1u << (i & 7));
+                out[i >> 3] |= bit;
+                if (d < 0) {
+                    out[planeBytes(n) + (i >> 3)] |= bit;
+                }
+                break;
+            }
+        }
+    }
+
+    // Pack n digits into out, which must hold bytes(packing, n)
+    static void pack(DigitPacking packing, const Digit* digits, int n, uint8_t* out);
+
+    // Unpack n digits from in, which holds bytes(packing, n)
+    static void unpack(DigitPacking packing, const uint8_t* in, int n, Digit* digits);
+
+    // Vector conveniences, sized to fit
+    static void pack(DigitPacking packing, const VecDigit& digits, PackedRow& out);
+    static void unpack(const PackedRow& row, VecDigit& digits);
+
+
+private:
+
+    // Bytes in one bit plane of n digits
+    static std::size_t planeBytes(int n) {
+        return (static_cast<std::size_t>(n) + 7) >> 3;
+    }
+
+};
+
+} // end namespace mdn
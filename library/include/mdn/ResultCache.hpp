@@ -0,0 +1,189 @@
+#pragma once
+
+// Result cache
+//  Remembers the answers of recent binary operations, so repeating one - re-running a division,
+//  multiplying the same pair again after an undo - is a lookup.  Mdn2d's plus, minus, multiply,
+//  divide and divideIterate consult the shared() instance, which starts disabled:
+//
+//      ResultCache::shared().setBudget(64 << 20);  // enable, with 64 MiB
+//
+//  Entries are found by operation, iteration parameters and a Fingerprint of each operand's digits,
+//  and confirmed by comparing the operands' configs and digits, so a hit is always exact.  A hit
+//  hands back a copy-on-write copy of the stored answer, the digits are only copied if either side
+//  later changes.  Least recently used entries are evicted to stay within the memory budget.
+//
+//  Divisions that did not converge are cached as-is, their remainder included.  divideIterate also
+//  depends on the incoming ans and rem, so these are part of its entry.
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <mdn/Fingerprint.hpp>
+#include <mdn/Fraxis.hpp>
+#include <mdn/GlobalConfig.hpp>
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dConfig.hpp>
+
+namespace mdn {
+
+enum class CachedOperation {
+    Plus,
+    Minus,
+    Multiply,
+    Divide,
+    DivideIterate
+};
+
+
+class MDN_API ResultCache {
+
+public:
+
+    // What identifies an entry, confirmed by the operands stored with it
+    struct Key {
+        CachedOperation op;
+        std::vector<Fingerprint> operands;
+        int nIters;
+        Fraxis fraxis;
+
+        bool operator==(const Key& rhs) const {
+            return
+                op == rhs.op && nIters == rhs.nIters && fraxis == rhs.fraxis
+                && operands == rhs.operands;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    // A stored operation: its inputs and outputs, held as copy-on-write copies
+    struct Entry {
+        Key key;
+
+        // lhs and rhs, then for DivideIterate the incoming ans and rem
+        std::vector<Mdn2d> operands;
+
+        // Configs of the destination numbers, which shape the result
+        Mdn2dConfig ansConfig;
+        Mdn2dConfig remConfig;
+
+        // Outputs, rem only for divisions given one
+        Mdn2d ans;
+        std::unique_ptr<Mdn2d> rem;
+        long double remMag;
+
+        // Approximate memory held
+        std::size_t bytes;
+
+        Entry(const Mdn2dConfig& config);
+    };
+
+
+private:
+
+    // Most recently used first
+    using EntryList = std::list<std::unique_ptr<Entry>>;
+    EntryList m_entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> m_lookup;
+
+    // Memory budget in bytes, 0 disables the cache
+    std::size_t m_budget;
+
+    // Memory held by m_entries
+    std::size_t m_bytes;
+
+    long long m_hits;
+    long long m_misses;
+
+    // Guards everything above
+    mutable std::mutex m_mutex;
+
+
+public:
+
+    // Process-wide cache used by Mdn2d, disabled until given a budget
+    static ResultCache& shared();
+
+    // Approximate memory held by a number's digits and addressing
+    static std::size_t static_bytes(const Mdn2d& mdn);
+
+
+    // *** Constructors
+
+        // Construct with a memory budget, 0 disables the cache
+        ResultCache(std::size_t budgetBytes=0);
+
+        ResultCache(const ResultCache&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+
+
+    // *** Member Functions
+
+        // True when the cache has a budget
+        bool enabled() const;
+
+        // Memory budget in bytes, 0 disables
+        std::size_t budget() const;
+
+        // Change the budget, evicting entries as needed
+        void setBudget(std::size_t budgetBytes);
+
+        // Number of entries, and the memory they hold
+        std::size_t size() const;
+        std::size_t bytes() const;
+
+        // Lookups that found, or did not find, an entry
+        long long hits() const;
+        long long misses() const;
+        void resetCounters();
+
+        // Drop all entries
+        void clear();
+
+        // Looks up lhs op rhs into ans, and for divisions rem (optional) and remMag.  On a hit,
+        //  writes the stored outputs and returns true.  On a miss, when enabled, pending gets the
+        //  entry to complete with store once the operation has run.  For DivideIterate, ans and
+        //  rem must be their values going in.  Caller holds the locks on every number.
+        bool fetch(
+            CachedOperation op,
+            const Mdn2d& lhs,
+            const Mdn2d& rhs,
+            Mdn2d& ans,
+            Mdn2d* rem,
+            long double* remMag,
+            int nIters,
+            Fraxis fraxis,
+            std::unique_ptr<Entry>& pending
+        );
+
+        // Completes pending from fetch with the outputs and adds it, does nothing when pending is
+        //  null.  Caller holds the locks on ans and rem.
+        void store(
+            std::unique_ptr<Entry>& pending,
+            const Mdn2d& ans,
+            const Mdn2d* rem,
+            long double remMag
+        );
+
+
+private:
+
+    // Evicts the least recently used entries until within budget, caller holds m_mutex
+    void internal_evict();
+
+    // Fingerprint of mdn's digits as they are.  Entries are confirmed by their operands' digits,
+    //  not their canonical forms, so a polymorphic operand is hashed directly rather than given a
+    //  full cleanup on every miss.  Caller holds the lock on mdn.
+    static Fingerprint static_keyFingerprint(const Mdn2d& mdn);
+
+    // True when stored and live have the same config and digits
+    static bool static_sameNumber(const Mdn2d& stored, const Mdn2d& live);
+
+};
+
+} // end namespace mdn
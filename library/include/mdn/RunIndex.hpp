@@ -0,0 +1,110 @@
+#pragma once
+
+// Run index
+//  Runs of consecutive non-zero digits along the rows, or the columns, of an Mdn2d, each line's
+//  runs sorted, so that a spreadsheet-style jump (see Mdn2dBase::jump) finds the next zero /
+//  non-zero boundary by binary search instead of stepping cell by cell.
+//
+//  Lines are indexed on first use.  Writers hold the exclusive lock and drop the lines where a
+//  digit becomes zero or non-zero, see markDirty; readers rebuild them, see
+//  Mdn2dBase::internal_lineRuns.
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace mdn {
+
+struct RunIndex {
+
+    // Positions first to last along a line, inclusive, all non-zero
+    struct Run {
+        int first;
+        int last;
+    };
+
+    // Runs of one line, ascending and separated by at least one zero
+    using Runs = std::vector<Run>;
+
+    // Runs of each line indexed so far, empty lines included
+    std::unordered_map<int, Runs> lines;
+
+    // Drop everything
+    void clear() {
+        lines.clear();
+    }
+
+    // Note a change to the non-zero positions on line
+    void markDirty(int line) {
+        lines.erase(line);
+    }
+
+    // Indexes line from the positions of its non-zero digits, given in any order
+    const Runs& build(int line, std::vector<int>& positions) {
+        std::sort(positions.begin(), positions.end());
+        Runs runs;
+        for (int pos : positions) {
+            if (!runs.empty() && runs.back().last + 1 == pos) {
+                runs.back().last = pos;
+            } else {
+                runs.push_back({pos, pos});
+            }
+        }
+        Runs& result = lines[line];
+        result.swap(runs);
+        return result;
+    }
+
+    // Run containing pos, or null if pos is zero
+    static const Run* static_runAt(const Runs& runs, int pos) {
+        auto it = std::upper_bound(
+            runs.begin(), runs.end(), pos, [](int p, const Run& run) { return p < run.first; }
+        );
+        if (it == runs.begin() || std::prev(it)->last < pos) {
+            return nullptr;
+        }
+        return &*std::prev(it);
+    }
+
+    // Nearest run wholly beyond pos in the direction of step (+1 or -1), or null if there is none
+    static const Run* static_nextRun(const Runs& runs, int pos, int step) {
+        if (step > 0) {
+            auto it = std::upper_bound(
+                runs.begin(), runs.end(), pos, [](int p, const Run& run) { return p < run.first; }
+            );
+            return it == runs.end() ? nullptr : &*it;
+        }
+        auto it = std::lower_bound(
+            runs.begin(), runs.end(), pos, [](const Run& run, int p) { return run.last < p; }
+        );
+        return it == runs.begin() ? nullptr : &*std::prev(it);
+    }
+
+    // Where a jump from pos in the direction of step (+1 or -1) lands on a line whose digits lie
+    //  within lo to hi:
+    //  * from a zero, the first non-zero, or the far end of the line if there is none
+    //  * from a non-zero, the end of its run, or if already there, the far end of the next run
+    //    when a single zero lies between, otherwise the first zero
+    static int static_jump(const Runs& runs, int pos, int step, int lo, int hi) {
+        const Run* here = static_runAt(runs, pos);
+        const Run* next = static_nextRun(runs, pos, step);
+        if (!here) {
+            if (!next) {
+                return step > 0 ? hi : lo;
+            }
+            return step > 0 ? next->first : next->last;
+        }
+        const int end = step > 0 ? here->last : here->first;
+        if (pos != end) {
+            return end;
+        }
+        if (next && (step > 0 ? next->first : next->last) == end + 2*step) {
+            return step > 0 ? next->last : next->first;
+        }
+        return end + step;
+    }
+
+};
+
+} // end namespace mdn
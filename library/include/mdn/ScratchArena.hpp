@@ -0,0 +1,58 @@
+#pragma once
+
+// Scratch arena
+//  Operation-scoped memory for short-lived Mdn2d temporaries, such as the partial products in a
+//  multiply or the per-iteration terms in a divide.  A pool resource recycles freed blocks within
+//  the operation, and draws its memory from a monotonic buffer, so everything is returned in one
+//  go when the arena is reset or destroyed.
+//
+//  Rules:
+//      * Not thread-safe, use one arena per thread
+//      * Anything allocated from the arena must be destroyed before reset() or ~ScratchArena -
+//          declare the arena before the scratch objects that use it
+//      * Scratch objects must not escape the operation.  Copy results out with operator= or
+//          locked_operatorEquals, which allocate from the destination's own memory resource.
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+class MDN_API ScratchArena {
+
+    // Upstream for m_pool, only ever grows until released
+    std::pmr::monotonic_buffer_resource m_buffer;
+
+    // Recycles blocks freed during the operation
+    std::pmr::unsynchronized_pool_resource m_pool;
+
+
+public:
+
+    // Size of the first block the arena requests from the heap
+    static constexpr std::size_t defaultInitialBytes = 64*1024;
+
+
+    // *** Constructors
+
+        // Construct, with the first heap request of initialBytes
+        ScratchArena(std::size_t initialBytes=defaultInitialBytes);
+
+        // Not copyable or movable - scratch objects hold a pointer to the resource
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+
+    // *** Member Functions
+
+        // Memory resource for scratch containers and Mdn2d objects
+        std::pmr::memory_resource* resource() { return &m_pool; }
+
+        // Release all scratch memory at once, all scratch objects must already be destroyed
+        void reset();
+
+};
+
+} // end namespace mdn
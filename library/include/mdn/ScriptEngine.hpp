@@ -0,0 +1,204 @@
+#pragma once
+
+// Script engine
+//  Runs scripts of Mdn2d operations without a gui.  A script is plain text, one statement per
+//  line, '#' starts a comment:
+//
+//      setConfig base=10 precision=32 signConvention=Positive
+//      load a numbers/a.mdntxt
+//      load b numbers/b.mdnbin
+//      plus a b sum            # sum = a + b
+//      multiply a b product    # independent of the line above, may run at the same time
+//      save sum out/sum.mdntxt
+//
+//  Statements name the numbers they read and write, so independent statements are grouped into
+//  waves and each wave runs in parallel on the shared ThreadPool.  Numbers live in a
+//  ScriptWorkspace - by default an in-memory MemoryWorkspace, the gui supplies one over its
+//  project tabs.  See ScriptEngine::help() for the statement list.
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <mdn/GlobalConfig.hpp>
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dConfig.hpp>
+
+namespace mdn {
+
+// A parsed statement
+struct MDN_API ScriptStatement {
+
+    // Source line number, starting at 1
+    int line = 0;
+
+    // Source text, without comments or surrounding whitespace
+    std::string text;
+
+    // Operation keyword, e.g. "plus"
+    std::string op;
+
+    // Tokens following the keyword
+    std::vector<std::string> args;
+
+    // Numbers this statement reads, and those it writes (or creates), files appear as
+    //  "@file:path"
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+
+    // When true the statement touches the whole workspace and runs in a wave of its own
+    bool barrier = false;
+
+};
+
+
+// The outcome of running one statement
+struct MDN_API ScriptResult {
+
+    // The statement's source line and text
+    int line = 0;
+    std::string text;
+
+    // False when the statement threw, or was not run because an earlier statement failed
+    bool ok = true;
+
+    // Printed output, or the error message when !ok
+    std::string output;
+
+    // Wall time spent on the statement
+    double seconds = 0.0;
+
+    // Scheduling wave, statements in the same wave ran concurrently, -1 when not run
+    int wave = -1;
+
+};
+
+
+// Named numbers a script operates on
+//  Calls from statements in the same wave may be concurrent, for different names
+class MDN_API ScriptWorkspace {
+
+public:
+
+    virtual ~ScriptWorkspace() = default;
+
+    // Config given to new numbers
+    virtual Mdn2dConfig config() const = 0;
+
+    // Change the config, applies to all existing numbers
+    virtual void setConfig(const Mdn2dConfig& config) = 0;
+
+    // Returns the named number, nullptr if it does not exist
+    virtual Mdn2d* find(const std::string& name) = 0;
+
+    // Returns the named number, creating an empty one if it does not exist
+    virtual Mdn2d& obtain(const std::string& name) = 0;
+
+    // Names of all numbers, in a stable order
+    virtual std::vector<std::string> names() const = 0;
+
+};
+
+
+// Workspace holding the numbers in memory, used by the command line tool
+class MDN_API MemoryWorkspace : public ScriptWorkspace {
+
+    // Guards m_numbers and m_config
+    mutable std::mutex m_mutex;
+
+    // Config given to new numbers
+    Mdn2dConfig m_config;
+
+    // The numbers, std::map keeps references valid as numbers are added
+    std::map<std::string, Mdn2d> m_numbers;
+
+
+public:
+
+    MemoryWorkspace(Mdn2dConfig config=Mdn2dConfig::static_defaultConfig());
+
+    Mdn2dConfig config() const override;
+    void setConfig(const Mdn2dConfig& config) override;
+    Mdn2d* find(const std::string& name) override;
+    Mdn2d& obtain(const std::string& name) override;
+    std::vector<std::string> names() const override;
+
+};
+
+
+class MDN_API ScriptEngine {
+
+    // Workspace created when none is supplied
+    std::unique_ptr<MemoryWorkspace> m_ownWorkspace;
+
+    // Where the numbers live
+    ScriptWorkspace& m_workspace;
+
+
+public:
+
+    // Statement list, as shown by the 'help' statement
+    static std::string help();
+
+    // Parse a script, firstLine is the line number of the first line of text
+    //  Exceptions
+    //      * InvalidArgument - unknown statement or wrong arguments, message gives the line
+    static std::vector<ScriptStatement> parse(const std::string& script, int firstLine=1);
+
+    // Assign each statement its wave: a statement runs after every earlier statement that
+    //  writes what it reads, or reads or writes what it writes
+    static std::vector<int> schedule(const std::vector<ScriptStatement>& statements);
+
+
+    // *** Constructors
+
+        // Construct with an in-memory workspace
+        ScriptEngine(Mdn2dConfig config=Mdn2dConfig::static_defaultConfig());
+
+        // Construct over the given workspace, it must outlive the engine
+        ScriptEngine(ScriptWorkspace& workspace);
+
+
+    // *** Member Functions
+
+        ScriptWorkspace& workspace() { return m_workspace; }
+
+        // Run the statements, a wave at a time.  With parallel true, statements within a wave
+        //  run concurrently.  report is called once per statement, in statement order, as
+        //  results become available.  A failed statement stops the run at that line: statements
+        //  after it in the script are reported as not run, those before it still run.
+        std::vector<ScriptResult> run(
+            const std::vector<ScriptStatement>& statements,
+            bool parallel=true,
+            const std::function<void(const ScriptResult&)>& report={}
+        );
+
+        // Parse and run
+        std::vector<ScriptResult> run(
+            const std::string& script,
+            bool parallel=true,
+            const std::function<void(const ScriptResult&)>& report={}
+        );
+
+
+private:
+
+    // Run a single statement, printing any output to os, throws on failure
+    void internal_execute(const ScriptStatement& st, std::ostream& os);
+
+    // Returns the named number, throws InvalidArgument if it does not exist
+    Mdn2d& internal_require(const ScriptStatement& st, const std::string& name);
+
+    // Load the file at path into the named number
+    void internal_load(const ScriptStatement& st, const std::string& name, const std::string& path);
+
+    // Load every tab of a gui project file as a number, named after its tab
+    void internal_loadProject(const ScriptStatement& st, const std::string& path, std::ostream& os);
+
+};
+
+} // end namespace mdn
@@ -169,7 +169,9 @@ public:
                 Log_Warn("Failed to acquire Mdn2d");
                 return;
             }
-            Coord postJump = dst->jump(m_cursor1, CardinalDirection::North);
+            Coord postJump = extendSelection
+                ? jumpEdge(*dst, CardinalDirection::North)
+                : dst->jump(m_cursor1, CardinalDirection::North);
             if (postJump == m_cursor1) {
                 // No actual movement
                 return;
@@ -189,7 +191,9 @@ public:
                 Log_Warn("Failed to acquire Mdn2d");
                 return;
             }
-            Coord postJump = dst->jump(m_cursor1, CardinalDirection::South);
+            Coord postJump = extendSelection
+                ? jumpEdge(*dst, CardinalDirection::South)
+                : dst->jump(m_cursor1, CardinalDirection::South);
             if (postJump == m_cursor1) {
                 // No actual movement
                 return;
@@ -209,7 +213,9 @@ public:
                 Log_Warn("Failed to acquire Mdn2d");
                 return;
             }
-            Coord postJump = dst->jump(m_cursor1, CardinalDirection::West);
+            Coord postJump = extendSelection
+                ? jumpEdge(*dst, CardinalDirection::West)
+                : dst->jump(m_cursor1, CardinalDirection::West);
             if (postJump == m_cursor1) {
                 // No actual movement
                 return;
@@ -229,7 +235,9 @@ public:
                 Log_Warn("Failed to acquire Mdn2d");
                 return;
             }
-            Coord postJump = dst->jump(m_cursor1, CardinalDirection::East);
+            Coord postJump = extendSelection
+                ? jumpEdge(*dst, CardinalDirection::East)
+                : dst->jump(m_cursor1, CardinalDirection::East);
             if (postJump == m_cursor1) {
                 // No actual movement
                 return;
@@ -242,6 +250,41 @@ public:
                 m_rect.set(m_cursor0);
             }
         }
+
+        // Where cursor1 lands when the selection is extended by a jump in direction cd.  Jumps
+        //  from cursor1's edge along every row (east / west) or column (north / south) that the
+        //  selection spans, in one batched call, and stops at the nearest landing, so repeated
+        //  jumps visit every zero / non-zero boundary within the selection's lines.
+        Coord jumpEdge(const Mdn2d& dst, CardinalDirection cd) const {
+            const Coord step = CardinalDirectionToCoord(cd);
+            const bool horizontal = step.x() != 0;
+            const int lo = horizontal ? m_rect.min().y() : m_rect.min().x();
+            const int hi = horizontal ? m_rect.max().y() : m_rect.max().x();
+            if (lo == hi) {
+                return dst.jump(m_cursor1, cd);
+            }
+            std::vector<Coord> from;
+            from.reserve(std::size_t(hi) - lo + 1);
+            for (int line = lo; line <= hi; ++line) {
+                from.push_back(
+                    horizontal ? Coord(m_cursor1.x(), line) : Coord(line, m_cursor1.y())
+                );
+            }
+            std::vector<Coord> landed;
+            dst.jump(from, cd, landed);
+            int nearest = 0;
+            for (const Coord& xy : landed) {
+                const int distance = horizontal
+                    ? (xy.x() - m_cursor1.x())*step.x()
+                    : (xy.y() - m_cursor1.y())*step.y();
+                if (distance > 0 && (nearest == 0 || distance < nearest)) {
+                    nearest = distance;
+                }
+            }
+            Log_Debug("Jumped along " << from.size() << " lines, nearest landing " << nearest);
+            return m_cursor1.translated(step*nearest);
+        }
+
         void cursorPageUp(bool extendSelection) {
             Log_Debug("extend=" << extendSelection);
             m_cursor1.translateY(m_pageDy);
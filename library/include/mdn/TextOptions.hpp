@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <mdn/GlobalConfig.hpp>
@@ -93,8 +94,20 @@ struct MDN_API TextReadSummary {
     // rows
     int height = 0;
 
+    // bytes of text consumed, header included
+    std::size_t bytes = 0;
+
+    // wall time spent reading, parsing and writing digits
+    double seconds = 0.0;
+
+    // parse throughput, 0 when nothing was timed
+    double bytesPerSecond() const {
+        return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const TextReadSummary& t) {
-        return os << "{" << t.parsedRect << ", (" << t.width << ", " << t.height << ")}";
+        return os << "{" << t.parsedRect << ", (" << t.width << ", " << t.height << "), "
+            << t.bytes << " bytes in " << t.seconds << "s}";
     }
 };
 
@@ -0,0 +1,92 @@
+#pragma once
+
+// Thread pool
+//  A fixed set of worker threads pulling tasks from a shared queue.  Used for data-parallel passes
+//  over large numbers, where the work splits into independent chunks.  The shared() instance is
+//  sized to the hardware and lives for the duration of the process.
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <mdn/GlobalConfig.hpp>
+
+namespace mdn {
+
+class MDN_API ThreadPool {
+
+    // Worker threads
+    std::vector<std::thread> m_workers;
+
+    // Tasks waiting for a worker
+    std::queue<std::function<void()>> m_tasks;
+
+    // Guards m_tasks and m_stopping
+    std::mutex m_mutex;
+
+    // Signals workers when a task arrives, or when stopping
+    std::condition_variable m_condition;
+
+    // When true, workers finish the queue and exit
+    bool m_stopping;
+
+
+public:
+
+    // Process-wide pool, sized to std::thread::hardware_concurrency
+    static ThreadPool& shared();
+
+
+    // *** Constructors
+
+        // Construct with nThreads workers, nThreads <= 0 uses std::thread::hardware_concurrency
+        ThreadPool(int nThreads=0);
+
+        // No copying or moving - workers hold a pointer to this pool
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Finishes queued tasks, then joins all workers
+        ~ThreadPool();
+
+
+    // *** Member Functions
+
+        // Number of worker threads
+        int size() const;
+
+        // Queue a task, returns a future for its result
+        template <class Function>
+        auto submit(Function fn) -> std::future<decltype(fn())> {
+            using Result = decltype(fn());
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+            std::future<Result> result = task->get_future();
+            internal_enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        // Split [begin, end) into chunks of at least minChunk and call fn(chunkBegin, chunkEnd) on
+        //  each chunk, in parallel.  Blocks until all chunks are complete.  The calling thread
+        //  works on chunks too, so this is safe to call from within a task.  The first exception
+        //  thrown by fn is rethrown here.
+        void parallelFor(
+            int begin, int end, const std::function<void(int, int)>& fn, int minChunk=1
+        );
+
+
+private:
+
+    // Add a task to the queue and wake a worker
+    void internal_enqueue(std::function<void()> task);
+
+    // Worker thread main loop
+    void internal_workerLoop();
+
+};
+
+} // end namespace mdn
@@ -101,9 +101,12 @@ public:
         return pairToString(pair, std::string(1, delimiter));
     }
 
-    // Convert a set of anything to a string delimiter
-    template<typename T>
-    static std::string setToString(const std::unordered_set<T>& set, const std::string& delimiter) {
+    // Convert a set of anything to a string delimiter, any allocator
+    template<typename T, typename Hash, typename Equal, typename Alloc>
+    static std::string setToString(
+        const std::unordered_set<T, Hash, Equal, Alloc>& set,
+        const std::string& delimiter
+    ) {
         if (set.empty()) return "";
 
         std::ostringstream oss;
@@ -120,8 +123,11 @@ public:
     }
 
     // Optional overload for char delimiter
-    template<typename T>
-    static std::string setToString(const std::unordered_set<T>& set, char delimiter) {
+    template<typename T, typename Hash, typename Equal, typename Alloc>
+    static std::string setToString(
+        const std::unordered_set<T, Hash, Equal, Alloc>& set,
+        char delimiter
+    ) {
         return setToString(set, std::string(1, delimiter));
     }
 
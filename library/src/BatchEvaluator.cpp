@@ -0,0 +1,111 @@
+#include <mdn/BatchEvaluator.hpp>
+
+#include <chrono>
+#include <exception>
+
+#include <mdn/Logger.hpp>
+#include <mdn/MdnException.hpp>
+
+
+mdn::BatchResult::BatchResult(const Mdn2dConfig& config):
+    value(config, "batch"),
+    remainder(config, "batch_rem")
+{}
+
+
+mdn::BatchEvaluator::BatchEvaluator(const Mdn2dConfig& config, ThreadPool& pool):
+    m_config(config),
+    m_pool(pool)
+{}
+
+
+const std::vector<mdn::BatchResult>& mdn::BatchEvaluator::evaluate(
+    BatchOperation op, const Pairs& pairs, Fraxis fraxis
+) {
+    Log_Debug2_H("op=" << static_cast<int>(op) << ", " << pairs.size() << " pairs");
+    const int n = static_cast<int>(pairs.size());
+    if (static_cast<int>(m_results.size()) > n) {
+        m_results.erase(m_results.begin() + n, m_results.end());
+    }
+    m_results.reserve(n);
+    while (static_cast<int>(m_results.size()) < n) {
+        m_results.emplace_back(m_config);
+    }
+    m_pool.parallelFor(
+        0,
+        n,
+        [this, op, &pairs, fraxis](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                internal_evaluate(op, pairs, i, fraxis);
+            }
+        }
+    );
+    Log_Debug2_T("");
+    return m_results;
+}
+
+
+void mdn::BatchEvaluator::setConfig(const Mdn2dConfig& config) {
+    m_config = config;
+    m_results.clear();
+}
+
+
+void mdn::BatchEvaluator::internal_evaluate(
+    BatchOperation op, const Pairs& pairs, int i, Fraxis fraxis
+) {
+    BatchResult& result = m_results[i];
+    const Mdn2d* lhs = pairs[i].first;
+    const Mdn2d* rhs = pairs[i].second;
+    const auto start = std::chrono::steady_clock::now();
+    result.ok = true;
+    result.error.clear();
+    result.remMag = 0.0;
+    try {
+        if (!lhs || !rhs) {
+            InvalidArgument err("Batch item " + std::to_string(i) + " has a null operand");
+            Log_Error(err.what());
+            throw err;
+        }
+        // Result slots belong to this item alone, operands are only read.  Each item starts
+        //  from fresh storage: cleanup visits digits in hash order, which depends on the buckets
+        //  left by the slot's earlier items, and the digits of a quotient depend on that order.
+        Mdn2d& ans = result.value;
+        for (Mdn2d* slot : {&ans, &result.remainder}) {
+            slot->internal_resetData();
+            slot->internal_clearMetadata();
+        }
+        switch (op) {
+            case BatchOperation::Plus: {
+                ans.locked_carryoverCleanup(lhs->locked_plus(*rhs, ans));
+                break;
+            }
+            case BatchOperation::Minus: {
+                ans.locked_carryoverCleanup(lhs->locked_minus(*rhs, ans));
+                break;
+            }
+            case BatchOperation::Multiply: {
+                ans.locked_carryoverCleanup(lhs->locked_multiply(*rhs, ans));
+                break;
+            }
+            case BatchOperation::Divide: {
+                static_cast<void>(
+                    lhs->locked_divide(*rhs, ans, result.remainder, result.remMag, fraxis)
+                );
+                result.remainder.internal_operationComplete();
+                if (result.remMag < 0) {
+                    result.ok = false;
+                    result.error = "Division failed";
+                }
+                break;
+            }
+        }
+        ans.internal_operationComplete();
+    } catch (const std::exception& e) {
+        result.ok = false;
+        result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+}
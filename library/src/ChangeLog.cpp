@@ -0,0 +1,436 @@
+#include <mdn/ChangeLog.hpp>
+
+#include <cstring>
+#include <exception>
+#include <vector>
+
+#include <mdn/Logger.hpp>
+
+
+namespace {
+
+constexpr char logMagic[8] = {'M','D','N','W','A','L','\0','\0'};
+constexpr char snapshotMagic[8] = {'M','D','N','S','N','A','P','\0'};
+
+// Bytes in a record header: payload bytes, checksum
+constexpr std::size_t recordHeaderBytes = 2*sizeof(std::uint32_t);
+
+// Bytes per digit in a record payload: x, y, digit
+constexpr std::size_t recordDigitBytes = 2*sizeof(std::int32_t) + 1;
+
+template <class Type>
+void appendValue(std::string& data, Type value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.append(bytes, sizeof(value));
+}
+
+template <class Type>
+Type readValue(const char* data) {
+    Type value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool writeHeader(std::FILE* file, const char* magic, std::uint64_t generation) {
+    return
+        std::fwrite(magic, 1, 8, file) == 8
+        && std::fwrite(&generation, sizeof(generation), 1, file) == 1;
+}
+
+} // end anonymous namespace
+
+
+std::string mdn::ChangeLog::static_logPath(const std::string& basePath) {
+    return basePath + ".wal";
+}
+
+
+std::string mdn::ChangeLog::static_snapshotPath(const std::string& basePath) {
+    return basePath + ".autosave";
+}
+
+
+bool mdn::ChangeLog::static_exists(const std::string& basePath) {
+    for (const std::string& path : {static_snapshotPath(basePath), static_logPath(basePath)}) {
+        if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+            std::fclose(file);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool mdn::ChangeLog::static_readSnapshot(const std::string& basePath, std::string& snapshot) {
+    Log_Debug2_H("basePath=" << basePath);
+    snapshot.clear();
+    std::FILE* file = std::fopen(static_snapshotPath(basePath).c_str(), "rb");
+    std::uint64_t generation;
+    if (!file || !static_readHeader(file, snapshotMagic, generation)) {
+        if (file) {
+            std::fclose(file);
+        }
+        Log_Debug2_T("No snapshot");
+        return false;
+    }
+    char buffer[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        snapshot.append(buffer, n);
+    }
+    std::fclose(file);
+    Log_Debug2_T("generation=" << generation << ", " << snapshot.size() << " bytes");
+    return true;
+}
+
+
+int mdn::ChangeLog::static_replay(const std::string& basePath, const ReplayFn& fn) {
+    Log_Debug2_H("basePath=" << basePath);
+    std::uint64_t snapshotGeneration;
+    std::uint64_t logGeneration;
+    std::FILE* snapshot = std::fopen(static_snapshotPath(basePath).c_str(), "rb");
+    const bool haveSnapshot =
+        snapshot && static_readHeader(snapshot, snapshotMagic, snapshotGeneration);
+    if (snapshot) {
+        std::fclose(snapshot);
+    }
+    std::FILE* file = std::fopen(static_logPath(basePath).c_str(), "rb");
+    if (
+        !haveSnapshot || !file || !static_readHeader(file, logMagic, logGeneration)
+        || logGeneration != snapshotGeneration
+    ) {
+        if (file) {
+            std::fclose(file);
+        }
+        Log_Debug2_T("No log for this snapshot, nothing to replay");
+        return 0;
+    }
+
+    // Record sizes are checked against what is left of the file before allocating
+    const long start = std::ftell(file);
+    long end = -1;
+    if (start >= 0 && std::fseek(file, 0, SEEK_END) == 0) {
+        end = std::ftell(file);
+    }
+    if (end < start || std::fseek(file, start, SEEK_SET) != 0) {
+        std::fclose(file);
+        Log_Warn("Change log " << basePath << " cannot be measured, nothing replayed");
+        Log_Debug2_T("");
+        return 0;
+    }
+
+    int count = 0;
+    std::vector<char> payload;
+    Writes writes;
+    std::string name;
+    while (true) {
+        char header[recordHeaderBytes];
+        if (std::fread(header, 1, recordHeaderBytes, file) != recordHeaderBytes) {
+            break;
+        }
+        const std::uint32_t size = readValue<std::uint32_t>(header);
+        const std::uint32_t checksum = readValue<std::uint32_t>(header + sizeof(std::uint32_t));
+        const long here = std::ftell(file);
+        if (here < 0 || size > static_cast<std::uint64_t>(end - here)) {
+            Log_Warn("Change log " << basePath << " ends in a damaged record, stopping there");
+            break;
+        }
+        payload.resize(size);
+        if (
+            std::fread(payload.data(), 1, size, file) != size
+            || static_checksum(payload.data(), size) != checksum
+            || size < 2*sizeof(std::uint32_t)
+        ) {
+            Log_Warn("Change log " << basePath << " ends in a damaged record, stopping there");
+            break;
+        }
+        const char* data = payload.data();
+        const std::uint32_t nameSize = readValue<std::uint32_t>(data);
+        data += sizeof(std::uint32_t);
+        if (size < 2*sizeof(std::uint32_t) + nameSize) {
+            Log_Warn("Change log " << basePath << " has a malformed record, stopping there");
+            break;
+        }
+        name.assign(data, nameSize);
+        data += nameSize;
+        const std::uint32_t nDigits = readValue<std::uint32_t>(data);
+        data += sizeof(std::uint32_t);
+        if (size != 2*sizeof(std::uint32_t) + nameSize + nDigits*recordDigitBytes) {
+            Log_Warn("Change log " << basePath << " has a malformed record, stopping there");
+            break;
+        }
+        writes.clear();
+        writes.reserve(nDigits);
+        for (std::uint32_t i = 0; i < nDigits; ++i) {
+            const std::int32_t x = readValue<std::int32_t>(data);
+            const std::int32_t y = readValue<std::int32_t>(data + sizeof(std::int32_t));
+            const Digit digit = static_cast<Digit>(data[2*sizeof(std::int32_t)]);
+            writes.emplace_back(Coord(x, y), digit);
+            data += recordDigitBytes;
+        }
+        fn(name, writes);
+        ++count;
+    }
+    std::fclose(file);
+    Log_Debug2_T("Replayed " << count << " records");
+    return count;
+}
+
+
+mdn::ChangeLog::ChangeLog(std::string basePath):
+    m_basePath(std::move(basePath)),
+    m_file(nullptr),
+    m_generation(0),
+    m_busy(false),
+    m_stopping(false),
+    m_logBytes(0),
+    m_failed(false)
+{
+    Log_Debug2_H("basePath=" << m_basePath);
+    // Any previous snapshot belongs to a discarded history
+    std::remove(static_snapshotPath(m_basePath).c_str());
+    m_failed = !internal_openLog();
+    m_worker = std::thread([this]() { internal_workerLoop(); });
+    Log_Debug2_T("");
+}
+
+
+mdn::ChangeLog::~ChangeLog() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+
+void mdn::ChangeLog::append(const std::string& name, const Writes& writes) {
+    if (writes.empty()) {
+        return;
+    }
+    Job job;
+    job.name = name;
+    job.writes = writes;
+    internal_enqueue(std::move(job));
+}
+
+
+void mdn::ChangeLog::compact(std::string snapshot) {
+    Log_Debug3("Queueing snapshot of " << snapshot.size() << " bytes");
+    Job job;
+    job.isSnapshot = true;
+    job.snapshot = std::move(snapshot);
+    internal_enqueue(std::move(job));
+}
+
+
+void mdn::ChangeLog::compact(EncodeFn encode) {
+    Log_Debug3("Queueing snapshot, encoded by the worker");
+    Job job;
+    job.isSnapshot = true;
+    job.encode = std::move(encode);
+    internal_enqueue(std::move(job));
+}
+
+
+void mdn::ChangeLog::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drained.wait(lock, [this]() { return m_jobs.empty() && !m_busy; });
+}
+
+
+void mdn::ChangeLog::discard() {
+    Log_Debug2_H("basePath=" << m_basePath);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    std::remove(static_logPath(m_basePath).c_str());
+    std::remove(static_snapshotPath(m_basePath).c_str());
+    Log_Debug2_T("");
+}
+
+
+std::size_t mdn::ChangeLog::logBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_logBytes;
+}
+
+
+bool mdn::ChangeLog::failed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+
+void mdn::ChangeLog::internal_enqueue(Job&& job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            Log_Debug3("Change log stopped, job dropped");
+            return;
+        }
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+
+void mdn::ChangeLog::internal_workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping && m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy = true;
+        }
+        const std::size_t written = internal_write(job);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy = false;
+            if (written == 0) {
+                m_failed = true;
+            } else if (job.isSnapshot) {
+                m_logBytes = 0;
+            } else {
+                m_logBytes += written;
+            }
+            if (m_jobs.empty()) {
+                m_drained.notify_all();
+            }
+        }
+    }
+}
+
+
+std::size_t mdn::ChangeLog::internal_write(const Job& job) {
+    if (job.isSnapshot) {
+        // Replace the snapshot first, then empty the log - see the generation note in the header
+        const std::uint64_t generation = m_generation + 1;
+        const std::string path = static_snapshotPath(m_basePath);
+        std::string encoded;
+        if (job.encode) {
+            try {
+                encoded = job.encode();
+            } catch (const std::exception& e) {
+                Log_Warn("Failed to encode autosave snapshot " << path << ": " << e.what());
+                return 0;
+            }
+        }
+        const std::string& snapshot = job.encode ? encoded : job.snapshot;
+        const std::string tmpPath = path + ".tmp";
+        std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+        bool ok =
+            file
+            && writeHeader(file, snapshotMagic, generation)
+            && std::fwrite(snapshot.data(), 1, snapshot.size(), file) == snapshot.size();
+        if (file) {
+            ok = (std::fclose(file) == 0) && ok;
+        }
+        if (ok && std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            // Some platforms will not rename over an existing file
+            std::remove(path.c_str());
+            ok = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+        }
+        if (!ok) {
+            Log_Warn("Failed to write autosave snapshot " << path << ", keeping the log");
+            std::remove(tmpPath.c_str());
+            return 0;
+        }
+        m_generation = generation;
+        if (!internal_openLog()) {
+            Log_Warn("Failed to restart change log " << static_logPath(m_basePath));
+        }
+        Log_Debug3("Wrote snapshot generation " << m_generation);
+        return snapshot.size();
+    }
+
+    if (!m_file) {
+        return 0;
+    }
+    std::string record;
+    record.reserve(
+        recordHeaderBytes + 2*sizeof(std::uint32_t) + job.name.size()
+        + job.writes.size()*recordDigitBytes
+    );
+    record.resize(recordHeaderBytes);
+    appendValue(record, static_cast<std::uint32_t>(job.name.size()));
+    record.append(job.name);
+    appendValue(record, static_cast<std::uint32_t>(job.writes.size()));
+    for (const auto& [xy, digit] : job.writes) {
+        appendValue(record, static_cast<std::int32_t>(xy.x()));
+        appendValue(record, static_cast<std::int32_t>(xy.y()));
+        record.push_back(static_cast<char>(digit));
+    }
+    const std::size_t payloadSize = record.size() - recordHeaderBytes;
+    const std::uint32_t size = static_cast<std::uint32_t>(payloadSize);
+    const std::uint32_t checksum = static_checksum(record.data() + recordHeaderBytes, payloadSize);
+    std::memcpy(&record[0], &size, sizeof(size));
+    std::memcpy(&record[sizeof(size)], &checksum, sizeof(checksum));
+    if (
+        std::fwrite(record.data(), 1, record.size(), m_file) != record.size()
+        || std::fflush(m_file) != 0
+    ) {
+        Log_Warn("Failed to append to change log " << static_logPath(m_basePath));
+        return 0;
+    }
+    return record.size();
+}
+
+
+bool mdn::ChangeLog::internal_openLog() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+    const std::string path = static_logPath(m_basePath);
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file || !writeHeader(m_file, logMagic, m_generation) || std::fflush(m_file) != 0) {
+        Log_Warn("Could not open change log " << path);
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        return false;
+    }
+    return true;
+}
+
+
+bool mdn::ChangeLog::static_readHeader(
+    std::FILE* file, const char* magic, std::uint64_t& generation
+) {
+    char buffer[8];
+    return
+        std::fread(buffer, 1, 8, file) == 8
+        && std::memcmp(buffer, magic, 8) == 0
+        && std::fread(&generation, sizeof(generation), 1, file) == 1;
+}
+
+
+std::uint32_t mdn::ChangeLog::static_checksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,325 @@
+#include <mdn/DigitJournal.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <mdn/Logger.hpp>
+
+
+namespace {
+
+// Bytes in a run header: y, x0, n
+constexpr std::size_t runHeaderBytes = 3*sizeof(std::int32_t);
+
+void appendInt(std::vector<char>& data, std::int32_t value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+std::int32_t readInt(const char* data) {
+    std::int32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // end anonymous namespace
+
+
+mdn::DigitJournal::DigitJournal(
+    std::size_t memoryBudget, std::size_t spillBytes, std::size_t maxSteps
+):
+    m_memoryBudget(memoryBudget),
+    m_spillBytes(spillBytes),
+    m_maxSteps(maxSteps),
+    m_memoryBytes(0),
+    m_spilledBytes(0),
+    m_fileBytes(0),
+    m_file(nullptr),
+    m_applying(false)
+{}
+
+
+mdn::DigitJournal::~DigitJournal() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+
+bool mdn::DigitJournal::seal(Writes* sealed) {
+    if (m_pending.empty()) {
+        return false;
+    }
+    Step step;
+    if (!internal_encode(step, sealed)) {
+        Log_Debug4("Pending changes cancel out, nothing to seal");
+        return false;
+    }
+    Log_Debug3("Sealing step of " << step.nDigits << " digits, " << step.size << " bytes");
+    for (const Step& redo : m_redo) {
+        internal_forget(redo);
+    }
+    m_redo.clear();
+    m_memoryBytes += step.size;
+    m_undo.push_back(std::move(step));
+    if (m_undo.back().size > m_spillBytes) {
+        if (internal_spill(m_undo.back())) {
+            m_memoryBytes -= m_undo.back().size;
+        }
+    }
+    internal_enforceLimits();
+    return true;
+}
+
+
+bool mdn::DigitJournal::takeUndo(Writes& writes) {
+    writes.clear();
+    if (m_undo.empty()) {
+        return false;
+    }
+    internal_decode(m_undo.back(), true, writes);
+    m_redo.push_back(std::move(m_undo.back()));
+    m_undo.pop_back();
+    return true;
+}
+
+
+bool mdn::DigitJournal::takeRedo(Writes& writes) {
+    writes.clear();
+    if (m_redo.empty()) {
+        return false;
+    }
+    internal_decode(m_redo.back(), false, writes);
+    m_undo.push_back(std::move(m_redo.back()));
+    m_redo.pop_back();
+    return true;
+}
+
+
+void mdn::DigitJournal::clear() {
+    m_pending.clear();
+    m_undo.clear();
+    m_redo.clear();
+    m_memoryBytes = 0;
+    m_spilledBytes = 0;
+    m_fileBytes = 0;
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+
+bool mdn::DigitJournal::internal_encode(Step& step, Writes* sealed) {
+    std::vector<std::pair<Coord, std::pair<Digit, Digit>>> changes;
+    changes.reserve(m_pending.size());
+    for (const auto& [xy, change] : m_pending) {
+        if (change.first != change.second) {
+            changes.emplace_back(xy, change);
+        }
+    }
+    m_pending.clear();
+    if (changes.empty()) {
+        return false;
+    }
+    std::sort(
+        changes.begin(),
+        changes.end(),
+        [](const auto& a, const auto& b) {
+            if (a.first.y() != b.first.y()) {
+                return a.first.y() < b.first.y();
+            }
+            return a.first.x() < b.first.x();
+        }
+    );
+    if (sealed) {
+        sealed->clear();
+        sealed->reserve(changes.size());
+        for (const auto& [xy, change] : changes) {
+            sealed->emplace_back(xy, change.second);
+        }
+    }
+    std::vector<char>& data = step.data;
+    data.reserve(2*changes.size() + runHeaderBytes);
+    std::size_t begin = 0;
+    while (begin < changes.size()) {
+        // Extend the run while the next digit is the right-hand neighbour
+        std::size_t end = begin + 1;
+        while (
+            end < changes.size()
+            && changes[end].first.y() == changes[begin].first.y()
+            && changes[end].first.x() == changes[end - 1].first.x() + 1
+        ) {
+            ++end;
+        }
+        const std::int32_t n = static_cast<std::int32_t>(end - begin);
+        appendInt(data, changes[begin].first.y());
+        appendInt(data, changes[begin].first.x());
+        appendInt(data, n);
+        for (std::size_t i = begin; i < end; ++i) {
+            data.push_back(static_cast<char>(changes[i].second.first));
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            data.push_back(static_cast<char>(changes[i].second.second));
+        }
+        begin = end;
+    }
+    data.shrink_to_fit();
+    step.size = data.size();
+    step.nDigits = changes.size();
+    return true;
+}
+
+
+void mdn::DigitJournal::internal_decode(const Step& step, bool undoing, Writes& writes) {
+    std::vector<char> loaded;
+    const char* data = step.data.data();
+    if (step.spilled()) {
+        loaded.resize(step.size);
+        if (
+            std::fseek(m_file, step.offset, SEEK_SET) != 0
+            || std::fread(loaded.data(), 1, step.size, m_file) != step.size
+        ) {
+            Log_Error("Failed to read journal step from temporary file, step skipped");
+            return;
+        }
+        data = loaded.data();
+    }
+    writes.reserve(step.nDigits);
+    std::size_t pos = 0;
+    while (pos < step.size) {
+        const std::int32_t y = readInt(data + pos);
+        const std::int32_t x0 = readInt(data + pos + sizeof(std::int32_t));
+        const std::int32_t n = readInt(data + pos + 2*sizeof(std::int32_t));
+        const char* digits = data + pos + runHeaderBytes + (undoing ? 0 : n);
+        for (std::int32_t i = 0; i < n; ++i) {
+            writes.emplace_back(Coord(x0 + i, y), static_cast<Digit>(digits[i]));
+        }
+        pos += runHeaderBytes + 2*static_cast<std::size_t>(n);
+    }
+}
+
+
+bool mdn::DigitJournal::internal_spill(Step& step) {
+    if (step.spilled()) {
+        return true;
+    }
+    if (!m_file) {
+        m_file = std::tmpfile();
+        if (!m_file) {
+            Log_Warn("Could not open a temporary file for the journal, keeping steps in memory");
+            return false;
+        }
+    }
+    if (std::fseek(m_file, 0, SEEK_END) != 0) {
+        return false;
+    }
+    const long offset = std::ftell(m_file);
+    if (offset < 0 || std::fwrite(step.data.data(), 1, step.size, m_file) != step.size) {
+        Log_Warn("Failed to write journal step to temporary file, keeping it in memory");
+        return false;
+    }
+    step.offset = offset;
+    step.data.clear();
+    step.data.shrink_to_fit();
+    m_spilledBytes += step.size;
+    m_fileBytes = static_cast<std::size_t>(offset) + step.size;
+    return true;
+}
+
+
+void mdn::DigitJournal::internal_enforceLimits() {
+    while (m_undo.size() > m_maxSteps) {
+        internal_forget(m_undo.front());
+        m_undo.pop_front();
+    }
+    // Oldest first: the undo history from its start, then the redo history from its far end
+    while (m_memoryBytes > m_memoryBudget) {
+        Step* oldest = nullptr;
+        for (Step& step : m_undo) {
+            if (!step.spilled()) {
+                oldest = &step;
+                break;
+            }
+        }
+        if (!oldest) {
+            for (Step& step : m_redo) {
+                if (!step.spilled()) {
+                    oldest = &step;
+                    break;
+                }
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        if (internal_spill(*oldest)) {
+            m_memoryBytes -= oldest->size;
+        } else if (!m_undo.empty()) {
+            // No temporary file, lose history instead
+            internal_forget(m_undo.front());
+            m_undo.pop_front();
+        } else {
+            break;
+        }
+    }
+    if (m_file && m_spilledBytes == 0) {
+        // Nothing left in the file, start it afresh
+        std::fclose(m_file);
+        m_file = nullptr;
+        m_fileBytes = 0;
+    } else if (m_file && m_fileBytes - m_spilledBytes > m_spilledBytes) {
+        internal_compact();
+    }
+}
+
+
+void mdn::DigitJournal::internal_compact() {
+    Log_Debug3(
+        "Compacting journal file, " << m_spilledBytes << " of " << m_fileBytes << " bytes live"
+    );
+    std::FILE* file = std::tmpfile();
+    if (!file) {
+        Log_Warn("Could not open a temporary file to compact the journal");
+        return;
+    }
+    // New offsets are applied only once every step is copied
+    std::vector<std::pair<Step*, long>> moved;
+    std::vector<char> buffer;
+    long offset = 0;
+    for (std::deque<Step>* history : {&m_undo, &m_redo}) {
+        for (Step& step : *history) {
+            if (!step.spilled()) {
+                continue;
+            }
+            buffer.resize(step.size);
+            if (
+                std::fseek(m_file, step.offset, SEEK_SET) != 0
+                || std::fread(buffer.data(), 1, step.size, m_file) != step.size
+                || std::fwrite(buffer.data(), 1, step.size, file) != step.size
+            ) {
+                Log_Warn("Failed to copy journal step while compacting, keeping the old file");
+                std::fclose(file);
+                return;
+            }
+            moved.emplace_back(&step, offset);
+            offset += static_cast<long>(step.size);
+        }
+    }
+    for (const auto& [step, newOffset] : moved) {
+        step->offset = newOffset;
+    }
+    std::fclose(m_file);
+    m_file = file;
+    m_fileBytes = static_cast<std::size_t>(offset);
+}
+
+
+void mdn::DigitJournal::internal_forget(const Step& step) {
+    if (step.spilled()) {
+        m_spilledBytes -= step.size;
+    } else {
+        m_memoryBytes -= step.size;
+    }
+}
@@ -0,0 +1,192 @@
+#include <mdn/DigitPyramid.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <mdn/Logger.hpp>
+
+
+int mdn::DigitPyramid::static_levelFor(const Rect& window, int maxCols, int maxRows) {
+    if (window.isInvalid()) {
+        return 0;
+    }
+    for (int level = 0; level < maxLevel; ++level) {
+        const Coord lo = static_tileOf(window.min(), level);
+        const Coord hi = static_tileOf(window.max(), level);
+        if (hi.x() - lo.x() < maxCols && hi.y() - lo.y() < maxRows) {
+            return level;
+        }
+    }
+    return maxLevel;
+}
+
+
+mdn::DigitPyramid::DigitPyramid():
+    m_levels(1),
+    m_polymorphic(1),
+    m_polymorphicEvent(-1)
+{}
+
+
+void mdn::DigitPyramid::change(const Coord& xy, Digit oldDigit, Digit newDigit) {
+    const int oldMagnitude = std::abs(oldDigit);
+    const int newMagnitude = std::abs(newDigit);
+    for (int level = 0; level < levels(); ++level) {
+        const Coord key = static_tileOf(xy, level);
+        Tile& tile = m_levels[level][key];
+        if (oldDigit) {
+            --tile.nonZero;
+            if (oldDigit > 0) {
+                --tile.positive;
+            }
+        }
+        if (newDigit) {
+            ++tile.nonZero;
+            if (newDigit > 0) {
+                ++tile.positive;
+            }
+            tile.maxMagnitude = std::max(tile.maxMagnitude, newMagnitude);
+        }
+        if (tile.nonZero == 0) {
+            m_levels[level].erase(key);
+        } else if (oldMagnitude >= tile.maxMagnitude && newMagnitude < oldMagnitude) {
+            // The largest digit may have gone
+            tile.stale = true;
+        }
+    }
+}
+
+
+void mdn::DigitPyramid::negate() {
+    for (Level& level : m_levels) {
+        for (auto& [key, tile] : level) {
+            tile.positive = tile.nonZero - tile.positive;
+        }
+    }
+}
+
+
+void mdn::DigitPyramid::setPolymorphic(const CoordSet& nodes, long long event) {
+    Log_Debug3_H("Binning " << nodes.size() << " polymorphic nodes over " << levels() << " levels");
+    for (int level = 0; level < levels(); ++level) {
+        Counts& counts = m_polymorphic[level];
+        counts.clear();
+        for (const Coord& xy : nodes) {
+            ++counts[static_tileOf(xy, level)];
+        }
+    }
+    m_polymorphicEvent = event;
+    Log_Debug3_T("");
+}
+
+
+mdn::Overview mdn::DigitPyramid::overview(
+    const Rect& window, int level, const DigitFn& digitAt
+) {
+    Log_Debug3_H("window=" << window << ", level=" << level);
+    Overview result;
+    level = std::clamp(level, 0, maxLevel);
+    result.level = level;
+    result.tileSize = static_tileSize(level);
+    if (window.isInvalid()) {
+        Log_Debug3_T("Empty window");
+        return result;
+    }
+    internal_ensureLevel(level);
+    result.tiles = Rect(static_tileOf(window.min(), level), static_tileOf(window.max(), level));
+    const int cols = result.cols();
+    const int rows = result.rows();
+    result.cells.resize(static_cast<std::size_t>(cols)*rows);
+    Level& tiles = m_levels[level];
+    const Counts& polymorphic = m_polymorphic[level];
+
+    // Visit whichever is smaller, the window's tiles or the level's tiles
+    auto fill = [&](const Coord& key, Tile& tile) {
+        OverviewTile& cell = result.cells[result.index(
+            key.x() - result.tiles.min().x(), result.tiles.max().y() - key.y()
+        )];
+        cell.nonZero = tile.nonZero;
+        cell.balance = 2*tile.positive - tile.nonZero;
+        cell.maxMagnitude = internal_resolveMax(level, key, tile, digitAt);
+        auto it = polymorphic.find(key);
+        cell.polymorphic = it == polymorphic.end() ? 0 : it->second;
+    };
+    if (result.cells.size() < tiles.size()) {
+        for (int ty = result.tiles.min().y(); ty <= result.tiles.max().y(); ++ty) {
+            for (int tx = result.tiles.min().x(); tx <= result.tiles.max().x(); ++tx) {
+                const Coord key(tx, ty);
+                auto it = tiles.find(key);
+                if (it != tiles.end()) {
+                    fill(key, it->second);
+                }
+            }
+        }
+    } else {
+        for (auto& [key, tile] : tiles) {
+            if (result.tiles.contains(key)) {
+                fill(key, tile);
+            }
+        }
+    }
+    Log_Debug3_T("Returning " << cols << "x" << rows << " tiles");
+    return result;
+}
+
+
+void mdn::DigitPyramid::internal_ensureLevel(int level) {
+    while (levels() <= level) {
+        const Level& below = m_levels.back();
+        const Counts& polymorphicBelow = m_polymorphic.back();
+        Level above;
+        Counts polymorphicAbove;
+        for (const auto& [key, tile] : below) {
+            Tile& parent = above[Coord(key.x() >> 1, key.y() >> 1)];
+            parent.nonZero += tile.nonZero;
+            parent.positive += tile.positive;
+            parent.maxMagnitude = std::max(parent.maxMagnitude, tile.maxMagnitude);
+            parent.stale = parent.stale || tile.stale;
+        }
+        for (const auto& [key, count] : polymorphicBelow) {
+            polymorphicAbove[Coord(key.x() >> 1, key.y() >> 1)] += count;
+        }
+        Log_Debug3("Built level " << levels() << ", " << above.size() << " tiles");
+        m_levels.push_back(std::move(above));
+        m_polymorphic.push_back(std::move(polymorphicAbove));
+    }
+}
+
+
+int mdn::DigitPyramid::internal_resolveMax(
+    int level, const Coord& tile, Tile& data, const DigitFn& digitAt
+) {
+    if (!data.stale) {
+        return data.maxMagnitude;
+    }
+    int result = 0;
+    if (level == 0) {
+        const int size = static_tileSize(0);
+        const int x0 = tile.x()*size;
+        const int y0 = tile.y()*size;
+        for (int y = y0; y < y0 + size; ++y) {
+            for (int x = x0; x < x0 + size; ++x) {
+                result = std::max(result, std::abs(static_cast<int>(digitAt(Coord(x, y)))));
+            }
+        }
+    } else {
+        Level& below = m_levels[level - 1];
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                const Coord child(2*tile.x() + dx, 2*tile.y() + dy);
+                auto it = below.find(child);
+                if (it != below.end()) {
+                    result = std::max(
+                        result, internal_resolveMax(level - 1, child, it->second, digitAt)
+                    );
+                }
+            }
+        }
+    }
+    data.maxMagnitude = result;
+    data.stale = false;
+    return result;
+}
@@ -0,0 +1,353 @@
+#include <mdn/ExactValue.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+
+#include <mdn/Logger.hpp>
+#include <mdn/MdnException.hpp>
+
+
+mdn::ExactValue mdn::ExactValue::static_fromDigits(int base, Terms& terms) {
+    ExactValue result(base);
+    if (terms.empty()) {
+        return result;
+    }
+    // Most significant first, each step scales the running mantissa up by the gap to the next
+    //  digit, then adds it in
+    std::sort(
+        terms.begin(),
+        terms.end(),
+        [](const std::pair<int, Digit>& a, const std::pair<int, Digit>& b) {
+            return a.first > b.first;
+        }
+    );
+    int position = terms.front().first;
+    for (const auto& [x, d] : terms) {
+        if (d == 0) {
+            continue;
+        }
+        if (!result.isZero()) {
+            result.m_exponent = position;
+            result.internal_lowerExponent(x);
+        }
+        position = x;
+        const uint32_t magnitude = static_cast<uint32_t>(d < 0 ? -static_cast<int>(d) : d);
+        if (result.isZero()) {
+            result.m_limbs.push_back(magnitude);
+            result.m_negative = d < 0;
+        } else if ((d < 0) == result.m_negative) {
+            result.internal_addSmall(magnitude);
+        } else if (result.m_limbs.size() > 1 || result.m_limbs[0] >= magnitude) {
+            result.internal_subSmall(magnitude);
+        } else {
+            // The digit outweighs the mantissa, the sign flips
+            result.m_limbs[0] = magnitude - result.m_limbs[0];
+            result.m_negative = d < 0;
+        }
+        result.internal_normalise();
+    }
+    if (!result.isZero()) {
+        result.m_exponent = position;
+    }
+    return result;
+}
+
+
+mdn::ExactValue::ExactValue(int base):
+    m_base(base),
+    m_exponent(0),
+    m_negative(false)
+{}
+
+
+mdn::ExactValue mdn::ExactValue::abs() const {
+    ExactValue result(*this);
+    result.m_negative = false;
+    return result;
+}
+
+
+mdn::ExactValue& mdn::ExactValue::negate() {
+    if (!isZero()) {
+        m_negative = !m_negative;
+    }
+    return *this;
+}
+
+
+mdn::ExactValue& mdn::ExactValue::operator+=(const ExactValue& rhs) {
+    internal_checkBase(rhs);
+    if (rhs.isZero()) {
+        return *this;
+    }
+    if (isZero()) {
+        *this = rhs;
+        return *this;
+    }
+    // Align the exponents, only the operand with the higher exponent is rescaled
+    const int exponent = std::min(m_exponent, rhs.m_exponent);
+    internal_lowerExponent(exponent);
+    ExactValue aligned(m_base);
+    const ExactValue* other = &rhs;
+    if (rhs.m_exponent != exponent) {
+        aligned = rhs;
+        aligned.internal_lowerExponent(exponent);
+        other = &aligned;
+    }
+    if (m_negative == other->m_negative) {
+        static_addLimbs(m_limbs, other->m_limbs);
+    } else if (static_compareLimbs(m_limbs, other->m_limbs) >= 0) {
+        static_subLimbs(m_limbs, other->m_limbs);
+    } else {
+        std::vector<uint32_t> limbs(other->m_limbs);
+        static_subLimbs(limbs, m_limbs);
+        m_limbs.swap(limbs);
+        m_negative = other->m_negative;
+    }
+    internal_normalise();
+    return *this;
+}
+
+
+int mdn::ExactValue::compareMagnitude(const ExactValue& rhs) const {
+    internal_checkBase(rhs);
+    if (isZero() || rhs.isZero()) {
+        return isZero() ? (rhs.isZero() ? 0 : -1) : 1;
+    }
+    // Estimates are within one bit of the true log2, so a wider gap decides it
+    const long double estimate = internal_log2Estimate();
+    const long double rhsEstimate = rhs.internal_log2Estimate();
+    if (estimate > rhsEstimate + 2) {
+        return 1;
+    }
+    if (estimate < rhsEstimate - 2) {
+        return -1;
+    }
+    const int exponent = std::min(m_exponent, rhs.m_exponent);
+    ExactValue a(*this);
+    ExactValue b(rhs);
+    a.internal_lowerExponent(exponent);
+    b.internal_lowerExponent(exponent);
+    return static_compareLimbs(a.m_limbs, b.m_limbs);
+}
+
+
+int mdn::ExactValue::compare(const ExactValue& rhs) const {
+    const int s = sign();
+    const int rhsSign = rhs.sign();
+    if (s != rhsSign) {
+        return s < rhsSign ? -1 : 1;
+    }
+    return s < 0 ? -compareMagnitude(rhs) : compareMagnitude(rhs);
+}
+
+
+long double mdn::ExactValue::toLongDouble() const {
+    if (isZero()) {
+        return 0.0L;
+    }
+    // The top three limbs hold more bits than a long double mantissa
+    const int n = static_cast<int>(m_limbs.size());
+    const int nTop = std::min(n, 3);
+    long double mantissa = 0.0L;
+    for (int i = n - 1; i >= n - nTop; --i) {
+        mantissa = mantissa*4294967296.0L + static_cast<long double>(m_limbs[i]);
+    }
+    const long long binaryExponent = 32LL*(n - nTop);
+    const long double power = std::pow(static_cast<long double>(m_base), m_exponent);
+    long double result;
+    // A subnormal power has already lost mantissa bits, even when the product would be normal
+    if (std::isnormal(power)) {
+        result = std::ldexp(
+            mantissa*power,
+            static_cast<int>(std::min<long long>(binaryExponent, INT_MAX))
+        );
+    } else {
+        // base^exponent alone is out of range or subnormal, but the product may not be
+        const long double log2Power = m_exponent*std::log2(static_cast<long double>(m_base));
+        const long double whole = std::floor(log2Power);
+        const long long shift = std::clamp<long long>(
+            binaryExponent + static_cast<long long>(whole), INT_MIN, INT_MAX
+        );
+        result = std::ldexp(mantissa*std::exp2(log2Power - whole), static_cast<int>(shift));
+    }
+    return m_negative ? -result : result;
+}
+
+
+std::string mdn::ExactValue::toString() const {
+    if (isZero()) {
+        return "0";
+    }
+    // Peel off nine decimal digits at a time
+    std::vector<uint32_t> limbs(m_limbs);
+    std::vector<uint32_t> chunks;
+    while (!limbs.empty()) {
+        uint64_t rem = 0;
+        for (int i = static_cast<int>(limbs.size()) - 1; i >= 0; --i) {
+            const uint64_t cur = (rem << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(cur / 1000000000u);
+            rem = cur % 1000000000u;
+        }
+        chunks.push_back(static_cast<uint32_t>(rem));
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+    }
+    std::string result = m_negative ? "-" : "";
+    result += std::to_string(chunks.back());
+    char buf[16];
+    for (int i = static_cast<int>(chunks.size()) - 2; i >= 0; --i) {
+        std::snprintf(buf, sizeof(buf), "%09u", static_cast<unsigned>(chunks[i]));
+        result += buf;
+    }
+    if (m_exponent != 0) {
+        result += " x " + std::to_string(m_base) + "^" + std::to_string(m_exponent);
+    }
+    return result;
+}
+
+
+long double mdn::ExactValue::internal_log2Estimate() const {
+    const uint32_t top = m_limbs.back();
+    int topBits = 0;
+    while (topBits < 32 && (top >> topBits) != 0) {
+        ++topBits;
+    }
+    const long double bits = 32.0L*(m_limbs.size() - 1) + topBits;
+    return bits + m_exponent*std::log2(static_cast<long double>(m_base));
+}
+
+
+void mdn::ExactValue::internal_lowerExponent(int newExponent) {
+    int n = m_exponent - newExponent;
+    m_exponent = newExponent;
+    if (n <= 0 || isZero()) {
+        return;
+    }
+    // Multiply by the largest power of base that fits a limb, as often as possible
+    uint32_t chunk = 1;
+    int chunkPower = 0;
+    while (static_cast<uint64_t>(chunk)*m_base <= 0xFFFFFFFFu) {
+        chunk *= m_base;
+        ++chunkPower;
+    }
+    for (; n >= chunkPower; n -= chunkPower) {
+        internal_mulSmall(chunk);
+    }
+    if (n > 0) {
+        uint32_t rest = 1;
+        for (int i = 0; i < n; ++i) {
+            rest *= m_base;
+        }
+        internal_mulSmall(rest);
+    }
+}
+
+
+void mdn::ExactValue::internal_mulSmall(uint32_t factor) {
+    uint64_t carry = 0;
+    for (uint32_t& limb : m_limbs) {
+        const uint64_t cur = static_cast<uint64_t>(limb)*factor + carry;
+        limb = static_cast<uint32_t>(cur);
+        carry = cur >> 32;
+    }
+    if (carry) {
+        m_limbs.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+
+void mdn::ExactValue::internal_addSmall(uint32_t value) {
+    uint64_t carry = value;
+    for (std::size_t i = 0; carry && i < m_limbs.size(); ++i) {
+        const uint64_t cur = static_cast<uint64_t>(m_limbs[i]) + carry;
+        m_limbs[i] = static_cast<uint32_t>(cur);
+        carry = cur >> 32;
+    }
+    if (carry) {
+        m_limbs.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+
+void mdn::ExactValue::internal_subSmall(uint32_t value) {
+    uint32_t borrow = value;
+    for (std::size_t i = 0; borrow && i < m_limbs.size(); ++i) {
+        const uint32_t prev = m_limbs[i];
+        m_limbs[i] = prev - borrow;
+        borrow = prev < borrow ? 1 : 0;
+    }
+}
+
+
+int mdn::ExactValue::static_compareLimbs(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b
+) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (std::size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+
+void mdn::ExactValue::static_addLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.size() < b.size()) {
+        a.resize(b.size(), 0);
+    }
+    uint64_t carry = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const uint64_t cur = static_cast<uint64_t>(a[i]) + (i < b.size() ? b[i] : 0) + carry;
+        a[i] = static_cast<uint32_t>(cur);
+        carry = cur >> 32;
+        if (!carry && i >= b.size()) {
+            break;
+        }
+    }
+    if (carry) {
+        a.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+
+void mdn::ExactValue::static_subLimbs(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    int64_t borrow = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        int64_t cur = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = cur < 0 ? 1 : 0;
+        if (cur < 0) {
+            cur += 4294967296LL;
+        }
+        a[i] = static_cast<uint32_t>(cur);
+        if (!borrow && i >= b.size()) {
+            break;
+        }
+    }
+}
+
+
+void mdn::ExactValue::internal_normalise() {
+    while (!m_limbs.empty() && m_limbs.back() == 0) {
+        m_limbs.pop_back();
+    }
+    if (m_limbs.empty()) {
+        m_negative = false;
+        m_exponent = 0;
+    }
+}
+
+
+void mdn::ExactValue::internal_checkBase(const ExactValue& rhs) const {
+    if (m_base != rhs.m_base) {
+        BaseMismatch err(m_base, rhs.m_base);
+        Log_Error(err.what());
+        throw err;
+    }
+}
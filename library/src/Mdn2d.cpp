@@ -1,17 +1,23 @@
 #include <mdn/Mdn2d.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <mutex>
 #include <stdexcept>
 #include <sstream>
+#include <utility>
+#include <vector>
 
+#include <mdn/BaseKernels.hpp>
 #include <mdn/Constants.hpp>
 #include <mdn/Logger.hpp>
 #include <mdn/MdnException.hpp>
+#include <mdn/ResultCache.hpp>
 #include <mdn/Selection.hpp>
 #include <mdn/Tools.hpp>
 
-
 mdn::Mdn2d::Mdn2d(std::string nameIn) :
     Mdn2dRules(nameIn)
 {
@@ -26,6 +32,15 @@ mdn::Mdn2d::Mdn2d(Mdn2dConfig config, std::string nameIn) :
 }
 
 
+mdn::Mdn2d::Mdn2d(
+    Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource
+) :
+    Mdn2dRules(config, nameIn, resource)
+{
+    Log_N_Debug2("Config=" << config);
+}
+
+
 mdn::Mdn2d::Mdn2d(const Mdn2d& other, std::string nameIn):
     Mdn2dRules(other, nameIn)
 {
@@ -98,8 +113,18 @@ void mdn::Mdn2d::plus(const Mdn2d& rhs, Mdn2d& ans) const {
     assertNotSelf(ans, "plus operation");
     auto lockThis = lockReadOnly();
     auto lockAns = ans.lockWriteable();
-    CoordSet changed = locked_plus(rhs, ans);
-    ans.locked_carryoverCleanup(changed);
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (
+        !cache.fetch(
+            CachedOperation::Plus, *this, rhs, ans, nullptr, nullptr, 0, Fraxis::Invalid, pending
+        )
+    ) {
+        CoordSet changed = locked_plus(rhs, ans);
+        ans.locked_carryoverCleanup(changed);
+        cache.store(pending, ans, nullptr, 0.0);
+    }
+    ans.internal_operationComplete();
     Log_N_Debug2_T("");
 }
 
@@ -108,9 +133,11 @@ mdn::CoordSet mdn::Mdn2d::locked_plus(const Mdn2d& rhs, Mdn2d& ans) const {
     Log_N_Debug3_H("ans(" << ans.m_name << ") = *this(" << m_name << ") + rhs(" << rhs.m_name << ")");
     CoordSet changed;
     ans.locked_operatorEquals(*this);
-    for (const auto& [xy, digit] : rhs.m_raw) {
-        changed.merge(ans.locked_add(xy, digit));
-    }
+    static_dispatchBase(ans.m_config.base(), [&](const auto& kernel) {
+        for (const auto& [xy, digit] : rhs.m_data->raw) {
+            ans.internal_add(kernel, xy, digit, false, changed);
+        }
+    });
     Log_N_Debug3_T("changed " << changed.size() << " digits");
     return changed;
 }
@@ -121,8 +148,18 @@ void mdn::Mdn2d::minus(const Mdn2d& rhs, Mdn2d& ans) const {
     assertNotSelf(ans, "minus operation");
     auto lockThis = lockReadOnly();
     auto lockAns = ans.lockWriteable();
-    CoordSet changed = locked_minus(rhs, ans);
-    ans.locked_carryoverCleanup(changed);
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (
+        !cache.fetch(
+            CachedOperation::Minus, *this, rhs, ans, nullptr, nullptr, 0, Fraxis::Invalid, pending
+        )
+    ) {
+        CoordSet changed = locked_minus(rhs, ans);
+        ans.locked_carryoverCleanup(changed);
+        cache.store(pending, ans, nullptr, 0.0);
+    }
+    ans.internal_operationComplete();
     Log_N_Debug2_T("");
 }
 
@@ -131,9 +168,11 @@ mdn::CoordSet mdn::Mdn2d::locked_minus(const Mdn2d& rhs, Mdn2d& ans) const {
     Log_N_Debug3_H("ans(" << ans.m_name << ") = *this(" << m_name << ") - rhs(" << rhs.m_name << ")");
     CoordSet changed;
     ans.locked_operatorEquals(*this);
-    for (const auto& [xy, digit] : rhs.m_raw) {
-        changed.merge(ans.locked_add(xy, -digit));
-    }
+    static_dispatchBase(ans.m_config.base(), [&](const auto& kernel) {
+        for (const auto& [xy, digit] : rhs.m_data->raw) {
+            ans.internal_add(kernel, xy, -digit, false, changed);
+        }
+    });
     Log_N_Debug3_T("changed " << changed.size() << " digits");
     return changed;
 }
@@ -149,8 +188,19 @@ void mdn::Mdn2d::multiply(const Mdn2d& rhs, Mdn2d& ans) const {
         lockRhsPtr = &lockRhs;
     }
     auto lockAns = ans.lockWriteable();
-    CoordSet changed = locked_multiply(rhs, ans);
-    ans.locked_carryoverCleanup(changed);
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (
+        !cache.fetch(
+            CachedOperation::Multiply, *this, rhs, ans, nullptr, nullptr, 0, Fraxis::Invalid,
+            pending
+        )
+    ) {
+        CoordSet changed = locked_multiply(rhs, ans);
+        ans.locked_carryoverCleanup(changed);
+        cache.store(pending, ans, nullptr, 0.0);
+    }
+    ans.internal_operationComplete();
     Log_N_Debug2_T("");
 }
 
@@ -165,19 +215,23 @@ mdn::CoordSet mdn::Mdn2d::locked_multiply(const Mdn2d& rhs, Mdn2d& ans) const {
     }
     ans.locked_setPrecision(sumPrecision);
     ans.locked_clear();
-    for (const auto& [xy, digit] : rhs.m_raw) {
+    // One arena for every partial product, released when the multiply is done
+    ScratchArena arena;
+    Mdn2d temp(m_config, "tmp_multiply", arena.resource());
+    auto tempLock = temp.lockWriteable();
+    for (const auto& [xy, digit] : rhs.m_data->raw) {
         int id = static_cast<int>(digit);
         // ans += (this x rhs_id).shift(rhs_xy)
         Log_N_Debug4("multiply loop: " << xy << ", " << static_cast<int>(digit));
-        Mdn2d temp(internal_copyMultiplyAndShift(id, xy));
-        ans.locked_plusEquals(std::move(temp));
+        internal_copyMultiplyAndShift(id, xy, temp, arena);
+        ans.locked_plusEquals(temp);
         Log_N_Debug4("Done plusEquals step");
     }
     int finalPrecision =
         sumPrecision < 0 ? -1 : std::round(sumPrecision*0.5);
     ans.locked_setPrecision(finalPrecision);
-    Log_N_Debug3_T("ans has " << ans.m_index.size() << " changed digits");
-    return ans.m_index;
+    Log_N_Debug3_T("ans has " << ans.m_data->index.size() << " changed digits");
+    return CoordSet(ans.m_data->index.begin(), ans.m_data->index.end());
 }
 
 
@@ -188,7 +242,18 @@ void mdn::Mdn2d::divideIterate(
     auto lockRhs = rhs.lockReadOnly();
     auto lockAns = ans.lockWriteable();
     auto lockRem = rem.lockWriteable();
-    return locked_divideIterate(nIters, rhs, ans, rem, remMag, fraxis);
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (
+        !cache.fetch(
+            CachedOperation::DivideIterate, *this, rhs, ans, &rem, &remMag, nIters, fraxis, pending
+        )
+    ) {
+        locked_divideIterate(nIters, rhs, ans, rem, remMag, fraxis);
+        cache.store(pending, ans, &rem, remMag);
+    }
+    ans.internal_operationComplete();
+    rem.internal_operationComplete();
 }
 
 
@@ -210,7 +275,7 @@ void mdn::Mdn2d::locked_divideIterate(
     //  rhs   = q values (qVal, qOffset, qSign, etc)
     //  ans   = t values (tVal, tOffset, tSign, etc)
     // internal_checkFraxis(fraxis);
-    if (rhs.m_index.empty()) {
+    if (rhs.m_data->index.empty()) {
         Log_N_Debug_T("Divisor is zero, answer is undefined");
         remMag = -1.0;
         return;
@@ -218,9 +283,6 @@ void mdn::Mdn2d::locked_divideIterate(
     CoordSet ansChanged;
     CoordSet remChanged;
 
-    // Find principal row for division - row with largest absolute magnitude
-    Coord pOffset;
-    long double pVal;
     if (fraxis == Fraxis::Invalid) {
         Log_Warn("Fraxis set to invalid value, changing to Fraxis::Default");
         fraxis = Fraxis::Default;
@@ -228,28 +290,33 @@ void mdn::Mdn2d::locked_divideIterate(
 
     Fraxis lastFraxis = fraxis;
     if (lastFraxis == Fraxis::Default) {
-        // Alternating fraxis directions, start with X
-        static Fraxis altStart = Fraxis::X;
-        fraxis = altStart;
-        altStart = altStart == Fraxis::X ? Fraxis::Y : Fraxis::X;
+        // Alternating fraxis directions, every call starts with X
+        fraxis = Fraxis::X;
     }
-    Log_N_Debug3_H("rhs row/col magMax dispatch");
-    if (
-        (fraxis == Fraxis::X && !rhs.locked_getRowMagMax(pOffset, pVal))
-        || (fraxis == Fraxis::Y && !rhs.locked_getColMagMax(pOffset, pVal))
-    ) {
-        Log_N_Debug3_T("rhs row/col magMax return");
-        Log_Warn("Failed to find max magnitude row or col");
-        remMag = -1.0;
-        Log_N_Debug_T("Failed magMax")
-        return;
-    }
-    Log_N_Debug3_T("rhs row/col magMax return, pOffset=" << pOffset << ", pVal=" << pVal);
+    // Scratch number for each iteration's quotient digits, cleared and reused every iteration
+    ScratchArena arena;
+    Mdn2d tmp(m_config, "tmp_divide", arena.resource());
     int iter = 0;
     for (; iter < nIters; ++iter) {
         Log_N_Debug3(
             "iter " << iter << " of " << nIters << ", fraxis=" << FraxisToName(fraxis)
         );
+        // Find principal row (or column) for division - largest absolute magnitude along the
+        //  current fraxis, the direction may alternate between iterations
+        Coord pOffset;
+        long double pVal;
+        Log_N_Debug3_H("rhs row/col magMax dispatch");
+        if (
+            (fraxis == Fraxis::X && !rhs.locked_getRowMagMax(pOffset, pVal))
+            || (fraxis == Fraxis::Y && !rhs.locked_getColMagMax(pOffset, pVal))
+        ) {
+            Log_N_Debug3_T("rhs row/col magMax return");
+            Log_Warn("Failed to find max magnitude row or col");
+            remMag = -1.0;
+            Log_N_Debug_T("Failed magMax")
+            return;
+        }
+        Log_N_Debug3_T("rhs row/col magMax return, pOffset=" << pOffset << ", pVal=" << pVal);
         Coord qOffset;
         long double qVal;
         Log_N_Debug2_H("rem row/col magMax dispatch");
@@ -275,7 +342,7 @@ void mdn::Mdn2d::locked_divideIterate(
             emplacement = Coord(qOffset.x() - pOffset.x(), 0);
         }
         Log_N_Debug3("emplacement=" << emplacement);
-        Mdn2d tmp(m_config, "tmp_divide");
+        tmp.locked_clear();
         Log_N_Debug3("internal_emplace(emplacement, div=" << div << ", fraxis)");
         static_cast<void>(tmp.internal_emplace(emplacement, div, fraxis));
         Log_N_Debug3("ans.locked_plusEquals(tmp)");
@@ -308,6 +375,147 @@ void mdn::Mdn2d::locked_divideIterate(
 }
 
 
+mdn::Fraxis mdn::Mdn2d::divideSpeculative(
+    int nIters, const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, int stallIters
+) const {
+    auto lockThis = lockReadOnly();
+    auto lockRhs = rhs.lockReadOnly();
+    auto lockAns = ans.lockWriteable();
+    auto lockRem = rem.lockWriteable();
+    return locked_divideSpeculative(nIters, rhs, ans, rem, remMag, stallIters);
+}
+
+
+mdn::Fraxis mdn::Mdn2d::locked_divideSpeculative(
+    int nIters, const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, int stallIters
+) const {
+    If_Log_Showing_Debug(
+        Log_N_Debug_H(""
+            << "nIters=" << nIters
+            << ", rhs=" << rhs.locked_name()
+            << ", ans=" << ans.locked_name()
+            << ", rem=" << rem.locked_name()
+            << ", stallIters=" << stallIters
+        );
+    );
+    // Each strategy works on its own copies, the shared operands are only read, and the caller's
+    //  locks on them are held until every strategy is done.  Remainders do not fall steadily, so
+    //  each strategy keeps a snapshot of its best state, shared with its working copies until
+    //  the next write.
+    struct Strategy {
+        Fraxis fraxis;
+        Mdn2d ans;
+        Mdn2d rem;
+        long double remMag;
+        int iters;
+        Mdn2d bestAns;
+        Mdn2d bestRem;
+        long double bestMag;
+    };
+    std::vector<Strategy> strategies;
+    strategies.reserve(3);
+    for (Fraxis fraxis : {Fraxis::Default, Fraxis::X, Fraxis::Y}) {
+        const std::string suffix = "_" + FraxisToName(fraxis);
+        strategies.push_back(
+            Strategy{
+                fraxis,
+                Mdn2d(ans, ans.locked_name() + suffix),
+                Mdn2d(rem, rem.locked_name() + suffix),
+                constants::ldoubleGreat,
+                0,
+                Mdn2d(ans, ans.locked_name() + suffix + "_best"),
+                Mdn2d(rem, rem.locked_name() + suffix + "_best"),
+                -1.0
+            }
+        );
+    }
+    std::atomic<bool> exact(false);
+    // Smallest best remMag of any strategy so far
+    std::mutex leaderMutex;
+    long double leaderMag = constants::ldoubleGreat;
+    auto run = [&](Strategy& s) {
+        auto lockAns = s.ans.lockWriteable();
+        auto lockRem = s.rem.lockWriteable();
+        auto lockBestAns = s.bestAns.lockWriteable();
+        auto lockBestRem = s.bestRem.lockWriteable();
+        int sinceBest = 0;
+        // One iteration at a time, so the alternating strategy steers its own direction
+        Fraxis fraxis = s.fraxis == Fraxis::Default ? Fraxis::X : s.fraxis;
+        for (; s.iters < nIters && !exact; ++s.iters) {
+            locked_divideIterate(1, rhs, s.ans, s.rem, s.remMag, fraxis);
+            if (s.remMag < 0.0) {
+                ++s.iters;
+                break;
+            }
+            if (s.bestMag < 0.0 || s.remMag < s.bestMag) {
+                s.bestAns.locked_operatorEquals(s.ans);
+                s.bestRem.locked_operatorEquals(s.rem);
+                s.bestMag = s.remMag;
+                sinceBest = 0;
+                std::lock_guard<std::mutex> lock(leaderMutex);
+                leaderMag = std::min(leaderMag, s.bestMag);
+            } else if (++sinceBest >= stallIters && s.fraxis != Fraxis::Default) {
+                // The alternating strategy always runs on, so the result is never worse than
+                //  divideIterate with Fraxis::Default
+                bool trailing = false;
+                {
+                    std::lock_guard<std::mutex> lock(leaderMutex);
+                    trailing = s.bestMag > leaderMag;
+                }
+                if (trailing) {
+                    Log_N_Debug2(
+                        "Abandoning " << FraxisToName(s.fraxis) << " after " << s.iters + 1
+                        << " iterations, stalled at best remMag=" << s.bestMag
+                        << ", leader has " << leaderMag
+                    );
+                    ++s.iters;
+                    break;
+                }
+            }
+            if (s.remMag == 0.0) {
+                exact = true;
+                ++s.iters;
+                break;
+            }
+            if (s.fraxis == Fraxis::Default) {
+                fraxis = fraxis == Fraxis::X ? Fraxis::Y : Fraxis::X;
+            }
+        }
+    };
+    ThreadPool::shared().parallelFor(
+        0,
+        static_cast<int>(strategies.size()),
+        [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                run(strategies[i]);
+            }
+        }
+    );
+
+    // Keep the smallest best remainder, earlier strategies win ties
+    const Strategy* winner = nullptr;
+    for (const Strategy& s : strategies) {
+        Log_N_Debug2(
+            FraxisToName(s.fraxis) << ": best remMag=" << s.bestMag << ", final remMag="
+            << s.remMag << " after " << s.iters << " iterations"
+        );
+        if (s.bestMag >= 0.0 && (!winner || s.bestMag < winner->bestMag)) {
+            winner = &s;
+        }
+    }
+    if (!winner) {
+        remMag = -1.0;
+        Log_N_Debug_T("All strategies failed");
+        return Fraxis::Invalid;
+    }
+    ans.locked_operatorEquals(winner->bestAns);
+    rem.locked_operatorEquals(winner->bestRem);
+    remMag = winner->bestMag;
+    Log_N_Debug_T("Kept " << FraxisToName(winner->fraxis) << ", remMag=" << remMag);
+    return winner->fraxis;
+}
+
+
 void mdn::Mdn2d::divide(const Mdn2d& rhs, Mdn2d& ans, Fraxis fraxis) const {
     If_Log_Showing_Debug2(
         Log_N_Debug2_H("ans = *this / rhs, fraxis: " << FraxisToName(fraxis));
@@ -315,8 +523,16 @@ void mdn::Mdn2d::divide(const Mdn2d& rhs, Mdn2d& ans, Fraxis fraxis) const {
     assertNotSelf(ans, "divide operation");
     auto lockThis = lockReadOnly();
     auto lockAns = ans.lockWriteable();
-    CoordSet changed = locked_divide(rhs, ans, fraxis);
-    Log_N_Debug2_T("changed.size() = " << changed.size());
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (
+        !cache.fetch(CachedOperation::Divide, *this, rhs, ans, nullptr, nullptr, 0, fraxis, pending)
+    ) {
+        locked_divide(rhs, ans, fraxis);
+        cache.store(pending, ans, nullptr, 0.0);
+    }
+    ans.internal_operationComplete();
+    Log_N_Debug2_T("");
 }
 
 
@@ -324,14 +540,51 @@ mdn::CoordSet mdn::Mdn2d::locked_divide(const Mdn2d& rhs, Mdn2d& ans, Fraxis fra
     If_Log_Showing_Debug3(
         Log_N_Debug3_H("ans = *this / rhs, fraxis: " << FraxisToName(fraxis));
     );
-    ans.locked_clear();
-    Mdn2d rem(*this, "rem_divide");
+    Mdn2d rem(m_config, "rem_divide");
+    auto lockRem = rem.lockWriteable();
+    long double remMag;
+    CoordSet changed = locked_divide(rhs, ans, rem, remMag, fraxis);
+    Log_N_Debug3_T("remMag = " << remMag);
+    return changed;
+}
+
+
+void mdn::Mdn2d::divide(
+    const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, Fraxis fraxis
+) const {
+    If_Log_Showing_Debug2(
+        Log_N_Debug2_H("ans = *this / rhs, with remainder, fraxis: " << FraxisToName(fraxis));
+    );
+    assertNotSelf(ans, "divide operation");
+    assertNotSelf(rem, "divide operation");
+    auto lockThis = lockReadOnly();
+    auto lockRhs = rhs.lockReadOnly();
+    auto lockAns = ans.lockWriteable();
     auto lockRem = rem.lockWriteable();
+    ResultCache& cache = ResultCache::shared();
+    std::unique_ptr<ResultCache::Entry> pending;
+    if (!cache.fetch(CachedOperation::Divide, *this, rhs, ans, &rem, &remMag, 0, fraxis, pending)) {
+        locked_divide(rhs, ans, rem, remMag, fraxis);
+        cache.store(pending, ans, &rem, remMag);
+    }
+    ans.internal_operationComplete();
+    rem.internal_operationComplete();
+    Log_N_Debug2_T("remMag = " << remMag);
+}
+
+
+mdn::CoordSet mdn::Mdn2d::locked_divide(
+    const Mdn2d& rhs, Mdn2d& ans, Mdn2d& rem, long double& remMag, Fraxis fraxis
+) const {
+    If_Log_Showing_Debug3(
+        Log_N_Debug3_H("ans = *this / rhs, with remainder, fraxis: " << FraxisToName(fraxis));
+    );
+    ans.locked_clear();
     rem.locked_operatorEquals(*this);
     long double lastRemMag = constants::ldoubleGreat;
-    long double remMag;
     locked_divideIterate(100, rhs, ans, rem, remMag, fraxis);
-    while (remMag < lastRemMag && remMag >= 0.0) {
+    while (remMag < lastRemMag && remMag > 0.0) {
+        lastRemMag = remMag;
         locked_divideIterate(100, rhs, ans, rem, remMag, fraxis);
     }
     if (remMag < 0) {
@@ -590,26 +843,9 @@ void mdn::Mdn2d::add(const Coord& xy, int value, bool overwrite, Fraxis unused)
 
 
 mdn::CoordSet mdn::Mdn2d::locked_add(const Coord& xy, int value, bool overwrite) {
-    int val(internal_checkOverwrite<int>(xy, overwrite));
-    int sum = val + value;
-    int carry = sum / m_config.base();
-    int rem = sum % m_config.base();
     CoordSet changed;
-    Log_N_Debug3_H(
-        "at " << xy << ", add " << value << ", no fraxis, result: " << sum << ":(r"
-        << rem << ",c" << carry << ")"
-    );
-
-    if (locked_setValue(xy, rem)) {
-        changed.insert(xy);
-    }
-    if (carry != 0) {
-        changed.merge(locked_add(xy.translatedX(1), carry, overwrite));
-        changed.merge(locked_add(xy.translatedY(1), carry, overwrite));
-    }
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    internal_add(xy, static_cast<long long>(value), overwrite, changed);
     return changed;
-    // internal_operationComplete();
 }
 
 
@@ -623,23 +859,8 @@ void mdn::Mdn2d::add(const Coord& xy, long value, bool overwrite, Fraxis unused)
 
 
 mdn::CoordSet mdn::Mdn2d::locked_add(const Coord& xy, long value, bool overwrite) {
-    long val(internal_checkOverwrite<long>(xy, overwrite));
-    long sum = val + value;
-    long carry = sum / m_config.base();
-    long rem = sum % m_config.base();
-    Log_N_Debug3_H(
-        "at " << xy << ", add " << value << ", no fraxis, result: " << sum << ":(r"
-        << rem << ",c" << carry << ")"
-    );
     CoordSet changed;
-    if (locked_setValue(xy, rem)) {
-        changed.insert(xy);
-    }
-    if (carry != 0) {
-        changed.merge(locked_add(xy.translatedX(1), carry, overwrite));
-        changed.merge(locked_add(xy.translatedY(1), carry, overwrite));
-    }
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    internal_add(xy, static_cast<long long>(value), overwrite, changed);
     return changed;
 }
 
@@ -654,23 +875,8 @@ void mdn::Mdn2d::add(const Coord& xy, long long value, bool overwrite, Fraxis un
 
 
 mdn::CoordSet mdn::Mdn2d::locked_add(const Coord& xy, long long value, bool overwrite) {
-    long long val(internal_checkOverwrite<long long>(xy, overwrite));
-    long long sum = val + value;
-    long long carry = sum / m_config.base();
-    long long rem = sum % m_config.base();
-    Log_N_Debug3_H(
-        "at " << xy << ", add " << value << ", no fraxis, result: " << sum << ":(r"
-        << rem << ",c" << carry << ")"
-    );
     CoordSet changed;
-    if (locked_setValue(xy, rem)) {
-        changed.insert(xy);
-    }
-    if (carry != 0) {
-        changed.merge(locked_add(xy.translatedX(1), carry, overwrite));
-        changed.merge(locked_add(xy.translatedY(1), carry, overwrite));
-    }
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    internal_add(xy, value, overwrite, changed);
     return changed;
 }
 
@@ -856,53 +1062,133 @@ void mdn::Mdn2d::multiply(long long value) {
 
 
 mdn::CoordSet mdn::Mdn2d::locked_multiply(int value) {
-    Log_N_Debug3_H("scalar multiply " << value);
-    Mdn2d temp = NewInstance(m_config);
-    auto tempLock = temp.lockWriteable();
-    CoordSet changed;
-
-    for (const auto& [xy, digit] : m_raw) {
-        int vxd = value*static_cast<int>(digit);
-        changed.merge(temp.locked_add(xy, vxd));
-    }
-    locked_operatorEquals(temp);
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
-    return changed;
+    ScratchArena arena;
+    return internal_multiplyScalar(static_cast<long long>(value), arena);
 }
 
 
 mdn::CoordSet mdn::Mdn2d::locked_multiply(long value) {
-    Log_N_Debug3_H("scalar multiply " << value);
-    Mdn2d temp = NewInstance(m_config);
-    auto tempLock = temp.lockWriteable();
-    CoordSet changed;
+    ScratchArena arena;
+    return internal_multiplyScalar(static_cast<long long>(value), arena);
+}
+
+
+mdn::CoordSet mdn::Mdn2d::locked_multiply(long long value) {
+    ScratchArena arena;
+    return internal_multiplyScalar(value, arena);
+}
+
 
-    for (const auto& [xy, digit] : m_raw) {
-        long vxd = value*static_cast<long>(digit);
-        changed.merge(temp.locked_add(xy, vxd));
+void mdn::Mdn2d::negateRegion(const Rect& region) {
+    Log_N_Debug2_H("region=" << region);
+    auto lock = lockWriteable();
+    locked_negateRegion(region);
+    internal_operationComplete();
+    Log_N_Debug2_T("");
+}
+
+
+mdn::CoordSet mdn::Mdn2d::locked_negateRegion(const Rect& region) {
+    // Negated digits never carry
+    return internal_transformRegion(region, -1, [](const Coord& xy) { return xy; });
+}
+
+
+void mdn::Mdn2d::multiplyRegion(const Rect& region, long long value) {
+    Log_N_Debug2_H("region=" << region << ", value=" << value);
+    auto lock = lockWriteable();
+    locked_carryoverCleanup(locked_multiplyRegion(region, value));
+    internal_operationComplete();
+    Log_N_Debug2_T("");
+}
+
+
+mdn::CoordSet mdn::Mdn2d::locked_multiplyRegion(const Rect& region, long long value) {
+    if (value == 1) {
+        Log_N_Debug3("Identity, no change");
+        return CoordSet();
     }
-    locked_operatorEquals(temp);
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
-    return changed;
+    return internal_transformRegion(region, value, [](const Coord& xy) { return xy; });
 }
 
 
-mdn::CoordSet mdn::Mdn2d::locked_multiply(long long value) {
-    Log_N_Debug3_H("scalar multiply " << value);
-    Mdn2d temp = NewInstance(m_config);
-    auto tempLock = temp.lockWriteable();
-    CoordSet changed;
+void mdn::Mdn2d::shiftRegion(const Rect& region, const Coord& xy) {
+    Log_N_Debug2_H("region=" << region << ", xy=" << xy);
+    auto lock = lockWriteable();
+    locked_carryoverCleanup(locked_shiftRegion(region, xy));
+    internal_operationComplete();
+    Log_N_Debug2_T("");
+}
+
 
-    for (const auto& [xy, digit] : m_raw) {
-        long long vxd = value*static_cast<long long>(digit);
-        changed.merge(temp.locked_add(xy, vxd));
+mdn::CoordSet mdn::Mdn2d::locked_shiftRegion(const Rect& region, const Coord& xy) {
+    if (xy == COORD_ORIGIN) {
+        Log_N_Debug3("No shift, no change");
+        return CoordSet();
     }
-    locked_operatorEquals(temp);
-    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    return internal_transformRegion(
+        region, 1, [&xy](const Coord& from) { return from.translated(xy); }
+    );
+}
+
+
+void mdn::Mdn2d::transposeRegion(const Rect& region) {
+    Log_N_Debug2_H("region=" << region);
+    auto lock = lockWriteable();
+    locked_carryoverCleanup(locked_transposeRegion(region));
+    internal_operationComplete();
+    Log_N_Debug2_T("");
+}
+
+
+mdn::CoordSet mdn::Mdn2d::locked_transposeRegion(const Rect& region) {
+    const Coord corner = region.min();
+    return internal_transformRegion(
+        region,
+        1,
+        [&corner](const Coord& from) {
+            return Coord(
+                corner.x() + from.y() - corner.y(), corner.y() + from.x() - corner.x()
+            );
+        }
+    );
+}
+
+
+mdn::CoordSet mdn::Mdn2d::carryoverCleanupRegion(const Rect& region, SignConvention sc) {
+    Log_N_Debug2_H("region=" << region);
+    auto lock = lockWriteable();
+    CoordSet changed = locked_carryoverCleanupRegion(region, sc);
+    internal_operationComplete();
+    Log_N_Debug2_T("result=[set of coords with " << changed.size() << " elements]");
     return changed;
 }
 
 
+mdn::CoordSet mdn::Mdn2d::locked_carryoverCleanupRegion(const Rect& region, SignConvention sc) {
+    if (region.isInvalid()) {
+        return CoordSet();
+    }
+    return locked_carryoverCleanup(locked_getNonZeroes(region), sc);
+}
+
+
+mdn::Fingerprint mdn::Mdn2d::fingerprint() const {
+    Log_N_Debug2_H("");
+    auto lock = lockReadOnly();
+    Fingerprint result = locked_fingerprint();
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+mdn::Fingerprint mdn::Mdn2d::locked_fingerprint() const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    internal_buildCanonical();
+    return *m_fingerprint;
+}
+
+
 bool mdn::Mdn2d::operator==(const Mdn2d& rhs) const {
     Log_N_Debug2_H("");
     auto lock = lockReadOnly();
@@ -911,32 +1197,19 @@ bool mdn::Mdn2d::operator==(const Mdn2d& rhs) const {
         Log_N_Debug2_T("equality test, result: config differs");
         return false;
     }
-    if (m_raw == rhs.m_raw) {
-        Log_N_Debug2_T("equality test, result: data are equal");
+    if (m_data == rhs.m_data) {
+        Log_N_Debug2_T("equality test, result: data are shared");
         return true;
     }
-    if (
-        m_config.signConvention() == SignConvention::Positive ||
-        m_config.signConvention() == SignConvention::Negative
-    ) {
-        Log_N_Debug2_T(
-            "equality test, result: data !=, with sign convention - no need for polymorphism tests"
-        );
+    std::scoped_lock guard(m_valueCacheMutex, rhs.m_valueCacheMutex);
+    internal_buildCanonical();
+    rhs.internal_buildCanonical();
+    if (*m_fingerprint != *rhs.m_fingerprint) {
+        Log_N_Debug2_T("equality test, result: fingerprints differ");
         return false;
     }
-    Log_N_Debug2("equality test, digits differ, checking polymorphism");
-    Mdn2d dlhs = Duplicate(*this);
-    Mdn2d drhs = Duplicate(rhs);
-    auto dlhsLock = dlhs.lockWriteable();
-    auto drhsLock = drhs.lockWriteable();
-    dlhs.m_config.setSignConvention(SignConvention::Positive);
-    drhs.m_config.setSignConvention(SignConvention::Positive);
-    dlhs.locked_carryoverCleanupAll();
-    drhs.locked_carryoverCleanupAll();
-    bool result = dlhs.m_raw == drhs.m_raw;
-    Log_N_Debug2_T(
-        "equality test, final polymorphism result = " << result
-    );
+    bool result = internal_canonicalRaw() == rhs.internal_canonicalRaw();
+    Log_N_Debug2_T("equality test, fingerprints match, digit comparison result = " << result);
     return result;
 }
 
@@ -968,9 +1241,11 @@ mdn::Mdn2d& mdn::Mdn2d::operator+=(const Mdn2d& rhs) {
 mdn::CoordSet mdn::Mdn2d::locked_plusEquals(const Mdn2d& rhs) {
     Log_N_Debug3_H("plus equals");
     CoordSet changed;
-    for (const auto& [xy, digit] : rhs.m_raw) {
-        changed.merge(locked_add(xy, digit));
-    }
+    static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+        for (const auto& [xy, digit] : rhs.m_data->raw) {
+            internal_add(kernel, xy, digit, false, changed);
+        }
+    });
     Log_N_Debug3_T("changed " << changed.size() << " digits");
     return changed;
 }
@@ -995,9 +1270,11 @@ mdn::Mdn2d& mdn::Mdn2d::operator-=(const Mdn2d& rhs) {
 mdn::CoordSet mdn::Mdn2d::locked_minusEquals(const Mdn2d& rhs) {
     Log_N_Debug3_H("minus equals");
     CoordSet changed;
-    for (const auto& [xy, digit] : rhs.m_raw) {
-        changed.merge(locked_add(xy, -digit));
-    }
+    static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+        for (const auto& [xy, digit] : rhs.m_data->raw) {
+            internal_add(kernel, xy, -digit, false, changed);
+        }
+    });
     Log_N_Debug3_T("changed " << changed.size() << " digits");
     return changed;
 }
@@ -1020,7 +1297,8 @@ mdn::Mdn2d& mdn::Mdn2d::operator*=(const Mdn2d& rhs) {
 
 mdn::CoordSet mdn::Mdn2d::locked_timesEquals(const Mdn2d& rhs) {
     Log_N_Debug3_H("times equals (Mdn2d)");
-    Mdn2d temp = NewInstance(m_config);
+    ScratchArena arena;
+    Mdn2d temp(m_config, "tmp_timesEquals", arena.resource());
     auto tempLock = temp.lockWriteable();
     CoordSet changed = locked_multiply(rhs, temp);
     locked_operatorEquals(temp);
@@ -1073,6 +1351,39 @@ mdn::Mdn2d& mdn::Mdn2d::operator*=(long long scalar) {
 }
 
 
+void mdn::Mdn2d::internal_buildCanonical() const {
+    if (m_fingerprint) {
+        return;
+    }
+    Log_N_Debug3_H("");
+    m_canonical.reset();
+    if (
+        m_config.signConvention() != SignConvention::Positive &&
+        m_config.signConvention() != SignConvention::Negative
+    ) {
+        // Polymorphic, settle on the positive form.  The copy shares our digits, and only takes
+        //  its own if the cleanup changes anything.
+        Mdn2d canon(*this, "canonical");
+        canon.m_config.setSignConvention(SignConvention::Positive);
+        canon.locked_carryoverCleanupAll();
+        if (canon.m_data != m_data) {
+            m_canonical = canon.m_data;
+        }
+    }
+    Fingerprint result;
+    for (const auto& [xy, digit] : internal_canonicalRaw()) {
+        result.add(xy, digit);
+    }
+    m_fingerprint = result;
+    Log_N_Debug3_T("fingerprint=" << result << (m_canonical ? ", cleaned up" : ", as is"));
+}
+
+
+const mdn::DigitStore& mdn::Mdn2d::internal_canonicalRaw() const {
+    return m_canonical ? m_canonical->raw : m_data->raw;
+}
+
+
 void mdn::Mdn2d::internal_checkFraxis(Fraxis& fraxis) const {
     if (fraxis == Fraxis::Default) {
         If_Log_Showing_Debug4(
@@ -1188,14 +1499,219 @@ mdn::CoordSet mdn::Mdn2d::internal_fraxisCascade(
 }
 
 
-mdn::Mdn2d mdn::Mdn2d::internal_copyMultiplyAndShift(int value, const Coord& shiftXY) const {
-    Log_N_Debug4_H("value: " << value << ", shift: " << shiftXY);
-    Mdn2d temp = Duplicate(*this);
-    {
-        auto tempLock = temp.lockWriteable();
-        temp.locked_multiply(value);
-        temp.locked_shift(shiftXY);
+void mdn::Mdn2d::internal_add(
+    const Coord& xy, long long value, bool overwrite, CoordSet& changed
+) {
+    static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+        internal_add(kernel, xy, value, overwrite, changed);
+    });
+}
+
+
+template <class Kernel>
+void mdn::Mdn2d::internal_add(
+    const Kernel& kernel, const Coord& xy, long long value, bool overwrite, CoordSet& changed
+) {
+    long long val(internal_checkOverwrite<long long>(xy, overwrite));
+    long long sum = val + value;
+    long long carry = kernel.carry(sum);
+    long long rem = kernel.rem(sum);
+    Log_N_Debug4(
+        "at " << xy << ", add " << value << ", no fraxis, result: " << sum << ":(r"
+        << rem << ",c" << carry << ")"
+    );
+    // rem is a digit by construction, so locked_setValue's range check is not needed
+    if (internal_setValueRaw(xy, static_cast<Digit>(rem))) {
+        changed.insert(xy);
+    }
+    if (carry != 0) {
+        internal_add(kernel, xy.translatedX(1), carry, overwrite, changed);
+        internal_add(kernel, xy.translatedY(1), carry, overwrite, changed);
+    }
+}
+
+
+mdn::CoordSet mdn::Mdn2d::internal_multiplyScalar(long long value, ScratchArena& arena) {
+    Log_N_Debug3_H("scalar multiply " << value);
+    CoordSet changed;
+    if (value == 1 || m_data->raw.empty()) {
+        Log_N_Debug3_T("Identity, no change");
+        return changed;
+    }
+    if (value == 0) {
+        locked_clear();
+        internal_modified();
+        Log_N_Debug3_T("Multiply by zero, cleared");
+        return changed;
+    }
+    internal_detach();
+    if (value == -1) {
+        // Negation never carries, and leaves the addressing untouched
+        for (auto& [xy, digit] : m_data->raw) {
+            if (m_journal) {
+                m_journal->record(xy, digit, -digit);
+            }
+            digit = -digit;
+            changed.insert(xy);
+        }
+        internal_negateValueCache();
+        internal_modified();
+        Log_N_Debug3_T("Negated " << changed.size() << " digits");
+        return changed;
+    }
+
+    // Row sweep - a carry from (x, y) lands on (x+1, y) and (x, y+1), so sweeping rows from the
+    //  bottom up, and each row from left to right, reaches every position after all of its
+    //  carries have arrived.  Each row is a buffer of (x, int64 accumulator), filled with the
+    //  products on that row plus the carries from the row below, sorted by x.
+    using Entry = std::pair<int, long long>;
+    std::pmr::vector<Entry> row(arena.resource());
+    std::pmr::vector<Entry> carries(arena.resource());
+    std::pmr::vector<Entry> nextCarries(arena.resource());
+    std::pmr::vector<std::pair<Coord, long long>> result(arena.resource());
+    result.reserve(m_data->raw.size());
+
+    // The base is dispatched once for the sweep, see BaseKernels.hpp
+    static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+        auto rowIter = m_data->yIndex.cbegin();
+        int carryY = 0;
+        while (rowIter != m_data->yIndex.cend() || !carries.empty()) {
+            int y;
+            if (carries.empty()) {
+                y = rowIter->first;
+            } else if (rowIter == m_data->yIndex.cend() || rowIter->first > carryY) {
+                y = carryY;
+            } else {
+                y = rowIter->first;
+            }
+            row.clear();
+            if (rowIter != m_data->yIndex.cend() && rowIter->first == y) {
+                for (const Coord& xy : rowIter->second) {
+                    row.emplace_back(xy.x(), value*static_cast<long long>(m_data->raw.at(xy)));
+                }
+                ++rowIter;
+            }
+            if (!carries.empty() && carryY == y) {
+                row.insert(row.end(), carries.cbegin(), carries.cend());
+            }
+            std::sort(row.begin(), row.end());
+
+            // Single pass along the row, pending holds the carry into pendingX
+            nextCarries.clear();
+            long long pending = 0;
+            int pendingX = 0;
+            std::size_t i = 0;
+            while (i < row.size() || pending != 0) {
+                int x = i < row.size() ? row[i].first : pendingX;
+                if (pending != 0 && pendingX < x) {
+                    x = pendingX;
+                }
+                long long acc = 0;
+                if (pending != 0 && pendingX == x) {
+                    acc = pending;
+                    pending = 0;
+                }
+                while (i < row.size() && row[i].first == x) {
+                    acc += row[i].second;
+                    ++i;
+                }
+                const long long carry = kernel.carry(acc);
+                const long long rem = kernel.rem(acc);
+                // Zeroes are kept, they may clear an existing digit
+                result.emplace_back(Coord(x, y), rem);
+                if (carry != 0) {
+                    pending = carry;
+                    pendingX = x + 1;
+                    nextCarries.emplace_back(x, carry);
+                }
+            }
+            carries.swap(nextCarries);
+            carryY = y + 1;
+        }
+    });
+
+    // Write back in place - most positions already hold a digit, so only new and vanishing digits
+    //  touch the addressing.  Work from the most significant end, so precision-limited numbers
+    //  drop low digits as they arrive rather than purging on the way up.
+    changed.reserve(result.size());
+    for (auto iter = result.crbegin(); iter != result.crend(); ++iter) {
+        const Coord& xy = iter->first;
+        const Digit digit = static_cast<Digit>(iter->second);
+        auto found = m_data->raw.find(xy);
+        if (found != m_data->raw.end()) {
+            if (digit == 0) {
+                locked_setToZero(xy);
+                changed.insert(xy);
+            } else {
+                const Digit oldDigit = found->second;
+                found->second = digit;
+                internal_valueChanged(xy, oldDigit, digit);
+                changed.insert(xy);
+            }
+        } else if (digit != 0 && locked_setValue(xy, digit)) {
+            changed.insert(xy);
+        }
+    }
+    internal_modified();
+    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    return changed;
+}
+
+
+template <class Place>
+mdn::CoordSet mdn::Mdn2d::internal_transformRegion(
+    const Rect& region, long long factor, Place place
+) {
+    Log_N_Debug3_H("region=" << region << ", factor=" << factor);
+    CoordSet changed;
+    if (region.isInvalid() || m_data->raw.empty()) {
+        Log_N_Debug3_T("Nothing in region, no change");
+        return changed;
     }
+
+    // Lift the digits within region, scaled, row by row.  Lifting is a small part of the work,
+    //  adding back goes through the shared addressing one digit at a time, so it runs serially.
+    //  Every digit it touches is in changed, the working set of the caller's cleanup, which is
+    //  where a large region's colour classes go parallel.
+    std::vector<std::pair<Coord, long long>> lifted;
+    for (
+        auto rowIter = m_data->yIndex.lower_bound(region.min().y());
+        rowIter != m_data->yIndex.cend() && rowIter->first <= region.max().y();
+        ++rowIter
+    ) {
+        for (const Coord& xy : rowIter->second) {
+            if (xy.x() >= region.min().x() && xy.x() <= region.max().x()) {
+                lifted.emplace_back(xy, factor*static_cast<long long>(m_data->raw.at(xy)));
+            }
+        }
+    }
+
+    // Clear the region, then add the lifted digits back where they belong
+    for (const auto& [xy, value] : lifted) {
+        locked_setToZero(xy);
+        changed.insert(xy);
+    }
+    static_dispatchBase(m_config.base(), [&](const auto& kernel) {
+        for (const auto& [xy, value] : lifted) {
+            if (value != 0) {
+                internal_add(kernel, place(xy), value, false, changed);
+            }
+        }
+    });
+    if (!changed.empty()) {
+        internal_modified();
+    }
+    Log_N_Debug3_T("changed " << changed.size() << " digits");
+    return changed;
+}
+
+
+void mdn::Mdn2d::internal_copyMultiplyAndShift(
+    int value, const Coord& shiftXY, Mdn2d& out, ScratchArena& arena
+) const {
+    Log_N_Debug4_H("value: " << value << ", shift: " << shiftXY);
+    out.locked_operatorEquals(*this);
+    out.internal_multiplyScalar(static_cast<long long>(value), arena);
+    out.locked_shift(shiftXY);
     Log_N_Debug4_T("");
-    return temp;
 }
@@ -1,5 +1,6 @@
 #include <mdn/Mdn2dBase.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <cstdlib>
@@ -52,6 +53,8 @@ mdn::Mdn2dBase::Mdn2dBase(std::string nameIn)
 :
     m_config(Mdn2dConfig::static_defaultConfig()),
     m_name(nameIn),
+    m_resource(std::pmr::get_default_resource()),
+    m_data(DigitData::NewInstance(m_resource)),
     m_bounds(Rect::GetInvalid()),
     m_modified(false),
     m_event(0)
@@ -70,6 +73,8 @@ mdn::Mdn2dBase::Mdn2dBase(Mdn2dConfig config, std::string nameIn)
 :
     m_config(config),
     m_name(nameIn),
+    m_resource(std::pmr::get_default_resource()),
+    m_data(DigitData::NewInstance(m_resource)),
     m_bounds(Rect::GetInvalid()),
     m_modified(false),
     m_event(0)
@@ -84,9 +89,32 @@ mdn::Mdn2dBase::Mdn2dBase(Mdn2dConfig config, std::string nameIn)
 }
 
 
+mdn::Mdn2dBase::Mdn2dBase(
+    Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource
+)
+:
+    m_config(config),
+    m_name(nameIn),
+    m_resource(resource),
+    m_data(DigitData::NewInstance(resource)),
+    m_bounds(Rect::GetInvalid()),
+    m_modified(false),
+    m_event(0)
+{
+    Log_N_Debug3_H("resource ctor, config=" << config << ", nameIn=" << m_name);
+    if (m_name.empty()) {
+        Log_N_Debug4("nameIn empty, generating new name");
+        m_name = config.parent().suggestName(nameIn);
+        Log_N_Debug3("changed name to " << m_name);
+    }
+    Log_N_Debug3_T("");
+}
+
+
 mdn::Mdn2dBase::Mdn2dBase(const Mdn2dBase& other, std::string nameIn):
     m_config(other.m_config),
     m_name(nameIn),
+    m_resource(std::pmr::get_default_resource()),
     m_modified(false),
     m_event(0)
 {
@@ -97,11 +125,7 @@ mdn::Mdn2dBase::Mdn2dBase(const Mdn2dBase& other, std::string nameIn):
         m_name = m_config.parent().suggestCopyName(other.m_name);
         Log_N_Debug3("changed name to " << m_name);
     }
-    m_raw = other.m_raw;
-    m_xIndex = other.m_xIndex;
-    m_yIndex = other.m_yIndex;
-    m_index = other.m_index;
-    m_index = other.m_index;
+    internal_shareData(other);
     m_bounds = other.m_bounds;
     Log_N_Debug3_T("");
 }
@@ -121,12 +145,10 @@ mdn::Mdn2dBase& mdn::Mdn2dBase::operator=(const Mdn2dBase& other) {
             throw err;
         }
         m_config.setPrecision(other.m_config.precision());
-        m_raw = other.m_raw;
-        m_xIndex = other.m_xIndex;
-        m_yIndex = other.m_yIndex;
-        m_index = other.m_index;
+        internal_shareData(other);
         m_bounds = other.m_bounds;
-        internal_modified();
+        internal_clearValueCache();
+        internal_modifiedAndComplete();
     } else {
         Log_Warn("Attempting to set Mdn2d equal to itself");
     }
@@ -145,11 +167,9 @@ mdn::Mdn2dBase& mdn::Mdn2dBase::locked_operatorEquals(const Mdn2dBase& other) {
             throw err;
         }
         m_config.setPrecision(other.m_config.precision());
-        m_raw = other.m_raw;
-        m_xIndex = other.m_xIndex;
-        m_yIndex = other.m_yIndex;
-        m_index = other.m_index;
+        internal_shareData(other);
         m_bounds = other.m_bounds;
+        internal_clearValueCache();
         internal_modified();
     } else {
         Log_Warn("Attempting to set Mdn2d equal to itself");
@@ -162,17 +182,18 @@ mdn::Mdn2dBase& mdn::Mdn2dBase::locked_operatorEquals(const Mdn2dBase& other) {
 mdn::Mdn2dBase::Mdn2dBase(Mdn2dBase&& other) noexcept :
     m_config(other.m_config),
     m_name(other.m_name),
+    m_resource(std::pmr::get_default_resource()),
     m_modified(false),
     m_event(0)
 {
     Log_N_Debug3_H("move-copy ctor, copying " << other.m_name);
     auto lock = other.lockReadOnly();
 
-    m_raw = std::move(other.m_raw);
-    m_xIndex = std::move(other.m_xIndex);
-    m_yIndex = std::move(other.m_yIndex);
-    m_index = std::move(other.m_index);
+    internal_shareData(other);
+    other.internal_resetData();
+    m_journal = std::move(other.m_journal);
     m_bounds = other.m_bounds;
+    other.internal_clearValueCache();
     Log_N_Debug3_T("");
 }
 
@@ -190,12 +211,14 @@ mdn::Mdn2dBase& mdn::Mdn2dBase::operator=(Mdn2dBase&& other) noexcept {
             m_config.setInvalid(err.what());
         }
         m_config.setPrecision(other.m_config.precision());
-        m_raw = std::move(other.m_raw);
-        m_xIndex = std::move(other.m_xIndex);
-        m_yIndex = std::move(other.m_yIndex);
-        m_index = std::move(other.m_index);
+        internal_shareData(other);
+        other.internal_resetData();
+        // other's history no longer matches its digits
+        other.m_journal.reset();
         m_bounds = other.m_bounds;
-        internal_modified();
+        internal_clearValueCache();
+        other.internal_clearValueCache();
+        internal_modifiedAndComplete();
     } else {
         Log_Warn("Attempting to set Mdn2d equal to itself");
     }
@@ -291,6 +314,7 @@ void mdn::Mdn2dBase::locked_setConfig(const Mdn2dConfig& newConfig) {
         // result = Mdn2dConfigImpact::PossiblePolymorphism;
     }
     m_config = newConfig;
+    internal_clearCanonical();
     Log_N_Debug3_T("");
 }
 
@@ -382,22 +406,22 @@ bool mdn::Mdn2dBase::nonZero(const Coord& xy) const {
 }
 bool mdn::Mdn2dBase::locked_nonZero(const Coord& xy) const {
     Log_N_Debug4("");
-    return m_index.find(xy) != m_index.end();
+    return m_data->index.find(xy) != m_data->index.end();
 }
 
 
-const mdn::CoordSet& mdn::Mdn2dBase::nonZeroOnRow(const Coord& xy) const {
+const mdn::CoordIndexSet& mdn::Mdn2dBase::nonZeroOnRow(const Coord& xy) const {
     Log_N_Debug2_H("At " << xy);
     auto lock = lockReadOnly();
-    const CoordSet& result = locked_nonZeroOnRow(xy);
+    const CoordIndexSet& result = locked_nonZeroOnRow(xy);
     Log_N_Debug2_T("Returning " << result.size() << " non-zero values");
     return result;
 }
-const mdn::CoordSet& mdn::Mdn2dBase::locked_nonZeroOnRow(const Coord& xy) const {
+const mdn::CoordIndexSet& mdn::Mdn2dBase::locked_nonZeroOnRow(const Coord& xy) const {
     Log_N_Debug3_H("At " << xy);
-    auto it = m_yIndex.find(xy.y());
-    if (it != m_yIndex.end()) {
-        const CoordSet& coords = it->second;
+    auto it = m_data->yIndex.find(xy.y());
+    if (it != m_data->yIndex.end()) {
+        const CoordIndexSet& coords = it->second;
         If_Log_Showing_Debug4(
             std::string coordsList(Tools::setToString<Coord>(coords, ','));
             Log_N_Debug4_T("Returning non-zero coords: " << coordsList);
@@ -408,22 +432,22 @@ const mdn::CoordSet& mdn::Mdn2dBase::locked_nonZeroOnRow(const Coord& xy) const
         return coords;
     }
     Log_N_Debug3_T("Returning empty set");
-    return m_nullCoordSet;
+    return m_nullCoordIndexSet;
 }
 
 
-const mdn::CoordSet& mdn::Mdn2dBase::nonZeroOnCol(const Coord& xy) const {
+const mdn::CoordIndexSet& mdn::Mdn2dBase::nonZeroOnCol(const Coord& xy) const {
     Log_N_Debug2_H("At " << xy);
     auto lock = lockReadOnly();
-    const CoordSet& result = locked_nonZeroOnCol(xy);
+    const CoordIndexSet& result = locked_nonZeroOnCol(xy);
     Log_N_Debug2_T("Returning " << result.size() << " non-zero values");
     return result;
 }
-const mdn::CoordSet& mdn::Mdn2dBase::locked_nonZeroOnCol(const Coord& xy) const {
+const mdn::CoordIndexSet& mdn::Mdn2dBase::locked_nonZeroOnCol(const Coord& xy) const {
     Log_N_Debug3_H("At " << xy);
-    auto it = m_xIndex.find(xy.x());
-    if (it != m_xIndex.end()) {
-        const CoordSet& coords = it->second;
+    auto it = m_data->xIndex.find(xy.x());
+    if (it != m_data->xIndex.end()) {
+        const CoordIndexSet& coords = it->second;
         If_Log_Showing_Debug4(
             std::string coordsList(Tools::setToString<Coord>(coords, ','));
             Log_N_Debug4_T("Returning non-zero coords: " << coordsList);
@@ -434,7 +458,107 @@ const mdn::CoordSet& mdn::Mdn2dBase::locked_nonZeroOnCol(const Coord& xy) const
         return coords;
     }
     Log_N_Debug3_T("Returning empty set");
-    return m_nullCoordSet;
+    return m_nullCoordIndexSet;
+}
+
+
+mdn::DensityMap mdn::Mdn2dBase::getDensityMap(const Rect& window, int cols, int rows) const {
+    Log_N_Debug2_H("window=" << window << ", cols=" << cols << ", rows=" << rows);
+    auto lock = lockReadOnly();
+    DensityMap result = locked_getDensityMap(window, cols, rows);
+    Log_N_Debug2_T("result is " << result.cols << "x" << result.rows);
+    return result;
+}
+mdn::DensityMap mdn::Mdn2dBase::locked_getDensityMap(
+    const Rect& window, int cols, int rows
+) const {
+    Log_N_Debug3_H("window=" << window << ", cols=" << cols << ", rows=" << rows);
+    DensityMap result;
+    if (window.isInvalid() || cols < 1 || rows < 1) {
+        Log_N_Debug3_T("Empty map");
+        return result;
+    }
+    const long long width = window.width();
+    const long long height = window.height();
+    result.window = window;
+    result.cols = static_cast<int>(std::min<long long>(cols, width));
+    result.rows = static_cast<int>(std::min<long long>(rows, height));
+    const std::size_t nCells = static_cast<std::size_t>(result.cols)*result.rows;
+    std::vector<int> positive(nCells, 0);
+    std::vector<int> negative(nCells, 0);
+
+    // Coordinate offset dx falls in cell floor(dx*cols/width), so cell c starts at
+    //  ceil(c*width/cols)
+    auto cellOf = [](long long offset, long long cells, long long extent) {
+        return static_cast<int>(offset*cells/extent);
+    };
+    auto cellStart = [](long long cell, long long cells, long long extent) {
+        return (cell*extent + cells - 1)/cells;
+    };
+    auto tally = [&](const Coord& xy, Digit digit) {
+        const int col = cellOf(xy.x() - window.min().x(), result.cols, width);
+        const int row = cellOf(window.max().y() - xy.y(), result.rows, height);
+        if (digit > 0) {
+            ++positive[result.index(col, row)];
+        } else {
+            ++negative[result.index(col, row)];
+        }
+    };
+
+    if (
+        m_bounds.isInvalid()
+        || (window.contains(m_bounds.min()) && window.contains(m_bounds.max()))
+    ) {
+        for (const auto& [xy, digit] : m_data->raw) {
+            tally(xy, digit);
+        }
+    } else {
+        // Visit only the rows that cross the window
+        const auto first = m_data->yIndex.lower_bound(window.min().y());
+        const auto last = m_data->yIndex.upper_bound(window.max().y());
+        for (auto rowIt = first; rowIt != last; ++rowIt) {
+            for (const Coord& xy : rowIt->second) {
+                if (xy.x() < window.min().x() || xy.x() > window.max().x()) {
+                    continue;
+                }
+                auto it = m_data->raw.find(xy);
+                if (it != m_data->raw.end()) {
+                    tally(xy, it->second);
+                }
+            }
+        }
+    }
+
+    result.density.resize(nCells);
+    result.balance.resize(nCells);
+    for (int row = 0; row < result.rows; ++row) {
+        const long long cellHeight =
+            cellStart(row + 1, result.rows, height) - cellStart(row, result.rows, height);
+        for (int col = 0; col < result.cols; ++col) {
+            const long long cellWidth =
+                cellStart(col + 1, result.cols, width) - cellStart(col, result.cols, width);
+            const std::size_t i = result.index(col, row);
+            const int count = positive[i] + negative[i];
+            result.density[i] = static_cast<float>(count)/(cellWidth*cellHeight);
+            result.balance[i] =
+                count ? static_cast<float>(positive[i] - negative[i])/count : 0.0f;
+        }
+    }
+    Log_N_Debug3_T("result is " << result.cols << "x" << result.rows);
+    return result;
+}
+
+
+long long mdn::Mdn2dBase::event() const {
+    Log_N_Debug2("");
+    auto lock = lockReadOnly();
+    return locked_event();
+}
+
+
+long long mdn::Mdn2dBase::locked_event() const {
+    Log_N_Debug3("returning event=" << m_event);
+    return m_event;
 }
 
 
@@ -456,7 +580,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
     }
     // When true, movement towards digit line is only allowed
     bool towardsDigitLineOnly = false;
-    bool withinBounds = true;
     Rect::FrontBack fbX;
     Rect::FrontBack fbY;
     if (m_bounds.isInvalid()) {
@@ -476,7 +599,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
             case Rect::FrontBack::InFront:
                 Log_N_Debug4("North or south of bounds, moving east/west, tdlo true");
                 towardsDigitLineOnly = true;
-                withinBounds = false;
                 break;
             default:
                 Log_N_Debug4("Vertically within bounds moving east/west");
@@ -491,7 +613,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
                     return ret;
                 }
                 Log_N_Debug4("West of bounds moving east");
-                withinBounds = false;
                 break;
             }
             case Rect::FrontBack::InFront:
@@ -502,7 +623,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
                     return ret;
                 }
                 Log_N_Debug4("East of bounds moving west");
-                withinBounds = false;
                 break;
             }
             default:
@@ -523,7 +643,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
             case Rect::FrontBack::InFront:
                 Log_N_Debug4("West or east of bounds, moving north/south, tdlo true");
                 towardsDigitLineOnly = true;
-                withinBounds = false;
                 break;
             default:
                 Log_N_Debug4("Horizontally within bounds, moving north/south");
@@ -538,7 +657,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
                     return ret;
                 }
                 Log_N_Debug4("South of bounds moving north");
-                withinBounds = false;
                 break;
             }
             case Rect::FrontBack::InFront:
@@ -549,7 +667,6 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
                     return ret;
                 }
                 Log_N_Debug4("North of bounds heading south");
-                withinBounds = false;
                 break;
             }
             default:
@@ -578,54 +695,47 @@ mdn::Coord mdn::Mdn2dBase::locked_jump(const Coord& xy, CardinalDirection cd) co
         return ret;
     }
 
-    // Begin standard jump algorithm - move until non-zero status changes
-    bool refNonZero = locked_nonZero(xy);
-    const int sanityCheckMax = 1000;
-    int sanityCheck = sanityCheckMax;
-    // Coord xyGo(xy.translated(cdCoord));
-    Coord xyGo = xy;
-    Coord prevXy = xy;
-    Log_N_Debug4("rnz=" << refNonZero << ", xy=" << xy);
-
-    while (sanityCheck--> 0) {
-        prevXy = xyGo;
-        xyGo.translate(cdCoord);
-        bool lnz = locked_nonZero(xyGo);
-        Log_N_Debug4(
-            "prevXy=" << prevXy << ", xyGo=" << xyGo << ", ref=" << refNonZero << ", lnz=" << lnz
+    // Begin standard jump algorithm - find where the non-zero status changes along the line
+    const bool horizontal = cdCoord.x() != 0;
+    const int step = horizontal ? cdCoord.x() : cdCoord.y();
+    const RunIndex::Runs& runs = horizontal
+        ? internal_lineRuns(true, xy.y())
+        : internal_lineRuns(false, xy.x());
+    int pos;
+    if (horizontal) {
+        pos = RunIndex::static_jump(
+            runs, xy.x(), step, m_bounds.min().x(), m_bounds.max().x()
+        );
+    } else {
+        pos = RunIndex::static_jump(
+            runs, xy.y(), step, m_bounds.min().y(), m_bounds.max().y()
         );
-        if (lnz != refNonZero) {
-            Log_N_Debug4("found it");
-            if (refNonZero) {
-                // We want to return non-zero location, so, previous spot is okay
-                if (prevXy != xy) {
-                    Log_N_Debug3_T("returning " << prevXy);
-                    return prevXy;
-                }
-            } else {
-                // We want to return non-zero location, so, current spot is okay
-                Log_N_Debug3_T("returning " << xyGo);
-                return xyGo;
-            }
-        }
-        // Check if we've left the bounds behind
-        bool inBounds = m_bounds.contains(xyGo);
-        if (!withinBounds) {
-            // Allows us to start out-of-bounds and cross to in-bounds
-            withinBounds = inBounds;
-            continue;
-        } else if (!inBounds) {
-            // We already have been in-bounds, and we're out now
-            break;
-        }
     }
+    Coord result = horizontal ? Coord(pos, xy.y()) : Coord(xy.x(), pos);
+    Log_N_Debug3_T("searched " << runs.size() << " runs, returning " << result);
+    return result;
+}
+
 
-    if (sanityCheck < 0) {
-        Log_N_Warn("jump algorithm exceeded " << sanityCheckMax << " iterations");
+void mdn::Mdn2dBase::jump(
+    const std::vector<Coord>& from, CardinalDirection cd, std::vector<Coord>& out
+) const {
+    Log_N_Debug2_H("Jumping from " << from.size() << " positions");
+    auto lock = lockReadOnly();
+    locked_jump(from, cd, out);
+    Log_N_Debug2_T("");
+}
+
+
+void mdn::Mdn2dBase::locked_jump(
+    const std::vector<Coord>& from, CardinalDirection cd, std::vector<Coord>& out
+) const {
+    Log_N_Debug3_H("Jumping from " << from.size() << " positions");
+    out.resize(from.size());
+    for (std::size_t i = 0; i < from.size(); ++i) {
+        out[i] = locked_jump(from[i], cd);
     }
-    // No valid stops - went out-of-bounds. Return the previous position.
-    Log_N_Debug3_T("no valid stops found, went out-of-bounds, returning " << prevXy);
-    return prevXy;
+    Log_N_Debug3_T("");
 }
 
 
@@ -639,8 +749,8 @@ mdn::Digit mdn::Mdn2dBase::getValue(const Coord& xy) const {
 
 
 mdn::Digit mdn::Mdn2dBase::locked_getValue(const Coord& xy) const {
-    auto it = m_raw.find(xy);
-    if (it == m_raw.end()) {
+    auto it = m_data->raw.find(xy);
+    if (it == m_data->raw.end()) {
         Log_N_Debug3("At " << xy << ": no entry, returning 0");
         return static_cast<Digit>(0);
     }
@@ -662,22 +772,7 @@ long double mdn::Mdn2dBase::getTotalValue() const {
 
 long double mdn::Mdn2dBase::locked_getTotalValue() const {
     Log_N_Debug3_H("");
-    long double result = 0.0;
-    if (m_xIndex.size() == 0) {
-        Log_N_Debug3_T("No non-zeroes");
-        return result;
-    }
-    for (auto it = m_yIndex.begin(); it != m_yIndex.end(); ++it) {
-        const int rowI = it->first;
-        const CoordSet& coords = it->second;
-        if (coords.empty()) {
-            continue;
-        }
-        Coord cursor(0, rowI);
-        long double rowVal = locked_getRowValue(Coord (0, rowI));
-        result += rowVal;
-        Log_N_Debug4("row " << rowI << " = " << rowVal << ", sum = " << result);
-    }
+    long double result = locked_getTotalExact().toLongDouble();
     Log_N_Debug3_T("returning " << result);
     return result;
 }
@@ -694,22 +789,97 @@ long double mdn::Mdn2dBase::getTotalMagnitude() const {
 
 long double mdn::Mdn2dBase::locked_getTotalMagnitude() const {
     Log_N_Debug3_H("");
-    long double result = 0.0;
-    if (m_xIndex.size() == 0) {
-        Log_N_Debug3_T("No non-zeroes");
-        return result;
+    long double result = locked_getTotalMagnitudeExact().toLongDouble();
+    Log_N_Debug3_T("returning " << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::getRowExact(int y) const {
+    Log_N_Debug2_H("y=" << y);
+    auto lock = lockReadOnly();
+    ExactValue result = locked_getRowExact(y);
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::locked_getRowExact(int y) const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    internal_refreshLines(true, false);
+    return internal_lineExact(true, y);
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::getColExact(int x) const {
+    Log_N_Debug2_H("x=" << x);
+    auto lock = lockReadOnly();
+    ExactValue result = locked_getColExact(x);
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::locked_getColExact(int x) const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    internal_refreshLines(false, false);
+    return internal_lineExact(false, x);
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::getTotalExact() const {
+    Log_N_Debug2_H("");
+    auto lock = lockReadOnly();
+    ExactValue result = locked_getTotalExact();
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::locked_getTotalExact() const {
+    Log_N_Debug3_H("");
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    if (m_totalValue) {
+        Log_N_Debug3_T("cached, " << *m_totalValue);
+        return *m_totalValue;
+    }
+    internal_refreshLines(true, false);
+    ExactValue result(m_config.base());
+    for (const auto& [y, coords] : m_data->yIndex) {
+        if (!coords.empty()) {
+            result += internal_lineExact(true, y);
+        }
     }
-    for (auto it = m_yIndex.begin(); it != m_yIndex.end(); ++it) {
-        const int rowI = it->first;
-        const CoordSet& coords = it->second;
-        if (coords.empty()) {
-            continue;
+    m_totalValue = result;
+    Log_N_Debug3_T("returning " << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::getTotalMagnitudeExact() const {
+    Log_N_Debug2_H("");
+    auto lock = lockReadOnly();
+    ExactValue result = locked_getTotalMagnitudeExact();
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::locked_getTotalMagnitudeExact() const {
+    Log_N_Debug3_H("");
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    if (m_totalMagnitude) {
+        Log_N_Debug3_T("cached, " << *m_totalMagnitude);
+        return *m_totalMagnitude;
+    }
+    internal_refreshLines(true, false);
+    ExactValue result(m_config.base());
+    for (const auto& [y, coords] : m_data->yIndex) {
+        if (!coords.empty()) {
+            result += internal_lineExact(true, y).abs();
         }
-        Coord cursor(0, rowI);
-        long double rowVal = locked_getRowValue(Coord (0, rowI));
-        result += std::abs(rowVal);
-        Log_N_Debug4("row " << rowI << " = " << rowVal << ", sum = " << result);
     }
+    m_totalMagnitude = result;
     Log_N_Debug3_T("returning " << result);
     return result;
 }
@@ -725,26 +895,9 @@ long double mdn::Mdn2dBase::getRowValue(const Coord& xy) const {
 
 
 long double mdn::Mdn2dBase::locked_getRowValue(const Coord& xy) const {
-    Log_N_Debug2_H("xy=" << xy);
-    VecDigit digits;
-    locked_getRow(xy.y(), digits);
-    int xMin = m_bounds.min().x();
-    int count = m_bounds.width();
-    long double base = static_cast<long double>(m_config.baseDouble());
-    long double baseFactor = internal_baseFactor(base, xMin);
-    Log_N_Debug4("baseFactor(" << xMin << ")=" << baseFactor);
-    long double result = 0.0;
-    for (int i = 0; i < count; ++i) {
-        long double d = static_cast<long double>(digits[i]);
-        If_Log_Showing_Debug4(
-            Log_N_Debug4(
-                "i=" << i << ",d=" << d << ",result+=d x baseFactor(" << baseFactor << ")"
-            );
-        );
-        result += d*baseFactor;
-        baseFactor *= base;
-    }
-    Log_N_Debug2_T("result=" << result);
+    Log_N_Debug3_H("xy=" << xy);
+    long double result = locked_getRowExact(xy.y()).toLongDouble();
+    Log_N_Debug3_T("result=" << result);
     return result;
 }
 
@@ -764,38 +917,29 @@ bool mdn::Mdn2dBase::getRowMagMax(Coord& xy, long double& val) const {
 
 bool mdn::Mdn2dBase::locked_getRowMagMax(Coord& xy, long double& val) const {
     Log_N_Debug3_H("xy=" << xy);
-    if (m_index.empty()) {
+    if (m_data->index.empty()) {
         Log_N_Debug3_T("No non-zeroes available, returning false (failed)");
         return false;
     }
-    auto last = m_xIndex.rbegin();
+    auto last = m_data->xIndex.rbegin();
     int col = last->first;
-    const CoordSet& nonZeroes = last->second;
-    double pVal = -1.0;
-    double pSign = 0.0;
-    int pRow = constants::intMin;
-    for (const Coord& xyi : nonZeroes) {
-        double curVal = locked_getRowValue(xyi);
-        double curSign = 1.0;
-        int curRow = xyi.y();
-        Log_N_Debug4(
-            "xyi=" << xyi << ",curVal=" << curVal << ",curSign=" << curSign << ",curRow=" << curRow
-        );
-        if (curVal < 0) {
-            curVal = -curVal;
-            curSign = -1.0;
-        }
-        if ((curVal == pVal && curRow > pRow) || (curVal > pVal)) {
-            // Prefer higher x value
-            pVal = curVal;
-            pSign = curSign;
-            pRow = curRow;
+    const CoordIndexSet& nonZeroes = last->second;
+    // Candidates are the rows with a digit in the last column.  Rows are ranked by exact
+    //  magnitude, higher y first on a tie, so the first candidate in the ranking wins.
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    internal_refreshLines(true, true);
+    for (const auto& [magnitude, row] : m_rowValues.ranking) {
+        Coord xyi(col, row);
+        if (nonZeroes.count(xyi)) {
+            val = m_rowValues.values.at(row).toLongDouble();
+            xy = xyi;
+            Log_N_Debug3_T("val=" << val << ",xy=" << xy);
+            return true;
         }
     }
-    val = pVal * pSign;
-    xy = Coord(col, pRow);
-    Log_N_Debug3_T("val=" << val << ",xy=" << xy);
-    return true;
+    Log_N_Warn("Internal error: no ranked row reaches column " << col);
+    Log_N_Debug3_T("Failed, returning false");
+    return false;
 }
 
 
@@ -887,13 +1031,13 @@ void mdn::Mdn2dBase::locked_getRow(const Coord& xy, VecDigit& out) const {
 //     );
 //     out.resize(xCount);
 //     std::fill(out.begin(), out.end(), 0);
-//     auto it = m_yIndex.find(y);
-//     if (it != m_yIndex.end()) {
+//     auto it = m_data->yIndex.find(y);
+//     if (it != m_data->yIndex.end()) {
 //         // There are non-zero entries on this row, fill them in
 //         const CoordSet& coords = it->second;
 //         for (const Coord& coord : coords) {
 //             if (coord.x() >= x0 && coord.x() <= x1) {
-//                 out[coord.x()-x0] = m_raw.at(coord);
+//                 out[coord.x()-x0] = m_data->raw.at(coord);
 //             }
 //         }
 //     }
@@ -919,13 +1063,47 @@ void mdn::Mdn2dBase::locked_getRow(const Coord& xy, int width, VecDigit& out) co
     );
     out.resize(width);
     std::fill(out.begin(), out.end(), 0);
-    auto it = m_yIndex.find(y);
-    if (it != m_yIndex.end()) {
+    auto it = m_data->yIndex.find(y);
+    if (it != m_data->yIndex.end()) {
         // There are non-zero entries on this row, fill them in
-        const CoordSet& coords = it->second;
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
             if (coord.x() >= x0 && coord.x() <= x1) {
-                out[coord.x()-x0] = m_raw.at(coord);
+                out[coord.x()-x0] = m_data->raw.at(coord);
+            }
+        }
+    }
+    Log_N_Debug3_T("");
+}
+
+
+void mdn::Mdn2dBase::getRowPacked(const Coord& xy, int width, PackedRow& out) const {
+    Log_N_Debug2("");
+    auto lock = lockReadOnly();
+    locked_getRowPacked(xy, width, out);
+}
+
+
+void mdn::Mdn2dBase::locked_getRowPacked(const Coord& xy, int width, PackedRow& out) const {
+    int x0 = xy.x();
+    int y = xy.y();
+    int x1 = x0 + width - 1;
+    Log_N_Debug3_H(
+        "Row " << y << " from x (" << x0 << " .. " << x1 << "), "
+        << width << " elements"
+    );
+    const DigitPacking packing = PackedDigits::forBase(m_config.base());
+    out.packing = packing;
+    out.width = std::max(width, 0);
+    out.data.assign(PackedDigits::bytes(packing, out.width), 0);
+    auto it = m_data->yIndex.find(y);
+    if (it != m_data->yIndex.end()) {
+        // Only the non-zeroes are visited, packed straight into the zero-filled row
+        const CoordIndexSet& coords = it->second;
+        uint8_t* data = out.data.data();
+        for (const Coord& coord : coords) {
+            if (coord.x() >= x0 && coord.x() <= x1) {
+                PackedDigits::put(packing, out.width, coord.x()-x0, m_data->raw.at(coord), data);
             }
         }
     }
@@ -965,19 +1143,75 @@ void mdn::Mdn2dBase::locked_getAreaRows(const Rect& window, VecVecDigit& out) co
         << "    yRange = (" << yStart << " .. " << yEnd << "), " << yCount << " rows"
     );
 
-    out.clear();
-    out.reserve(yCount);
-
+    // Reuse the caller's rows, locked_getRow resizes and zeroes each one
+    out.resize(yCount);
     for (int y = yStart; y < yEnd; ++y) {
-        VecDigit row(width, Digit(0));
-        Coord xy(xStart, y);
-        locked_getRow(xy, width, row);
-        out.push_back(row);
+        locked_getRow(Coord(xStart, y), width, out[y - yStart]);
     }
     Log_N_Debug3_T("");
 }
 
 
+long long mdn::Mdn2dBase::getAreaDigits(
+    const Rect& window, Digit* out, std::ptrdiff_t stride, long long sinceEvent
+) const {
+    Log_N_Debug2_H("window=" << window << ", sinceEvent=" << sinceEvent);
+    auto lock = lockReadOnly();
+    long long result = locked_getAreaDigits(window, out, stride, sinceEvent);
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+long long mdn::Mdn2dBase::locked_getAreaDigits(
+    const Rect& window, Digit* out, std::ptrdiff_t stride, long long sinceEvent
+) const {
+    Log_N_Debug3_H("window=" << window << ", sinceEvent=" << sinceEvent);
+    // Changes not yet completed have not moved m_event on
+    if (sinceEvent == m_event && !m_modified) {
+        Log_N_Debug3_T("Unchanged since event " << sinceEvent);
+        return m_event;
+    }
+    if (window.isInvalid()) {
+        Log_N_Debug3_T("Empty window");
+        return m_event;
+    }
+    const int x0 = window.min().x();
+    const int x1 = window.max().x();
+    const int y0 = window.min().y();
+    const int width = window.width();
+    for (int r = 0; r < window.height(); ++r) {
+        std::fill_n(out + r*stride, width, Digit(0));
+    }
+
+    // Only the rows crossing the window, then per row whichever is fewer: its non-zero digits,
+    //  or the window's columns
+    const auto first = m_data->yIndex.lower_bound(y0);
+    const auto last = m_data->yIndex.upper_bound(window.max().y());
+    for (auto rowIt = first; rowIt != last; ++rowIt) {
+        const int y = rowIt->first;
+        const CoordIndexSet& coords = rowIt->second;
+        Digit* row = out + static_cast<std::ptrdiff_t>(y - y0)*stride;
+        if (coords.size() <= static_cast<std::size_t>(width)) {
+            for (const Coord& xy : coords) {
+                if (xy.x() >= x0 && xy.x() <= x1) {
+                    row[xy.x() - x0] = m_data->raw.at(xy);
+                }
+            }
+        } else {
+            for (int x = x0; x <= x1; ++x) {
+                auto it = m_data->raw.find(Coord(x, y));
+                if (it != m_data->raw.end()) {
+                    row[x - x0] = it->second;
+                }
+            }
+        }
+    }
+    Log_N_Debug3_T("Filled " << width << "x" << window.height() << " at event " << m_event);
+    return m_event;
+}
+
+
 long double mdn::Mdn2dBase::getColValue(const Coord& xy) const {
     Log_N_Debug2_H("At " << xy);
     auto lock = lockReadOnly();
@@ -988,26 +1222,9 @@ long double mdn::Mdn2dBase::getColValue(const Coord& xy) const {
 
 
 long double mdn::Mdn2dBase::locked_getColValue(const Coord& xy) const {
-    Log_N_Debug2_H("xy=" << xy);
-    VecDigit digits;
-    locked_getCol(xy.x(), digits);
-    int yMin = m_bounds.min().y();
-    int count = m_bounds.height();
-    long double base = static_cast<long double>(m_config.baseDouble());
-    long double baseFactor = internal_baseFactor(base, yMin);
-    Log_N_Debug4("baseFactor(" << yMin << ")=" << baseFactor);
-    long double result = 0.0;
-    for (int i = 0; i < count; ++i) {
-        long double d = static_cast<long double>(digits[i]);
-        If_Log_Showing_Debug4(
-            Log_N_Debug4(
-                "i=" << i << ",d=" << d << ",result+=d x baseFactor(" << baseFactor << ")"
-            );
-        );
-        result += d*baseFactor;
-        baseFactor *= base;
-    }
-    Log_N_Debug2_T("result=" << result);
+    Log_N_Debug3_H("xy=" << xy);
+    long double result = locked_getColExact(xy.x()).toLongDouble();
+    Log_N_Debug3_T("result=" << result);
     return result;
 }
 
@@ -1027,36 +1244,22 @@ bool mdn::Mdn2dBase::getColMagMax(Coord& xy, long double& val) const {
 
 bool mdn::Mdn2dBase::locked_getColMagMax(Coord& xy, long double& val) const {
     Log_N_Debug3_H("xy=" << xy);
-    if (m_index.empty()) {
+    if (m_data->index.empty()) {
         Log_N_Debug3_T("No non-zeroes available, returning false (failed)");
         return false;
     }
-    auto last = m_xIndex.rbegin();
-    int row = last->first;
-    const CoordSet& nonZeroes = last->second;
-    long double pVal = -1.0;
-    long double pSign = 0.0;
-    int pCol = constants::intMin;
-    for (const Coord& xyi : nonZeroes) {
-        long double curVal = locked_getColValue(xyi);
-        long double curSign = 1.0;
-        int curCol = xyi.x();
-        Log_N_Debug4(
-            "xyi=" << xyi << ",curVal=" << curVal << ",curSign=" << curSign << ",curCol=" << curCol
-        );
-        if (curVal < 0) {
-            curVal = -curVal;
-            curSign = -1.0;
-        }
-        if ((curVal == pVal && curCol > pCol) || (curVal > pVal)) {
-            // Prefer higher x value
-            pVal = curVal;
-            pSign = curSign;
-            pCol = curCol;
-        }
-    }
-    val = pVal * pSign;
-    xy = Coord(pCol, row);
+    // Candidates come from the last column, so the pivot is always column xMax.  Division's
+    //  Fraxis::Y results depend on this choice, it is kept as is.
+    auto last = m_data->xIndex.rbegin();
+    int col = last->first;
+    int row = constants::intMin;
+    for (const Coord& xyi : last->second) {
+        row = std::max(row, xyi.y());
+    }
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    internal_refreshLines(false, false);
+    val = internal_lineExact(false, col).toLongDouble();
+    xy = Coord(col, row);
     Log_N_Debug3_T("val=" << val << ",xy=" << xy);
     return true;
 }
@@ -1126,13 +1329,13 @@ void mdn::Mdn2dBase::locked_getCol(const Coord& xy, int height, VecDigit& out) c
     );
     out.resize(height);
     std::fill(out.begin(), out.end(), 0);
-    auto it = m_xIndex.find(x);
-    if (it != m_xIndex.end()) {
+    auto it = m_data->xIndex.find(x);
+    if (it != m_data->xIndex.end()) {
         // There are non-zero entries on this row, fill them in
-        const CoordSet& coords = it->second;
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
             if (coord.y() >= y0 && coord.y() <= y1) {
-                out[coord.y()-y0] = m_raw.at(coord);
+                out[coord.y()-y0] = m_data->raw.at(coord);
             }
         }
     }
@@ -1169,15 +1372,15 @@ mdn::CoordSet mdn::Mdn2dBase::locked_getNonZeroes(const Rect& window) const {
         return result;
     }
 
-    // Iterate by Y rows using m_yIndex; filter X on each row
+    // Iterate by Y rows using m_data->yIndex; filter X on each row
     const int y0 = w.bottom();
     const int y1 = w.top();
     const int x0 = w.left();
     const int x1 = w.right();
 
     // lower_bound..upper_bound over y
-    auto it = m_yIndex.lower_bound(y0);
-    const auto itEnd = m_yIndex.upper_bound(y1);
+    auto it = m_data->yIndex.lower_bound(y0);
+    const auto itEnd = m_data->yIndex.upper_bound(y1);
 
     If_Log_Showing_Debug3(
         Log_N_Debug3_H(
@@ -1187,7 +1390,7 @@ mdn::CoordSet mdn::Mdn2dBase::locked_getNonZeroes(const Rect& window) const {
     );
 
     for (; it != itEnd; ++it) {
-        const CoordSet& rowSet = it->second;
+        const CoordIndexSet& rowSet = it->second;
         for (const Coord& c : rowSet) {
             const int x = c.x();
             if (x >= x0 && x <= x1) {
@@ -1218,7 +1421,13 @@ void mdn::Mdn2dBase::clear() {
 
 void mdn::Mdn2dBase::locked_clear() {
     Log_N_Debug3_H("");
-    m_raw.clear();
+    internal_journalDigits(true);
+    if (m_data.use_count() > 1) {
+        // Shared, nothing to copy, just let go
+        internal_resetData();
+    } else {
+        m_data->raw.clear();
+    }
     internal_clearMetadata();
     Log_N_Debug3_T("");
 }
@@ -1235,8 +1444,9 @@ bool mdn::Mdn2dBase::setToZero(const Coord& xy) {
 
 
 bool mdn::Mdn2dBase::locked_setToZero(const Coord& xy) {
-    auto it = m_raw.find(xy);
-    if (it == m_raw.end()) {
+    internal_detach();
+    auto it = m_data->raw.find(xy);
+    if (it == m_data->raw.end()) {
         // Already zero
         Log_N_Debug3_H("Setting " << xy << " to zero: already zero");
         bool result = locked_checkPrecisionWindow(xy) != PrecisionStatus::Below;
@@ -1249,39 +1459,41 @@ bool mdn::Mdn2dBase::locked_setToZero(const Coord& xy) {
             "Setting " << xy << " to zero: current value=" << static_cast<int>(it->second)
         );
     );
-    auto xit(m_xIndex.find(xy.x()));
-    auto yit(m_yIndex.find(xy.y()));
+    auto xit(m_data->xIndex.find(xy.x()));
+    auto yit(m_data->yIndex.find(xy.y()));
     #ifdef MDN_DEBUG
         // Debug mode - sanity check - metadata entries must be non-zero
-        if (xit == m_xIndex.end() || yit == m_yIndex.end()) {
+        if (xit == m_data->xIndex.end() || yit == m_data->yIndex.end()) {
             Log_N_Warn(
                 "Internal error: addressing data invalid, discovered when zeroing "
                 << "coord: " << xy << "\n"
                 << "Rebuilding metadata.\n"
             );
             locked_rebuildMetadata();
-            xit = m_xIndex.find(xy.x());
-            yit = m_yIndex.find(xy.y());
+            xit = m_data->xIndex.find(xy.x());
+            yit = m_data->yIndex.find(xy.y());
         }
     #endif // MDN_DEBUG
-    m_raw.erase(it);
+    const Digit oldDigit = it->second;
+    m_data->raw.erase(it);
     internal_modified();
+    internal_valueChanged(xy, oldDigit, 0);
 
-    CoordSet& coordsAlongX(xit->second);
-    CoordSet& coordsAlongY(yit->second);
+    CoordIndexSet& coordsAlongX(xit->second);
+    CoordIndexSet& coordsAlongY(yit->second);
     coordsAlongX.erase(xy);
     coordsAlongY.erase(xy);
-    m_index.erase(xy);
+    m_data->index.erase(xy);
     bool checkBounds = false;
     if (coordsAlongX.size() == 0) {
         Log_N_Debug3("Erasing empty indexing column at " << xy.x());
-        m_xIndex.erase(xit);
+        m_data->xIndex.erase(xit);
         checkBounds = true;
     }
 
     if (coordsAlongY.size() == 0) {
         Log_N_Debug3("Erasing empty indexing row at " << xy.y());
-        m_yIndex.erase(yit);
+        m_data->yIndex.erase(yit);
         checkBounds = true;
     }
     if (checkBounds) {
@@ -1320,14 +1532,19 @@ mdn::CoordSet mdn::Mdn2dBase::locked_setToZero(const CoordSet& purgeSet) {
     Log_N_Debug3_H("Zeroing set containing " << purgeSet.size() << " coords");
 
     CoordSet changed;
-    // Step 1: Erase from m_raw
+    internal_detach();
+    // Step 1: Erase from m_data->raw
     for (const Coord& coord : purgeSet) {
-        if (m_raw.erase(coord)) {
+        auto found = m_data->raw.find(coord);
+        if (found != m_data->raw.end()) {
+            const Digit oldDigit = found->second;
+            m_data->raw.erase(found);
             changed.insert(coord);
+            internal_valueChanged(coord, oldDigit, 0);
         }
     }
 
-    // Step 2: Clean up m_xIndex and m_yIndex
+    // Step 2: Clean up m_data->xIndex and m_data->yIndex
     int indexRowsRemoved = 0;
     int indexColsRemoved = 0;
     for (const Coord& coord : purgeSet) {
@@ -1335,24 +1552,24 @@ mdn::CoordSet mdn::Mdn2dBase::locked_setToZero(const CoordSet& purgeSet) {
         int y = coord.y();
 
         // Erase coord from index
-        m_index.erase(coord);
+        m_data->index.erase(coord);
 
         // Erase coord from x index
-        auto xIt = m_xIndex.find(x);
-        if (xIt != m_xIndex.end()) {
+        auto xIt = m_data->xIndex.find(x);
+        if (xIt != m_data->xIndex.end()) {
             xIt->second.erase(coord);
             if (xIt->second.empty()) {
-                m_xIndex.erase(xIt);
+                m_data->xIndex.erase(xIt);
                 ++indexColsRemoved;
             }
         }
 
         // Erase coord from y index
-        auto yIt = m_yIndex.find(y);
-        if (yIt != m_yIndex.end()) {
+        auto yIt = m_data->yIndex.find(y);
+        if (yIt != m_data->yIndex.end()) {
             yIt->second.erase(coord);
             if (yIt->second.empty()) {
-                m_yIndex.erase(yIt);
+                m_data->yIndex.erase(yIt);
                 ++indexRowsRemoved;
             }
         }
@@ -1493,21 +1710,135 @@ void mdn::Mdn2dBase::setRow(const Coord& xy, const VecDigit& row) {
     Log_N_Debug2_H("at " << xy);
     auto lock = lockWriteable();
     locked_setRow(xy, row);
+    internal_operationComplete();
     Log_N_Debug2_T("");
 }
 
 
 void mdn::Mdn2dBase::locked_setRow(const Coord& xy, const VecDigit& row) {
     Log_N_Debug3_H("at " << xy);
+    // Zeroes that land on positions that are already zero are skipped
     Coord cursor = xy;
     for (int i = 0; i < row.size(); ++i) {
-        locked_setValue(cursor, row[i]);
+        if (row[i] != 0 || m_data->raw.find(cursor) != m_data->raw.end()) {
+            locked_setValue(cursor, row[i]);
+        }
         cursor.translateX(1);
     }
     Log_N_Debug3_T("");
 }
 
 
+void mdn::Mdn2dBase::setRowPacked(const Coord& xy, const PackedRow& row) {
+    Log_N_Debug2_H("at " << xy);
+    auto lock = lockWriteable();
+    locked_setRowPacked(xy, row);
+    internal_operationComplete();
+    Log_N_Debug2_T("");
+}
+
+
+void mdn::Mdn2dBase::locked_setRowPacked(const Coord& xy, const PackedRow& row) {
+    Log_N_Debug3_H("at " << xy);
+    if (row.width < 0 || row.data.size() != PackedDigits::bytes(row.packing, row.width)) {
+        InvalidArgument err(
+            "Packed row of " + std::to_string(row.width) + " digits has " +
+            std::to_string(row.data.size()) + " bytes, expecting " +
+            std::to_string(PackedDigits::bytes(row.packing, row.width))
+        );
+        Log_N_Error(err.what());
+        throw err;
+    }
+    VecDigit digits;
+    PackedDigits::unpack(row, digits);
+    locked_setRow(xy, digits);
+    Log_N_Debug3_T("");
+}
+
+
+void mdn::Mdn2dBase::enableJournal(
+    std::size_t memoryBudget, std::size_t spillBytes, std::size_t maxSteps
+) {
+    Log_N_Debug2_H("memoryBudget=" << memoryBudget << ", spillBytes=" << spillBytes);
+    auto lock = lockWriteable();
+    if (!m_journal) {
+        m_journal.reset(new DigitJournal(memoryBudget, spillBytes, maxSteps));
+    }
+    Log_N_Debug2_T("");
+}
+
+
+void mdn::Mdn2dBase::disableJournal() {
+    Log_N_Debug2("");
+    auto lock = lockWriteable();
+    m_journal.reset();
+}
+
+
+bool mdn::Mdn2dBase::journalEnabled() const {
+    auto lock = lockReadOnly();
+    return static_cast<bool>(m_journal);
+}
+
+
+bool mdn::Mdn2dBase::canUndo() const {
+    auto lock = lockReadOnly();
+    return m_journal && (m_journal->canUndo() || m_journal->hasPending());
+}
+
+
+bool mdn::Mdn2dBase::canRedo() const {
+    auto lock = lockReadOnly();
+    return m_journal && m_journal->canRedo();
+}
+
+
+bool mdn::Mdn2dBase::undo() {
+    Log_N_Debug2_H("");
+    auto lock = lockWriteable();
+    bool result = locked_undo();
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+bool mdn::Mdn2dBase::locked_undo() {
+    if (!m_journal) {
+        return false;
+    }
+    // Anything done since the last completed operation is a step of its own
+    internal_sealJournal();
+    DigitJournal::Writes writes;
+    if (!m_journal->takeUndo(writes)) {
+        return false;
+    }
+    internal_applyJournal(writes);
+    return true;
+}
+
+
+bool mdn::Mdn2dBase::redo() {
+    Log_N_Debug2_H("");
+    auto lock = lockWriteable();
+    bool result = locked_redo();
+    Log_N_Debug2_T("result=" << result);
+    return result;
+}
+
+
+bool mdn::Mdn2dBase::locked_redo() {
+    if (!m_journal) {
+        return false;
+    }
+    DigitJournal::Writes writes;
+    if (!m_journal->takeRedo(writes)) {
+        return false;
+    }
+    internal_applyJournal(writes);
+    return true;
+}
+
+
 std::vector<std::string> mdn::Mdn2dBase::toStringRows() const {
     return toStringRows(TextWriteOptions::DefaultPretty());
 }
@@ -1713,7 +2044,7 @@ void mdn::Mdn2dBase::locked_rebuildMetadata() const {
     Log_N_Debug3("");
     internal_clearMetadata();
 
-    for (const auto& [xy, digit] : m_raw) {
+    for (const auto& [xy, digit] : m_data->raw) {
         if (digit == 0) {
             throw ZeroEncountered(xy);
         }
@@ -1723,10 +2054,10 @@ void mdn::Mdn2dBase::locked_rebuildMetadata() const {
     }
 
     // This updates bounds based on metadata
-    // auto itMinX = m_xIndex.cbegin();
-    // auto itMaxX = m_xIndex.crbegin();
-    // auto itMinY = m_yIndex.cbegin();
-    // auto itMaxY = m_yIndex.crbegin();
+    // auto itMinX = m_data->xIndex.cbegin();
+    // auto itMaxX = m_data->xIndex.crbegin();
+    // auto itMinY = m_data->yIndex.cbegin();
+    // auto itMaxY = m_data->yIndex.crbegin();
     // m_bounds.min() = {itMinX->first, itMinY->first};
     // m_bounds.max() = {itMaxX->first, itMaxY->first};
 }
@@ -1768,33 +2099,33 @@ const mdn::Rect& mdn::Mdn2dBase::locked_bounds() const {
 }
 
 
-const std::unordered_map<mdn::Coord, mdn::Digit>&  mdn::Mdn2dBase::data_raw() {
+const mdn::DigitStore&  mdn::Mdn2dBase::data_raw() {
     auto lock = lockReadOnly();
     return locked_data_raw();
 }
-const std::unordered_map<mdn::Coord, mdn::Digit>&  mdn::Mdn2dBase::locked_data_raw() {
-    return m_raw;
+const mdn::DigitStore&  mdn::Mdn2dBase::locked_data_raw() {
+    return m_data->raw;
 }
-const std::map<int, mdn::CoordSet>&  mdn::Mdn2dBase::data_xIndex() {
+const mdn::CoordIndex&  mdn::Mdn2dBase::data_xIndex() {
     auto lock = lockReadOnly();
     return locked_data_xIndex();
 }
-const std::map<int, mdn::CoordSet>&  mdn::Mdn2dBase::locked_data_xIndex() {
-    return m_xIndex;
+const mdn::CoordIndex&  mdn::Mdn2dBase::locked_data_xIndex() {
+    return m_data->xIndex;
 }
-const std::map<int, mdn::CoordSet>&  mdn::Mdn2dBase::data_yIndex() {
+const mdn::CoordIndex&  mdn::Mdn2dBase::data_yIndex() {
     auto lock = lockReadOnly();
     return locked_data_yIndex();
 }
-const std::map<int, mdn::CoordSet>&  mdn::Mdn2dBase::locked_data_yIndex() {
-    return m_yIndex;
+const mdn::CoordIndex&  mdn::Mdn2dBase::locked_data_yIndex() {
+    return m_data->yIndex;
 }
-const mdn::CoordSet&  mdn::Mdn2dBase::data_index() {
+const mdn::CoordIndexSet&  mdn::Mdn2dBase::data_index() {
     auto lock = lockReadOnly();
     return locked_data_index();
 }
-const mdn::CoordSet&  mdn::Mdn2dBase::locked_data_index() {
-    return m_index;
+const mdn::CoordIndexSet&  mdn::Mdn2dBase::locked_data_index() {
+    return m_data->index;
 }
 const std::unordered_map<int, mdn::MdnObserver*>&  mdn::Mdn2dBase::data_observers() {
     auto lock = lockReadOnly();
@@ -1835,6 +2166,7 @@ int mdn::Mdn2dBase::locked_setPrecision(int newPrecision) {
     Log_N_Debug3_H("newPrecision=" << newPrecision);
     int oldPrecision = m_config.precision();
     m_config.setPrecision(newPrecision);
+    internal_clearCanonical();
     Log_N_Debug3("Precision was: " << oldPrecision << ", new value: " << newPrecision);
 
     bool opUnlimited = oldPrecision < 0;
@@ -1934,6 +2266,7 @@ void mdn::Mdn2dBase::internal_modified() {
 
 
 void mdn::Mdn2dBase::internal_operationComplete() {
+    internal_sealJournal();
     if (m_modified) {
         Log_N_Debug4("Operation complete, incrementing m_event from " << m_event);
         ++m_event;
@@ -1946,6 +2279,7 @@ void mdn::Mdn2dBase::internal_operationComplete() {
 
 
 void mdn::Mdn2dBase::internal_modifiedAndComplete() {
+    internal_sealJournal();
     Log_N_Debug4("Operation complete and modified, incrementing m_event from " << m_event);
     ++m_event;
     m_modified = false;
@@ -1980,15 +2314,283 @@ void mdn::Mdn2dBase::assertNotSelf(Mdn2dBase& that, const std::string& descripti
 
 void mdn::Mdn2dBase::internal_clearMetadata() const {
     Log_N_Debug3("");
+    internal_detach();
     m_bounds.clear();
 
-    m_xIndex.clear();
-    m_yIndex.clear();
-    m_index.clear();
+    m_data->xIndex.clear();
+    m_data->yIndex.clear();
+    m_data->index.clear();
+    internal_clearValueCache();
+}
+
+
+void mdn::Mdn2dBase::internal_clearValueCache() const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    m_rowValues.clear();
+    m_colValues.clear();
+    m_totalValue.reset();
+    m_totalMagnitude.reset();
+    m_pyramid.reset();
+    m_rowRuns.clear();
+    m_colRuns.clear();
+    internal_clearCanonical();
+}
+
+
+void mdn::Mdn2dBase::internal_detach() const {
+    if (m_data.use_count() > 1) {
+        Log_N_Debug4("Detaching from shared digits");
+        m_data = DigitData::Duplicate(*m_data, m_resource);
+    }
+}
+
+
+void mdn::Mdn2dBase::internal_shareData(const Mdn2dBase& other) {
+    internal_journalDigits(true);
+    if (m_resource == other.m_resource) {
+        m_data = other.m_data;
+    } else {
+        m_data = DigitData::Duplicate(*other.m_data, m_resource);
+    }
+    internal_journalDigits(false);
+}
+
+
+void mdn::Mdn2dBase::internal_resetData() {
+    m_data = DigitData::NewInstance(m_resource);
+}
+
+
+void mdn::Mdn2dBase::internal_journalDigits(bool removing) {
+    if (!m_journal) {
+        return;
+    }
+    for (const auto& [xy, digit] : m_data->raw) {
+        if (removing) {
+            m_journal->record(xy, digit, 0);
+        } else {
+            m_journal->record(xy, 0, digit);
+        }
+    }
+}
+
+
+void mdn::Mdn2dBase::internal_restoreDigit(const Coord& xy, Digit value) {
+    internal_detach();
+    if (value == 0) {
+        locked_setToZero(xy);
+        return;
+    }
+    auto it = m_data->raw.find(xy);
+    Digit oldDigit = 0;
+    if (it == m_data->raw.end()) {
+        internal_insertAddress(xy);
+        m_data->raw[xy] = value;
+    } else {
+        oldDigit = it->second;
+        it->second = value;
+    }
+    if (oldDigit != value) {
+        internal_valueChanged(xy, oldDigit, value);
+        internal_modified();
+    }
+}
+
+
+void mdn::Mdn2dBase::internal_applyJournal(const DigitJournal::Writes& writes) {
+    Log_N_Debug3_H("Applying " << writes.size() << " journaled digits");
+    m_journal->beginApply();
+    for (const auto& [xy, digit] : writes) {
+        internal_restoreDigit(xy, digit);
+    }
+    m_journal->endApply();
+    internal_modifiedAndComplete();
+    for (auto& [id, obs] : m_observers) {
+        obs->digitsChanged(writes);
+    }
+    Log_N_Debug3_T("");
+}
+
+
+void mdn::Mdn2dBase::internal_sealJournal() {
+    if (!m_journal) {
+        return;
+    }
+    if (m_observers.empty()) {
+        m_journal->seal();
+        return;
+    }
+    DigitJournal::Writes sealed;
+    if (m_journal->seal(&sealed)) {
+        for (auto& [id, obs] : m_observers) {
+            obs->digitsChanged(sealed);
+        }
+    }
+}
+
+
+void mdn::Mdn2dBase::internal_valueChanged(const Coord& xy, Digit oldDigit, Digit newDigit) {
+    if (m_journal) {
+        m_journal->record(xy, oldDigit, newDigit);
+    }
+    // Writers hold the exclusive lock, no reader can be using the cache
+    m_rowValues.markDirty(xy.y());
+    m_colValues.markDirty(xy.x());
+    if (m_pyramid) {
+        m_pyramid->change(xy, oldDigit, newDigit);
+    }
+    if ((oldDigit == 0) != (newDigit == 0)) {
+        m_rowRuns.markDirty(xy.y());
+        m_colRuns.markDirty(xy.x());
+    }
+    m_totalValue.reset();
+    m_totalMagnitude.reset();
+    internal_clearCanonical();
+}
+
+
+const mdn::RunIndex::Runs& mdn::Mdn2dBase::internal_lineRuns(bool row, int line) const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    RunIndex& index = row ? m_rowRuns : m_colRuns;
+    auto found = index.lines.find(line);
+    if (found != index.lines.end()) {
+        return found->second;
+    }
+    // Entries are only erased under the exclusive lock, so the reference outlives the guard
+    std::vector<int> positions;
+    const CoordIndex& lines = row ? m_data->yIndex : m_data->xIndex;
+    auto it = lines.find(line);
+    if (it != lines.end()) {
+        positions.reserve(it->second.size());
+        for (const Coord& xy : it->second) {
+            positions.push_back(row ? xy.x() : xy.y());
+        }
+    }
+    Log_N_Debug4("Indexing " << positions.size() << " digits on line " << line);
+    return index.build(line, positions);
+}
+
+
+void mdn::Mdn2dBase::internal_negateValueCache() {
+    m_rowValues.negate();
+    m_colValues.negate();
+    if (m_totalValue) {
+        m_totalValue->negate();
+    }
+    if (m_pyramid) {
+        m_pyramid->negate();
+    }
+    internal_clearCanonical();
+}
+
+
+mdn::Overview mdn::Mdn2dBase::internal_overview(
+    const Rect& window, int level, const CoordSet* polymorphicNodes
+) const {
+    std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+    if (!m_pyramid) {
+        Log_N_Debug3("Building digit pyramid from " << m_data->raw.size() << " digits");
+        m_pyramid.reset(new DigitPyramid());
+        for (const auto& [xy, digit] : m_data->raw) {
+            m_pyramid->change(xy, 0, digit);
+        }
+    }
+    const bool polymorphic = polymorphicNodes != nullptr;
+    if (polymorphic && m_pyramid->polymorphicEvent() != m_event) {
+        m_pyramid->setPolymorphic(*polymorphicNodes, m_event);
+    }
+    Overview result = m_pyramid->overview(
+        window,
+        level,
+        [this](const Coord& xy) {
+            auto it = m_data->raw.find(xy);
+            return it == m_data->raw.end() ? Digit(0) : it->second;
+        }
+    );
+    if (!polymorphic) {
+        for (OverviewTile& cell : result.cells) {
+            cell.polymorphic = 0;
+        }
+    }
+    return result;
+}
+
+
+void mdn::Mdn2dBase::internal_clearCanonical() const {
+    m_canonical.reset();
+    m_fingerprint.reset();
+}
+
+
+void mdn::Mdn2dBase::internal_refreshLines(bool alongRow, bool rank) const {
+    LineValues& lines = alongRow ? m_rowValues : m_colValues;
+    if (!lines.dirty.empty()) {
+        Log_N_Debug4("Refreshing " << lines.dirty.size() << " changed lines");
+        std::sort(lines.dirty.begin(), lines.dirty.end());
+        lines.dirty.erase(std::unique(lines.dirty.begin(), lines.dirty.end()), lines.dirty.end());
+        for (int line : lines.dirty) {
+            auto found = lines.values.find(line);
+            if (found != lines.values.end()) {
+                if (lines.ranked) {
+                    lines.ranking.erase(std::make_pair(found->second.abs(), line));
+                }
+                lines.values.erase(found);
+            }
+        }
+        if (lines.ranked) {
+            // Keep the ranking complete, rebuilding changed lines now
+            for (int line : lines.dirty) {
+                static_cast<void>(internal_lineExact(alongRow, line));
+            }
+        }
+        lines.dirty.clear();
+    }
+    if (rank && !lines.ranked) {
+        Log_N_Debug4("Ranking all " << (alongRow ? "rows" : "columns"));
+        lines.ranking.clear();
+        for (const auto& [line, value] : lines.values) {
+            lines.ranking.emplace(value.abs(), line);
+        }
+        lines.ranked = true;
+        const CoordIndex& index = alongRow ? m_data->yIndex : m_data->xIndex;
+        for (const auto& [line, coords] : index) {
+            if (!coords.empty()) {
+                static_cast<void>(internal_lineExact(alongRow, line));
+            }
+        }
+    }
+}
+
+
+mdn::ExactValue mdn::Mdn2dBase::internal_lineExact(bool alongRow, int line) const {
+    LineValues& lines = alongRow ? m_rowValues : m_colValues;
+    auto found = lines.values.find(line);
+    if (found != lines.values.end()) {
+        return found->second;
+    }
+    // Along a row digits sit at base^x, along a column at base^y
+    const CoordIndex& index = alongRow ? m_data->yIndex : m_data->xIndex;
+    ExactValue::Terms terms;
+    auto it = index.find(line);
+    if (it != index.end()) {
+        terms.reserve(it->second.size());
+        for (const Coord& xy : it->second) {
+            terms.emplace_back(alongRow ? xy.x() : xy.y(), m_data->raw.at(xy));
+        }
+    }
+    ExactValue result = ExactValue::static_fromDigits(m_config.base(), terms);
+    if (!result.isZero()) {
+        lines.values.emplace(line, result);
+        if (lines.ranked) {
+            lines.ranking.emplace(result.abs(), line);
+        }
+    }
+    return result;
 }
 
 
 bool mdn::Mdn2dBase::internal_setValueRaw(const Coord& xy, Digit value) {
+    internal_detach();
     if (value == 0) {
         If_Log_Showing_Debug4(
             Log_N_Debug4_H(
@@ -2000,8 +2602,8 @@ bool mdn::Mdn2dBase::internal_setValueRaw(const Coord& xy, Digit value) {
         return false;
     }
 
-    auto it = m_raw.find(xy);
-    if (it == m_raw.end()) {
+    auto it = m_data->raw.find(xy);
+    if (it == m_data->raw.end()) {
         // No entry exists
         If_Log_Showing_Debug4(
             Log_N_Debug4_H(
@@ -2017,7 +2619,8 @@ bool mdn::Mdn2dBase::internal_setValueRaw(const Coord& xy, Digit value) {
         }
         internal_modified();
         internal_insertAddress(xy);
-        m_raw[xy] = value;
+        m_data->raw[xy] = value;
+        internal_valueChanged(xy, 0, value);
         if (ps == PrecisionStatus::Above) {
             // Above numerical precision range
             Log_N_Debug4("New value above precision range, purging low digits");
@@ -2035,6 +2638,7 @@ bool mdn::Mdn2dBase::internal_setValueRaw(const Coord& xy, Digit value) {
     it->second = value;
     if (oldVal != value) {
         internal_modified();
+        internal_valueChanged(xy, oldVal, value);
     } else {
         If_Log_Showing_Debug4(
             Log_N_Debug4(
@@ -2064,25 +2668,11 @@ bool mdn::Mdn2dBase::internal_setValueRaw(const Coord& xy, Digit value) {
 
 void mdn::Mdn2dBase::internal_insertAddress(const Coord& xy) const {
     Log_N_Debug4("At: " << xy);
-    m_index.insert(xy);
-    auto xit = m_xIndex.find(xy.x());
-    if (xit == m_xIndex.end()) {
-        m_xIndex.emplace(xy.x(), CoordSet());
-        CoordSet newX;
-        newX.insert(xy);
-        m_xIndex[xy.x()] = newX;
-    } else {
-        xit->second.insert(xy);
-    }
-    auto yit = m_yIndex.find(xy.y());
-    if (yit == m_yIndex.end()) {
-        m_yIndex.emplace(xy.y(), CoordSet());
-        CoordSet newy;
-        newy.insert(xy);
-        m_yIndex[xy.y()] = newy;
-    } else {
-        yit->second.insert(xy);
-    }
+    internal_detach();
+    m_data->index.insert(xy);
+    // New index sets are constructed with the index's own memory resource
+    m_data->xIndex[xy.x()].insert(xy);
+    m_data->yIndex[xy.y()].insert(xy);
     m_bounds.growToInclude(xy);
 }
 
@@ -2143,7 +2733,7 @@ int mdn::Mdn2dBase::internal_purgeExcessDigits() {
     int purgeX = gridSize.x() - precision;
     if (purgeX > 0) {
         int minX = m_bounds.max().x() - precision;
-        for (const auto& [x, coords] : m_xIndex) {
+        for (const auto& [x, coords] : m_data->xIndex) {
             if (x >= minX) break;
             purgeSet.insert(coords.begin(), coords.end());
         }
@@ -2151,7 +2741,7 @@ int mdn::Mdn2dBase::internal_purgeExcessDigits() {
     int purgeY = gridSize.y() - precision;
     if (purgeY > 0) {
         int minY = m_bounds.max().y() - precision;
-        for (const auto& [y, coords] : m_yIndex) {
+        for (const auto& [y, coords] : m_data->yIndex) {
             if (y >= minY) break;
             purgeSet.insert(coords.begin(), coords.end());
         }
@@ -2175,14 +2765,14 @@ int mdn::Mdn2dBase::internal_purgeExcessDigits() {
 
 void mdn::Mdn2dBase::internal_updateBounds() {
     Log_N_Debug4_H("");
-    if (m_xIndex.empty() || m_yIndex.empty()) {
+    if (m_data->xIndex.empty() || m_data->yIndex.empty()) {
         m_bounds.clear();
         Log_N_Debug3("Updating bounds: no non-zero digits exist, there are no bounds");
     } else {
-        auto itMinX = m_xIndex.cbegin();
-        auto itMaxX = m_xIndex.crbegin();
-        auto itMinY = m_yIndex.cbegin();
-        auto itMaxY = m_yIndex.crbegin();
+        auto itMinX = m_data->xIndex.cbegin();
+        auto itMaxX = m_data->xIndex.crbegin();
+        auto itMinY = m_data->yIndex.cbegin();
+        auto itMaxY = m_data->yIndex.crbegin();
         m_bounds.set(itMinX->first, itMinY->first, itMaxX->first, itMaxY->first);
         Log_N_Debug3("Updating bounds, new bounds: " << m_bounds);
     }
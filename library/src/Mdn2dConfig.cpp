@@ -67,7 +67,8 @@ mdn::Mdn2dConfig::Mdn2dConfig(
     m_epsilon(static_calculateEpsilon(m_precision, m_base)),
     m_signConvention(signConventionIn),
     m_fraxisCascadeDepth(fraxisCascadeDepthIn),
-    m_fraxis(fraxisIn)
+    m_fraxis(fraxisIn),
+    m_maxCleanupWaves(defaultMaxCleanupWaves())
 {
     Log_Debug3_H("");
     updateIdentity();
@@ -124,7 +125,8 @@ bool mdn::Mdn2dConfig::checkConfig() const {
             (m_signConvention == SignConvention::Negative) ||
             (m_signConvention == SignConvention::Neutral)
         ) &&
-        ((m_fraxis == Fraxis::X) || (m_fraxis == Fraxis::Y))
+        ((m_fraxis == Fraxis::X) || (m_fraxis == Fraxis::Y)) &&
+        (m_maxCleanupWaves > 0 || m_maxCleanupWaves == -1)
     );
 }
 
@@ -140,7 +142,8 @@ void mdn::Mdn2dConfig::validateConfig() const {
         oss << ", expecting: 'Neutral', 'Positive', or 'Negative'" << std::endl;
         oss << "    fraxisCascadeDepth = " << m_fraxisCascadeDepth << std::endl;
         oss << "    fraxis = " << FraxisToName(m_fraxis)
-            << ", expecting 'X' or 'Y'";
+            << ", expecting 'X' or 'Y'" << std::endl;
+        oss << "    maxCleanupWaves = " << m_maxCleanupWaves << ", must be > 0, or -1";
         InvalidArgument err(oss.str());
         Log_Error(err.what());
         throw err;
@@ -164,6 +167,7 @@ void mdn::Mdn2dConfig::update(const Mdn2dConfig& cfg) {
     m_signConvention = cfg.m_signConvention;
     m_fraxisCascadeDepth = cfg.m_fraxisCascadeDepth;
     m_fraxis = cfg.m_fraxis;
+    m_maxCleanupWaves = cfg.m_maxCleanupWaves;
 }
 
 
@@ -1,7 +1,10 @@
 #include <mdn/Mdn2dIO.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <sstream>
@@ -9,10 +12,14 @@
 #include <mdn/Coord.hpp>
 #include <mdn/Logger.hpp>
 #include <mdn/Mdn2dConfig.hpp>
+#include <mdn/PackedDigits.hpp>
 #include <mdn/Tools.hpp>
 
 namespace {
 
+// Streaming text output is written to the std::ostream in chunks of about this size
+constexpr std::size_t streamChunkBytes = 1 << 20;
+
 // Forward declaration so helpers can use toU32
 static std::u32string toU32(const std::string& in);
 
@@ -160,6 +167,281 @@ static char delimChar(mdn::CommaTabSpace d) {
     }
 }
 
+
+// Formats lines of text output - the x axis line, and rows of digits.  Digit text comes from a
+//  table built once, with Tools::digitToAlpha, so each digit is a single append.
+class RowFormatter {
+
+    // Axis characters, empty when axes are off
+    std::string m_h;
+    std::string m_v;
+    std::string m_x;
+    bool m_hasAxes;
+
+    // Delimiter between cells
+    std::string m_delim;
+
+    // Minimum width of the sign and digit, 0 for none
+    int m_padding;
+
+    // Position in a row of the vertical axis, i.e. before index m_xDigLine
+    int m_xDigLine;
+
+    // Text for each digit value, with its trailing delimiter, indexed by value + maxMagnitude
+    static constexpr int maxMagnitude = 31;
+    std::array<std::string, 2*maxMagnitude + 1> m_digitText;
+
+    // Options needed for digits outside the table
+    bool m_alphanumeric;
+    std::string m_negative;
+
+
+public:
+
+    RowFormatter(const mdn::TextWriteOptions& opt, int base, int xDigLine) :
+        m_hasAxes(false),
+        m_delim(mdn::toString(opt.delim)),
+        m_padding(0),
+        m_xDigLine(xDigLine),
+        m_alphanumeric(opt.alphanumeric),
+        m_negative(opt.wideNegatives ? mdn::Tools::BoxArtStr_h : "-")
+    {
+        switch (opt.axes) {
+            case mdn::AxesOutput::None: {
+                break;
+            }
+            case mdn::AxesOutput::BoxArt: {
+                m_hasAxes = true;
+                m_h = mdn::Tools::BoxArtStr_h;
+                m_v = mdn::Tools::BoxArtStr_v;
+                m_x = mdn::Tools::BoxArtStr_x;
+                break;
+            }
+            case mdn::AxesOutput::Simple: {
+                m_hasAxes = true;
+                m_h = "-";
+                m_v = "|";
+                m_x = "+";
+                break;
+            }
+        }
+
+        // Pad with spaces only when delim is Space
+        if (opt.delim == mdn::CommaTabSpace::Space) {
+            if (!opt.alphanumeric && base > 10) {
+                // sign and digit may be 3 characters: e.g. -12
+                m_padding = 3;
+            } else {
+                // sign and digit will never exceed 2 characters: e.g. -c
+                m_padding = 2;
+            }
+        }
+
+        for (int v = -maxMagnitude; v <= maxMagnitude; ++v) {
+            m_digitText[v + maxMagnitude] = mdn::Tools::digitToAlpha(
+                static_cast<mdn::Digit>(v), m_alphanumeric, "", m_negative, m_padding
+            ) + m_delim;
+        }
+    }
+
+    bool hasAxes() const {
+        return m_hasAxes;
+    }
+
+    // Appends the x axis line for rows of xCount digits
+    void appendAxisLine(std::string& out, int xCount) const {
+        std::string hAssemble;
+        if (m_padding > 0) {
+            for (int i = 0; i <= m_padding; ++i) {
+                hAssemble += m_h;
+            }
+        } else {
+            // No character alignment, default to width of 2
+            hAssemble = m_h + m_h;
+        }
+        // i indexes along a row i=0 where x=x0, i.e. x = x0+i
+        int i;
+        for (i = 0; i < m_xDigLine && i < xCount; ++i) {
+            out += hAssemble;
+        }
+        if (i == m_xDigLine) {
+            out += m_x;
+            out += m_h;
+            // extra 'H' is to account for adding a delimeter after the vertical digit line
+        }
+        for (; i < xCount; ++i) {
+            out += hAssemble;
+        }
+    }
+
+    // Appends one row of digits, with the vertical axis when axes are on
+    void appendRow(std::string& out, const std::vector<mdn::Digit>& row) const {
+        const int xCount = static_cast<int>(row.size());
+        int i;
+        for (i = 0; i < m_xDigLine && i < xCount; ++i) {
+            appendDigit(out, row[i]);
+        }
+        if (m_hasAxes && (i == m_xDigLine)) {
+            out += m_v;
+            out += m_delim;
+        }
+        for (; i < xCount; ++i) {
+            appendDigit(out, row[i]);
+        }
+    }
+
+
+private:
+
+    void appendDigit(std::string& out, mdn::Digit d) const {
+        const int v = static_cast<int>(d);
+        if (v >= -maxMagnitude && v <= maxMagnitude) {
+            out += m_digitText[v + maxMagnitude];
+        } else {
+            out += mdn::Tools::digitToAlpha(d, m_alphanumeric, "", m_negative, m_padding);
+            out += m_delim;
+        }
+    }
+
+};
+
+
+// Reads everything left in the stream into one buffer
+static std::string readRemaining(std::istream& is) {
+    std::string buffer;
+    const std::streampos start = is.tellg();
+    if (start != std::streampos(-1)) {
+        is.seekg(0, std::ios::end);
+        const std::streampos end = is.tellg();
+        is.seekg(start);
+        if (end != std::streampos(-1) && end > start) {
+            buffer.reserve(static_cast<std::size_t>(end - start));
+        }
+    }
+    is.clear();
+    char chunk[1 << 16];
+    while (is.read(chunk, sizeof(chunk)) || is.gcount() > 0) {
+        buffer.append(chunk, static_cast<std::size_t>(is.gcount()));
+    }
+    return buffer;
+}
+
+
+// Finds the next line in [cursor, end), excluding its '\n' or "\r\n", with std::getline semantics
+static bool nextLine(const char*& cursor, const char* end, const char*& b, const char*& e) {
+    if (cursor >= end) {
+        return false;
+    }
+    b = cursor;
+    const void* nl = std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor));
+    e = nl ? static_cast<const char*>(nl) : end;
+    cursor = nl ? e + 1 : end;
+    if (e > b && *(e - 1) == '\r') {
+        --e;
+    }
+    return true;
+}
+
+
+static bool nextLine(const char*& cursor, const char* end, std::string& line) {
+    const char* b;
+    const char* e;
+    if (!nextLine(cursor, end, b, e)) {
+        return false;
+    }
+    line.assign(b, e);
+    return true;
+}
+
+
+// True when [b, e) is plain ASCII, checked a word at a time
+static bool isAscii(const char* b, const char* e) {
+    constexpr std::uint64_t highBits = 0x8080808080808080ULL;
+    while (e - b >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, b, sizeof(word));
+        if (word & highBits) {
+            return false;
+        }
+        b += 8;
+    }
+    for (; b < e; ++b) {
+        if (static_cast<unsigned char>(*b) & 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// ASCII version of likelyAxisLine
+static bool likelyAxisLineAscii(const char* b, const char* e) {
+    for (const char* p = b; p < e; ++p) {
+        const char c = *p;
+        if (c == ' ' || c == '\t' || c == '\r') {
+            continue;
+        }
+        if (c != '|' && c != '-' && c != '+') {
+            return false;
+        }
+    }
+    return b < e;
+}
+
+
+// Parses one cell: a lone letter is an alphanumeric digit, anything else is read like
+//  std::stoi, with unparseable cells giving 0
+static int parseCell(const char* b, const char* e) {
+    if (e - b == 1 && std::isalpha(static_cast<unsigned char>(*b))) {
+        int v = alphaToDigit(static_cast<char32_t>(static_cast<unsigned char>(*b)));
+        return v == std::numeric_limits<int>::min() ? 0 : v;
+    }
+    const char* p = b;
+    while (p < e && std::isspace(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    bool negative = false;
+    if (p < e && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p == e || *p < '0' || *p > '9') {
+        return 0;
+    }
+    long long v = 0;
+    for (; p < e && *p >= '0' && *p <= '9'; ++p) {
+        v = v*10 + (*p - '0');
+        if (v > static_cast<long long>(std::numeric_limits<int>::max()) + 1) {
+            return 0;
+        }
+    }
+    if (negative) {
+        v = -v;
+    }
+    if (v > std::numeric_limits<int>::max()) {
+        return 0;
+    }
+    return static_cast<int>(v);
+}
+
+
+// Splits [b, e) on delim and parses each non-empty cell into row
+static void splitCells(const char* b, const char* e, char delim, std::vector<int>& row) {
+    while (b < e) {
+        const void* found = std::memchr(b, delim, static_cast<std::size_t>(e - b));
+        const char* cellEnd = found ? static_cast<const char*>(found) : e;
+        if (cellEnd > b) {
+            row.push_back(parseCell(b, cellEnd));
+        }
+        b = cellEnd + 1;
+    }
+}
+
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 } // anonymous
 
 
@@ -270,13 +552,24 @@ std::vector<std::string> mdn::Mdn2dIO::locked_toStringRows(
     const TextWriteOptions& opt
 ) {
     Log_Debug3_H(src.name() << ": opt=" << opt);
+    std::vector<std::string> lines;
+    internal_formatRows(src, opt, [&lines](const std::string& line) { lines.push_back(line); });
+    Log_Debug3_T("returning " << lines.size() << " lines of text");
+    return lines;
+}
+
+
+void mdn::Mdn2dIO::internal_formatRows(
+    const Mdn2dBase& src,
+    const TextWriteOptions& opt,
+    const std::function<void(const std::string&)>& emit
+) {
     Log_Debug4("opt.rowOrder=" << toString(opt.rowOrder));
     Rect b = src.locked_hasBounds() ? src.locked_bounds() : Rect::GetInvalid();
     Rect w = opt.window.isValid() ? opt.window : b;
-    std::vector<std::string> lines;
     if (!w.isValid()) {
-        Log_Debug3_T("Empty window");
-        return lines;
+        Log_Debug3("Empty window");
+        return;
     }
 
     const int x0 = w.left();
@@ -302,129 +595,67 @@ std::vector<std::string> mdn::Mdn2dIO::locked_toStringRows(
         << ", y:(" << y0 << "," << y1 << ")=" << yCount
     );
 
-    std::string H = "";
-    std::string V = "";
-    std::string X = "";
-    bool hasAxes = false;
-    switch (opt.axes) {
-        case AxesOutput::None: {
-            break;
-        }
-        case AxesOutput::BoxArt: {
-            hasAxes = true;
-            H = Tools::BoxArtStr_h;
-            V = Tools::BoxArtStr_v;
-            X = Tools::BoxArtStr_x;
-            break;
-        }
-        case AxesOutput::Simple: {
-            hasAxes = true;
-            H = "-";
-            V = "|";
-            X = "+";
-            break;
-        }
-    }
-
-    std::string delimStr = mdn::toString(opt.delim);
-
-    // Pad with spaces only when delim is Space
-    int signAndDigitPadding = 0;
-    if (opt.delim == CommaTabSpace::Space) {
-        if (!opt.alphanumeric && src.locked_config().base() > 10) {
-            // sign and digit may be 3 characters: e.g. -12
-            signAndDigitPadding = 3;
-        } else {
-            // sign and digit will never exceed 2 characters: e.g. -c
-            signAndDigitPadding = 2;
-        }
-    }
-
     // DigLine - digit line appears before what index in 'row' array below
     int xDigLine = -x0;
     int yDigLine = -1;
 
-    std::string negativeStr = opt.wideNegatives? Tools::BoxArtStr_h : "-";
+    const RowFormatter formatter(opt, src.locked_config().base(), xDigLine);
 
+    // Both are reused for every line, so memory stays constant with window height
     std::vector<Digit> row;
+    std::string line;
     Log_Debug3("Reserving " << xCount);
     row.reserve(static_cast<std::size_t>(xCount));
 
-    // for (int y = y0; y <= y1; ++y) {
     Log_Debug4("y=" << yStart << " to " << yEnd);
     for (int y = yStart; ; y += yStep) {
         // First, if axes are on, are we at the yDigit line?
-        if (hasAxes && (y == yDigLine)) {
-            std::string hAssemble;
-            if (signAndDigitPadding > 0) {
-                for (int i = 0; i <= signAndDigitPadding; ++i) {
-                    hAssemble += H;
-                }
-            } else {
-                // No character alignment, default to width of 2
-                hAssemble = H + H;
-            }
-            // i indexes along a row i=0 where x=x0, i.e. x = x0+i
-            int i;
-            std::ostringstream oss;
-            for (i = 0; i < xDigLine && i < xCount; ++i) {
-                oss << hAssemble;
-            }
-            if (i == xDigLine) {
-                oss << X << H;
-                // extra 'H' is to account for adding a delimeter after the vertical digit line
-            }
-            for (; i < xCount; ++i) {
-                oss << hAssemble;
-            }
-            lines.push_back(oss.str());
+        if (formatter.hasAxes() && (y == yDigLine)) {
+            line.clear();
+            formatter.appendAxisLine(line, xCount);
+            emit(line);
         }
-        Log_Debug3_H("getRow dispatch(" << y << "," << x0 << "," << x1 << ", row)");
         Coord xy(x0, y);
         src.locked_getRow(xy, xCount, row);
-        Log_Debug3_T(
-            "row.size()=" << row.size() << ", xCount=" << xCount << ", row.size()==xCount="
-                << (row.size() == xCount)
-        );
         Assert(row.size() == xCount, "Rows are not the expected size");
-        std::ostringstream line;
-
-        // Now indexing by position in the row array
-        int i;
-        for (i = 0; i < xDigLine && i < xCount; ++i) {
-            std::string digStr(
-                Tools::digitToAlpha(
-                    row[i],
-                    opt.alphanumeric,
-                    "",
-                    negativeStr,
-                    signAndDigitPadding
-                )
-            );
-            line << digStr << delimStr;
-        }
-        if (hasAxes && (i == xDigLine)) {
-            line << V << delimStr;
-        }
-        for (; i < xCount; ++i) {
-            std::string digStr(
-                Tools::digitToAlpha(
-                    row[i],
-                    opt.alphanumeric,
-                    "",
-                    negativeStr,
-                    signAndDigitPadding
-                )
-            );
-            line << digStr << delimStr;
-        }
-        lines.push_back(line.str());
+        line.clear();
+        formatter.appendRow(line, row);
+        emit(line);
         if (y == yEnd) {
             break;
         }
     } // end y loop
-    Log_Debug3_T("returning " << lines.size() << " lines of text");
-    return lines;
+}
+
+
+void mdn::Mdn2dIO::internal_streamRows(
+    const Mdn2dBase& src,
+    std::ostream& os,
+    const TextWriteOptions& opt
+) {
+    Log_Debug3_H("");
+    // Lines are gathered into one buffer and written in large chunks, lines are separated by
+    //  '\n', with no trailing newline
+    std::string chunk;
+    chunk.reserve(streamChunkBytes + streamChunkBytes/4);
+    bool first = true;
+    internal_formatRows(
+        src,
+        opt,
+        [&os, &chunk, &first](const std::string& line) {
+            if (!first) {
+                chunk += '\n';
+            }
+            first = false;
+            chunk += line;
+            if (chunk.size() >= streamChunkBytes) {
+                os.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                chunk.clear();
+            }
+        }
+    );
+    os.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    Log_Debug3_T("");
 }
 
 
@@ -602,14 +833,8 @@ void mdn::Mdn2dIO::locked_saveTextPretty(
     Log_Debug3_H("");
     // First output header (name and bounds)
     internal_saveTextHeader(src, os);
-    // Now output the data
-    std::vector<std::string> lines = locked_toStringRows(src, opt);
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        os << lines[i];
-        if (i + 1 < lines.size()) {
-            os << '\n';
-        }
-    }
+    // Now stream the data
+    internal_streamRows(src, os, opt);
     Log_Debug3_T("");
 }
 
@@ -632,14 +857,8 @@ void mdn::Mdn2dIO::locked_saveTextUtility(
     Log_Debug3_H("");
     // First output header (name and bounds)
     internal_saveTextHeader(src, os);
-    // Now output the data
-    std::vector<std::string> lines = locked_toStringRows(src, opt);
-    for (std::size_t i = 0; i < lines.size(); ++i) {
-        os << lines[i];
-        if (i + 1 < lines.size()) {
-            os << '\n';
-        }
-    }
+    // Now stream the data
+    internal_streamRows(src, os, opt);
     Log_Debug3_T("");
 }
 
@@ -659,10 +878,17 @@ mdn::TextReadSummary mdn::Mdn2dIO::locked_loadText(
     Mdn2dBase& dst
 ) {
     Log_Debug3_H("");
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Work on one contiguous buffer, lines and cells are found by scanning bytes
+    const std::string buffer = readRemaining(is);
+    const char* cursor = buffer.data();
+    const char* const bufferEnd = cursor + buffer.size();
+
     std::string nameLine, boundsLine, configLine;
 
-    // Handle optional BOM on the very first getline
-    if (!std::getline(is, nameLine)) {
+    // Handle optional BOM on the very first line
+    if (!nextLine(cursor, bufferEnd, nameLine)) {
         Log_Debug3_T("empty stream");
         return {};
     }
@@ -676,12 +902,12 @@ mdn::TextReadSummary mdn::Mdn2dIO::locked_loadText(
     }
     Log_Debug4("ready to read stream");
 
-    if (!std::getline(is, boundsLine)) {
+    if (!nextLine(cursor, bufferEnd, boundsLine)) {
         Log_Debug3_T("Stream ended early");
         return {};
     }
     Log_Debug4("Got raw bounds line: [" << boundsLine << "]");
-    if (!std::getline(is, configLine)) {
+    if (!nextLine(cursor, bufferEnd, configLine)) {
         Log_Debug3_T("Stream ended early");
         return {};
     }
@@ -731,110 +957,108 @@ mdn::TextReadSummary mdn::Mdn2dIO::locked_loadText(
     mdn::Rect writeRect = empty ? mdn::Rect::GetInvalid() : mdn::Rect(x0, y0, x1, y1, true);
     Log_Debug4("Assembled bounds=" << writeRect);
 
-    // Now read the remainder of the stream as data lines (your existing logic below)
-    std::vector<std::string> lines;
-    std::string line;
-    while (std::getline(is, line)) {
-        lines.push_back(line);
-    }
-
-    std::vector<std::vector<int>> grid;
-    grid.reserve(lines.size());
-
+    // Data lines, parsed into one flat grid, top row first.  Width is set by the first row,
+    //  shorter rows are padded with zeroes and longer rows are truncated.
+    std::vector<Digit> grid;
+    std::vector<int> row;
+    std::string converted;
+    int W = 0;
+    int H = 0;
     char delim = '\0';
-    for (const std::string& ln : lines) {
-        Log_Debug4("Working on line [" << ln << "]");
-        std::u32string u = toU32(ln);
-        if (likelyAxisLine(u)) {
-            Log_Debug4("Likely axis line");
-            continue;
-        }
-        for (char32_t& c : u) {
-            if (c == BOX_V() || c == U'|') {
-                c = U' ';
+    const char* lineBegin;
+    const char* lineEnd;
+    while (nextLine(cursor, bufferEnd, lineBegin, lineEnd)) {
+        const char* b = lineBegin;
+        const char* e = lineEnd;
+        if (!isAscii(b, e)) {
+            // Box-art or other multi-byte characters - decode only this line
+            std::u32string u = toU32(std::string(b, e));
+            if (likelyAxisLine(u)) {
+                Log_Debug4("Likely axis line");
+                continue;
             }
-            if (c == BOX_H()) {
-                c = U'-';
+            for (char32_t& c : u) {
+                if (c == BOX_V() || c == U'|') {
+                    c = U' ';
+                }
+                if (c == BOX_H()) {
+                    c = U'-';
+                }
+            }
+            converted = fromU32(u);
+            b = converted.data();
+            e = b + converted.size();
+        } else {
+            if (likelyAxisLineAscii(b, e)) {
+                Log_Debug4("Likely axis line");
+                continue;
+            }
+            if (std::memchr(b, '|', e - b)) {
+                converted.assign(b, e);
+                std::replace(converted.begin(), converted.end(), '|', ' ');
+                b = converted.data();
+                e = b + converted.size();
             }
         }
-        std::string ascii = fromU32(u);
-        Log_Debug4("ascii=" << ascii);
 
         if (delim == '\0') {
-            delim = internal_identifyDelim(ascii);
+            delim = internal_identifyDelim(std::string(b, e));
             if (delim == '\0') {
                 Log_Debug4("Could not identify delimiter");
                 continue;
             }
         }
-        std::istringstream iss(ascii);
-        std::string cell;
-        std::vector<int> row;
-        while (std::getline(iss, cell, delim)) {
-            if (cell.empty()) {
-                continue;
-            }
-            bool hasAlpha = false;
-            for (char ch : cell) {
-                if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')) {
-                    hasAlpha = true;
-                    break;
-                }
-            }
-            if (hasAlpha && cell.size() == 1) {
-                int v = alphaToDigit(static_cast<char32_t>(cell[0]));
-                row.push_back(v == std::numeric_limits<int>::min() ? 0 : v);
-            } else {
-                try {
-                    int v = std::stoi(cell);
-                    row.push_back(v);
-                } catch (...) {
-                    row.push_back(0);
-                }
-            }
+        row.clear();
+        splitCells(b, e, delim, row);
+        if (row.empty()) {
+            continue;
         }
-        if (!row.empty()) {
-            grid.push_back(std::move(row));
-            If_Log_Showing_Debug4(
-                Log_Debug4("row=[" << Tools::vectorToString(row, ",", false) << "]");
-            );
+        If_Log_Showing_Debug4(
+            Log_Debug4("row=[" << Tools::vectorToString(row, ",", false) << "]");
+        );
+        if (H == 0) {
+            W = static_cast<int>(row.size());
         }
+        row.resize(static_cast<std::size_t>(W), 0);
+        for (int v : row) {
+            grid.push_back(static_cast<Digit>(v));
+        }
+        ++H;
     }
 
     TextReadSummary out;
-    if (grid.empty()) {
+    out.bytes = buffer.size();
+    if (H == 0) {
+        out.seconds = secondsSince(startTime);
         Log_Debug3_T("result = " << out);
         return out;
     }
 
-    const int H = static_cast<int>(grid.size());
-    const int W = static_cast<int>(grid.front().size());
-
     // Destination anchor (bottom-left) from header, or (0,0) if Empty/invalid
     const int ax = writeRect.isValid() ? writeRect.left()   : 0;
     const int ay = writeRect.isValid() ? writeRect.bottom() : 0;
 
-    // Clear and write rows, anchored at (ax, ay)
+    // Clear and bulk-write rows, anchored at (ax, ay), with storage sized once up front
     dst.locked_clear();
+    const std::size_t nNonZero = static_cast<std::size_t>(
+        grid.size() - std::count(grid.cbegin(), grid.cend(), Digit(0))
+    );
+    dst.m_data->raw.reserve(nNonZero);
+    dst.m_data->index.reserve(nNonZero);
 
-    std::vector<Digit> row;
-    row.resize(static_cast<std::size_t>(W));
-
+    VecDigit digitRow(static_cast<std::size_t>(W));
     for (int r = 0; r < H; ++r) {
-        for (int c = 0; c < W; ++c) {
-            row[static_cast<std::size_t>(c)] =
-                static_cast<Digit>(grid[static_cast<std::size_t>(r)][static_cast<std::size_t>(c)]);
-        }
+        const auto rowBegin = grid.cbegin() + static_cast<std::ptrdiff_t>(r)*W;
+        std::copy(rowBegin, rowBegin + W, digitRow.begin());
         Coord xy(ax, ay + (H - 1 - r));
-        dst.locked_setRow(xy, row);
-        // dst.locked_setRow(ay + (H - 1 - r), ax, row);
-        Log_Info("row index is " << ay + (H - 1 - r) << ", and other one would be " << (ay + r));
+        dst.locked_setRow(xy, digitRow);
     }
 
     // Report what we parsed/wrote
     out.width  = W;
     out.height = H;
     out.parsedRect = Rect(ax, ay, ax + W - 1, ay + H - 1);
+    out.seconds = secondsSince(startTime);
 
     Log_Debug3_T("result = " << out);
     return out;
@@ -861,7 +1085,7 @@ void mdn::Mdn2dIO::locked_saveBinary(
     os.write(magic, 6);
 
     // version
-    uint16_t ver = 1;
+    uint16_t ver = 2;
     os.write(reinterpret_cast<const char*>(&ver), sizeof(ver));
 
     const std::string nameUtf8 = src.m_name;
@@ -897,23 +1121,24 @@ void mdn::Mdn2dIO::locked_saveBinary(
     os.write(reinterpret_cast<const char*>(&H), sizeof(H));
     os.write(reinterpret_cast<const char*>(&W), sizeof(W));
 
+    // version 2: digit packing
+    const DigitPacking packing = PackedDigits::forBase(base);
+    uint8_t packing8 = static_cast<uint8_t>(packing);
+    os.write(reinterpret_cast<const char*>(&packing8), sizeof(packing8));
+
     if (!b.isValid()) {
         Log_Debug3_T("");
         return;
     }
 
-    std::vector<Digit> row;
-    row.reserve(static_cast<std::size_t>(W));
-
-    std::int32_t width = x1 - x0 + 1;
+    PackedRow row;
     for (int y = y0; y <= y1; ++y) {
-        row.clear();
         Coord xy(x0, y);
-        src.getRow(xy, width, row);
-        for (Digit d : row) {
-            std::int8_t b8 = static_cast<std::int8_t>(d);
-            os.write(reinterpret_cast<const char*>(&b8), sizeof(b8));
-        }
+        src.locked_getRowPacked(xy, W, row);
+        os.write(
+            reinterpret_cast<const char*>(row.data.data()),
+            static_cast<std::streamsize>(row.data.size())
+        );
     }
     Log_Debug3_T("");
 }
@@ -943,9 +1168,10 @@ void mdn::Mdn2dIO::locked_loadBinary(
 
     std::uint16_t ver = 0;
     is.read(reinterpret_cast<char*>(&ver), sizeof(ver));
-    if (ver != 1) {
+    if (ver != 1 && ver != 2) {
         ReadError err(
-            "Unsupported Mdn2d version: expecting version 1, got version " + std::to_string(ver)
+            "Unsupported Mdn2d version: expecting version 1 or 2, got version " +
+            std::to_string(ver)
         );
         Log_Error(err.what());
         throw err;
@@ -992,6 +1218,17 @@ void mdn::Mdn2dIO::locked_loadBinary(
     is.read(reinterpret_cast<char*>(&H), sizeof(H));
     is.read(reinterpret_cast<char*>(&W), sizeof(W));
 
+    // Version 1 rows are unpacked bytes
+    std::uint8_t packing8 = static_cast<std::uint8_t>(DigitPacking::Byte);
+    if (ver >= 2) {
+        is.read(reinterpret_cast<char*>(&packing8), sizeof(packing8));
+        if (!PackedDigits::isValid(packing8)) {
+            ReadError err("Unsupported digit packing in Mdn2d binary: " + std::to_string(packing8));
+            Log_Error(err.what());
+            throw err;
+        }
+    }
+
     Mdn2dConfig dstCfg = dst.locked_config();
     Mdn2dConfig cfg = Mdn2dConfig(
         static_cast<int>(base32),
@@ -1008,17 +1245,26 @@ void mdn::Mdn2dIO::locked_loadBinary(
         return;
     }
 
-    std::vector<Digit> row;
-    row.resize(static_cast<std::size_t>(W), Digit(0));
+    PackedRow row;
+    row.packing = static_cast<DigitPacking>(packing8);
+    row.width = W;
+    row.data.resize(PackedDigits::bytes(row.packing, W));
 
     for (int r = 0; r < H; ++r) {
-        for (int c = 0; c < W; ++c) {
-            std::int8_t b8 = 0;
-            is.read(reinterpret_cast<char*>(&b8), sizeof(b8));
-            row[static_cast<std::size_t>(c)] = static_cast<Digit>(b8);
+        is.read(
+            reinterpret_cast<char*>(row.data.data()),
+            static_cast<std::streamsize>(row.data.size())
+        );
+        if (!is) {
+            ReadError err(
+                "Mdn2d binary ends early, read " + std::to_string(r) + " of " +
+                std::to_string(H) + " rows"
+            );
+            Log_Error(err.what());
+            throw err;
         }
         Coord xy(x0, y0 + r);
-        dst.locked_setRow(xy, row);
+        dst.locked_setRowPacked(xy, row);
     }
     Log_Debug3_T("");
 }
@@ -1079,7 +1325,7 @@ mdn::TextReadSummary mdn::Mdn2dIO::locked_load(
         if (headerOk) safeRead(&ver, sizeof(ver));
         // Don’t throw here; let the real binary loader validate/throw.
         // If unexpected, we’ll just fall back to text.
-        if (!(headerOk && ver == 1)) headerOk = false;
+        if (!(headerOk && (ver == 1 || ver == 2))) headerOk = false;
 
         // 3) Name length + name bytes
         std::uint32_t nameLen = 0;
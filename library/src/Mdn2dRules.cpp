@@ -1,5 +1,6 @@
 #include <mdn/Mdn2dRules.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
@@ -11,7 +12,80 @@
 #include <mdn/MdnException.hpp>
 #include <mdn/Tools.hpp>
 
-constexpr int maxCarryoverIters = 200;
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define MDN_CARRYOVER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MDN_CARRYOVER_SSE2
+#endif
+
+// Colour classes at least this size are checked in parallel during carryover cleanup
+constexpr int parallelCleanupMinCoords = 4096;
+
+// A row is 'dense' enough for the row kernel when its span is no more than this many times its
+//  non-zero count
+constexpr int denseRowSpanFactor = 8;
+
+namespace {
+
+// Core of static_checkCarryover, without the logging, shared by the scalar row kernel
+inline mdn::Carryover classifyCarryover(mdn::Digit p, mdn::Digit x, mdn::Digit y, mdn::Digit base) {
+    if (p > base || p < -base) {
+        return mdn::Carryover::Required;
+    }
+    if (p > 0) {
+        if (x < 0 && y < 0) {
+            return mdn::Carryover::Required;
+        } else if (x < 0 || y < 0) {
+            return mdn::Carryover::OptionalPositive;
+        }
+    } else if (p < 0) {
+        if (x > 0 && y > 0) {
+            return mdn::Carryover::Required;
+        } else if (x > 0 || y > 0) {
+            return mdn::Carryover::OptionalNegative;
+        }
+    }
+    return mdn::Carryover::Invalid;
+}
+
+// Scalar row kernel, classifies positions i0 .. n-1
+void checkCarryoverRowScalar(
+    const mdn::Digit* p,
+    const mdn::Digit* x,
+    const mdn::Digit* y,
+    int i0,
+    int n,
+    mdn::Digit base,
+    mdn::CarryoverMasks& masks
+) {
+    constexpr int wb = mdn::CarryoverMasks::wordBits;
+    for (int i = i0; i < n; ++i) {
+        const uint64_t bit = uint64_t(1) << (i % wb);
+        switch (classifyCarryover(p[i], x[i], y[i], base)) {
+            case mdn::Carryover::Required:
+                masks.required[i/wb] |= bit;
+                break;
+            case mdn::Carryover::OptionalPositive:
+                masks.optionalPositive[i/wb] |= bit;
+                break;
+            case mdn::Carryover::OptionalNegative:
+                masks.optionalNegative[i/wb] |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Carryover cleanup colour class of xy, (x - y) mod 3
+inline int cleanupColour(const mdn::Coord& xy) {
+    const int c = (xy.x() - xy.y()) % 3;
+    return c < 0 ? c + 3 : c;
+}
+
+} // end anonymous namespace
 
 mdn::Carryover mdn::Mdn2dRules::static_checkCarryover(Digit p, Digit x, Digit y, Digit base) {
     Log_Debug4_H("");
@@ -22,28 +96,7 @@ mdn::Carryover mdn::Mdn2dRules::static_checkCarryover(Digit p, Digit x, Digit y,
             << static_cast<int>(y) << ")"
         );
     );
-    Carryover result = Carryover::Invalid;
-    if (abs(p) > base) {
-        result = Carryover::Required;
-    } else {
-        auto pos = [](Digit t) { return t > 0; };
-        auto neg = [](Digit t) { return t < 0; };
-
-        if (pos(p)) {
-            if (neg(x) && neg(y)) {
-                result = Carryover::Required;
-            }
-            else if (neg(x) || neg(y)) {
-                result = Carryover::OptionalPositive;
-            }
-        } else if (neg(p)) {
-            if (pos(x) && pos(y)) {
-                result = Carryover::Required;
-            } else if (pos(x) || pos(y)) {
-                result = Carryover::OptionalNegative;
-            }
-        }
-    }
+    Carryover result = classifyCarryover(p, x, y, base);
 
     If_Log_Showing_Debug4(
         Log_Debug4_T("result = " << CarryoverToName(result));
@@ -52,6 +105,101 @@ mdn::Carryover mdn::Mdn2dRules::static_checkCarryover(Digit p, Digit x, Digit y,
 }
 
 
+void mdn::Mdn2dRules::static_checkCarryoverRow(
+    const Digit* p, const Digit* x, const Digit* y, int n, Digit base, CarryoverMasks& masks
+) {
+    masks.reset(n);
+    int i = 0;
+
+    // Lane-wise, with all comparisons signed:
+    //  big      = p > base | p < -base
+    //  required = big | (p > 0 & x < 0 & y < 0) | (p < 0 & x > 0 & y > 0)
+    //  optPos   = ~big & p > 0 & (x < 0 ^ y < 0)
+    //  optNeg   = ~big & p < 0 & (x > 0 ^ y > 0)
+    #if defined(MDN_CARRYOVER_AVX2)
+        constexpr int lanes = 32;
+        const __m256i vZero = _mm256_setzero_si256();
+        const __m256i vBase = _mm256_set1_epi8(base);
+        const __m256i vNegBase = _mm256_set1_epi8(static_cast<char>(-base));
+        for (; i + lanes <= n; i += lanes) {
+            const __m256i vp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            const __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+            const __m256i big = _mm256_or_si256(
+                _mm256_cmpgt_epi8(vp, vBase), _mm256_cmpgt_epi8(vNegBase, vp)
+            );
+            const __m256i pPos = _mm256_cmpgt_epi8(vp, vZero);
+            const __m256i pNeg = _mm256_cmpgt_epi8(vZero, vp);
+            const __m256i xPos = _mm256_cmpgt_epi8(vx, vZero);
+            const __m256i xNeg = _mm256_cmpgt_epi8(vZero, vx);
+            const __m256i yPos = _mm256_cmpgt_epi8(vy, vZero);
+            const __m256i yNeg = _mm256_cmpgt_epi8(vZero, vy);
+            const __m256i req = _mm256_or_si256(
+                big,
+                _mm256_or_si256(
+                    _mm256_and_si256(pPos, _mm256_and_si256(xNeg, yNeg)),
+                    _mm256_and_si256(pNeg, _mm256_and_si256(xPos, yPos))
+                )
+            );
+            const __m256i optPos = _mm256_andnot_si256(
+                big, _mm256_and_si256(pPos, _mm256_xor_si256(xNeg, yNeg))
+            );
+            const __m256i optNeg = _mm256_andnot_si256(
+                big, _mm256_and_si256(pNeg, _mm256_xor_si256(xPos, yPos))
+            );
+            const int w = i / CarryoverMasks::wordBits;
+            const int shift = i % CarryoverMasks::wordBits;
+            masks.required[w] |=
+                uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(req))) << shift;
+            masks.optionalPositive[w] |=
+                uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(optPos))) << shift;
+            masks.optionalNegative[w] |=
+                uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(optNeg))) << shift;
+        }
+    #elif defined(MDN_CARRYOVER_SSE2)
+        constexpr int lanes = 16;
+        const __m128i vZero = _mm_setzero_si128();
+        const __m128i vBase = _mm_set1_epi8(base);
+        const __m128i vNegBase = _mm_set1_epi8(static_cast<char>(-base));
+        for (; i + lanes <= n; i += lanes) {
+            const __m128i vp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+            const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+            const __m128i big = _mm_or_si128(
+                _mm_cmpgt_epi8(vp, vBase), _mm_cmplt_epi8(vp, vNegBase)
+            );
+            const __m128i pPos = _mm_cmpgt_epi8(vp, vZero);
+            const __m128i pNeg = _mm_cmplt_epi8(vp, vZero);
+            const __m128i xPos = _mm_cmpgt_epi8(vx, vZero);
+            const __m128i xNeg = _mm_cmplt_epi8(vx, vZero);
+            const __m128i yPos = _mm_cmpgt_epi8(vy, vZero);
+            const __m128i yNeg = _mm_cmplt_epi8(vy, vZero);
+            const __m128i req = _mm_or_si128(
+                big,
+                _mm_or_si128(
+                    _mm_and_si128(pPos, _mm_and_si128(xNeg, yNeg)),
+                    _mm_and_si128(pNeg, _mm_and_si128(xPos, yPos))
+                )
+            );
+            const __m128i optPos = _mm_andnot_si128(
+                big, _mm_and_si128(pPos, _mm_xor_si128(xNeg, yNeg))
+            );
+            const __m128i optNeg = _mm_andnot_si128(
+                big, _mm_and_si128(pNeg, _mm_xor_si128(xPos, yPos))
+            );
+            const int w = i / CarryoverMasks::wordBits;
+            const int shift = i % CarryoverMasks::wordBits;
+            masks.required[w] |= uint64_t(_mm_movemask_epi8(req)) << shift;
+            masks.optionalPositive[w] |= uint64_t(_mm_movemask_epi8(optPos)) << shift;
+            masks.optionalNegative[w] |= uint64_t(_mm_movemask_epi8(optNeg)) << shift;
+        }
+    #endif
+
+    // Remainder, or everything when there is no SIMD support
+    checkCarryoverRowScalar(p, x, y, i, n, base, masks);
+}
+
+
 mdn::Mdn2dRules::Mdn2dRules(std::string nameIn) :
     Mdn2dBase(nameIn)
 {
@@ -66,6 +214,15 @@ mdn::Mdn2dRules::Mdn2dRules(Mdn2dConfig config, std::string nameIn) :
 }
 
 
+mdn::Mdn2dRules::Mdn2dRules(
+    Mdn2dConfig config, std::string nameIn, std::pmr::memory_resource* resource
+) :
+    Mdn2dBase(config, nameIn, resource)
+{
+    Log_Debug3("Config=" << config);
+}
+
+
 mdn::Mdn2dRules::Mdn2dRules(const Mdn2dRules& other, std::string nameIn):
     Mdn2dBase(other, nameIn)
 {
@@ -183,7 +340,10 @@ mdn::CoordSet mdn::Mdn2dRules::locked_carryover(const Coord& xy, int carry) {
         << static_cast<int>(x) << ","
         << static_cast<int>(y) << ",base)"
     );
-    Carryover co = static_checkCarryover(p, x, y, m_config.baseDigit());
+    // A cascade brings a carry for p, and only cascades when p + carry is beyond the base
+    Carryover co = carry == 0
+        ? static_checkCarryover(p, x, y, m_config.baseDigit())
+        : Carryover::Required;
     Log_N_Debug4_T("static_checkCarryover return=" << CarryoverToName(co));
     if (co == Carryover::Invalid) {
         std::ostringstream oss;
@@ -195,7 +355,7 @@ mdn::CoordSet mdn::Mdn2dRules::locked_carryover(const Coord& xy, int carry) {
         // throw err;
         return CoordSet({});
     }
-    int ip = static_cast<int>(p);
+    int ip = static_cast<int>(p) + carry;
     int ix = static_cast<int>(x);
     int iy = static_cast<int>(y);
     int nCarry;
@@ -207,7 +367,7 @@ mdn::CoordSet mdn::Mdn2dRules::locked_carryover(const Coord& xy, int carry) {
             nCarry = 1;
         }
     } else {
-        nCarry = (ip + carry)/m_config.base();
+        nCarry = ip/m_config.base();
     }
     #ifdef MDN_DEBUG
         if (nCarry > 1 || nCarry < -1) {
@@ -286,12 +446,33 @@ mdn::CoordSet mdn::Mdn2dRules::carryoverCleanup(const CoordSet& coords, SignConv
 
 
 mdn::CoordSet mdn::Mdn2dRules::locked_carryoverCleanup(const CoordSet& coords, SignConvention sc) {
-    CoordSet affectedCoords;
+    CleanupReport report;
+    locked_carryoverCleanup(coords, sc, report);
+    return std::move(report.changed);
+}
+
+
+mdn::CleanupReport mdn::Mdn2dRules::carryoverCleanupWithReport(
+    const CoordSet& coords, SignConvention sc
+) {
+    Log_N_Debug2_H("Carryover clean up on " << coords.size() << " coords");
+    auto lock = lockWriteable();
+    CleanupReport report;
+    locked_carryoverCleanup(coords, sc, report);
+    internal_operationComplete();
+    Log_N_Debug2_T("result=" << report);
+    return report;
+}
+
+
+void mdn::Mdn2dRules::locked_carryoverCleanup(
+    const CoordSet& coords, SignConvention sc, CleanupReport& report
+) {
+    report = CleanupReport();
     if (coords.empty()) {
         Log_N_Debug3("Carryover cleanup, no coords to check");
-        return affectedCoords;
+        return;
     }
-    CoordSet buffer;
 
     Log_N_Debug3_H("Input set of " << coords.size() << " elements for carryoverCleanup");
     If_Log_Showing_Debug4(
@@ -309,43 +490,62 @@ mdn::CoordSet mdn::Mdn2dRules::locked_carryoverCleanup(const CoordSet& coords, S
     }
     Log_N_Debug4("wrongSign=" << CarryoverToName(wrongSign));
 
+    const int maxWaves = m_config.maxCleanupWaves();
     CoordSet workingSet(coords);
-    bool achievedGreatness = false;
-    for (int i = 0; i < maxCarryoverIters; ++i) {
-        for (const Coord& xy: workingSet) {
-            Carryover co = locked_checkCarryover(xy);
-            If_Log_Showing_Debug4(
-                Log_N_Debug4("Coord " << xy << ", got " << CarryoverToName(co));
-            );
-            if (co == Carryover::Required || co == wrongSign) {
-                Log_N_Debug4_H("locked_carryover dispatch");
-                buffer.merge(locked_carryover(xy));
-                Log_N_Debug4_T("locked_carryover return");
+    CoordSet written;
+    std::vector<Coord> wave;
+    std::array<int, 4> classStart;
+    CleanupWaves seenWaves;
+    CleanupWaves::State waveState;
+    while (!workingSet.empty()) {
+        if (maxWaves >= 0 && report.waves >= maxWaves) {
+            report.status = CleanupStatus::IterationLimit;
+            break;
+        }
+        internal_orderCleanupWave(workingSet, wave, classStart);
+        report.peakWorkingSet = std::max(report.peakWorkingSet, static_cast<int>(wave.size()));
+        internal_cleanupWaveState(wave, waveState);
+        if (seenWaves.repeats(std::move(waveState))) {
+            report.status = CleanupStatus::Oscillating;
+            break;
+        }
+        ++report.waves;
+        for (int c = 0; c < 3; ++c) {
+            if (classStart[c + 1] - classStart[c] >= parallelCleanupMinCoords) {
+                report.carries += internal_cleanupClassParallel(
+                    wave, classStart[c], classStart[c + 1], wrongSign, written, ThreadPool::shared()
+                );
+            } else {
+                report.carries += internal_cleanupClass(
+                    wave, classStart[c], classStart[c + 1], wrongSign, written
+                );
             }
         }
-        Log_N_Debug4("carryover loop done, buffer.size()=" << buffer.size());
-        workingSet = buffer;
-        affectedCoords.merge(buffer);
-        buffer.clear();
-        if (!workingSet.size()) {
-            Log_N_Debug4("achievedGreatness");
-            achievedGreatness = true;
-        } else {
-            Log_N_Debug4("Not yet achievedGreatness, but we hold out hope");
+        Log_N_Debug4("Wave " << report.waves << " done, " << written.size() << " digits written");
+
+        // Next wave checks each written digit, and the digits whose carryover check reads it
+        workingSet.clear();
+        for (const Coord& xy : written) {
+            workingSet.insert(xy);
+            workingSet.insert(xy.translatedX(-1));
+            workingSet.insert(xy.translatedY(-1));
         }
+        report.changed.merge(written);
+        written.clear();
     }
-    if (!achievedGreatness) {
+    if (!report.converged()) {
         Log_N_Warn(
             "Failed to finish all required carryovers and carryover sign " << "conventions.\n"
-            << "\tMax iterations: " << maxCarryoverIters << '\n'
+            << "\tStatus: " << report.status << '\n'
+            << "\tMax waves: " << maxWaves << '\n'
+            << "\tWaves run: " << report.waves << '\n'
             << "\tDigits remaining to check: " << workingSet.size() << '\n'
-            << "\tTotal digits affected: " << affectedCoords.size() << '\n'
+            << "\tTotal digits affected: " << report.changed.size() << '\n'
         );
-        Log_N_Debug3_T("Carryover cleanup on " << coords.size() << " coords failed.");
+        Log_N_Debug3_T("Carryover cleanup on " << coords.size() << " coords failed: " << report);
     } else {
-        Log_N_Debug3_T("Carryover cleanup on " << coords.size() << " coords complete.");
+        Log_N_Debug3_T("Carryover cleanup on " << coords.size() << " coords complete: " << report);
     }
-    return affectedCoords;
 }
 
 
@@ -361,13 +561,47 @@ mdn::CoordSet mdn::Mdn2dRules::carryoverCleanupAll(SignConvention sc) {
 
 mdn::CoordSet mdn::Mdn2dRules::locked_carryoverCleanupAll(SignConvention sc) {
     Log_N_Debug4_H("");
-    CoordSet changed = locked_carryoverCleanup(m_index, sc);
+    CleanupReport report;
+    locked_carryoverCleanupAll(sc, report);
     If_Log_Showing_Debug4(
-        std::string coordsList(Tools::setToString<Coord>(changed, ','));
+        std::string coordsList(Tools::setToString<Coord>(report.changed, ','));
         Log_N_Debug4("changed=" << coordsList);
     );
     Log_N_Debug4_T("");
-    return changed;
+    return std::move(report.changed);
+}
+
+
+mdn::CleanupReport mdn::Mdn2dRules::carryoverCleanupAllWithReport(SignConvention sc) {
+    Log_N_Debug2_H("");
+    auto lock = lockWriteable();
+    CleanupReport report;
+    locked_carryoverCleanupAll(sc, report);
+    internal_operationComplete();
+    Log_N_Debug2_T("result=" << report);
+    return report;
+}
+
+
+void mdn::Mdn2dRules::locked_carryoverCleanupAll(SignConvention sc, CleanupReport& report) {
+    Log_N_Debug4_H("");
+    if (sc == SignConvention::Invalid) {
+        sc = m_config.signConvention();
+    }
+    // Only digits that need a carryover now can start a cleanup - prefilter them in one pass.
+    //  Digits that need one later are always beside an earlier carryover, and get queued then.
+    CoordSet seeds;
+    CoordSet optionalPositive;
+    CoordSet optionalNegative;
+    internal_classifyRows(seeds, optionalPositive, optionalNegative);
+    if (sc == SignConvention::Positive) {
+        seeds.merge(optionalNegative);
+    } else if (sc == SignConvention::Negative) {
+        seeds.merge(optionalPositive);
+    }
+    Log_N_Debug4("Prefilter found " << seeds.size() << " of " << m_data->index.size() << " digits");
+    locked_carryoverCleanup(seeds, sc, report);
+    Log_N_Debug4_T("result=" << report);
 }
 
 
@@ -441,14 +675,17 @@ void mdn::Mdn2dRules::locked_shiftRight(int nDigits) {
             throw std::invalid_argument("cannot shift negative digits, use opposite direction");
         }
     #endif
-    for (auto it = m_xIndex.rbegin(); it != m_xIndex.rend(); ++it) {
-        const CoordSet& coords = it->second;
+    internal_journalDigits(true);
+    internal_detach();
+    for (auto it = m_data->xIndex.rbegin(); it != m_data->xIndex.rend(); ++it) {
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
-            Digit d = m_raw[coord];
-            m_raw.erase(coord);
-            m_raw[coord.translatedX(nDigits)] = d;
+            Digit d = m_data->raw[coord];
+            m_data->raw.erase(coord);
+            m_data->raw[coord.translatedX(nDigits)] = d;
         }
     }
+    internal_journalDigits(false);
     internal_modified();
     locked_rebuildMetadata();
     Log_N_Debug3_T("");
@@ -471,14 +708,17 @@ void mdn::Mdn2dRules::locked_shiftLeft(int nDigits) {
             throw std::invalid_argument("cannot shift negative digits, use opposite direction");
         }
     #endif
-    for (auto it = m_xIndex.begin(); it != m_xIndex.end(); ++it) {
-        const CoordSet& coords = it->second;
+    internal_journalDigits(true);
+    internal_detach();
+    for (auto it = m_data->xIndex.begin(); it != m_data->xIndex.end(); ++it) {
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
-            Digit d = m_raw[coord];
-            m_raw.erase(coord);
-            m_raw[coord.translatedX(-nDigits)] = d;
+            Digit d = m_data->raw[coord];
+            m_data->raw.erase(coord);
+            m_data->raw[coord.translatedX(-nDigits)] = d;
         }
     }
+    internal_journalDigits(false);
     internal_modified();
     locked_rebuildMetadata();
     Log_N_Debug3_T("");
@@ -501,14 +741,17 @@ void mdn::Mdn2dRules::locked_shiftUp(int nDigits) {
             throw std::invalid_argument("cannot shift negative digits, use opposite direction");
         }
     #endif
-    for (auto it = m_yIndex.rbegin(); it != m_yIndex.rend(); ++it) {
-        const CoordSet& coords = it->second;
+    internal_journalDigits(true);
+    internal_detach();
+    for (auto it = m_data->yIndex.rbegin(); it != m_data->yIndex.rend(); ++it) {
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
-            Digit d = m_raw[coord];
-            m_raw.erase(coord);
-            m_raw[coord.translatedY(nDigits)] = d;
+            Digit d = m_data->raw[coord];
+            m_data->raw.erase(coord);
+            m_data->raw[coord.translatedY(nDigits)] = d;
         }
     }
+    internal_journalDigits(false);
     internal_modified();
     locked_rebuildMetadata();
     Log_N_Debug3_T("");
@@ -531,14 +774,17 @@ void mdn::Mdn2dRules::locked_shiftDown(int nDigits) {
             throw std::invalid_argument("cannot shift negative digits, use opposite direction");
         }
     #endif
-    for (auto it = m_yIndex.begin(); it != m_yIndex.end(); ++it) {
-        const CoordSet& coords = it->second;
+    internal_journalDigits(true);
+    internal_detach();
+    for (auto it = m_data->yIndex.begin(); it != m_data->yIndex.end(); ++it) {
+        const CoordIndexSet& coords = it->second;
         for (const Coord& coord : coords) {
-            Digit d = m_raw[coord];
-            m_raw.erase(coord);
-            m_raw[coord.translatedY(-nDigits)] = d;
+            Digit d = m_data->raw[coord];
+            m_data->raw.erase(coord);
+            m_data->raw[coord.translatedY(-nDigits)] = d;
         }
     }
+    internal_journalDigits(false);
     internal_modified();
     locked_rebuildMetadata();
     Log_N_Debug3_T("");
@@ -558,11 +804,11 @@ void mdn::Mdn2dRules::locked_transpose() {
     Log_N_Debug3_H("");
     Mdn2d temp(NewInstance(m_config));
     auto tempLock = temp.lockWriteable();
-    for (const auto& [xy, digit] : m_raw) {
+    for (const auto& [xy, digit] : m_data->raw) {
         temp.locked_setValue(Coord(xy.y(), xy.x()), digit);
     }
     locked_operatorEquals(temp);
-    if (m_raw.size()) {
+    if (m_data->raw.size()) {
         internal_modified();
     }
     Log_N_Debug3_T("");
@@ -594,23 +840,33 @@ const mdn::CoordSet& mdn::Mdn2dRules::locked_getPolymorphicNodes() const {
 }
 
 
+mdn::Overview mdn::Mdn2dRules::getOverview(
+    const Rect& window, int level, bool withPolymorphism
+) const {
+    Log_N_Debug2_H("window=" << window << ", level=" << level);
+    auto lock = lockReadOnly();
+    Overview result = locked_getOverview(window, level, withPolymorphism);
+    Log_N_Debug2_T("Returning " << result.cols() << "x" << result.rows() << " tiles");
+    return result;
+}
+
+
+mdn::Overview mdn::Mdn2dRules::locked_getOverview(
+    const Rect& window, int level, bool withPolymorphism
+) const {
+    Log_N_Debug3("window=" << window << ", level=" << level);
+    return internal_overview(
+        window, level, withPolymorphism ? &locked_getPolymorphicNodes() : nullptr
+    );
+}
+
+
 void mdn::Mdn2dRules::internal_polymorphicScan() const {
     Log_N_Debug3_H("");
-    int nRequired = 0;
     m_polymorphicNodes.clear();
-    for (const auto& [xy, digit] : m_raw) {
-        switch(locked_checkCarryover(xy)) {
-            case Carryover::Required:
-                ++nRequired;
-                break;
-            case Carryover::OptionalPositive:
-            case Carryover::OptionalNegative:
-                m_polymorphicNodes.insert(xy);
-                break;
-            default:
-                break;
-        }
-    }
+    CoordSet required;
+    internal_classifyRows(required, m_polymorphicNodes, m_polymorphicNodes);
+    int nRequired = required.size();
     if (nRequired) {
         Log_N_Warn(
             "Internal error: found " << nRequired << " required carryovers during scan.\n"
@@ -622,6 +878,256 @@ void mdn::Mdn2dRules::internal_polymorphicScan() const {
 }
 
 
+void mdn::Mdn2dRules::internal_orderCleanupWave(
+    const CoordSet& coords, std::vector<Coord>& wave, std::array<int, 4>& classStart
+) const {
+    wave.assign(coords.begin(), coords.end());
+    std::sort(
+        wave.begin(),
+        wave.end(),
+        [](const Coord& a, const Coord& b) {
+            const int ca = cleanupColour(a);
+            const int cb = cleanupColour(b);
+            if (ca != cb) {
+                return ca < cb;
+            }
+            if (a.y() != b.y()) {
+                return a.y() < b.y();
+            }
+            return a.x() < b.x();
+        }
+    );
+    int i = 0;
+    const int n = static_cast<int>(wave.size());
+    for (int c = 0; c < 3; ++c) {
+        classStart[c] = i;
+        while (i < n && cleanupColour(wave[i]) == c) {
+            ++i;
+        }
+    }
+    classStart[3] = n;
+}
+
+
+void mdn::Mdn2dRules::internal_cleanupWaveState(
+    const std::vector<Coord>& wave, CleanupWaves::State& state
+) const {
+    auto digitAt = [this](const Coord& xy) -> Digit {
+        auto it = m_data->raw.find(xy);
+        return it == m_data->raw.end() ? Digit(0) : it->second;
+    };
+    state.coords = wave;
+    state.digits.clear();
+    state.digits.reserve(3*wave.size());
+    for (const Coord& xy : wave) {
+        state.digits.push_back(digitAt(xy));
+        state.digits.push_back(digitAt(xy.translatedX(1)));
+        state.digits.push_back(digitAt(xy.translatedY(1)));
+    }
+}
+
+
+int mdn::Mdn2dRules::internal_cleanupClass(
+    const std::vector<Coord>& wave,
+    int begin,
+    int end,
+    Carryover wrongSign,
+    CoordSet& buffer
+) {
+    int nCarries = 0;
+    for (int i = begin; i < end; ++i) {
+        const Coord& xy = wave[i];
+        Carryover co = locked_checkCarryover(xy);
+        If_Log_Showing_Debug4(
+            Log_N_Debug4("Coord " << xy << ", got " << CarryoverToName(co));
+        );
+        if (co == Carryover::Required || co == wrongSign) {
+            Log_N_Debug4_H("locked_carryover dispatch");
+            buffer.merge(locked_carryover(xy));
+            ++nCarries;
+            Log_N_Debug4_T("locked_carryover return");
+        }
+    }
+    return nCarries;
+}
+
+
+int mdn::Mdn2dRules::internal_cleanupClassParallel(
+    const std::vector<Coord>& wave,
+    int begin,
+    int end,
+    Carryover wrongSign,
+    CoordSet& buffer,
+    ThreadPool& pool
+) {
+    Log_N_Debug3_H("Parallel cleanup of " << (end - begin) << " coords");
+    const Digit baseDigit = m_config.baseDigit();
+    const int base = m_config.base();
+
+    // What to do at each coord:
+    //  None   - no carryover needed
+    //  Simple - one carryover that stays inside its footprint, digits are in the Proposal
+    //  Full   - needs locked_carryover, i.e. it cascades, or the Proposal may be out of date
+    enum class Action : int8_t { None, Simple, Full };
+    struct Proposal {
+        Digit p;
+        Digit x;
+        Digit y;
+        Action action;
+    };
+    std::vector<Proposal> proposals(end - begin);
+
+    // Read-only pass - footprints within a colour class are disjoint, so each coord can be checked
+    //  against the digits as they are now
+    pool.parallelFor(
+        begin,
+        end,
+        [&](int i0, int i1) {
+            auto digitAt = [this](const Coord& xy) -> Digit {
+                auto it = m_data->raw.find(xy);
+                return it == m_data->raw.end() ? Digit(0) : it->second;
+            };
+            for (int i = i0; i < i1; ++i) {
+                const Coord& xy = wave[i];
+                Proposal& prop = proposals[i - begin];
+                prop.p = digitAt(xy);
+                prop.x = digitAt(xy.translatedX(1));
+                prop.y = digitAt(xy.translatedY(1));
+                const Carryover co = classifyCarryover(prop.p, prop.x, prop.y, baseDigit);
+                if (co != Carryover::Required && co != wrongSign) {
+                    prop.action = Action::None;
+                    continue;
+                }
+                const int nCarry = prop.p < 0 ? -1 : 1;
+                const int ix = prop.x + nCarry;
+                const int iy = prop.y + nCarry;
+                const bool cascades = ix >= base || ix <= -base || iy >= base || iy <= -base;
+                prop.action = cascades ? Action::Full : Action::Simple;
+            }
+        },
+        256
+    );
+
+    // Apply in wave order.  Cascades write outside their footprint, so later proposals that
+    //  touch a cascade's digits are re-checked.  A change in bounds can purge digits anywhere, so
+    //  after that everything is re-checked.
+    CoordSet dirty;
+    const Coord boundsMin(m_bounds.min());
+    const Coord boundsMax(m_bounds.max());
+    bool stale = false;
+    int nFull = 0;
+    int nCarries = 0;
+    for (int i = begin; i < end; ++i) {
+        const Coord& xy = wave[i];
+        const Coord xy_x = xy.translatedX(1);
+        const Coord xy_y = xy.translatedY(1);
+        const Proposal& prop = proposals[i - begin];
+        Action action = prop.action;
+        if (
+            stale
+         || (!dirty.empty() && (dirty.count(xy) || dirty.count(xy_x) || dirty.count(xy_y)))
+        ) {
+            const Carryover co = locked_checkCarryover(xy);
+            action = (co == Carryover::Required || co == wrongSign) ? Action::Full : Action::None;
+        }
+        if (action == Action::None) {
+            continue;
+        }
+        ++nCarries;
+        if (action == Action::Full) {
+            ++nFull;
+            CoordSet affected = locked_carryover(xy);
+            dirty.insert(affected.begin(), affected.end());
+            buffer.merge(affected);
+        } else {
+            // Same writes, in the same order, as locked_carryover
+            const int nCarry = prop.p < 0 ? -1 : 1;
+            locked_setValue(xy, static_cast<int>(prop.p) - nCarry*base);
+            locked_setValue(xy_y, static_cast<int>(prop.y) + nCarry);
+            locked_setValue(xy_x, static_cast<int>(prop.x) + nCarry);
+            buffer.insert(xy);
+            buffer.insert(xy_x);
+            buffer.insert(xy_y);
+        }
+        if (!stale && (!(m_bounds.min() == boundsMin) || !(m_bounds.max() == boundsMax))) {
+            Log_N_Debug4("Bounds changed, checking remaining coords serially");
+            stale = true;
+        }
+    }
+    Log_N_Debug3_T("Done, " << nCarries << " carryovers, " << nFull << " applied serially");
+    return nCarries;
+}
+
+
+void mdn::Mdn2dRules::internal_classifyRows(
+    CoordSet& required, CoordSet& optionalPositive, CoordSet& optionalNegative
+) const {
+    Log_N_Debug3_H("");
+    const Digit base = m_config.baseDigit();
+    VecDigit row;
+    VecDigit rowAbove;
+    CarryoverMasks masks;
+    int nDense = 0;
+    for (const auto& [y, coords] : m_data->yIndex) {
+        if (coords.empty()) {
+            continue;
+        }
+        int xMin = coords.begin()->x();
+        int xMax = xMin;
+        for (const Coord& xy : coords) {
+            xMin = std::min(xMin, xy.x());
+            xMax = std::max(xMax, xy.x());
+        }
+        const int width = xMax - xMin + 1;
+        if (width > denseRowSpanFactor*static_cast<int>(coords.size())) {
+            // Sparse row, not worth assembling
+            for (const Coord& xy : coords) {
+                switch (
+                    classifyCarryover(
+                        m_data->raw.at(xy),
+                        locked_getValue(xy.translatedX(1)),
+                        locked_getValue(xy.translatedY(1)),
+                        base
+                    )
+                ) {
+                    case Carryover::Required:
+                        required.insert(xy);
+                        break;
+                    case Carryover::OptionalPositive:
+                        optionalPositive.insert(xy);
+                        break;
+                    case Carryover::OptionalNegative:
+                        optionalNegative.insert(xy);
+                        break;
+                    default:
+                        break;
+                }
+            }
+            continue;
+        }
+        ++nDense;
+        // Pivots are row[0 .. width-1], x axials are row[1 .. width], y axials are rowAbove
+        locked_getRow(Coord(xMin, y), width + 1, row);
+        locked_getRow(Coord(xMin, y + 1), width, rowAbove);
+        static_checkCarryoverRow(row.data(), row.data() + 1, rowAbove.data(), width, base, masks);
+        CarryoverMasks::forEachSet(
+            masks.required, [&](int i) { required.insert(Coord(xMin + i, y)); }
+        );
+        CarryoverMasks::forEachSet(
+            masks.optionalPositive, [&](int i) { optionalPositive.insert(Coord(xMin + i, y)); }
+        );
+        CarryoverMasks::forEachSet(
+            masks.optionalNegative, [&](int i) { optionalNegative.insert(Coord(xMin + i, y)); }
+        );
+    }
+    Log_N_Debug3_T(
+        "Classified " << m_data->yIndex.size() << " rows, " << nDense << " dense, found "
+        << required.size() << " required, " << optionalPositive.size() << " optionalPositive, "
+        << optionalNegative.size() << " optionalNegative"
+    );
+}
+
+
 void mdn::Mdn2dRules::internal_oneCarryover(const Coord& xy) {
     Log_N_Debug4_H("At " << xy);
     Coord xy_x = xy.translatedX(1);
@@ -0,0 +1,131 @@
+#include <mdn/PackedDigits.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+mdn::DigitPacking mdn::PackedDigits::forBase(int base) {
+    if (base <= 2) {
+        return DigitPacking::BitPlanes;
+    }
+    if (base <= 8) {
+        return DigitPacking::Nibble;
+    }
+    return DigitPacking::Byte;
+}
+
+
+bool mdn::PackedDigits::isValid(uint8_t code) {
+    return code <= static_cast<uint8_t>(DigitPacking::BitPlanes);
+}
+
+
+std::size_t mdn::PackedDigits::bytes(DigitPacking packing, int n) {
+    if (n <= 0) {
+        return 0;
+    }
+    switch (packing) {
+        case DigitPacking::Nibble:
+            return (static_cast<std::size_t>(n) + 1) >> 1;
+        case DigitPacking::BitPlanes:
+            return 2*planeBytes(n);
+        default:
+            return static_cast<std::size_t>(n);
+    }
+}
+
+
+void mdn::PackedDigits::pack(DigitPacking packing, const Digit* digits, int n, uint8_t* out) {
+    switch (packing) {
+        case DigitPacking::Byte: {
+            if (n > 0) {
+                std::memcpy(out, digits, static_cast<std::size_t>(n));
+            }
+            break;
+        }
+        case DigitPacking::Nibble: {
+            const int nPairs = n >> 1;
+            for (int p = 0; p < nPairs; ++p) {
+                const uint8_t lo = static_cast<uint8_t>(digits[2*p] & 0x0F);
+                const uint8_t hi = static_cast<uint8_t>(digits[2*p + 1] & 0x0F);
+                out[p] = static_cast<uint8_t>(lo | (hi << 4));
+            }
+            if (n & 1) {
+                out[nPairs] = static_cast<uint8_t>(digits[n - 1] & 0x0F);
+            }
+            break;
+        }
+        case DigitPacking::BitPlanes: {
+            const std::size_t nBytes = planeBytes(n);
+            uint8_t* nonZero = out;
+            uint8_t* negative = out + nBytes;
+            for (std::size_t b = 0; b < nBytes; ++b) {
+                const int i0 = static_cast<int>(b << 3);
+                const int i1 = std::min(n, i0 + 8);
+                uint8_t nz = 0;
+                uint8_t neg = 0;
+                for (int i = i0; i < i1; ++i) {
+                    const int k = i - i0;
+                    nz |= static_cast<uint8_t>((digits[i] != 0) << k);
+                    neg |= static_cast<uint8_t>((digits[i] < 0) << k);
+                }
+                nonZero[b] = nz;
+                negative[b] = neg;
+            }
+            break;
+        }
+    }
+}
+
+
+void mdn::PackedDigits::unpack(DigitPacking packing, const uint8_t* in, int n, Digit* digits) {
+    switch (packing) {
+        case DigitPacking::Byte: {
+            if (n > 0) {
+                std::memcpy(digits, in, static_cast<std::size_t>(n));
+            }
+            break;
+        }
+        case DigitPacking::Nibble: {
+            // Shifting the nibble to the top of an int8_t and back sign-extends it
+            const int nPairs = n >> 1;
+            for (int p = 0; p < nPairs; ++p) {
+                const uint8_t b = in[p];
+                digits[2*p] = static_cast<Digit>(static_cast<int8_t>(b << 4) >> 4);
+                digits[2*p + 1] = static_cast<Digit>(static_cast<int8_t>(b) >> 4);
+            }
+            if (n & 1) {
+                digits[n - 1] = static_cast<Digit>(static_cast<int8_t>(in[nPairs] << 4) >> 4);
+            }
+            break;
+        }
+        case DigitPacking::BitPlanes: {
+            // digit = nz - 2*(nz & neg), a negative bit without its non-zero bit reads as zero
+            const std::size_t nBytes = planeBytes(n);
+            const uint8_t* nonZero = in;
+            const uint8_t* negative = in + nBytes;
+            for (int i = 0; i < n; ++i) {
+                const int k = i & 7;
+                const int nz = (nonZero[i >> 3] >> k) & 1;
+                const int neg = (negative[i >> 3] >> k) & 1;
+                digits[i] = static_cast<Digit>(nz - 2*(nz & neg));
+            }
+            break;
+        }
+    }
+}
+
+
+void mdn::PackedDigits::pack(DigitPacking packing, const VecDigit& digits, PackedRow& out) {
+    const int n = static_cast<int>(digits.size());
+    out.packing = packing;
+    out.width = n;
+    out.data.resize(bytes(packing, n));
+    pack(packing, digits.data(), n, out.data.data());
+}
+
+
+void mdn::PackedDigits::unpack(const PackedRow& row, VecDigit& digits) {
+    digits.resize(static_cast<std::size_t>(std::max(row.width, 0)));
+    unpack(row.packing, row.data.data(), row.width, digits.data());
+}
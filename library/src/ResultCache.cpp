@@ -0,0 +1,249 @@
+#include <mdn/ResultCache.hpp>
+
+#include <mdn/Logger.hpp>
+
+
+mdn::ResultCache& mdn::ResultCache::shared() {
+    static ResultCache cache;
+    return cache;
+}
+
+
+std::size_t mdn::ResultCache::static_bytes(const Mdn2d& mdn) {
+    // A node in raw and in index, and one in a row and a column set, each with its bucket slot
+    constexpr std::size_t perDigit = 4*(sizeof(Coord) + 3*sizeof(void*)) + sizeof(Digit);
+    return sizeof(Mdn2d) + perDigit*mdn.m_data->raw.size();
+}
+
+
+mdn::Fingerprint mdn::ResultCache::static_keyFingerprint(const Mdn2d& mdn) {
+    const SignConvention sc = mdn.m_config.signConvention();
+    if (sc == SignConvention::Positive || sc == SignConvention::Negative) {
+        // Canonical form is the digits themselves, and the fingerprint is kept between misses
+        return mdn.locked_fingerprint();
+    }
+    Fingerprint result;
+    for (const auto& [xy, digit] : mdn.m_data->raw) {
+        result.add(xy, digit);
+    }
+    return result;
+}
+
+
+std::size_t mdn::ResultCache::KeyHash::operator()(const Key& key) const noexcept {
+    std::uint64_t h = Fingerprint::mix(
+        (static_cast<std::uint64_t>(key.op) << 40)
+        ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.nIters)) << 8)
+        ^ static_cast<std::uint64_t>(key.fraxis)
+    );
+    for (const Fingerprint& f : key.operands) {
+        h = Fingerprint::mix(h ^ std::hash<Fingerprint>()(f));
+    }
+    return static_cast<std::size_t>(h);
+}
+
+
+mdn::ResultCache::Entry::Entry(const Mdn2dConfig& config):
+    ansConfig(config),
+    remConfig(config),
+    ans(config, "cache_ans"),
+    remMag(0.0),
+    bytes(0)
+{}
+
+
+mdn::ResultCache::ResultCache(std::size_t budgetBytes):
+    m_budget(budgetBytes),
+    m_bytes(0),
+    m_hits(0),
+    m_misses(0)
+{}
+
+
+bool mdn::ResultCache::enabled() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_budget > 0;
+}
+
+
+std::size_t mdn::ResultCache::budget() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_budget;
+}
+
+
+void mdn::ResultCache::setBudget(std::size_t budgetBytes) {
+    Log_Debug2("budget=" << budgetBytes);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_budget = budgetBytes;
+    internal_evict();
+}
+
+
+std::size_t mdn::ResultCache::size() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_entries.size();
+}
+
+
+std::size_t mdn::ResultCache::bytes() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_bytes;
+}
+
+
+long long mdn::ResultCache::hits() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_hits;
+}
+
+
+long long mdn::ResultCache::misses() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_misses;
+}
+
+
+void mdn::ResultCache::resetCounters() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+
+void mdn::ResultCache::clear() {
+    Log_Debug2("");
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_lookup.clear();
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+
+bool mdn::ResultCache::fetch(
+    CachedOperation op,
+    const Mdn2d& lhs,
+    const Mdn2d& rhs,
+    Mdn2d& ans,
+    Mdn2d* rem,
+    long double* remMag,
+    int nIters,
+    Fraxis fraxis,
+    std::unique_ptr<Entry>& pending
+) {
+    pending.reset();
+    if (!enabled()) {
+        return false;
+    }
+    Log_Debug3_H("op=" << static_cast<int>(op) << ", nIters=" << nIters);
+    const bool iterate = op == CachedOperation::DivideIterate;
+    std::vector<const Mdn2d*> operands{&lhs, &rhs};
+    if (iterate) {
+        operands.push_back(&ans);
+        operands.push_back(rem);
+    }
+    Key key{op, {}, nIters, fraxis};
+    key.operands.reserve(operands.size());
+    for (const Mdn2d* operand : operands) {
+        key.operands.push_back(static_keyFingerprint(*operand));
+    }
+    // A division without a rem argument makes its own, with lhs's config
+    const Mdn2dConfig& remConfig = rem ? rem->m_config : lhs.m_config;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto found = m_lookup.find(key);
+    if (found != m_lookup.end()) {
+        Entry& entry = **found->second;
+        bool match =
+            entry.ansConfig == ans.m_config
+            && entry.remConfig == remConfig
+            && (!rem || entry.rem);
+        for (std::size_t i = 0; match && i < operands.size(); ++i) {
+            match = static_sameNumber(entry.operands[i], *operands[i]);
+        }
+        if (match) {
+            ans.locked_operatorEquals(entry.ans);
+            if (rem) {
+                rem->locked_operatorEquals(*entry.rem);
+            }
+            if (remMag) {
+                *remMag = entry.remMag;
+            }
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            ++m_hits;
+            Log_Debug3_T("hit");
+            return true;
+        }
+    }
+    ++m_misses;
+    pending.reset(new Entry(ans.m_config));
+    pending->key = std::move(key);
+    pending->remConfig = remConfig;
+    pending->operands.reserve(operands.size());
+    for (const Mdn2d* operand : operands) {
+        pending->operands.emplace_back(*operand, "cache_operand");
+    }
+    Log_Debug3_T("miss");
+    return false;
+}
+
+
+void mdn::ResultCache::store(
+    std::unique_ptr<Entry>& pending,
+    const Mdn2d& ans,
+    const Mdn2d* rem,
+    long double remMag
+) {
+    if (!pending) {
+        return;
+    }
+    Entry& entry = *pending;
+    entry.ans.locked_operatorEquals(ans);
+    if (rem) {
+        entry.rem.reset(new Mdn2d(*rem, "cache_rem"));
+    }
+    entry.remMag = remMag;
+    entry.bytes = sizeof(Entry) + static_bytes(entry.ans);
+    for (const Mdn2d& operand : entry.operands) {
+        entry.bytes += static_bytes(operand);
+    }
+    if (entry.rem) {
+        entry.bytes += static_bytes(*entry.rem);
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (entry.bytes > m_budget) {
+        Log_Debug3("Entry of " << entry.bytes << " bytes exceeds budget, not cached");
+        pending.reset();
+        return;
+    }
+    auto found = m_lookup.find(entry.key);
+    if (found != m_lookup.end()) {
+        // Same fingerprints, different numbers, or a racing thread got there first
+        m_bytes -= (*found->second)->bytes;
+        m_entries.erase(found->second);
+        m_lookup.erase(found);
+    }
+    m_bytes += entry.bytes;
+    m_entries.push_front(std::move(pending));
+    m_lookup.emplace(entry.key, m_entries.begin());
+    internal_evict();
+}
+
+
+void mdn::ResultCache::internal_evict() {
+    while (m_bytes > m_budget && !m_entries.empty()) {
+        Entry& oldest = *m_entries.back();
+        Log_Debug4("Evicting entry of " << oldest.bytes << " bytes");
+        m_bytes -= oldest.bytes;
+        m_lookup.erase(oldest.key);
+        m_entries.pop_back();
+    }
+}
+
+
+bool mdn::ResultCache::static_sameNumber(const Mdn2d& stored, const Mdn2d& live) {
+    return
+        stored.m_config == live.m_config
+        && (stored.m_data == live.m_data || stored.m_data->raw == live.m_data->raw);
+}
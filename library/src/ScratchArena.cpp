@@ -0,0 +1,16 @@
+#include <mdn/ScratchArena.hpp>
+
+#include <mdn/Logger.hpp>
+
+
+mdn::ScratchArena::ScratchArena(std::size_t initialBytes) :
+    m_buffer(initialBytes),
+    m_pool(&m_buffer)
+{}
+
+
+void mdn::ScratchArena::reset() {
+    Log_Debug4("");
+    m_pool.release();
+    m_buffer.release();
+}
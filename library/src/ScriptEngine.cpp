@@ -0,0 +1,850 @@
+#include <mdn/ScriptEngine.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include <mdn/Logger.hpp>
+#include <mdn/Mdn2dIO.hpp>
+#include <mdn/MdnException.hpp>
+#include <mdn/ThreadPool.hpp>
+
+
+namespace {
+
+// Splits a line into whitespace separated tokens
+std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::istringstream iss(text);
+    std::string token;
+    while (iss >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+
+// Prefix for error messages about a statement
+std::string where(const mdn::ScriptStatement& st) {
+    return "line " + std::to_string(st.line) + " [" + st.text + "]: ";
+}
+
+
+// Throws InvalidArgument unless the statement has minArgs to maxArgs arguments
+void requireArgs(const mdn::ScriptStatement& st, int minArgs, int maxArgs, const char* usage) {
+    const int n = static_cast<int>(st.args.size());
+    if (n < minArgs || n > maxArgs) {
+        mdn::InvalidArgument err(where(st) + "expecting: " + usage);
+        Log_Error(err.what());
+        throw err;
+    }
+}
+
+
+// Parses an integer argument, the whole token must be used
+long long toInteger(const mdn::ScriptStatement& st, const std::string& token) {
+    std::size_t used = 0;
+    long long result = 0;
+    try {
+        result = std::stoll(token, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != token.size()) {
+        mdn::InvalidArgument err(where(st) + "expecting an integer, got '" + token + "'");
+        Log_Error(err.what());
+        throw err;
+    }
+    return result;
+}
+
+
+// Parses an int argument, out of range values are rejected rather than wrapped
+int toInt(const mdn::ScriptStatement& st, const std::string& token) {
+    const long long result = toInteger(st, token);
+    if (
+        result < std::numeric_limits<int>::min() || result > std::numeric_limits<int>::max()
+    ) {
+        mdn::InvalidArgument err(
+            where(st) + "expecting an integer from "
+                + std::to_string(std::numeric_limits<int>::min()) + " to "
+                + std::to_string(std::numeric_limits<int>::max()) + ", got '" + token + "'"
+        );
+        Log_Error(err.what());
+        throw err;
+    }
+    return static_cast<int>(result);
+}
+
+
+// Parses an optional fraxis argument, x or y in either case, Default when absent
+mdn::Fraxis toFraxis(const mdn::ScriptStatement& st, std::size_t argIndex) {
+    if (argIndex >= st.args.size()) {
+        return mdn::Fraxis::Default;
+    }
+    const std::string& token = st.args[argIndex];
+    if (token == "x" || token == "X") {
+        return mdn::Fraxis::X;
+    }
+    if (token == "y" || token == "Y") {
+        return mdn::Fraxis::Y;
+    }
+    mdn::InvalidArgument err(where(st) + "expecting fraxis X or Y, got '" + token + "'");
+    Log_Error(err.what());
+    throw err;
+}
+
+
+// True when the optional fraxis argument asks for speculative division, 'best' in either case
+bool isBestFraxis(const mdn::ScriptStatement& st, std::size_t argIndex) {
+    if (argIndex >= st.args.size()) {
+        return false;
+    }
+    const std::string& token = st.args[argIndex];
+    return token == "best" || token == "Best";
+}
+
+
+// Splits a setConfig 'key=value' argument
+void splitSetting(
+    const mdn::ScriptStatement& st,
+    const std::string& token,
+    std::string& key,
+    std::string& value
+) {
+    const std::size_t eq = token.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 == token.size()) {
+        mdn::InvalidArgument err(where(st) + "expecting key=value, got '" + token + "'");
+        Log_Error(err.what());
+        throw err;
+    }
+    key = token.substr(0, eq);
+    value = token.substr(eq + 1);
+    static const std::vector<std::string> keys(
+        {
+            "base", "precision", "signConvention", "fraxisCascadeDepth", "fraxis",
+            "maxCleanupWaves"
+        }
+    );
+    if (std::find(keys.cbegin(), keys.cend(), key) == keys.cend()) {
+        mdn::InvalidArgument err(
+            where(st) + "unknown setting '" + key + "', expecting one of: base, precision, "
+                + "signConvention, fraxisCascadeDepth, fraxis, maxCleanupWaves"
+        );
+        Log_Error(err.what());
+        throw err;
+    }
+}
+
+
+// Lowercase file extension of path, without the dot
+std::string extension(const std::string& path) {
+    const std::size_t dot = path.find_last_of('.');
+    const std::size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return "";
+    }
+    std::string ext = path.substr(dot + 1);
+    std::transform(
+        ext.begin(), ext.end(), ext.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); }
+    );
+    return ext;
+}
+
+
+// Files are scheduled like numbers, so a load waits for an earlier save of the same path
+std::string fileResource(const std::string& path) {
+    return "@file:" + path;
+}
+
+
+template<typename T>
+void binaryRead(std::istream& in, T& v) {
+    in.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+
+
+// Bytes from the read position to the end of in, 0 if in has failed
+std::uint64_t bytesLeft(std::istream& in) {
+    if (!in) {
+        return 0;
+    }
+    const std::istream::pos_type here = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(here);
+    return end > here ? static_cast<std::uint64_t>(end - here) : 0;
+}
+
+
+// A length beyond the end of the file fails in instead of allocating it
+std::string binaryReadString(std::istream& in) {
+    std::uint32_t n = 0;
+    binaryRead(in, n);
+    std::string s;
+    if (n > bytesLeft(in)) {
+        in.setstate(std::ios::failbit);
+        return s;
+    }
+    s.resize(n);
+    in.read(s.data(), n);
+    return s;
+}
+
+} // end anonymous namespace
+
+
+// ~~~ MemoryWorkspace
+
+mdn::MemoryWorkspace::MemoryWorkspace(Mdn2dConfig config) :
+    m_config(config)
+{}
+
+
+mdn::Mdn2dConfig mdn::MemoryWorkspace::config() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+
+void mdn::MemoryWorkspace::setConfig(const Mdn2dConfig& config) {
+    Log_Debug3_H("config=" << config);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    std::vector<Mdn2d*> numbers;
+    numbers.reserve(m_numbers.size());
+    for (auto& [name, num] : m_numbers) {
+        numbers.push_back(&num);
+    }
+    // Each number is independent, a sign convention change runs a full cleanup on each
+    ThreadPool::shared().parallelFor(
+        0,
+        static_cast<int>(numbers.size()),
+        [&numbers, &config](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                numbers[i]->setConfig(config);
+            }
+        }
+    );
+    Log_Debug3_T("");
+}
+
+
+mdn::Mdn2d* mdn::MemoryWorkspace::find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_numbers.find(name);
+    return iter == m_numbers.end() ? nullptr : &(iter->second);
+}
+
+
+mdn::Mdn2d& mdn::MemoryWorkspace::obtain(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_numbers.find(name);
+    if (iter == m_numbers.end()) {
+        iter = m_numbers.try_emplace(name, m_config, name).first;
+    }
+    return iter->second;
+}
+
+
+std::vector<std::string> mdn::MemoryWorkspace::names() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> result;
+    result.reserve(m_numbers.size());
+    for (const auto& [name, num] : m_numbers) {
+        result.push_back(name);
+    }
+    return result;
+}
+
+
+// ~~~ ScriptEngine
+
+std::string mdn::ScriptEngine::help() {
+    return
+        "Statements, one per line, '#' starts a comment:\n"
+        "  new n                        create or clear number n\n"
+        "  load n path                  load n from a .mdnbin, .mdntxt, .mdncsv or .mdntsv file\n"
+        "  loadProject path             load every tab of a .mdnproj file, named by tab\n"
+        "  save n path                  save n, format chosen by the file extension\n"
+        "  print n                      print n as text\n"
+        "  list                         print the config and all number names\n"
+        "  copy dst src                 dst = src\n"
+        "  clear n                      set all digits of n to zero\n"
+        "  set n x y digit              set one digit\n"
+        "  add n x y value              add an integer or real value at (x, y)\n"
+        "  plus a b ans                 ans = a + b\n"
+        "  minus a b ans                ans = a - b\n"
+        "  multiply a b ans             ans = a x b\n"
+        "  multiply n k                 n = n x k, for integer k\n"
+        "  divide a b ans [X|Y]         ans = a / b\n"
+        "  divideIterate a b ans rem iterations [X|Y|best]\n"
+        "                               continue a / b, a new rem starts as a copy of a, best\n"
+        "                               tries X, Y and alternating, and keeps the closest\n"
+        "  shift n dx dy                move all digits of n\n"
+        "  transpose n                  swap x and y\n"
+        "  carryover n x y              carry over the digit at (x, y)\n"
+        "  cleanup n [signConvention]   carryover cleanup of all digits\n"
+        "  setConfig key=value ...      base, precision, signConvention, fraxisCascadeDepth,\n"
+        "                               fraxis, maxCleanupWaves - applies to all numbers\n"
+        "  help                         show this list\n";
+}
+
+
+std::vector<mdn::ScriptStatement> mdn::ScriptEngine::parse(
+    const std::string& script,
+    int firstLine
+) {
+    Log_Debug3_H("");
+    std::vector<ScriptStatement> statements;
+    std::istringstream iss(script);
+    std::string rawLine;
+    int line = firstLine - 1;
+    while (std::getline(iss, rawLine)) {
+        ++line;
+        const std::size_t hash = rawLine.find('#');
+        if (hash != std::string::npos) {
+            rawLine.erase(hash);
+        }
+        std::vector<std::string> tokens = tokenize(rawLine);
+        if (tokens.empty()) {
+            continue;
+        }
+
+        ScriptStatement st;
+        st.line = line;
+        st.op = tokens.front();
+        st.args.assign(tokens.begin() + 1, tokens.end());
+        for (const std::string& token : tokens) {
+            if (!st.text.empty()) {
+                st.text += ' ';
+            }
+            st.text += token;
+        }
+        const std::vector<std::string>& a = st.args;
+
+        if (st.op == "new" || st.op == "clear") {
+            requireArgs(st, 1, 1, "new|clear n");
+            st.writes = {a[0]};
+        } else if (st.op == "load") {
+            requireArgs(st, 2, 2, "load n path");
+            st.reads = {fileResource(a[1])};
+            st.writes = {a[0]};
+        } else if (st.op == "loadProject") {
+            requireArgs(st, 1, 1, "loadProject path");
+            st.barrier = true;
+        } else if (st.op == "save") {
+            requireArgs(st, 2, 2, "save n path");
+            st.reads = {a[0]};
+            st.writes = {fileResource(a[1])};
+        } else if (st.op == "print") {
+            requireArgs(st, 1, 1, "print n");
+            st.reads = {a[0]};
+        } else if (st.op == "list" || st.op == "help") {
+            requireArgs(st, 0, 0, "list|help");
+            st.barrier = (st.op == "list");
+        } else if (st.op == "copy") {
+            requireArgs(st, 2, 2, "copy dst src");
+            st.reads = {a[1]};
+            st.writes = {a[0]};
+        } else if (st.op == "set" || st.op == "add") {
+            requireArgs(st, 4, 4, "set|add n x y value");
+            toInt(st, a[1]);
+            toInt(st, a[2]);
+            if (st.op == "set") {
+                toInt(st, a[3]);
+            }
+            st.writes = {a[0]};
+        } else if (st.op == "plus" || st.op == "minus") {
+            requireArgs(st, 3, 3, "plus|minus a b ans");
+            st.reads = {a[0], a[1]};
+            st.writes = {a[2]};
+        } else if (st.op == "multiply") {
+            requireArgs(st, 2, 3, "multiply a b ans, or multiply n k");
+            if (a.size() == 2) {
+                toInteger(st, a[1]);
+                st.writes = {a[0]};
+            } else {
+                st.reads = {a[0], a[1]};
+                st.writes = {a[2]};
+            }
+        } else if (st.op == "divide") {
+            requireArgs(st, 3, 4, "divide a b ans [X|Y]");
+            toFraxis(st, 3);
+            st.reads = {a[0], a[1]};
+            st.writes = {a[2]};
+        } else if (st.op == "divideIterate") {
+            requireArgs(st, 5, 6, "divideIterate a b ans rem iterations [X|Y|best]");
+            toInt(st, a[4]);
+            if (!isBestFraxis(st, 5)) {
+                toFraxis(st, 5);
+            }
+            if (a[2] == a[3] || a[2] == a[0] || a[2] == a[1] || a[3] == a[0] || a[3] == a[1]) {
+                InvalidArgument err(where(st) + "ans and rem must differ from a, b and each other");
+                Log_Error(err.what());
+                throw err;
+            }
+            st.reads = {a[0], a[1]};
+            st.writes = {a[2], a[3]};
+        } else if (st.op == "shift" || st.op == "carryover") {
+            requireArgs(st, 3, 3, "shift n dx dy, or carryover n x y");
+            toInt(st, a[1]);
+            toInt(st, a[2]);
+            st.writes = {a[0]};
+        } else if (st.op == "transpose") {
+            requireArgs(st, 1, 1, "transpose n");
+            st.writes = {a[0]};
+        } else if (st.op == "cleanup") {
+            requireArgs(st, 1, 2, "cleanup n [signConvention]");
+            if (a.size() == 2) {
+                NameToSignConvention(a[1]);
+            }
+            st.writes = {a[0]};
+        } else if (st.op == "setConfig") {
+            requireArgs(st, 1, 6, "setConfig key=value ...");
+            std::string key;
+            std::string value;
+            for (const std::string& token : a) {
+                splitSetting(st, token, key, value);
+                if (key != "signConvention" && key != "fraxis") {
+                    toInt(st, value);
+                }
+            }
+            st.barrier = true;
+        } else {
+            InvalidArgument err(where(st) + "unknown statement '" + st.op + "', try 'help'");
+            Log_Error(err.what());
+            throw err;
+        }
+        statements.push_back(std::move(st));
+    }
+    Log_Debug3_T("parsed " << statements.size() << " statements");
+    return statements;
+}
+
+
+std::vector<int> mdn::ScriptEngine::schedule(const std::vector<ScriptStatement>& statements) {
+    std::vector<int> waves;
+    waves.reserve(statements.size());
+    // Latest wave that reads / writes each name
+    std::unordered_map<std::string, int> lastRead;
+    std::unordered_map<std::string, int> lastWrite;
+    auto latest = [](const std::unordered_map<std::string, int>& m, const std::string& name) {
+        auto iter = m.find(name);
+        return iter == m.cend() ? -1 : iter->second;
+    };
+    // Statements after a barrier cannot start before this wave
+    int floor = 0;
+    int maxWave = -1;
+    for (const ScriptStatement& st : statements) {
+        int wave = floor;
+        if (st.barrier) {
+            wave = maxWave + 1;
+            floor = wave + 1;
+        } else {
+            for (const std::string& name : st.reads) {
+                wave = std::max(wave, latest(lastWrite, name) + 1);
+            }
+            for (const std::string& name : st.writes) {
+                wave = std::max(wave, latest(lastWrite, name) + 1);
+                wave = std::max(wave, latest(lastRead, name) + 1);
+            }
+            for (const std::string& name : st.reads) {
+                lastRead[name] = std::max(latest(lastRead, name), wave);
+            }
+            for (const std::string& name : st.writes) {
+                lastWrite[name] = wave;
+            }
+        }
+        maxWave = std::max(maxWave, wave);
+        waves.push_back(wave);
+    }
+    return waves;
+}
+
+
+mdn::ScriptEngine::ScriptEngine(Mdn2dConfig config) :
+    m_ownWorkspace(new MemoryWorkspace(config)),
+    m_workspace(*m_ownWorkspace)
+{}
+
+
+mdn::ScriptEngine::ScriptEngine(ScriptWorkspace& workspace) :
+    m_workspace(workspace)
+{}
+
+
+std::vector<mdn::ScriptResult> mdn::ScriptEngine::run(
+    const std::string& script,
+    bool parallel,
+    const std::function<void(const ScriptResult&)>& report
+) {
+    return run(parse(script), parallel, report);
+}
+
+
+std::vector<mdn::ScriptResult> mdn::ScriptEngine::run(
+    const std::vector<ScriptStatement>& statements,
+    bool parallel,
+    const std::function<void(const ScriptResult&)>& report
+) {
+    Log_Debug2_H("statements=" << statements.size() << ", parallel=" << parallel);
+    const int n = static_cast<int>(statements.size());
+    const std::vector<int> waves = schedule(statements);
+    const int nWaves = n ? *std::max_element(waves.cbegin(), waves.cend()) + 1 : 0;
+
+    std::vector<ScriptResult> results(n);
+    std::vector<std::vector<int>> members(nWaves);
+    for (int i = 0; i < n; ++i) {
+        results[i].line = statements[i].line;
+        results[i].text = statements[i].text;
+        members[waves[i]].push_back(i);
+    }
+
+    auto execute = [this, &statements, &results, &waves](int i) {
+        ScriptResult& result = results[i];
+        result.wave = waves[i];
+        std::ostringstream oss;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            internal_execute(statements[i], oss);
+            result.output = oss.str();
+        } catch (const std::exception& e) {
+            result.ok = false;
+            result.output = oss.str() + e.what();
+        }
+        result.seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+    };
+
+    // Results are reported in statement order, as soon as all earlier statements are done
+    std::vector<char> done(n, 0);
+    int nReported = 0;
+    auto reportReady = [&]() {
+        while (nReported < n && done[nReported]) {
+            if (report) {
+                report(results[nReported]);
+            }
+            ++nReported;
+        }
+    };
+
+    // A failure skips the statements after it in the script, those before it still run
+    int firstFailed = n;
+    for (int w = 0; w < nWaves; ++w) {
+        std::vector<int> wave;
+        for (int i : members[w]) {
+            if (i < firstFailed) {
+                wave.push_back(i);
+            }
+        }
+        const int nw = static_cast<int>(wave.size());
+        Log_Debug3("wave " << w << " has " << nw << " statements to run");
+        if (parallel && nw > 1) {
+            ThreadPool::shared().parallelFor(
+                0,
+                nw,
+                [&execute, &wave](int i0, int i1) {
+                    for (int i = i0; i < i1; ++i) {
+                        execute(wave[i]);
+                    }
+                }
+            );
+        } else {
+            for (int i : wave) {
+                execute(i);
+            }
+        }
+        for (int i : wave) {
+            done[i] = 1;
+            if (!results[i].ok) {
+                firstFailed = std::min(firstFailed, i);
+            }
+        }
+        reportReady();
+    }
+    const bool failed = firstFailed < n;
+    if (failed) {
+        const std::string reason =
+            "not run, line " + std::to_string(statements[firstFailed].line) + " failed";
+        for (int i = 0; i < n; ++i) {
+            if (!done[i]) {
+                results[i].ok = false;
+                results[i].output = reason;
+                done[i] = 1;
+            }
+        }
+        reportReady();
+    }
+    Log_Debug2_T("ran " << nWaves << " waves" << (failed ? ", with a failure" : ""));
+    return results;
+}
+
+
+void mdn::ScriptEngine::internal_execute(const ScriptStatement& st, std::ostream& os) {
+    Log_Debug3_H("line " << st.line << ": " << st.text);
+    const std::vector<std::string>& a = st.args;
+    const std::string& op = st.op;
+
+    if (op == "new") {
+        m_workspace.obtain(a[0]).clear();
+    } else if (op == "clear") {
+        internal_require(st, a[0]).clear();
+    } else if (op == "load") {
+        internal_load(st, a[0], a[1]);
+    } else if (op == "loadProject") {
+        internal_loadProject(st, a[0], os);
+    } else if (op == "save") {
+        const Mdn2d& src = internal_require(st, a[0]);
+        std::ofstream ofs(a[1], std::ios::binary);
+        if (!ofs.is_open()) {
+            WriteError err(where(st) + "cannot open '" + a[1] + "' for writing");
+            Log_Error(err.what());
+            throw err;
+        }
+        const std::string ext = extension(a[1]);
+        if (ext == "mdntxt") {
+            src.saveTextPretty(ofs, true, true);
+        } else if (ext == "mdncsv") {
+            src.saveTextUtility(ofs, CommaTabSpace::Comma);
+        } else if (ext == "mdntsv") {
+            src.saveTextUtility(ofs, CommaTabSpace::Tab);
+        } else {
+            src.saveBinary(ofs);
+        }
+        if (!ofs.good()) {
+            WriteError err(where(st) + "failed writing '" + a[1] + "'");
+            Log_Error(err.what());
+            throw err;
+        }
+    } else if (op == "print") {
+        os << internal_require(st, a[0]) << '\n';
+    } else if (op == "list") {
+        os << "config " << m_workspace.config() << '\n';
+        for (const std::string& name : m_workspace.names()) {
+            os << "  " << name << '\n';
+        }
+    } else if (op == "help") {
+        os << help();
+    } else if (op == "copy") {
+        if (a[0] != a[1]) {
+            Mdn2d& dst = m_workspace.obtain(a[0]);
+            dst = internal_require(st, a[1]);
+        }
+    } else if (op == "set") {
+        Mdn2d& dst = m_workspace.obtain(a[0]);
+        dst.setValue(Coord(toInt(st, a[1]), toInt(st, a[2])), toInt(st, a[3]));
+    } else if (op == "add") {
+        Mdn2d& dst = m_workspace.obtain(a[0]);
+        const Coord xy(toInt(st, a[1]), toInt(st, a[2]));
+        if (a[3].find_first_of(".eE") == std::string::npos) {
+            dst.add(xy, toInteger(st, a[3]));
+        } else {
+            const int precision = dst.config().precision();
+            dst.add(xy, std::stod(a[3]), precision > 0 ? precision : 16);
+        }
+    } else if (op == "plus" || op == "minus" || op == "multiply" || op == "divide") {
+        if (op == "multiply" && a.size() == 2) {
+            internal_require(st, a[0]).multiply(toInteger(st, a[1]));
+        } else {
+            // The operations cannot write to an operand, so aliased answers go through a temp
+            const bool aliased = (a[2] == a[0]) || (a[2] == a[1]);
+            Mdn2d* ansPtr = aliased ? nullptr : &m_workspace.obtain(a[2]);
+            const Mdn2d& lhs = internal_require(st, a[0]);
+            const Mdn2d& rhs = internal_require(st, a[1]);
+            Mdn2d temp(lhs.config(), a[2]);
+            Mdn2d& ans = aliased ? temp : *ansPtr;
+            if (op == "plus") {
+                lhs.plus(rhs, ans);
+            } else if (op == "minus") {
+                lhs.minus(rhs, ans);
+            } else if (op == "multiply") {
+                lhs.multiply(rhs, ans);
+            } else {
+                lhs.divide(rhs, ans, toFraxis(st, 3));
+            }
+            if (aliased) {
+                internal_require(st, a[2]) = std::move(temp);
+            }
+        }
+    } else if (op == "divideIterate") {
+        const bool fresh = (m_workspace.find(a[3]) == nullptr);
+        Mdn2d& ans = m_workspace.obtain(a[2]);
+        Mdn2d& rem = m_workspace.obtain(a[3]);
+        const Mdn2d& lhs = internal_require(st, a[0]);
+        const Mdn2d& rhs = internal_require(st, a[1]);
+        if (fresh) {
+            ans.clear();
+            rem = lhs;
+        }
+        long double remMag = 0.0;
+        const int nIters = toInt(st, a[4]);
+        if (isBestFraxis(st, 5)) {
+            Fraxis kept = lhs.divideSpeculative(nIters, rhs, ans, rem, remMag);
+            os << "kept fraxis " << kept << '\n';
+        } else {
+            lhs.divideIterate(nIters, rhs, ans, rem, remMag, toFraxis(st, 5));
+        }
+        os << "remainder magnitude " << remMag << '\n';
+    } else if (op == "shift") {
+        internal_require(st, a[0]).shift(toInt(st, a[1]), toInt(st, a[2]));
+    } else if (op == "transpose") {
+        internal_require(st, a[0]).transpose();
+    } else if (op == "carryover") {
+        internal_require(st, a[0]).carryover(Coord(toInt(st, a[1]), toInt(st, a[2])));
+    } else if (op == "cleanup") {
+        SignConvention sc = (a.size() == 2) ? NameToSignConvention(a[1]) : SignConvention::Invalid;
+        internal_require(st, a[0]).carryoverCleanupAll(sc);
+    } else if (op == "setConfig") {
+        const Mdn2dConfig current = m_workspace.config();
+        int base = current.base();
+        int precision = current.precision();
+        SignConvention signConvention = current.signConvention();
+        int fraxisCascadeDepth = current.fraxisCascadeDepth();
+        Fraxis fraxis = current.fraxis();
+        int maxCleanupWaves = current.maxCleanupWaves();
+        std::string key;
+        std::string value;
+        for (const std::string& token : a) {
+            splitSetting(st, token, key, value);
+            if (key == "base") {
+                base = toInt(st, value);
+            } else if (key == "precision") {
+                precision = toInt(st, value);
+            } else if (key == "signConvention") {
+                signConvention = NameToSignConvention(value);
+            } else if (key == "fraxisCascadeDepth") {
+                fraxisCascadeDepth = toInt(st, value);
+            } else if (key == "fraxis") {
+                fraxis = NameToFraxis(value);
+            } else {
+                maxCleanupWaves = toInt(st, value);
+            }
+        }
+        Mdn2dConfig config(base, precision, signConvention, fraxisCascadeDepth, fraxis);
+        config.setMaxCleanupWaves(maxCleanupWaves);
+        config.validateConfig();
+        m_workspace.setConfig(config);
+    }
+    Log_Debug3_T("");
+}
+
+
+mdn::Mdn2d& mdn::ScriptEngine::internal_require(
+    const ScriptStatement& st,
+    const std::string& name
+) {
+    Mdn2d* num = m_workspace.find(name);
+    if (!num) {
+        InvalidArgument err(where(st) + "no number named '" + name + "'");
+        Log_Error(err.what());
+        throw err;
+    }
+    return *num;
+}
+
+
+void mdn::ScriptEngine::internal_load(
+    const ScriptStatement& st,
+    const std::string& name,
+    const std::string& path
+) {
+    Log_Debug3_H("name=" << name << ", path=" << path);
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        ReadError err(where(st) + "cannot open '" + path + "' for reading");
+        Log_Error(err.what());
+        throw err;
+    }
+    Mdn2d loaded(m_workspace.config(), name);
+    Mdn2dIO::load(ifs, loaded);
+    Mdn2d& dst = m_workspace.obtain(name);
+    if (loaded.config().base() != dst.config().base()) {
+        BaseMismatch err(dst.config().base(), loaded.config().base());
+        Log_Error(err.what());
+        throw err;
+    }
+    // Move assignment keeps the workspace name
+    dst = std::move(loaded);
+    Log_Debug3_T("");
+}
+
+
+void mdn::ScriptEngine::internal_loadProject(
+    const ScriptStatement& st,
+    const std::string& path,
+    std::ostream& os
+) {
+    Log_Debug3_H("path=" << path);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        ReadError err(where(st) + "cannot open '" + path + "' for reading");
+        Log_Error(err.what());
+        throw err;
+    }
+
+    // Same layout as the gui's Project::saveBinary
+    char magic[8] = {};
+    in.read(magic, 8);
+    std::uint32_t version = 0;
+    binaryRead(in, version);
+    if (!in || std::memcmp(magic, "MDNPRJ", 6) != 0 || version != 1) {
+        ReadError err(where(st) + "'" + path + "' is not a version 1 MDN project file");
+        Log_Error(err.what());
+        throw err;
+    }
+    const std::string projectName = binaryReadString(in);
+    std::int32_t base = 10;
+    std::int32_t precision = -1;
+    std::int32_t sign = 0;
+    std::int32_t cascadeDepth = Mdn2dConfig::defaultFraxisCascadeDepth();
+    std::int32_t fraxis = 0;
+    std::int32_t activeIndex = 0;
+    std::uint32_t count = 0;
+    binaryRead(in, base);
+    binaryRead(in, precision);
+    binaryRead(in, sign);
+    binaryRead(in, cascadeDepth);
+    binaryRead(in, fraxis);
+    binaryRead(in, activeIndex);
+    binaryRead(in, count);
+    // Each tab takes at least its index and name length
+    if (!in || count > bytesLeft(in)/(2*sizeof(std::uint32_t))) {
+        ReadError err(where(st) + "'" + path + "' is truncated");
+        Log_Error(err.what());
+        throw err;
+    }
+
+    Mdn2dConfig config(
+        base,
+        precision,
+        static_cast<SignConvention>(sign),
+        cascadeDepth,
+        static_cast<Fraxis>(fraxis)
+    );
+    m_workspace.setConfig(config);
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::int32_t index = 0;
+        binaryRead(in, index);
+        const std::string tabName = binaryReadString(in);
+        if (!in) {
+            ReadError err(where(st) + "'" + path + "' is truncated");
+            Log_Error(err.what());
+            throw err;
+        }
+        Mdn2d loaded(config, tabName);
+        loaded.loadBinary(in);
+        m_workspace.obtain(tabName) = std::move(loaded);
+    }
+    os << "project '" << projectName << "', " << count << " tabs, config " << config << '\n';
+    Log_Debug3_T("");
+}
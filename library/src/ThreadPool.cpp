@@ -0,0 +1,133 @@
+#include <mdn/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <mdn/Logger.hpp>
+
+
+mdn::ThreadPool& mdn::ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+
+mdn::ThreadPool::ThreadPool(int nThreads) :
+    m_stopping(false)
+{
+    if (nThreads <= 0) {
+        nThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    Log_Debug3("Starting " << nThreads << " worker threads");
+    m_workers.reserve(nThreads);
+    for (int i = 0; i < nThreads; ++i) {
+        m_workers.emplace_back([this]() { internal_workerLoop(); });
+    }
+}
+
+
+mdn::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+
+int mdn::ThreadPool::size() const {
+    return static_cast<int>(m_workers.size());
+}
+
+
+void mdn::ThreadPool::parallelFor(
+    int begin, int end, const std::function<void(int, int)>& fn, int minChunk
+) {
+    const int n = end - begin;
+    if (n <= 0) {
+        return;
+    }
+    // Aim for a few chunks per thread so uneven chunks balance out
+    const int nThreads = size() + 1;
+    const int chunk = std::max(std::max(1, minChunk), (n + 4*nThreads - 1)/(4*nThreads));
+    const int nChunks = (n + chunk - 1)/chunk;
+    if (nChunks == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    // Chunks are claimed from a shared counter, so any helper that starts after all chunks are
+    //  claimed exits straight away without touching fn
+    struct State {
+        std::atomic<int> next{0};
+        std::atomic<int> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    auto work = [state, &fn, begin, end, chunk, nChunks]() {
+        while (true) {
+            const int c = state->next++;
+            if (c >= nChunks) {
+                return;
+            }
+            const int c0 = begin + c*chunk;
+            const int c1 = std::min(end, c0 + chunk);
+            try {
+                fn(c0, c1);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+            }
+            if (++state->done == nChunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+    const int nHelpers = std::min(nChunks - 1, size());
+    for (int i = 0; i < nHelpers; ++i) {
+        internal_enqueue(work);
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state, nChunks]() { return state->done == nChunks; });
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+
+void mdn::ThreadPool::internal_enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+
+void mdn::ThreadPool::internal_workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Test checks
+//  Minimal support for the self-checking test apps that ctest runs, see add_mdn_test in
+//  sandbox/CMakeLists.txt.  MDN_CHECK reports each failed condition with its location and keeps
+//  going, and main ends with 'return mdn::test::result();', non-zero when any check failed.
+
+#include <iostream>
+
+namespace mdn {
+namespace test {
+
+// Number of failed checks so far
+inline int& failures() {
+    static int nFailures = 0;
+    return nFailures;
+}
+
+// Reports the outcome, returns the exit code for main
+inline int result() {
+    if (failures() != 0) {
+        std::cerr << failures() << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}
+
+} // end namespace test
+} // end namespace mdn
+
+#define MDN_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ++mdn::test::failures(); \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+        } \
+    } while (false)
@@ -0,0 +1,154 @@
+// getAreaDigits: the buffer matches getValue over the window for sparse and dense rows, with a
+//  stride wider than the window left untouched beyond it, and a fetch since the current event
+//  leaves the buffer alone only while the number is unchanged
+
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Written to the buffer beforehand, never a digit
+static const Digit Unwritten = Digit(111);
+
+// Number of ways buf differs from getValue over window, or was written past its width
+static int checkBuffer(
+    const Mdn2d& a, const Rect& window, const std::vector<Digit>& buf, std::ptrdiff_t stride
+) {
+    int wrong = 0;
+    const int width = window.width();
+    for (int r = 0; r < window.height(); ++r) {
+        const int y = window.min().y() + r;
+        for (int c = 0; c < stride; ++c) {
+            const Digit got = buf[r*stride + c];
+            if (c < width) {
+                wrong += got != a.getValue(Coord(window.min().x() + c, y));
+            } else {
+                wrong += got != Unwritten;
+            }
+        }
+    }
+    // Rows below the window's last are not touched either
+    for (std::size_t i = window.height()*stride; i < buf.size(); ++i) {
+        wrong += buf[i] != Unwritten;
+    }
+    return wrong;
+}
+
+// Number of ways a fetch of window into a fresh, padded buffer goes wrong
+static int fetch(const Mdn2d& a, const Rect& window, int padding) {
+    const std::ptrdiff_t stride = window.width() + padding;
+    std::vector<Digit> buf((window.height() + 1)*stride, Unwritten);
+    int wrong = a.getAreaDigits(window, buf.data(), stride) != a.event();
+    return wrong + checkBuffer(a, window, buf, stride);
+}
+
+static void testRandom(std::mt19937& rng) {
+    for (int trial = 0; trial < 30; ++trial) {
+        Mdn2d a(Mdn2dConfig(10), "a");
+        const int span = 10 + int(rng() % 40);
+        const int nDigits = int(rng() % (span*span/2 + 1));
+        for (int i = 0; i < nDigits; ++i) {
+            const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+            a.setValue(xy, Digit(int(rng() % 19) - 9));
+        }
+        int wrong = 0;
+        for (int w = 0; w < 8; ++w) {
+            // Narrow windows probe the window's columns in the busy rows, wide ones probe
+            //  each row's digits
+            const int x0 = int(rng() % (2*span)) - span;
+            const int y0 = int(rng() % (2*span)) - span;
+            const int width = w % 2 ? 1 + int(rng() % 4) : 1 + int(rng() % (2*span));
+            const Rect window(x0, y0, x0 + width - 1, y0 + int(rng() % span));
+            wrong += fetch(a, window, 0);
+            wrong += fetch(a, window, 1 + int(rng() % 7));
+        }
+        MDN_CHECK(wrong == 0);
+    }
+}
+
+static void testRowProbes() {
+    Mdn2d a(Mdn2dConfig(10), "a");
+
+    // Row 0 holds far more digits than a narrow window's width, row 2 fewer, row 1 none
+    for (int x = -30; x <= 30; ++x) {
+        a.setValue(Coord(x, 0), Digit(x % 9 ? x % 9 : 1));
+    }
+    a.setValue(Coord(-40, 2), 5);
+    a.setValue(Coord(3, 2), -6);
+    a.setValue(Coord(40, 2), 7);
+
+    // Dense row, narrow window and a stride more than twice its width
+    const Rect narrow(1, 0, 4, 2);
+    MDN_CHECK(fetch(a, narrow, 9) == 0);
+    std::vector<Digit> buf(3*13, Unwritten);
+    a.getAreaDigits(narrow, buf.data(), 13);
+    MDN_CHECK(buf[0] == 1 && buf[3] == 4 && buf[4] == Unwritten);
+    MDN_CHECK(buf[13] == 0 && buf[2*13 + 2] == -6 && buf[2*13 + 3] == 0);
+
+    // Sparse rows, window wider than they are full, and digits either side of it
+    const Rect wide(-35, 1, 35, 2);
+    MDN_CHECK(fetch(a, wide, 0) == 0);
+    MDN_CHECK(fetch(a, wide, 5) == 0);
+
+    // Both at once, and an empty window
+    MDN_CHECK(fetch(a, Rect(-50, -3, 50, 4), 2) == 0);
+    std::vector<Digit> none(4, Unwritten);
+    a.getAreaDigits(Rect::GetInvalid(), none.data(), 2);
+    MDN_CHECK(none == std::vector<Digit>(4, Unwritten));
+}
+
+static void testSinceEvent() {
+    Mdn2d a(Mdn2dConfig(10), "a");
+    a.setValue(Coord(0, 0), 3);
+    a.setValue(Coord(2, 1), -4);
+    const Rect window(-1, -1, 3, 2);
+    const std::ptrdiff_t stride = window.width() + 2;
+    std::vector<Digit> buf((window.height() + 1)*stride, Unwritten);
+    const long long e0 = a.getAreaDigits(window, buf.data(), stride);
+    MDN_CHECK(e0 == a.event());
+    MDN_CHECK(checkBuffer(a, window, buf, stride) == 0);
+
+    // Unchanged: nothing is written, however many times it is asked
+    std::vector<Digit> blank(buf.size(), Unwritten);
+    MDN_CHECK(a.getAreaDigits(window, blank.data(), stride, e0) == e0);
+    MDN_CHECK(a.getAreaDigits(window, blank.data(), stride, e0) == e0);
+    MDN_CHECK(blank == std::vector<Digit>(buf.size(), Unwritten));
+
+    // An earlier or unknown event fills the buffer
+    MDN_CHECK(a.getAreaDigits(window, blank.data(), stride, e0 - 1) == e0);
+    MDN_CHECK(checkBuffer(a, window, blank, stride) == 0);
+    blank.assign(buf.size(), Unwritten);
+    MDN_CHECK(a.getAreaDigits(window, blank.data(), stride, -1) == e0);
+    MDN_CHECK(checkBuffer(a, window, blank, stride) == 0);
+
+    // A change moves the event on, and the stale buffer is refilled
+    a.setValue(Coord(1, 0), 8);
+    MDN_CHECK(a.event() != e0);
+    const long long e1 = a.getAreaDigits(window, buf.data(), stride, e0);
+    MDN_CHECK(e1 == a.event());
+    MDN_CHECK(checkBuffer(a, window, buf, stride) == 0);
+    MDN_CHECK(buf[1*stride + 2] == 8);
+
+    // A change still under way has not moved the event on, but is not skipped either
+    a.internal_modified();
+    blank.assign(buf.size(), Unwritten);
+    MDN_CHECK(a.getAreaDigits(window, blank.data(), stride, e1) == e1);
+    MDN_CHECK(checkBuffer(a, window, blank, stride) == 0);
+    a.internal_operationComplete();
+    MDN_CHECK(a.event() != e1);
+    blank.assign(buf.size(), Unwritten);
+    a.getAreaDigits(window, blank.data(), stride, e1);
+    MDN_CHECK(checkBuffer(a, window, blank, stride) == 0);
+}
+
+int main() {
+    std::mt19937 rng(48);
+    testRandom(rng);
+    testRowProbes();
+    testSinceEvent();
+    return mdn::test::result();
+}
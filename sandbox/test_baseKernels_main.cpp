@@ -0,0 +1,130 @@
+// Base kernels: FixedBase<B>, including the biased shift of power-of-two bases, matches RuntimeBase
+//  for every base 2..32, digit by digit and through additions with carry
+
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <mdn/BaseKernels.hpp>
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Adds value at xy, carrying to (x+1, y) and (x, y+1) as Mdn2d::internal_add does
+template <class Kernel>
+static void addWithCarry(
+    const Kernel& kernel, std::map<std::pair<int, int>, long long>& digits, int x, int y,
+    long long value
+) {
+    const long long sum = digits[{x, y}] + value;
+    const long long carry = kernel.carry(sum);
+    digits[{x, y}] = kernel.rem(sum);
+    if (carry != 0) {
+        addWithCarry(kernel, digits, x + 1, y, carry);
+        addWithCarry(kernel, digits, x, y + 1, carry);
+    }
+}
+
+template <int B>
+static int checkBase(std::mt19937_64& rng) {
+    const FixedBase<B> fixed;
+    const RuntimeBase runtime{B};
+    int wrong = fixed.base() != runtime.base();
+
+    // Sums near zero, where the bias matters, exhaustively
+    std::vector<long long> sums;
+    for (long long sum = -8LL*B*B; sum <= 8LL*B*B; ++sum) {
+        sums.push_back(sum);
+    }
+    // The extremes, and random sums of every magnitude
+    const long long lo = std::numeric_limits<long long>::min();
+    const long long hi = std::numeric_limits<long long>::max();
+    for (long long sum : {lo, lo + 1, lo + B - 1, lo + B, hi, hi - 1, hi - B + 1, hi - B}) {
+        sums.push_back(sum);
+    }
+    for (int i = 0; i < 2000; ++i) {
+        const long long sum = static_cast<long long>(rng());
+        sums.push_back(sum >> (rng() % 63));
+    }
+    for (long long sum : sums) {
+        wrong += fixed.carry(sum) != runtime.carry(sum);
+        wrong += fixed.rem(sum) != runtime.rem(sum);
+        wrong += fixed.isDigit(sum) != runtime.isDigit(sum);
+        // Truncation toward zero, the digit keeps the sign of the sum
+        wrong += fixed.carry(sum)*B + fixed.rem(sum) != sum;
+        wrong += !fixed.isDigit(fixed.rem(sum));
+    }
+
+    // Additions with carry, over random digits and values of both signs
+    for (int trial = 0; trial < 20; ++trial) {
+        std::map<std::pair<int, int>, long long> byFixed;
+        std::map<std::pair<int, int>, long long> byRuntime;
+        for (int i = 0; i < 30; ++i) {
+            const int x = int(rng() % 6);
+            const int y = int(rng() % 6);
+            const long long magnitude = B == 2 ? 64 : 1LL << (rng() % 24);
+            const long long value = static_cast<long long>(rng() % (2*magnitude + 1)) - magnitude;
+            addWithCarry(fixed, byFixed, x, y, value);
+            addWithCarry(runtime, byRuntime, x, y, value);
+        }
+        wrong += byFixed != byRuntime;
+    }
+    return wrong;
+}
+
+template <int... Bs>
+static int checkBases(std::mt19937_64& rng, std::integer_sequence<int, Bs...>) {
+    return (checkBase<Bs + 2>(rng) + ...);
+}
+
+static void testKernels(std::mt19937_64& rng) {
+    MDN_CHECK(checkBases(rng, std::make_integer_sequence<int, 31>()) == 0);
+}
+
+// Mdn2d's own add, dispatched to a FixedBase kernel where there is one, against RuntimeBase
+struct Adder : Mdn2d {
+    using Mdn2d::Mdn2d;
+
+    void add(const Coord& xy, long long value) {
+        auto lock = lockWriteable();
+        CoordSet changed;
+        internal_add(xy, value, false, changed);
+        internal_operationComplete();
+    }
+};
+
+static void testDispatched(std::mt19937_64& rng) {
+    int wrong = 0;
+    for (int base = 2; base <= 32; ++base) {
+        const int dispatched = static_dispatchBase(
+            base, [](const auto& kernel) { return kernel.base(); }
+        );
+        wrong += dispatched != base;
+
+        Adder a(Mdn2dConfig(base), "a");
+        std::map<std::pair<int, int>, long long> expected;
+        for (int i = 0; i < 200; ++i) {
+            const int x = int(rng() % 10) - 5;
+            const int y = int(rng() % 10) - 5;
+            const long long magnitude = base == 2 ? 16 : 1LL << (rng() % 20);
+            const long long value = static_cast<long long>(rng() % (2*magnitude + 1)) - magnitude;
+            a.add(Coord(x, y), value);
+            addWithCarry(RuntimeBase{base}, expected, x, y, value);
+        }
+        for (const auto& [xy, digit] : expected) {
+            wrong += a.getValue(Coord(xy.first, xy.second)) != digit;
+        }
+    }
+    MDN_CHECK(wrong == 0);
+}
+
+int main() {
+    std::mt19937_64 rng(36);
+    testKernels(rng);
+    testDispatched(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,122 @@
+// BatchEvaluator gives the same results as the individual Mdn2d operations, and isolates failures
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mdn/BatchEvaluator.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Same digits in the same places
+static bool sameDigits(const Mdn2d& a, const Mdn2d& b) {
+    const Rect bounds = Rect::UnionOf(a.bounds(), b.bounds());
+    if (!bounds.isValid()) {
+        return true;
+    }
+    VecVecDigit rowsA;
+    VecVecDigit rowsB;
+    a.getAreaRows(bounds, rowsA);
+    b.getAreaRows(bounds, rowsB);
+    return rowsA == rowsB;
+}
+
+int main() {
+    std::mt19937 rng(40);
+    Mdn2dConfig config(10, 32, SignConvention::Positive, 20, Fraxis::X);
+    std::vector<Mdn2d> operands;
+    for (int k = 0; k < 12; ++k) {
+        operands.emplace_back(config, "op" + std::to_string(k));
+        for (int j = 0; j < 6; ++j) {
+            const Coord xy(static_cast<int>(rng() % 5) - 2, static_cast<int>(rng() % 5) - 2);
+            operands.back().setValue(xy, static_cast<int>(rng() % 19) - 9);
+        }
+        if (operands.back().getTotalMagnitude() == 0) {
+            operands.back().setValue(Coord(0, 0), 3);
+        }
+    }
+    BatchEvaluator::Pairs pairs;
+    for (const Mdn2d& lhs : operands) {
+        for (const Mdn2d& rhs : operands) {
+            pairs.emplace_back(&lhs, &rhs);
+        }
+    }
+
+    BatchEvaluator batch(config);
+    for (
+        BatchOperation op : {BatchOperation::Plus, BatchOperation::Minus, BatchOperation::Multiply}
+    ) {
+        const std::vector<BatchResult>& results = batch.evaluate(op, pairs);
+        MDN_CHECK(results.size() == pairs.size());
+        int wrong = 0;
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            Mdn2d ans(config, "ans");
+            if (op == BatchOperation::Plus) {
+                pairs[k].first->plus(*pairs[k].second, ans);
+            } else if (op == BatchOperation::Minus) {
+                pairs[k].first->minus(*pairs[k].second, ans);
+            } else {
+                pairs[k].first->multiply(*pairs[k].second, ans);
+            }
+            wrong += !results[k].ok || !sameDigits(ans, results[k].value);
+        }
+        MDN_CHECK(wrong == 0);
+    }
+
+    // A smaller batch reuses the slots
+    const BatchEvaluator::Pairs few(pairs.begin(), pairs.begin() + 4);
+    const std::vector<BatchResult>& sums = batch.evaluate(BatchOperation::Plus, few);
+    MDN_CHECK(sums.size() == few.size());
+    for (std::size_t k = 0; k < few.size(); ++k) {
+        Mdn2d ans(config, "ans");
+        few[k].first->plus(*few[k].second, ans);
+        MDN_CHECK(sums[k].ok && sameDigits(ans, sums[k].value));
+    }
+
+    // A null operand fails only its own item.  Quotients reuse the slots of the batches above.
+    Mdn2d divisor(config, "divisor");
+    divisor.setValue(Coord(0, 0), 4);
+    BatchEvaluator::Pairs divisions;
+    for (const Mdn2d& lhs : operands) {
+        divisions.emplace_back(&lhs, &divisor);
+    }
+    divisions.emplace_back(&operands[0], nullptr);
+    const std::vector<BatchResult>& quotients = batch.evaluate(BatchOperation::Divide, divisions);
+    MDN_CHECK(quotients.size() == divisions.size());
+    int wrong = 0;
+    for (std::size_t k = 0; k + 1 < divisions.size(); ++k) {
+        Mdn2d ans(config, "ans");
+        Mdn2d rem(config, "rem");
+        long double remMag = 0.0;
+        divisions[k].first->divide(*divisions[k].second, ans, rem, remMag, Fraxis::Default);
+        wrong +=
+            !quotients[k].ok
+            || !sameDigits(ans, quotients[k].value)
+            || !sameDigits(rem, quotients[k].remainder)
+            || remMag != quotients[k].remMag;
+    }
+    MDN_CHECK(wrong == 0);
+    MDN_CHECK(!quotients.back().ok);
+    MDN_CHECK(!quotients.back().error.empty());
+
+    // The same batch again, on slots now holding its own quotients, gives the same digits.  The
+    //  first digits are kept as text, a copy would share the slot's storage.
+    std::vector<std::vector<std::string>> firstValues;
+    std::vector<std::vector<std::string>> firstRemainders;
+    for (const BatchResult& result : quotients) {
+        firstValues.push_back(result.value.toStringRows());
+        firstRemainders.push_back(result.remainder.toStringRows());
+    }
+    const std::vector<BatchResult>& again = batch.evaluate(BatchOperation::Divide, divisions);
+    wrong = 0;
+    for (std::size_t k = 0; k + 1 < divisions.size(); ++k) {
+        wrong +=
+            !again[k].ok
+            || firstValues[k] != again[k].value.toStringRows()
+            || firstRemainders[k] != again[k].remainder.toStringRows();
+    }
+    MDN_CHECK(wrong == 0);
+    return mdn::test::result();
+}
@@ -0,0 +1,128 @@
+// Row carryover classification: the row kernel, SIMD or not, agrees with static_checkCarryover at
+//  every position, for every base, row lengths that are not a multiple of the vector width, and
+//  whole numbers with dense and sparse rows
+
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Carryover type held by masks at position i, see also disjoint
+static Carryover fromMasks(const CarryoverMasks& masks, int i) {
+    const int w = i / CarryoverMasks::wordBits;
+    const uint64_t bit = uint64_t(1) << (i % CarryoverMasks::wordBits);
+    if (masks.required[w] & bit) {
+        return Carryover::Required;
+    }
+    if (masks.optionalPositive[w] & bit) {
+        return Carryover::OptionalPositive;
+    }
+    if (masks.optionalNegative[w] & bit) {
+        return Carryover::OptionalNegative;
+    }
+    return Carryover::Invalid;
+}
+
+// True when no position has more than one type
+static bool disjoint(const CarryoverMasks& masks) {
+    for (std::size_t w = 0; w < masks.required.size(); ++w) {
+        const uint64_t rp = masks.required[w] & masks.optionalPositive[w];
+        const uint64_t rn = masks.required[w] & masks.optionalNegative[w];
+        const uint64_t pn = masks.optionalPositive[w] & masks.optionalNegative[w];
+        if (rp | rn | pn) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random values for a digit position: mostly digits, some carries in progress, a few extremes
+static Digit randomValue(std::mt19937& rng, int base) {
+    switch (rng() % 8) {
+        case 0:
+            return Digit(int(rng() % 256) - 128);
+        case 1:
+            return Digit(int(rng() % (4*base - 1)) - (2*base - 1));
+        case 2:
+            return 0;
+        default:
+            return Digit(int(rng() % (2*base - 1)) - (base - 1));
+    }
+}
+
+static void testKernel(std::mt19937& rng) {
+    CarryoverMasks masks;
+    for (int base = 2; base <= 32; ++base) {
+        for (int n = 0; n <= 140; ++n) {
+            std::vector<Digit> p(n + 1);
+            std::vector<Digit> y(n);
+            for (Digit& d : p) {
+                d = randomValue(rng, base);
+            }
+            for (Digit& d : y) {
+                d = randomValue(rng, base);
+            }
+            Mdn2dRules::static_checkCarryoverRow(
+                p.data(), p.data() + 1, y.data(), n, Digit(base), masks
+            );
+            MDN_CHECK(static_cast<int>(masks.required.size()) == CarryoverMasks::nWords(n));
+            MDN_CHECK(disjoint(masks));
+            int wrong = 0;
+            for (int i = 0; i < n; ++i) {
+                wrong += fromMasks(masks, i)
+                    != Mdn2dRules::static_checkCarryover(p[i], p[i + 1], y[i], Digit(base));
+            }
+            // No stray bits beyond the row
+            for (int i = n; i < CarryoverMasks::nWords(n)*CarryoverMasks::wordBits; ++i) {
+                wrong += fromMasks(masks, i) != Carryover::Invalid;
+            }
+            MDN_CHECK(wrong == 0);
+        }
+    }
+}
+
+// Polymorphic nodes found by the row scan are the optional carryovers found digit by digit
+static void testNumber(std::mt19937& rng) {
+    for (int base : {2, 3, 10, 16, 32}) {
+        for (int trial = 0; trial < 10; ++trial) {
+            Mdn2d a(Mdn2dConfig(base), "a");
+            // Dense block, its rows 100 or so wide
+            const int w = 60 + int(rng() % 70);
+            for (int y = 0; y < 12; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    a.setValue(Coord(x, y), Digit(int(rng() % (2*base - 1)) - (base - 1)));
+                }
+            }
+            // Sparse rows
+            for (int i = 0; i < 40; ++i) {
+                const Coord xy(int(rng() % 2000) - 1000, 20 + int(rng() % 6));
+                a.setValue(xy, Digit(int(rng() % (2*base - 1)) - (base - 1)));
+            }
+            a.carryoverCleanupAll();
+
+            CoordSet expected;
+            const Rect b = a.bounds();
+            for (int y = b.min().y() - 1; y <= b.max().y(); ++y) {
+                for (int x = b.min().x() - 1; x <= b.max().x(); ++x) {
+                    const Coord xy(x, y);
+                    const Carryover co = a.checkCarryover(xy);
+                    if (co == Carryover::OptionalPositive || co == Carryover::OptionalNegative) {
+                        expected.insert(xy);
+                    }
+                }
+            }
+            MDN_CHECK(a.getPolymorphicNodes() == expected);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(26);
+    testKernel(rng);
+    testNumber(rng);
+    return mdn::test::result();
+}
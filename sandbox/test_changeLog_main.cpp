@@ -0,0 +1,135 @@
+// ChangeLog: records replay onto their own snapshot, in order, snapshots can be encoded by the
+//  worker, and replay stops cleanly at a damaged record
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mdn/ChangeLog.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+using Records = std::vector<std::pair<std::string, ChangeLog::Writes>>;
+
+static Records replay(const std::string& basePath) {
+    Records result;
+    ChangeLog::static_replay(
+        basePath,
+        [&result](const std::string& name, const ChangeLog::Writes& writes) {
+            result.emplace_back(name, writes);
+        }
+    );
+    return result;
+}
+
+// Appends raw bytes to the end of the log
+static void appendRaw(const std::string& basePath, const std::string& bytes) {
+    std::FILE* file = std::fopen(ChangeLog::static_logPath(basePath).c_str(), "ab");
+    MDN_CHECK(file);
+    if (file) {
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+}
+
+int main() {
+    const std::string basePath = "test_changeLog_tmp";
+    Records expected;
+    for (int k = 0; k < 5; ++k) {
+        ChangeLog::Writes writes;
+        for (int i = 0; i <= k; ++i) {
+            writes.emplace_back(Coord(i - 2, -k), static_cast<Digit>(k - i));
+        }
+        expected.emplace_back("n" + std::to_string(k % 2), writes);
+    }
+    {
+        ChangeLog log(basePath);
+        log.compact("old snapshot");
+        log.append("stale", {{Coord(0, 0), 1}});
+        log.compact("snapshot");
+        for (const auto& [name, writes] : expected) {
+            log.append(name, writes);
+        }
+        log.flush();
+        MDN_CHECK(!log.failed());
+    }
+
+    // Records since the last compact, in order
+    std::string snapshot;
+    MDN_CHECK(ChangeLog::static_readSnapshot(basePath, snapshot));
+    MDN_CHECK(snapshot == "snapshot");
+    MDN_CHECK(replay(basePath) == expected);
+
+    // A record claiming more bytes than the file holds ends the replay, without allocating them
+    std::string huge(8, '\0');
+    huge[0] = huge[1] = huge[2] = huge[3] = '\xf0';
+    appendRaw(basePath, huge);
+    MDN_CHECK(replay(basePath) == expected);
+
+    // So does a torn record
+    {
+        ChangeLog log(basePath);
+        log.compact("snapshot");
+        for (const auto& [name, writes] : expected) {
+            log.append(name, writes);
+        }
+        log.flush();
+    }
+    appendRaw(basePath, std::string("\x20\0\0\0\x01\x02\x03\x04\x05", 9));
+    MDN_CHECK(replay(basePath) == expected);
+
+    // A snapshot given by an encoder is produced on the worker, not the calling thread, and
+    //  still lands in queue order
+    {
+        ChangeLog log(basePath);
+        log.compact("old snapshot");
+        log.append("stale", {{Coord(0, 0), 1}});
+        std::thread::id encodedOn;
+        log.compact([&encodedOn]() {
+            encodedOn = std::this_thread::get_id();
+            return std::string("encoded snapshot");
+        });
+        for (const auto& [name, writes] : expected) {
+            log.append(name, writes);
+        }
+        log.flush();
+        MDN_CHECK(!log.failed());
+        MDN_CHECK(encodedOn != std::thread::id());
+        MDN_CHECK(encodedOn != std::this_thread::get_id());
+    }
+    MDN_CHECK(ChangeLog::static_readSnapshot(basePath, snapshot));
+    MDN_CHECK(snapshot == "encoded snapshot");
+    MDN_CHECK(replay(basePath) == expected);
+
+    // An encoder that throws leaves the snapshot and the log as they were
+    {
+        ChangeLog log(basePath);
+        log.compact("snapshot");
+        for (const auto& [name, writes] : expected) {
+            log.append(name, writes);
+        }
+        log.compact([]() -> std::string { throw std::runtime_error("no snapshot"); });
+        log.flush();
+        MDN_CHECK(log.failed());
+    }
+    MDN_CHECK(ChangeLog::static_readSnapshot(basePath, snapshot));
+    MDN_CHECK(snapshot == "snapshot");
+    MDN_CHECK(replay(basePath) == expected);
+
+    // A new log starts with no records, and discard removes the files
+    {
+        ChangeLog log(basePath);
+        log.compact("fresh");
+        log.flush();
+        MDN_CHECK(replay(basePath).empty());
+        log.discard();
+    }
+    MDN_CHECK(!ChangeLog::static_exists(basePath));
+    return mdn::test::result();
+}
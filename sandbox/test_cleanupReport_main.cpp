@@ -0,0 +1,213 @@
+// Cleanup reports: convergence, the value kept, the wave limit, and oscillation detection by exact
+//  wave state
+
+#include <random>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Carries keep sum(d*t^x*s^y) whenever t + s = base, checked here modulo a prime
+static const long long prime = 1000000007LL;
+
+static long long power(long long b, long long e) {
+    if (e < 0) {
+        b = power(b, prime - 2);
+        e = -e;
+    }
+    long long r = 1;
+    b %= prime;
+    while (e) {
+        if (e & 1) {
+            r = r*b % prime;
+        }
+        b = b*b % prime;
+        e >>= 1;
+    }
+    return r;
+}
+
+static long long invariant(const Mdn2d& a) {
+    const int base = a.config().base();
+    const long long t = base == 2 ? 1 : 2;
+    const long long s = base - t;
+    long long sum = 0;
+    if (!a.hasBounds()) {
+        return sum;
+    }
+    const Rect b = a.bounds();
+    for (int y = b.min().y(); y <= b.max().y(); ++y) {
+        for (int x = b.min().x(); x <= b.max().x(); ++x) {
+            const Digit d = a.getValue(Coord(x, y));
+            if (d) {
+                const long long w = power(t, x)*power(s, y) % prime;
+                sum = ((sum + d*w) % prime + prime) % prime;
+            }
+        }
+    }
+    return sum;
+}
+
+static void fill(Mdn2d& a, std::mt19937& rng, int size) {
+    const int base = a.config().base();
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            a.setValue(Coord(x, y), Digit(int(rng() % (2*base - 1)) - (base - 1)));
+        }
+    }
+}
+
+// Number of digits still needing a carryover under sign convention sc
+static int nRemaining(const Mdn2d& a, SignConvention sc) {
+    const Carryover wrongSign = sc == SignConvention::Positive ? Carryover::OptionalNegative
+        : sc == SignConvention::Negative ? Carryover::OptionalPositive : Carryover::Required;
+    int n = 0;
+    const Rect b = a.bounds();
+    for (int y = b.min().y() - 1; y <= b.max().y(); ++y) {
+        for (int x = b.min().x() - 1; x <= b.max().x(); ++x) {
+            const Carryover co = a.checkCarryover(Coord(x, y));
+            n += co == Carryover::Required || co == wrongSign;
+        }
+    }
+    return n;
+}
+
+static void testConverged(std::mt19937& rng) {
+    for (SignConvention sc :
+        {SignConvention::Positive, SignConvention::Negative, SignConvention::Neutral}
+    ) {
+        Mdn2d a(Mdn2dConfig(10, -1, sc), "a");
+        fill(a, rng, 40);
+        const Mdn2d before(a, "before");
+        const CleanupReport report = a.carryoverCleanupAllWithReport();
+        MDN_CHECK(report.converged());
+        MDN_CHECK(report.status == CleanupStatus::Converged);
+        MDN_CHECK(report.waves > 0);
+        MDN_CHECK(report.carries > 0);
+        MDN_CHECK(report.peakWorkingSet > 0);
+        MDN_CHECK(nRemaining(a, sc) == 0);
+
+        // Every digit that differs was reported as changed
+        int missed = 0;
+        const Rect b = Rect::UnionOf(a.bounds(), before.bounds());
+        for (int y = b.min().y(); y <= b.max().y(); ++y) {
+            for (int x = b.min().x(); x <= b.max().x(); ++x) {
+                const Coord xy(x, y);
+                missed += a.getValue(xy) != before.getValue(xy) && !report.changed.count(xy);
+            }
+        }
+        MDN_CHECK(missed == 0);
+
+        // Nothing left to do
+        const CleanupReport again = a.carryoverCleanupAllWithReport();
+        MDN_CHECK(again.converged());
+        MDN_CHECK(again.waves == 0);
+        MDN_CHECK(again.carries == 0);
+        MDN_CHECK(again.changed.empty());
+    }
+}
+
+// Cascading carries arrive with the carry added in, so cleanup never changes the value
+static void testValueKept(std::mt19937& rng) {
+    int changed = 0;
+    for (int trial = 0; trial < 600; ++trial) {
+        const int base = 2 + int(rng() % 31);
+        const SignConvention sc = trial % 3 == 0 ? SignConvention::Neutral
+            : trial % 3 == 1 ? SignConvention::Positive : SignConvention::Negative;
+        Mdn2d a(Mdn2dConfig(base, -1, sc), "a");
+        fill(a, rng, 2 + int(rng() % 8));
+        const long long before = invariant(a);
+        const CleanupReport report = a.carryoverCleanupAllWithReport();
+        MDN_CHECK(report.converged());
+        changed += invariant(a) != before;
+    }
+    MDN_CHECK(changed == 0);
+}
+
+static void testIterationLimit(std::mt19937& rng) {
+    Mdn2dConfig config(10, -1, SignConvention::Positive);
+    config.setMaxCleanupWaves(0);
+    Mdn2d a(config, "a");
+    fill(a, rng, 30);
+    const std::vector<std::string> start = a.toStringRows();
+    CleanupReport report = a.carryoverCleanupAllWithReport();
+    MDN_CHECK(report.status == CleanupStatus::IterationLimit);
+    MDN_CHECK(!report.converged());
+    MDN_CHECK(report.waves == 0);
+    MDN_CHECK(report.changed.empty());
+    MDN_CHECK(a.toStringRows() == start);
+
+    config.setMaxCleanupWaves(2);
+    a.setConfig(config);
+    report = a.carryoverCleanupAllWithReport();
+    MDN_CHECK(report.status == CleanupStatus::IterationLimit);
+    MDN_CHECK(report.waves == 2);
+    MDN_CHECK(report.carries > 0);
+    MDN_CHECK(nRemaining(a, SignConvention::Positive) > 0);
+
+    // Lifting the limit finishes the job
+    config.setMaxCleanupWaves(-1);
+    a.setConfig(config);
+    report = a.carryoverCleanupAllWithReport();
+    MDN_CHECK(report.converged());
+    MDN_CHECK(nRemaining(a, SignConvention::Positive) == 0);
+}
+
+// A repeat is an identical state, never just an identical hash
+static void testWaveStates() {
+    CleanupWaves::State a;
+    a.coords = {Coord(0, 0), Coord(1, 0)};
+    a.digits = {5, -3, 0, 2, 0, 1};
+    CleanupWaves::State b = a;
+    b.digits[4] = 7;
+    CleanupWaves::State c = a;
+    c.coords[1] = Coord(0, 1);
+
+    MDN_CHECK(CleanupWaves::static_hash(a) == CleanupWaves::static_hash(CleanupWaves::State(a)));
+    MDN_CHECK(CleanupWaves::static_hash(a) != CleanupWaves::static_hash(b));
+
+    // Forced collisions: the same hash for all three states
+    CleanupWaves waves;
+    MDN_CHECK(!waves.repeats(42, CleanupWaves::State(a)));
+    MDN_CHECK(!waves.repeats(42, CleanupWaves::State(b)));
+    MDN_CHECK(!waves.repeats(42, CleanupWaves::State(c)));
+    MDN_CHECK(waves.repeats(42, CleanupWaves::State(b)));
+    MDN_CHECK(waves.repeats(42, CleanupWaves::State(a)));
+    MDN_CHECK(waves.seen.size() == 1);
+    MDN_CHECK(waves.seen[42].size() == 3);
+
+    // Filed by their own hash
+    CleanupWaves hashed;
+    MDN_CHECK(!hashed.repeats(CleanupWaves::State(a)));
+    MDN_CHECK(!hashed.repeats(CleanupWaves::State(b)));
+    MDN_CHECK(hashed.repeats(CleanupWaves::State(a)));
+    hashed.clear();
+    MDN_CHECK(!hashed.repeats(CleanupWaves::State(a)));
+}
+
+static void testStatusNames() {
+    for (CleanupStatus s :
+        {CleanupStatus::Converged, CleanupStatus::Oscillating, CleanupStatus::IterationLimit}
+    ) {
+        MDN_CHECK(NameToCleanupStatus(CleanupStatusToName(s)) == s);
+    }
+    bool thrown = false;
+    try {
+        NameToCleanupStatus("Diverging");
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    MDN_CHECK(thrown);
+}
+
+int main() {
+    std::mt19937 rng(28);
+    testConverged(rng);
+    testValueKept(rng);
+    testIterationLimit(rng);
+    testWaveStates();
+    testStatusNames();
+    return mdn::test::result();
+}
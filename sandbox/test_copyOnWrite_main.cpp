@@ -0,0 +1,93 @@
+// Copies share digits until one side writes, a write never shows through to the other side
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static Mdn2d makeNumber(const Mdn2dConfig& config) {
+    Mdn2d a(config, "a");
+    for (int x = -20; x < 20; ++x) {
+        for (int y = -20; y < 20; ++y) {
+            a.setValue(Coord(x, y), ((x*7 + y*3) % 9 + 9) % 9 + 1);
+        }
+    }
+    return a;
+}
+
+int main() {
+    Mdn2dConfig config(10, 64, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d a = makeNumber(config);
+    const auto original = a.toStringRows();
+
+    std::vector<Mdn2d> copies;
+    for (int i = 0; i < 12; ++i) {
+        copies.emplace_back(a, "c" + std::to_string(i));
+    }
+    for (const Mdn2d& c : copies) {
+        MDN_CHECK(c.toStringRows() == original);
+    }
+
+    // Writes to a copy leave the original and the other copies alone
+    copies[3].setValue(Coord(0, 0), 0);
+    copies[4].add(Coord(1, 1), 5.0, 4);
+    copies[5].multiply(3);
+    copies[6].shiftRight(2);
+    copies[7].clear();
+    MDN_CHECK(a.toStringRows() == original);
+    for (int i = 3; i < 8; ++i) {
+        MDN_CHECK(copies[i].toStringRows() != original);
+    }
+    MDN_CHECK(copies[8].toStringRows() == original);
+
+    // Assignment shares too, either side may write first
+    Mdn2d b(config, "b");
+    b = copies[9];
+    b.setValue(Coord(2, 2), 1);
+    MDN_CHECK(copies[9].toStringRows() == original);
+    Mdn2d c(config, "c");
+    c = copies[9];
+    copies[9].setValue(Coord(2, 2), 1);
+    MDN_CHECK(c.toStringRows() == original);
+
+    // Writing the source does not reach its copy
+    Mdn2d source = makeNumber(config);
+    Mdn2d copy(source, "copy");
+    source.setValue(Coord(-3, 4), 0);
+    MDN_CHECK(copy.toStringRows() == original);
+
+    // A moved-from number is empty, and independent of the one it moved to
+    Mdn2d moved(std::move(copies[10]));
+    MDN_CHECK(moved.toStringRows() == original);
+    MDN_CHECK(copies[10].getTotalMagnitude() == 0);
+    copies[10].setValue(Coord(0, 0), 2);
+    MDN_CHECK(moved.toStringRows() == original);
+
+    // Copies of one number written concurrently each detach on their own
+    std::vector<Mdn2d> parallel;
+    for (int i = 0; i < 16; ++i) {
+        parallel.emplace_back(a, "p" + std::to_string(i));
+    }
+    ThreadPool::shared().parallelFor(
+        0,
+        static_cast<int>(parallel.size()),
+        [&parallel](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                parallel[i].setValue(Coord(30, i), 1);
+            }
+        },
+        1
+    );
+    MDN_CHECK(a.toStringRows() == original);
+    for (int i = 0; i < static_cast<int>(parallel.size()); ++i) {
+        MDN_CHECK(parallel[i].getValue(Coord(30, i)) == 1);
+        MDN_CHECK(parallel[i].getValue(Coord(30, (i + 1) % 16)) == 0);
+    }
+    return mdn::test::result();
+}
@@ -0,0 +1,135 @@
+// getDensityMap: every cell's density and sign balance match a brute-force count over the
+//  window, for windows covering the number, cutting through it or missing it, and uneven cells
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Number of ways map differs from a count of every coordinate in window
+static int checkMap(const Mdn2d& a, const Rect& window, int cols, int rows) {
+    const DensityMap map = a.getDensityMap(window, cols, rows);
+    const int width = window.width();
+    const int height = window.height();
+    const int nCols = std::min(cols, width);
+    const int nRows = std::min(rows, height);
+    int wrong = 0;
+    wrong += map.cols != nCols || map.rows != nRows;
+    wrong += map.density.size() != std::size_t(nCols*nRows);
+    wrong += map.balance.size() != std::size_t(nCols*nRows);
+    wrong += map.window.min() != window.min() || map.window.max() != window.max();
+    if (wrong) {
+        return wrong;
+    }
+
+    // Cell of each coordinate, by its offset into the window, row 0 at the top
+    std::vector<int> area(nCols*nRows, 0);
+    std::vector<int> positive(nCols*nRows, 0);
+    std::vector<int> negative(nCols*nRows, 0);
+    for (int y = window.min().y(); y <= window.max().y(); ++y) {
+        for (int x = window.min().x(); x <= window.max().x(); ++x) {
+            const int col = (x - window.min().x())*nCols/width;
+            const int row = (window.max().y() - y)*nRows/height;
+            const int i = row*nCols + col;
+            ++area[i];
+            const Digit d = a.getValue(Coord(x, y));
+            positive[i] += d > 0;
+            negative[i] += d < 0;
+        }
+    }
+    for (int row = 0; row < nRows; ++row) {
+        for (int col = 0; col < nCols; ++col) {
+            const int i = row*nCols + col;
+            const std::size_t mi = map.index(col, row);
+            const int count = positive[i] + negative[i];
+            const float density = float(count)/area[i];
+            const float balance = count ? float(positive[i] - negative[i])/count : 0.0f;
+            wrong += std::fabs(map.density[mi] - density) > 1e-6f;
+            wrong += std::fabs(map.balance[mi] - balance) > 1e-6f;
+            wrong += map.density[mi] < 0.0f || map.density[mi] > 1.0f;
+        }
+    }
+    return wrong;
+}
+
+static void testRandom(std::mt19937& rng) {
+    for (int trial = 0; trial < 40; ++trial) {
+        Mdn2d a(Mdn2dConfig(10), "a");
+        const int span = 10 + int(rng() % 30);
+        const int nDigits = int(rng() % (span*span/2 + 1));
+        for (int i = 0; i < nDigits; ++i) {
+            const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/3);
+            a.setValue(xy, Digit(int(rng() % 19) - 9));
+        }
+
+        int wrong = 0;
+        for (int w = 0; w < 6; ++w) {
+            // Windows covering the whole number, cutting through it, or beside it
+            Rect window;
+            if (w == 0 && a.hasBounds()) {
+                window = a.bounds();
+            } else if (w == 1) {
+                window = Rect(-span, -span, span, span);
+            } else if (w == 5) {
+                window = Rect(2*span, 0, 3*span, span/2);
+            } else {
+                const int x0 = int(rng() % span) - span/2;
+                const int y0 = int(rng() % span) - span/2;
+                window = Rect(x0, y0, x0 + 1 + int(rng() % span), y0 + int(rng() % span));
+            }
+            if (!window.isValid()) {
+                continue;
+            }
+            // Even and uneven divisions, and more cells than coordinates
+            for (const auto& [cols, rows] : {
+                std::pair<int, int>(1, 1), {3, 2}, {7, 5}, {window.width(), window.height()},
+                {window.width() + 3, 2*window.height()}
+            }) {
+                wrong += checkMap(a, window, cols, rows);
+            }
+        }
+        MDN_CHECK(wrong == 0);
+    }
+}
+
+static void testEdges() {
+    Mdn2d a(Mdn2dConfig(10), "a");
+
+    // An empty number gives an all-zero map
+    MDN_CHECK(checkMap(a, Rect(0, 0, 9, 9), 3, 3) == 0);
+    const DensityMap blank = a.getDensityMap(Rect(0, 0, 9, 9), 3, 3);
+    for (float d : blank.density) {
+        MDN_CHECK(d == 0.0f);
+    }
+
+    // An invalid window or no cells gives an empty map
+    a.setValue(Coord(1, 1), 4);
+    MDN_CHECK(a.getDensityMap(Rect::GetInvalid(), 4, 4).empty());
+    MDN_CHECK(a.getDensityMap(Rect(0, 0, 3, 3), 0, 4).empty());
+    MDN_CHECK(a.getDensityMap(Rect(0, 0, 3, 3), 4, -1).empty());
+
+    // The top row comes first, its two digits of opposite sign balance out
+    a.setValue(Coord(0, 1), -2);
+    a.setValue(Coord(0, 0), 7);
+    const DensityMap map = a.getDensityMap(Rect(0, 0, 1, 1), 1, 2);
+    MDN_CHECK(map.cols == 1 && map.rows == 2);
+    MDN_CHECK(map.density[map.index(0, 0)] == 1.0f);
+    MDN_CHECK(map.balance[map.index(0, 0)] == 0.0f);
+    MDN_CHECK(map.density[map.index(0, 1)] == 0.5f);
+    MDN_CHECK(map.balance[map.index(0, 1)] == 1.0f);
+    MDN_CHECK(checkMap(a, Rect(0, 0, 1, 1), 1, 2) == 0);
+}
+
+int main() {
+    std::mt19937 rng(46);
+    testRandom(rng);
+    testEdges();
+    return mdn::test::result();
+}
@@ -0,0 +1,145 @@
+// DigitJournal undo / redo: every step undone and redone restores the number exactly, and
+//  spilled steps keep the temporary file compact
+
+#include <random>
+#include <vector>
+
+#include <mdn/DigitJournal.hpp>
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static bool sameDigits(const Mdn2d& a, const Mdn2d& b) {
+    for (int y = -30; y <= 30; ++y) {
+        for (int x = -30; x <= 30; ++x) {
+            if (a.getValue(Coord(x, y)) != b.getValue(Coord(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Undo walks back through snapshots taken after each operation, redo walks forward again
+static void testUndoRedo(std::mt19937& rng) {
+    Mdn2dConfig config(10, 40, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d a(config, "a");
+    Mdn2d b(config, "b");
+    for (int j = 0; j < 40; ++j) {
+        a.setValue(
+            Coord(static_cast<int>(rng() % 8) - 4, static_cast<int>(rng() % 8) - 4),
+            static_cast<int>(rng() % 10)
+        );
+        b.setValue(
+            Coord(static_cast<int>(rng() % 6) - 3, static_cast<int>(rng() % 6) - 3),
+            static_cast<int>(rng() % 10)
+        );
+    }
+    a.enableJournal();
+    MDN_CHECK(a.journalEnabled() && !a.canUndo() && !a.canRedo());
+
+    std::vector<Mdn2d> snapshots;
+    snapshots.emplace_back(a, "s0");
+    a.setValue(Coord(1, 1), 7);
+    snapshots.emplace_back(a, "s1");
+    a *= b;
+    snapshots.emplace_back(a, "s2");
+    a.clear();
+    snapshots.emplace_back(a, "s3");
+    a = b;
+    snapshots.emplace_back(a, "s4");
+    a.shiftRight(3);
+    snapshots.emplace_back(a, "s5");
+
+    for (int i = 4; i >= 0; --i) {
+        MDN_CHECK(a.undo());
+        MDN_CHECK(sameDigits(a, snapshots[i]));
+    }
+    MDN_CHECK(!a.undo());
+    for (int i = 1; i <= 5; ++i) {
+        MDN_CHECK(a.redo());
+        MDN_CHECK(sameDigits(a, snapshots[i]));
+    }
+    MDN_CHECK(!a.redo());
+
+    // A new change drops the redo history
+    a.undo();
+    a.undo();
+    a.setValue(Coord(0, 0), 3);
+    MDN_CHECK(!a.canRedo());
+    a.undo();
+    MDN_CHECK(sameDigits(a, snapshots[3]));
+
+    // The answer of a binary operation records its own step
+    Mdn2d c(config, "c");
+    c.enableJournal();
+    c.setValue(Coord(2, 2), 4);
+    const Mdn2d before(c, "before");
+    a.plus(b, c);
+    MDN_CHECK(c.undo());
+    MDN_CHECK(sameDigits(c, before));
+}
+
+// Steps spilled to the temporary file undo as well as those in memory
+static void testSpilledUndo() {
+    Mdn2dConfig config(10, 40, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d d(config, "d");
+    d.enableJournal(64, 32, 1000);
+    std::vector<Mdn2d> snapshots;
+    snapshots.emplace_back(d, "snap");
+    for (int k = 0; k < 40; ++k) {
+        d.setValue(Coord(k % 9 - 4, k / 9), k % 9 + 1);
+        snapshots.emplace_back(d, "snap");
+    }
+    for (int k = 39; k >= 0; --k) {
+        MDN_CHECK(d.undo());
+        MDN_CHECK(sameDigits(d, snapshots[k]));
+    }
+    for (int k = 1; k <= 40; ++k) {
+        MDN_CHECK(d.redo());
+        MDN_CHECK(sameDigits(d, snapshots[k]));
+    }
+}
+
+// Dropped steps never leave the file more dead than live, and compacted steps still decode
+static void testCompaction() {
+    DigitJournal journal(1 << 20, 0, 4);
+    for (int k = 0; k < 100; ++k) {
+        for (int i = 0; i <= k % 7; ++i) {
+            journal.record(Coord(i, k), 0, static_cast<Digit>(1 + k % 9));
+        }
+        journal.seal();
+        MDN_CHECK(journal.memoryBytes() == 0);
+        MDN_CHECK(journal.fileBytes() <= 2*journal.spilledBytes());
+    }
+    MDN_CHECK(journal.undoSize() == 4);
+
+    // Dropping the redo history leaves dead space too
+    DigitJournal::Writes writes;
+    journal.takeUndo(writes);
+    journal.takeUndo(writes);
+    journal.takeUndo(writes);
+    journal.record(Coord(0, -1), 0, 5);
+    journal.seal();
+    MDN_CHECK(journal.redoSize() == 0);
+    MDN_CHECK(journal.fileBytes() <= 2*journal.spilledBytes());
+
+    MDN_CHECK(journal.takeUndo(writes));
+    MDN_CHECK(writes.size() == 1 && writes[0].first == Coord(0, -1) && writes[0].second == 0);
+    MDN_CHECK(journal.takeUndo(writes));
+    // Step 96, the oldest left, wrote digits 0 to 96 % 7 of row 96
+    MDN_CHECK(writes.size() == 96 % 7 + 1);
+    MDN_CHECK(writes[0].first == Coord(0, 96) && writes[0].second == 0);
+    MDN_CHECK(journal.takeRedo(writes));
+    MDN_CHECK(writes.size() == 96 % 7 + 1 && writes.back().second == 1 + 96 % 9);
+}
+
+int main() {
+    std::mt19937 rng(44);
+    testUndoRedo(rng);
+    testSpilledUndo();
+    testCompaction();
+    return mdn::test::result();
+}
@@ -0,0 +1,211 @@
+// DigitPyramid: tile counts, sign balance, maxima - including stale ones recomputed after their
+//  largest digit went - and polymorphic counts match a brute-force tally after random edits,
+//  negations and lazily built levels, directly and through Mdn2d::getOverview
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <utility>
+
+#include <mdn/DigitPyramid.hpp>
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+using Digits = std::map<std::pair<int, int>, Digit>;
+
+static int floorDiv(int a, int b) {
+    return a >= 0 ? a/b : -((-a + b - 1)/b);
+}
+
+// Number of ways view differs from a tally of digits, and nodes, over its tiles
+static int checkOverview(const Overview& view, const Rect& window, const Digits& digits,
+    const CoordSet& nodes
+) {
+    const int size = view.tileSize;
+    int wrong = view.tileSize != DigitPyramid::static_tileSize(view.level);
+    const Rect tiles(
+        floorDiv(window.min().x(), size), floorDiv(window.min().y(), size),
+        floorDiv(window.max().x(), size), floorDiv(window.max().y(), size)
+    );
+    wrong += view.tiles.min() != tiles.min() || view.tiles.max() != tiles.max();
+    wrong += view.cells.size() != std::size_t(tiles.width())*tiles.height();
+    if (wrong) {
+        return wrong;
+    }
+    std::vector<OverviewTile> expected(view.cells.size());
+    auto cellOf = [&](int x, int y) -> OverviewTile* {
+        const int tx = floorDiv(x, size);
+        const int ty = floorDiv(y, size);
+        if (!tiles.contains(Coord(tx, ty))) {
+            return nullptr;
+        }
+        return &expected[view.index(tx - tiles.min().x(), tiles.max().y() - ty)];
+    };
+    for (const auto& [xy, digit] : digits) {
+        if (OverviewTile* cell = digit ? cellOf(xy.first, xy.second) : nullptr) {
+            ++cell->nonZero;
+            cell->balance += digit > 0 ? 1 : -1;
+            cell->maxMagnitude = std::max(cell->maxMagnitude, std::abs(int(digit)));
+        }
+    }
+    for (const Coord& xy : nodes) {
+        if (OverviewTile* cell = cellOf(xy.x(), xy.y())) {
+            ++cell->polymorphic;
+        }
+    }
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        wrong += view.cells[i].nonZero != expected[i].nonZero;
+        wrong += view.cells[i].balance != expected[i].balance;
+        wrong += view.cells[i].maxMagnitude != expected[i].maxMagnitude;
+        wrong += view.cells[i].polymorphic != expected[i].polymorphic;
+    }
+    return wrong;
+}
+
+static void testRandomEdits(std::mt19937& rng) {
+    for (int trial = 0; trial < 10; ++trial) {
+        DigitPyramid pyramid;
+        Digits digits;
+        CoordSet nodes;
+        auto digitAt = [&digits](const Coord& xy) {
+            auto it = digits.find({xy.x(), xy.y()});
+            return it == digits.end() ? Digit(0) : it->second;
+        };
+        const int span = 40 + int(rng() % 80);
+        int wrong = 0;
+        int built = 1;
+        MDN_CHECK(pyramid.levels() == 1);
+        for (int round = 0; round < 40; ++round) {
+            for (int i = 0; i < 60; ++i) {
+                const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+                const Digit old = digitAt(xy);
+                // Shrinking a digit, or clearing it, leaves its tile's maximum stale
+                Digit d;
+                switch (rng() % 4) {
+                    case 0: d = 0; break;
+                    case 1: d = Digit(old/2); break;
+                    default: d = Digit(int(rng() % 19) - 9); break;
+                }
+                pyramid.change(xy, old, d);
+                digits[{xy.x(), xy.y()}] = d;
+            }
+            if (round % 9 == 4) {
+                pyramid.negate();
+                for (auto& [xy, digit] : digits) {
+                    digit = Digit(-digit);
+                }
+            }
+            // Polymorphic nodes sit on non-zero digits, and are replaced after every change
+            nodes.clear();
+            for (const auto& [xy, digit] : digits) {
+                if (digit && rng() % 4 == 0) {
+                    nodes.insert(Coord(xy.first, xy.second));
+                }
+            }
+            pyramid.setPolymorphic(nodes, round);
+            wrong += pyramid.polymorphicEvent() != round;
+
+            // Levels are only built when asked for, and then kept up to date
+            const int level = int(rng() % 7);
+            const int x0 = int(rng() % span) - span/2 - 8;
+            const int y0 = int(rng() % span) - span/2 - 8;
+            const Rect window(x0, y0, x0 + int(rng() % span), y0 + int(rng() % span));
+            wrong += checkOverview(pyramid.overview(window, level, digitAt), window, digits, nodes);
+            built = std::max(built, level + 1);
+            wrong += pyramid.levels() != built;
+            const Rect all(-span, -span, span, span);
+            for (int l = 0; l < built; ++l) {
+                wrong += checkOverview(pyramid.overview(all, l, digitAt), all, digits, nodes);
+            }
+        }
+        MDN_CHECK(wrong == 0);
+    }
+}
+
+static void testStaleMax() {
+    DigitPyramid pyramid;
+    Digits digits;
+    auto digitAt = [&digits](const Coord& xy) {
+        auto it = digits.find({xy.x(), xy.y()});
+        return it == digits.end() ? Digit(0) : it->second;
+    };
+    auto set = [&](int x, int y, Digit d) {
+        pyramid.change(Coord(x, y), digitAt(Coord(x, y)), d);
+        digits[{x, y}] = d;
+    };
+    // One level 2 tile, 16 digits across, with its largest digit in one corner
+    set(0, 0, 9);
+    set(15, 15, -4);
+    set(5, 9, 2);
+    const Rect window(0, 0, 15, 15);
+    MDN_CHECK(pyramid.overview(window, 2, digitAt).cells.at(0).maxMagnitude == 9);
+
+    // Removing the 9 leaves the tile's maximum at every level to be found again
+    set(0, 0, 1);
+    MDN_CHECK(pyramid.overview(window, 2, digitAt).cells.at(0).maxMagnitude == 4);
+    set(15, 15, 0);
+    MDN_CHECK(pyramid.overview(window, 2, digitAt).cells.at(0).maxMagnitude == 2);
+    const Overview fine = pyramid.overview(window, 0, digitAt);
+    MDN_CHECK(fine.cells.at(fine.index(0, 3)).maxMagnitude == 1);
+    MDN_CHECK(checkOverview(fine, window, digits, {}) == 0);
+    MDN_CHECK(checkOverview(pyramid.overview(window, 1, digitAt), window, digits, {}) == 0);
+
+    // An emptied tile is dropped
+    set(0, 0, 0);
+    set(5, 9, 0);
+    MDN_CHECK(pyramid.overview(window, 2, digitAt).cells.at(0).nonZero == 0);
+    MDN_CHECK(pyramid.overview(window, 2, digitAt).cells.at(0).maxMagnitude == 0);
+}
+
+static void testLevelFor() {
+    const Rect window(-100, 7, 300, 40);
+    for (int maxCols : {1, 4, 30}) {
+        const int level = DigitPyramid::static_levelFor(window, maxCols, 3);
+        auto fits = [&](int l) {
+            const int size = DigitPyramid::static_tileSize(l);
+            return floorDiv(300, size) - floorDiv(-100, size) < maxCols
+                && floorDiv(40, size) - floorDiv(7, size) < 3;
+        };
+        // maxLevel when no level fits, as tiles either side of zero never merge
+        MDN_CHECK(fits(level) || (level == DigitPyramid::maxLevel && maxCols == 1));
+        MDN_CHECK(level == 0 || !fits(level - 1));
+    }
+    MDN_CHECK(DigitPyramid::static_levelFor(Rect::GetInvalid(), 4, 4) == 0);
+}
+
+// Mdn2d keeps its pyramid in step with its digits, including those a cleanup moves
+static void testThroughMdn2d(std::mt19937& rng) {
+    Mdn2d a(Mdn2dConfig(10, -1, SignConvention::Positive), "a");
+    const Rect window(-40, -35, 37, 31);
+    int wrong = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 40; ++i) {
+            const Coord xy(int(rng() % 60) - 30, int(rng() % 60) - 30);
+            a.setValue(xy, rng() % 3 ? Digit(int(rng() % 19) - 9) : Digit(0));
+        }
+        if (round % 7 == 3) {
+            a.multiply(-1);
+        }
+        Digits digits;
+        for (int y = window.min().y(); y <= window.max().y(); ++y) {
+            for (int x = window.min().x(); x <= window.max().x(); ++x) {
+                digits[{x, y}] = a.getValue(Coord(x, y));
+            }
+        }
+        wrong += checkOverview(a.getOverview(window, round % 4), window, digits, {});
+    }
+    MDN_CHECK(wrong == 0);
+}
+
+int main() {
+    std::mt19937 rng(47);
+    testRandomEdits(rng);
+    testStaleMax();
+    testLevelFor();
+    testThroughMdn2d(rng);
+    return mdn::test::result();
+}
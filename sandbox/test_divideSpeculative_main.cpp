@@ -0,0 +1,70 @@
+// Speculative division keeps the best state reached by any strategy, so it is never worse than
+//  dividing with the alternating (default) fraxis over the same number of iterations
+
+#include <random>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Compares divideSpeculative with divideIterate along Fraxis::Default
+static void check(const Mdn2d& a, const Mdn2d& b, int nIters, int stallIters) {
+    const Mdn2dConfig& config = a.config();
+    Mdn2d ansDefault = Mdn2d::NewInstance(config, "ansDefault");
+    Mdn2d remDefault(a, "remDefault");
+    long double magDefault = -1.0;
+    a.divideIterate(nIters, b, ansDefault, remDefault, magDefault, Fraxis::Default);
+
+    Mdn2d ans = Mdn2d::NewInstance(config, "ans");
+    Mdn2d rem(a, "rem");
+    long double mag = -1.0;
+    const Fraxis fraxis = a.divideSpeculative(nIters, b, ans, rem, mag, stallIters);
+    if (magDefault >= 0.0) {
+        MDN_CHECK(fraxis != Fraxis::Invalid);
+        MDN_CHECK(mag >= 0.0 && mag <= magDefault);
+        // rem and remMag come from the same iteration
+        MDN_CHECK(rem.getTotalMagnitude() == mag);
+    }
+}
+
+int main() {
+    // A case where the last state of a strategy is far from its best
+    {
+        Mdn2dConfig config(10, 16, SignConvention::Positive, 20, Fraxis::X);
+        Mdn2d a = Mdn2d::NewInstance(config, "a");
+        Mdn2d b = Mdn2d::NewInstance(config, "b");
+        a.setValue(Coord(0, 0), 7);
+        a.setValue(Coord(1, 0), 3);
+        a.setValue(Coord(0, 1), 2);
+        b.setValue(Coord(0, 0), 3);
+        b.setValue(Coord(1, 1), 1);
+        for (int stallIters : {1, 8, 1000}) {
+            check(a, b, 20, stallIters);
+        }
+    }
+    std::mt19937 rng(39);
+    for (int base : {2, 10, 16}) {
+        for (int c = 0; c < 4; ++c) {
+            Mdn2dConfig config(base, 16, SignConvention::Positive, 20, Fraxis::X);
+            Mdn2d a = Mdn2d::NewInstance(config, "a");
+            Mdn2d b = Mdn2d::NewInstance(config, "b");
+            const int span = 2*base - 1;
+            for (int k = 0; k < 12; ++k) {
+                const Coord xy(static_cast<int>(rng() % 6) - 3, static_cast<int>(rng() % 6) - 3);
+                a.setValue(xy, static_cast<int>(rng() % span) - (base - 1));
+            }
+            for (int k = 0; k < 5; ++k) {
+                const Coord xy(static_cast<int>(rng() % 3) - 1, static_cast<int>(rng() % 3) - 1);
+                b.setValue(xy, static_cast<int>(rng() % span) - (base - 1));
+            }
+            if (b.getTotalMagnitude() == 0) {
+                b.setValue(Coord(0, 0), 1);
+            }
+            check(a, b, 10, 2);
+            check(a, b, 20, 8);
+        }
+    }
+    return mdn::test::result();
+}
@@ -0,0 +1,108 @@
+// ExactValue arithmetic, and the exact row, column and total values of an Mdn2d
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <mdn/ExactValue.hpp>
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static bool near(long double a, long double b, long double tolerance) {
+    return std::fabs(a - b) <= tolerance*std::max<long double>(1, std::fabs(b));
+}
+
+// Sums, signs and comparisons are exact however far apart the exponents are
+static void testArithmetic() {
+    ExactValue::Terms bigTerms = {{60, 1}, {0, 1}};
+    ExactValue big = ExactValue::static_fromDigits(10, bigTerms);
+    ExactValue::Terms hugeTerms = {{60, -1}};
+    const ExactValue huge = ExactValue::static_fromDigits(10, hugeTerms);
+    MDN_CHECK(big.compareMagnitude(huge) > 0);
+    MDN_CHECK(huge.compare(big) < 0);
+    big += huge;
+    MDN_CHECK(big.toLongDouble() == 1.0L);
+    MDN_CHECK(big.sign() == 1);
+
+    ExactValue::Terms fractionTerms = {{-3, 5}, {-1, 2}};
+    ExactValue fraction = ExactValue::static_fromDigits(10, fractionTerms);
+    MDN_CHECK(fraction.toString() == "205 x 10^-3");
+    fraction.negate();
+    MDN_CHECK(fraction.sign() == -1);
+    MDN_CHECK(fraction.abs().sign() == 1);
+    ExactValue sum = fraction;
+    sum += fraction.abs();
+    MDN_CHECK(sum.isZero());
+    MDN_CHECK(sum.compare(ExactValue(10)) == 0);
+
+    ExactValue::Terms tinyTerms = {{-16000, 1}, {-16001, 1}};
+    const ExactValue tiny = ExactValue::static_fromDigits(2, tinyTerms);
+    MDN_CHECK(tiny.toLongDouble() == std::ldexp(3.0L, -16001));
+
+    // 10^e is subnormal, with only a few digits left, yet the value, about 10^(e+30), is normal
+    //  and keeps full precision
+    const int e = std::numeric_limits<long double>::min_exponent10 - 12;
+    ExactValue::Terms smallTerms = {{e + 30, 1}, {e, 1}};
+    const ExactValue small = ExactValue::static_fromDigits(10, smallTerms);
+    const long double expected = std::pow(10.0L, static_cast<long double>(e + 30));
+    MDN_CHECK(std::isnormal(expected));
+    MDN_CHECK(std::fabs(small.toLongDouble() - expected) <= 1e-13L*expected);
+}
+
+// Row, column and total values match a direct sum over the digits, and follow later writes
+static void testNumberValues(std::mt19937& rng) {
+    for (int base : {2, 3, 10, 16, 32}) {
+        Mdn2dConfig config(base, 200, SignConvention::Positive, 20, Fraxis::X);
+        Mdn2d a = Mdn2d::NewInstance(config, "a");
+        for (int k = 0; k < 200; ++k) {
+            const Coord xy(static_cast<int>(rng() % 30) - 15, static_cast<int>(rng() % 30) - 15);
+            a.setValue(xy, static_cast<int>(rng() % (2*base - 1)) - (base - 1));
+        }
+        const long double b = base;
+        long double total = 0;
+        long double magnitude = 0;
+        for (int y = -15; y < 15; ++y) {
+            long double row = 0;
+            for (int x = -15; x < 15; ++x) {
+                row += a.getValue(Coord(x, y))*std::pow(b, x);
+            }
+            MDN_CHECK(near(a.getRowValue(Coord(0, y)), row, 1e-14L));
+            total += row;
+            magnitude += std::fabs(row);
+        }
+        for (int x = -15; x < 15; ++x) {
+            long double col = 0;
+            for (int y = -15; y < 15; ++y) {
+                col += a.getValue(Coord(x, y))*std::pow(b, y);
+            }
+            MDN_CHECK(near(a.getColValue(Coord(x, 0)), col, 1e-14L));
+        }
+        MDN_CHECK(near(a.getTotalValue(), total, 1e-12L));
+        MDN_CHECK(a.getTotalValue() == a.getTotalExact().toLongDouble());
+        MDN_CHECK(near(a.getTotalMagnitude(), magnitude, 1e-12L));
+
+        // Cached values are dropped by writes
+        a.setValue(Coord(14, 0), 1);
+        total = 0;
+        for (int y = -15; y < 15; ++y) {
+            for (int x = -15; x < 15; ++x) {
+                total += a.getValue(Coord(x, y))*std::pow(b, x);
+            }
+        }
+        MDN_CHECK(near(a.getTotalValue(), total, 1e-12L));
+        a.clear();
+        MDN_CHECK(a.getTotalValue() == 0);
+        MDN_CHECK(a.getTotalExact().isZero());
+    }
+}
+
+int main() {
+    std::mt19937 rng(3);
+    testArithmetic();
+    testNumberValues(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,206 @@
+// Fingerprint and equality: the cached canonical form follows edits, equality of numbers in
+//  different digit forms matches a cleanup from scratch, and a number equals itself
+
+#include <random>
+#include <string>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static void fill(Mdn2d& a, std::mt19937& rng, int nDigits, int span) {
+    const int base = a.config().base();
+    for (int i = 0; i < nDigits; ++i) {
+        const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+        a.setValue(xy, Digit(int(rng() % (2*base - 1)) - (base - 1)));
+    }
+}
+
+// Same digits in the same places
+static bool sameDigits(const Mdn2d& a, const Mdn2d& b) {
+    const Rect bounds = Rect::UnionOf(a.bounds(), b.bounds());
+    if (!bounds.isValid()) {
+        return true;
+    }
+    VecVecDigit rowsA;
+    VecVecDigit rowsB;
+    a.getAreaRows(bounds, rowsA);
+    b.getAreaRows(bounds, rowsB);
+    return rowsA == rowsB;
+}
+
+// Equality as operator== did before the cache: polymorphic numbers are cleaned up under the
+//  positive sign convention, from scratch, and their digits compared
+static bool reference(const Mdn2d& a, const Mdn2d& b) {
+    if (a.config() != b.config()) {
+        return false;
+    }
+    const SignConvention sc = a.config().signConvention();
+    if (sc == SignConvention::Positive || sc == SignConvention::Negative) {
+        return sameDigits(a, b);
+    }
+    Mdn2dConfig positive(a.config());
+    positive.setSignConvention(SignConvention::Positive);
+    Mdn2d ca(a, "ca");
+    Mdn2d cb(b, "cb");
+    ca.setConfig(positive);
+    cb.setConfig(positive);
+    return sameDigits(ca, cb);
+}
+
+// a, moved into another digit form of the same value by optional carryovers
+static Mdn2d reshaped(const Mdn2d& a, std::mt19937& rng, int span) {
+    Mdn2d b(a, "reshaped");
+    int done = 0;
+    for (int i = 0; i < 200 && done < 4; ++i) {
+        const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+        const Carryover co = b.checkCarryover(xy);
+        if (co == Carryover::OptionalPositive || co == Carryover::OptionalNegative) {
+            b.carryover(xy);
+            ++done;
+        }
+    }
+    return b;
+}
+
+static void testDigitForms(std::mt19937& rng) {
+    // One carryover apart: 3 at the origin is -7 with a 1 to its right and a 1 above
+    Mdn2dConfig neutral(10, -1, SignConvention::Neutral);
+    Mdn2d three(neutral, "three");
+    three.setValue(COORD_ORIGIN, 3);
+    Mdn2d carried(neutral, "carried");
+    carried.setValue(COORD_ORIGIN, -7);
+    carried.setValue(Coord(1, 0), 1);
+    carried.setValue(Coord(0, 1), 1);
+    MDN_CHECK(three == carried);
+    MDN_CHECK(three.fingerprint() == carried.fingerprint());
+
+    // Under a fixed sign convention the digits themselves are compared
+    Mdn2dConfig positive(10, -1, SignConvention::Positive);
+    Mdn2d threeP(positive, "threeP");
+    threeP.setValue(COORD_ORIGIN, 3);
+    Mdn2d carriedP(positive, "carriedP");
+    carriedP.setValue(COORD_ORIGIN, -7);
+    carriedP.setValue(Coord(1, 0), 1);
+    carriedP.setValue(Coord(0, 1), 1);
+    MDN_CHECK(threeP != carriedP);
+
+    // Random forms, cached equality and fingerprints agree with the reference.  The positive
+    //  cleanup is not a unique normal form, so a few equal values still compare unequal.
+    int nDiffer = 0;
+    int nEqual = 0;
+    int wrong = 0;
+    for (int base : {2, 3, 10, 16, 32}) {
+        for (int trial = 0; trial < 20; ++trial) {
+            Mdn2d a(Mdn2dConfig(base, -1, SignConvention::Neutral), "a");
+            fill(a, rng, 25, 8);
+            const Mdn2d b = reshaped(a, rng, 8);
+            const bool expected = reference(a, b);
+            nDiffer += !sameDigits(a, b);
+            nEqual += expected && !sameDigits(a, b);
+            wrong += (a == b) != expected;
+            wrong += (a != b) == expected;
+            wrong += (a.fingerprint() == b.fingerprint()) != expected;
+
+            // A different value differs, in equality and in fingerprint
+            Mdn2d c(b, "c");
+            const Coord xy(9, 9);
+            c.setValue(xy, Digit(c.getValue(xy) == 1 ? 2 : 1));
+            wrong += a == c;
+            wrong += a.fingerprint() == c.fingerprint();
+        }
+    }
+    MDN_CHECK(wrong == 0);
+    // The forms really did differ, and mostly compare equal
+    MDN_CHECK(nDiffer > 60);
+    MDN_CHECK(nEqual > 60);
+}
+
+static void testInvalidation(std::mt19937& rng) {
+    Mdn2d a(Mdn2dConfig(10, -1, SignConvention::Neutral), "a");
+    fill(a, rng, 30, 10);
+    const Mdn2d original(a, "original");
+    const Fingerprint f0 = a.fingerprint();
+    const Coord xy(2, -3);
+    const Digit d = a.getValue(xy);
+
+    // Fingerprint and equality follow every edit, and come back with the digits
+    a.setValue(xy, Digit(d == 5 ? 6 : 5));
+    MDN_CHECK(a.fingerprint() != f0);
+    MDN_CHECK(a != original);
+    a.setValue(xy, d);
+    MDN_CHECK(a.fingerprint() == f0);
+    MDN_CHECK(a == original);
+
+    // Negation flips cached line values in place, the canonical form must still go
+    a.multiply(-1);
+    MDN_CHECK(a.fingerprint() != f0);
+    MDN_CHECK(a != original);
+    a.multiply(-1);
+    MDN_CHECK(a.fingerprint() == f0);
+    MDN_CHECK(a == original);
+
+    // Region operations, then assignment
+    a.shiftRegion(Rect(-1, -1, 1, 1), Coord(1, 0));
+    MDN_CHECK(a.fingerprint() != f0);
+    MDN_CHECK(a != original);
+    a = original;
+    MDN_CHECK(a.fingerprint() == f0);
+    MDN_CHECK(a == original);
+
+    // Config changes, a different config is never equal
+    Mdn2d b(original, "b");
+    Mdn2dConfig positive(original.config());
+    positive.setSignConvention(SignConvention::Positive);
+    b.setConfig(positive);
+    MDN_CHECK(b != original);
+    b.setConfig(original.config());
+    MDN_CHECK((b == original) == reference(b, original));
+    MDN_CHECK((b.fingerprint() == f0) == reference(b, original));
+
+    // Clearing
+    a.clear();
+    MDN_CHECK(a.fingerprint() == Fingerprint());
+    MDN_CHECK(a != original);
+    MDN_CHECK(a == Mdn2d(original.config(), "empty"));
+}
+
+static void testSelf(std::mt19937& rng) {
+    for (SignConvention sc : {SignConvention::Neutral, SignConvention::Positive}) {
+        Mdn2d a(Mdn2dConfig(16, -1, sc), "a");
+        MDN_CHECK(a == a);
+        fill(a, rng, 40, 12);
+        MDN_CHECK(a == a);
+        MDN_CHECK(!(a != a));
+        const Fingerprint f = a.fingerprint();
+        MDN_CHECK(a == a);
+        MDN_CHECK(a.fingerprint() == f);
+        a.setValue(Coord(20, 20), 3);
+        MDN_CHECK(a == a);
+        MDN_CHECK(a.fingerprint() != f);
+
+        // Shared digits, then the same digits held separately
+        const Mdn2d copy(a, "copy");
+        MDN_CHECK(copy == a);
+        Mdn2d deep(a.config(), "deep");
+        const Rect bounds = a.bounds();
+        for (int y = bounds.min().y(); y <= bounds.max().y(); ++y) {
+            for (int x = bounds.min().x(); x <= bounds.max().x(); ++x) {
+                deep.setValue(Coord(x, y), a.getValue(Coord(x, y)));
+            }
+        }
+        MDN_CHECK(deep == a);
+        MDN_CHECK(a == deep);
+        MDN_CHECK(deep.fingerprint() == a.fingerprint());
+    }
+}
+
+int main() {
+    std::mt19937 rng(42);
+    testDigitForms(rng);
+    testInvalidation(rng);
+    testSelf(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,196 @@
+// Line values: the cached row and column values, their ranking and the dirty-line refresh agree
+//  with a brute-force recompute after random edits, as do getRowMagMax and getColMagMax
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+struct Lines : Mdn2d {
+    using Mdn2d::Mdn2d;
+
+    // (line, value) in ranked order, ranking first if need be
+    std::vector<std::pair<int, ExactValue>> ranking(bool alongRow) const {
+        auto lock = lockReadOnly();
+        std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+        internal_refreshLines(alongRow, true);
+        const LineValues& lines = alongRow ? m_rowValues : m_colValues;
+        std::vector<std::pair<int, ExactValue>> result;
+        for (const auto& [magnitude, line] : lines.ranking) {
+            result.emplace_back(line, lines.values.at(line));
+        }
+        return result;
+    }
+
+    // Lines noted as changed and not yet refreshed
+    std::size_t nDirty(bool alongRow) const {
+        auto lock = lockReadOnly();
+        std::lock_guard<std::mutex> guard(m_valueCacheMutex);
+        return (alongRow ? m_rowValues : m_colValues).dirty.size();
+    }
+};
+
+// Every non-zero line's value, assembled from getValue
+static std::map<int, ExactValue> bruteLines(const Mdn2d& a, bool alongRow) {
+    std::map<int, ExactValue> result;
+    if (!a.hasBounds()) {
+        return result;
+    }
+    const Rect b = a.bounds();
+    const int lo = alongRow ? b.min().y() : b.min().x();
+    const int hi = alongRow ? b.max().y() : b.max().x();
+    for (int line = lo; line <= hi; ++line) {
+        ExactValue::Terms terms;
+        const int from = alongRow ? b.min().x() : b.min().y();
+        const int to = alongRow ? b.max().x() : b.max().y();
+        for (int i = from; i <= to; ++i) {
+            const Digit d = a.getValue(alongRow ? Coord(i, line) : Coord(line, i));
+            if (d) {
+                terms.emplace_back(i, d);
+            }
+        }
+        ExactValue value = ExactValue::static_fromDigits(a.config().base(), terms);
+        if (!value.isZero()) {
+            result.emplace(line, value);
+        }
+    }
+    return result;
+}
+
+// Number of ways the cached values and ranking differ from brute force
+static int checkLines(const Lines& a, bool alongRow) {
+    const std::map<int, ExactValue> expected = bruteLines(a, alongRow);
+    std::vector<std::pair<int, ExactValue>> order(expected.begin(), expected.end());
+    std::stable_sort(order.begin(), order.end(), [](const auto& l, const auto& r) {
+        const int cmp = l.second.compareMagnitude(r.second);
+        return cmp != 0 ? cmp > 0 : l.first > r.first;
+    });
+
+    int wrong = 0;
+    for (const auto& [line, value] : expected) {
+        const ExactValue got = alongRow ? a.getRowExact(line) : a.getColExact(line);
+        wrong += got.compare(value) != 0;
+    }
+    const std::vector<std::pair<int, ExactValue>> ranked = a.ranking(alongRow);
+    wrong += ranked.size() != order.size();
+    for (std::size_t i = 0; i < std::min(ranked.size(), order.size()); ++i) {
+        wrong += ranked[i].first != order[i].first;
+        wrong += ranked[i].second.compare(order[i].second) != 0;
+    }
+    wrong += a.nDirty(alongRow) != 0;
+    return wrong;
+}
+
+// getRowMagMax takes the largest row reaching the last column, higher y on a tie, and
+//  getColMagMax takes the last column itself
+static int checkMagMax(const Lines& a) {
+    Coord xy;
+    long double val;
+    if (!a.hasBounds()) {
+        return a.getRowMagMax(xy, val) + a.getColMagMax(xy, val);
+    }
+    const std::map<int, ExactValue> rows = bruteLines(a, true);
+    const std::map<int, ExactValue> cols = bruteLines(a, false);
+    const Rect b = a.bounds();
+    int xMax = b.min().x();
+    for (int x = b.min().x(); x <= b.max().x(); ++x) {
+        for (int y = b.min().y(); y <= b.max().y(); ++y) {
+            if (a.getValue(Coord(x, y))) {
+                xMax = x;
+            }
+        }
+    }
+    int pRow = 0;
+    const ExactValue* pVal = nullptr;
+    for (int y = b.min().y(); y <= b.max().y(); ++y) {
+        if (a.getValue(Coord(xMax, y)) && rows.count(y)) {
+            if (!pVal || rows.at(y).compareMagnitude(*pVal) >= 0) {
+                pVal = &rows.at(y);
+                pRow = y;
+            }
+        }
+    }
+
+    int wrong = 0;
+    wrong += !a.getRowMagMax(xy, val);
+    wrong += xy != Coord(xMax, pRow);
+    wrong += !pVal || val != pVal->toLongDouble();
+    wrong += !a.getColMagMax(xy, val);
+    wrong += xy.x() != xMax;
+    wrong += !cols.count(xMax) || val != cols.at(xMax).toLongDouble();
+    return wrong;
+}
+
+static void testRandomEdits(std::mt19937& rng) {
+    for (int base : {2, 3, 10, 16, 32}) {
+        Lines a(Mdn2dConfig(base, -1, SignConvention::Positive), "a");
+        const int span = 12;
+        int wrong = 0;
+        for (int round = 0; round < 60; ++round) {
+            // A handful of single-digit edits, some clearing digits, so few lines turn dirty
+            const int nEdits = round % 10 == 9 ? 200 : 1 + int(rng() % 6);
+            for (int i = 0; i < nEdits; ++i) {
+                const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+                const int d = rng() % 4 == 0 ? 0 : int(rng() % (2*base - 1)) - (base - 1);
+                a.setValue(xy, Digit(d));
+            }
+            switch (round % 7) {
+                case 3: a.multiply(-1); break;
+                case 5: a.negateRegion(Rect(-2, -2, 3, 1)); break;
+                default: break;
+            }
+            // Query in varying order, so both refresh paths - ranked and unranked - are used
+            if (round % 2) {
+                wrong += checkMagMax(a);
+                wrong += checkLines(a, true);
+                wrong += checkLines(a, false);
+            } else {
+                wrong += checkLines(a, false);
+                wrong += checkLines(a, true);
+                wrong += checkMagMax(a);
+            }
+        }
+        MDN_CHECK(wrong == 0);
+    }
+}
+
+// Edits after ranking only dirty their own lines, which the next reader refreshes
+static void testDirtyRefresh() {
+    Lines a(Mdn2dConfig(10, -1, SignConvention::Positive), "a");
+    for (int y = 0; y < 8; ++y) {
+        a.setValue(Coord(y, y), Digit(y + 1));
+    }
+    MDN_CHECK(checkLines(a, true) == 0);
+    a.setValue(Coord(0, 3), 9);
+    a.setValue(Coord(9, 3), 9);
+    MDN_CHECK(a.nDirty(true) == 2);
+    MDN_CHECK(a.ranking(true).front().first == 3);
+    MDN_CHECK(a.nDirty(true) == 0);
+    a.setValue(Coord(0, 3), 0);
+    a.setValue(Coord(9, 3), 0);
+    a.setValue(Coord(3, 3), 0);
+    const auto ranked = a.ranking(true);
+    MDN_CHECK(ranked.size() == 7);
+    MDN_CHECK(ranked.front().first == 7);
+    MDN_CHECK(checkLines(a, true) == 0);
+
+    // Clearing the number empties the ranking
+    a.clear();
+    MDN_CHECK(a.ranking(true).empty());
+    MDN_CHECK(checkMagMax(a) == 0);
+}
+
+int main() {
+    std::mt19937 rng(38);
+    testRandomEdits(rng);
+    testDirtyRefresh();
+    return mdn::test::result();
+}
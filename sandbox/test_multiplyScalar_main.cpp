@@ -0,0 +1,227 @@
+// Scalar multiply: the row sweep and its 0, 1 and -1 fast paths against the per-digit multiply it
+//  replaced, which added value*digit into a fresh number one digit at a time
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Carries keep sum(d*t^x*s^y) whenever t + s = base, checked here modulo a prime
+static const long long prime = 1000000007LL;
+
+static long long power(long long b, long long e) {
+    if (e < 0) {
+        b = power(b, prime - 2);
+        e = -e;
+    }
+    long long r = 1;
+    b %= prime;
+    while (e) {
+        if (e & 1) {
+            r = r*b % prime;
+        }
+        b = b*b % prime;
+        e >>= 1;
+    }
+    return r;
+}
+
+static long long invariant(const Mdn2d& a) {
+    const long long t = 1;
+    const long long s = a.config().base() - 1;
+    long long sum = 0;
+    if (!a.hasBounds()) {
+        return sum;
+    }
+    const Rect b = a.bounds();
+    for (int y = b.min().y(); y <= b.max().y(); ++y) {
+        for (int x = b.min().x(); x <= b.max().x(); ++x) {
+            const Digit d = a.getValue(Coord(x, y));
+            if (d) {
+                const long long w = power(t, x)*power(s, y) % prime;
+                sum = ((sum + d*w) % prime + prime) % prime;
+            }
+        }
+    }
+    return sum;
+}
+
+static long long times(long long k, long long v) {
+    return ((k % prime + prime) % prime)*v % prime;
+}
+
+// Positions of a's non-zero digits
+static CoordSet nonZero(const Mdn2d& a) {
+    CoordSet coords;
+    if (!a.hasBounds()) {
+        return coords;
+    }
+    const Rect b = a.bounds();
+    for (int y = b.min().y(); y <= b.max().y(); ++y) {
+        for (int x = b.min().x(); x <= b.max().x(); ++x) {
+            if (a.getValue(Coord(x, y))) {
+                coords.insert(Coord(x, y));
+            }
+        }
+    }
+    return coords;
+}
+
+// Number of digits still needing a carryover under the positive sign convention
+static int nRemaining(const Mdn2d& a) {
+    int n = 0;
+    if (!a.hasBounds()) {
+        return n;
+    }
+    const Rect b = a.bounds();
+    for (int y = b.min().y() - 1; y <= b.max().y(); ++y) {
+        for (int x = b.min().x() - 1; x <= b.max().x(); ++x) {
+            const Carryover co = a.checkCarryover(Coord(x, y));
+            n += co == Carryover::Required || co == Carryover::OptionalNegative;
+        }
+    }
+    return n;
+}
+
+struct Scalar : Mdn2d {
+    using Mdn2d::Mdn2d;
+
+    // Row sweep, without cleanup
+    CoordSet sweep(long long value) {
+        auto lock = lockWriteable();
+        CoordSet changed = locked_multiply(value);
+        internal_operationComplete();
+        return changed;
+    }
+
+    // The per-digit multiply the row sweep replaced, without cleanup
+    CoordSet perDigit(long long value) {
+        auto lock = lockWriteable();
+        Scalar temp(m_config, "temp");
+        CoordSet changed;
+        {
+            auto tempLock = temp.lockWriteable();
+            for (const auto& [xy, digit] : m_data->raw) {
+                changed.merge(temp.locked_add(xy, value*static_cast<long long>(digit)));
+            }
+        }
+        locked_operatorEquals(temp);
+        internal_operationComplete();
+        return changed;
+    }
+
+    // Cleanup over changed, as the public multiply does
+    void cleanup(const CoordSet& changed) {
+        carryoverCleanup(changed);
+    }
+};
+
+static void testAgainstPerDigit(std::mt19937& rng) {
+    for (int base : {2, 3, 7, 10, 16, 32}) {
+        for (int trial = 0; trial < 12; ++trial) {
+            Scalar a(Mdn2dConfig(base, -1, SignConvention::Positive), "a");
+            const int span = 4 + int(rng() % 12);
+            for (int i = 0; i < 3*span; ++i) {
+                const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+                a.setValue(xy, Digit(int(rng() % (2*base - 1)) - (base - 1)));
+            }
+            // Carries in bases 2 and 3 barely shrink as they spread, large factors would fill
+            //  memory, or take the per-digit path minutes
+            long long value;
+            switch (base < 7 ? 0 : trial % 4) {
+                case 0: value = int(rng() % 201) - 100; break;
+                case 1: value = (long long)(rng() % 1000000)*1000000 + rng() % 1000000; break;
+                case 2: value = -((long long)(rng() % 1000000)*1000000 + 7); break;
+                default: value = (1LL << 40) + int(rng() % 3) - 1; break;
+            }
+            const long long v0 = invariant(a);
+            const CoordSet before = nonZero(a);
+            Scalar bySweep(a, "bySweep");
+            Scalar byDigit(a, "byDigit");
+            const CoordSet swept = bySweep.sweep(value);
+            const CoordSet oldChanged = byDigit.perDigit(value);
+
+            // Same value, and the sweep leaves only valid digits
+            MDN_CHECK(invariant(bySweep) == times(value, v0));
+            MDN_CHECK(invariant(byDigit) == times(value, v0));
+            int invalid = 0;
+            for (const Coord& xy : nonZero(bySweep)) {
+                invalid += bySweep.getValue(xy) >= base || bySweep.getValue(xy) <= -base;
+            }
+            MDN_CHECK(invalid == 0);
+
+            // Changed covers every position that differs, and everything the old path reported
+            //  that still holds a digit
+            int missed = 0;
+            CoordSet all = before;
+            for (const Coord& xy : nonZero(bySweep)) {
+                all.insert(xy);
+            }
+            for (const Coord& xy : all) {
+                missed += a.getValue(xy) != bySweep.getValue(xy) && !swept.count(xy);
+            }
+            for (const Coord& xy : oldChanged) {
+                missed += bySweep.getValue(xy) != 0 && !swept.count(xy);
+            }
+            MDN_CHECK(missed == 0);
+            int stray = 0;
+            for (const Coord& xy : swept) {
+                stray += !all.count(xy);
+            }
+            MDN_CHECK(stray == 0);
+
+            // Cleaned up from their changed sets, both end on the same value with nothing left to
+            //  carry.  Cleaned digits are not unique, so the digits themselves may differ.
+            bySweep.cleanup(swept);
+            byDigit.cleanup(oldChanged);
+            MDN_CHECK(invariant(bySweep) == times(value, v0));
+            MDN_CHECK(invariant(byDigit) == times(value, v0));
+            MDN_CHECK(nRemaining(bySweep) == 0);
+            MDN_CHECK(nRemaining(byDigit) == 0);
+        }
+    }
+}
+
+static void testFastPaths(std::mt19937& rng) {
+    Scalar a(Mdn2dConfig(10, -1, SignConvention::Positive), "a");
+    for (int i = 0; i < 50; ++i) {
+        a.setValue(Coord(int(rng() % 12) - 6, int(rng() % 12) - 6), Digit(int(rng() % 19) - 9));
+    }
+    const CoordSet before = nonZero(a);
+
+    Scalar one(a, "one");
+    MDN_CHECK(one.sweep(1).empty());
+    MDN_CHECK(one.toStringRows() == a.toStringRows());
+
+    Scalar negated(a, "negated");
+    const CoordSet changed = negated.sweep(-1);
+    MDN_CHECK(changed == before);
+    int wrong = 0;
+    for (const Coord& xy : before) {
+        wrong += negated.getValue(xy) != -a.getValue(xy);
+    }
+    MDN_CHECK(wrong == 0);
+    MDN_CHECK(nonZero(negated) == before);
+
+    Scalar zero(a, "zero");
+    zero.sweep(0);
+    MDN_CHECK(!zero.hasBounds());
+    MDN_CHECK(nonZero(zero).empty());
+
+    // An empty number stays empty
+    Scalar empty(Mdn2dConfig(10), "empty");
+    MDN_CHECK(empty.sweep(12345).empty());
+    MDN_CHECK(!empty.hasBounds());
+}
+
+int main() {
+    std::mt19937 rng(30);
+    testAgainstPerDigit(rng);
+    testFastPaths(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,84 @@
+// PackedDigits kernels and the packed binary format: every base round-trips exactly
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dIO.hpp>
+#include <mdn/PackedDigits.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static Digit randomDigit(std::mt19937& rng, int base) {
+    return static_cast<Digit>(static_cast<int>(rng() % (2*base - 1)) - (base - 1));
+}
+
+// pack / unpack restore the digits, and put builds the same bytes as pack
+static void testKernels(std::mt19937& rng) {
+    for (int base = 2; base <= 32; ++base) {
+        const DigitPacking packing = PackedDigits::forBase(base);
+        MDN_CHECK(PackedDigits::isValid(static_cast<uint8_t>(packing)));
+        for (int n = 0; n < 40; ++n) {
+            VecDigit digits(n);
+            for (Digit& d : digits) {
+                d = randomDigit(rng, base);
+            }
+            PackedRow row;
+            PackedDigits::pack(packing, digits, row);
+            MDN_CHECK(row.width == n);
+            MDN_CHECK(row.data.size() == PackedDigits::bytes(packing, n));
+            VecDigit unpacked;
+            PackedDigits::unpack(row, unpacked);
+            MDN_CHECK(unpacked == digits);
+
+            std::vector<uint8_t> put(PackedDigits::bytes(packing, n), 0);
+            for (int i = 0; i < n; ++i) {
+                if (digits[i] != 0) {
+                    PackedDigits::put(packing, n, i, digits[i], put.data());
+                }
+            }
+            MDN_CHECK(put == row.data);
+        }
+    }
+    MDN_CHECK(!PackedDigits::isValid(uint8_t(3)));
+}
+
+// saveBinary then load gives back the same digits, for an empty number too
+static void testFileRoundTrip(std::mt19937& rng) {
+    for (int base : {2, 3, 5, 8, 9, 10, 16, 32}) {
+        Mdn2dConfig config(base, 200, SignConvention::Positive, 20, Fraxis::X);
+        Mdn2d a = Mdn2d::NewInstance(config, "a");
+        for (int k = 0; k < 300; ++k) {
+            const Coord xy(static_cast<int>(rng() % 41) - 20, static_cast<int>(rng() % 31) - 15);
+            a.setValue(xy, randomDigit(rng, base));
+        }
+        std::stringstream ss;
+        a.saveBinary(ss);
+        Mdn2d b = Mdn2d::NewInstance(config, "b");
+        Mdn2dIO::load(ss, b);
+        const Rect bounds = a.bounds();
+        VecVecDigit rowsA;
+        VecVecDigit rowsB;
+        a.getAreaRows(bounds, rowsA);
+        b.getAreaRows(bounds, rowsB);
+        MDN_CHECK(rowsA == rowsB);
+        MDN_CHECK(b.bounds().min() == bounds.min() && b.bounds().max() == bounds.max());
+
+        Mdn2d empty = Mdn2d::NewInstance(config, "empty");
+        std::stringstream ssEmpty;
+        empty.saveBinary(ssEmpty);
+        Mdn2d c = Mdn2d::NewInstance(config, "c");
+        Mdn2dIO::load(ssEmpty, c);
+        MDN_CHECK(!c.bounds().isValid());
+    }
+}
+
+int main() {
+    std::mt19937 rng(7);
+    testKernels(rng);
+    testFileRoundTrip(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,135 @@
+// Parallel carryover cleanup: colour classes large enough to run on the thread pool give the same
+//  digits, carries and written coords as the serial path, wave by wave
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Runs cleanup waves the way locked_carryoverCleanup does, each class serially or in parallel
+struct Cleaner : Mdn2d {
+    using Mdn2d::Mdn2d;
+
+    // Every digit, as a cleanup's first working set
+    CoordSet allCoords() const {
+        CoordSet coords;
+        const Rect b = bounds();
+        for (int y = b.min().y(); y <= b.max().y(); ++y) {
+            for (int x = b.min().x(); x <= b.max().x(); ++x) {
+                if (getValue(Coord(x, y))) {
+                    coords.insert(Coord(x, y));
+                }
+            }
+        }
+        return coords;
+    }
+
+    // One wave over workingSet, returns the digits written and adds to nCarries and nLargest,
+    //  the size of the largest colour class
+    CoordSet wave(const CoordSet& workingSet, ThreadPool* pool, int& nCarries, int& nLargest) {
+        auto lock = lockWriteable();
+        std::vector<Coord> ordered;
+        std::array<int, 4> classStart;
+        internal_orderCleanupWave(workingSet, ordered, classStart);
+        CoordSet written;
+        for (int c = 0; c < 3; ++c) {
+            nLargest = std::max(nLargest, classStart[c + 1] - classStart[c]);
+            if (pool) {
+                nCarries += internal_cleanupClassParallel(
+                    ordered, classStart[c], classStart[c + 1], Carryover::OptionalNegative,
+                    written, *pool
+                );
+            } else {
+                nCarries += internal_cleanupClass(
+                    ordered, classStart[c], classStart[c + 1], Carryover::OptionalNegative,
+                    written
+                );
+            }
+        }
+        internal_operationComplete();
+        return written;
+    }
+};
+
+// Next wave's working set, as in locked_carryoverCleanup
+static CoordSet nextWorkingSet(const CoordSet& written) {
+    CoordSet result;
+    for (const Coord& xy : written) {
+        result.insert(xy);
+        result.insert(xy.translatedX(-1));
+        result.insert(xy.translatedY(-1));
+    }
+    return result;
+}
+
+static bool sameDigits(const Mdn2d& a, const Mdn2d& b) {
+    if (a.hasBounds() != b.hasBounds()) {
+        return false;
+    }
+    if (!a.hasBounds()) {
+        return true;
+    }
+    const Rect r = Rect::UnionOf(a.bounds(), b.bounds());
+    for (int y = r.min().y(); y <= r.max().y(); ++y) {
+        for (int x = r.min().x(); x <= r.max().x(); ++x) {
+            if (a.getValue(Coord(x, y)) != b.getValue(Coord(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(27);
+    ThreadPool pool(4);
+    for (int base : {2, 10, 16}) {
+        const Mdn2dConfig config(base, -1, SignConvention::Positive);
+        Cleaner serial(config, "serial");
+        for (int y = 0; y < 140; ++y) {
+            for (int x = 0; x < 140; ++x) {
+                serial.setValue(Coord(x, y), Digit(int(rng() % (2*base - 1)) - (base - 1)));
+            }
+        }
+        const Mdn2d start(serial, "start");
+        Cleaner parallel(serial, "parallel");
+
+        CoordSet serialSet = serial.allCoords();
+        CoordSet parallelSet = serialSet;
+        int nWaves = 0;
+        int nLargest = 0;
+        int nSerialCarries = 0;
+        int nParallelCarries = 0;
+        while (!serialSet.empty() && nWaves < 1000) {
+            const CoordSet serialWritten =
+                serial.wave(serialSet, nullptr, nSerialCarries, nLargest);
+            const CoordSet parallelWritten =
+                parallel.wave(parallelSet, &pool, nParallelCarries, nLargest);
+            MDN_CHECK(serialWritten == parallelWritten);
+            MDN_CHECK(nSerialCarries == nParallelCarries);
+            MDN_CHECK(sameDigits(serial, parallel));
+            serialSet = nextWorkingSet(serialWritten);
+            parallelSet = nextWorkingSet(parallelWritten);
+            ++nWaves;
+        }
+        MDN_CHECK(serialSet.empty());
+        // The first wave's classes are large enough to run in parallel in a real cleanup
+        MDN_CHECK(nLargest >= 4096);
+        MDN_CHECK(nSerialCarries > 0);
+
+        // And a real cleanup, which picks the parallel path itself, ends the same way
+        Cleaner whole(start, "whole");
+        const CleanupReport report = whole.carryoverCleanupWithReport(whole.allCoords());
+        MDN_CHECK(report.converged());
+        MDN_CHECK(report.carries == nSerialCarries);
+        MDN_CHECK(sameDigits(whole, serial));
+    }
+    return mdn::test::result();
+}
@@ -0,0 +1,333 @@
+// Region operations: each changes the number as if the digits within region were transformed on
+//  their own and added back, before any cleanup, for small regions and large ones alike.  After
+//  cleanup the value matches the whole-number operations, large regions clean up in parallel, and
+//  carryoverCleanupRegion settles the region under the asked-for sign convention.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Carries keep the value of a base 10 number, and so its sum of d*3^x*7^y (3 + 7 = 10), checked
+//  here modulo a prime
+static const long long prime = 1000000007LL;
+
+static long long power(long long b, long long e) {
+    if (e < 0) {
+        b = power(b, prime - 2);
+        e = -e;
+    }
+    long long r = 1;
+    b %= prime;
+    while (e) {
+        if (e & 1) {
+            r = r*b % prime;
+        }
+        b = b*b % prime;
+        e >>= 1;
+    }
+    return r;
+}
+
+static long long weight(int x, int y) {
+    return power(3, x)*power(7, y) % prime;
+}
+
+static long long addTerm(long long sum, long long digit, int x, int y) {
+    return ((sum + digit % prime*weight(x, y)) % prime + prime) % prime;
+}
+
+static long long invariant(const Mdn2d& a) {
+    long long sum = 0;
+    if (!a.hasBounds()) {
+        return sum;
+    }
+    const Rect b = a.bounds();
+    for (int y = b.min().y(); y <= b.max().y(); ++y) {
+        for (int x = b.min().x(); x <= b.max().x(); ++x) {
+            const Digit d = a.getValue(Coord(x, y));
+            if (d) {
+                sum = addTerm(sum, d, x, y);
+            }
+        }
+    }
+    return sum;
+}
+
+// Access to the region operations without the cleanup that follows them, each returning the
+//  working set that cleanup would start from
+struct RawRegionOps : Mdn2d {
+    using Mdn2d::Mdn2d;
+
+    CoordSet multiply(const Rect& region, long long value) {
+        auto lock = lockWriteable();
+        CoordSet changed = locked_multiplyRegion(region, value);
+        internal_operationComplete();
+        return changed;
+    }
+
+    CoordSet shift(const Rect& region, const Coord& xy) {
+        auto lock = lockWriteable();
+        CoordSet changed = locked_shiftRegion(region, xy);
+        internal_operationComplete();
+        return changed;
+    }
+
+    CoordSet transpose(const Rect& region) {
+        auto lock = lockWriteable();
+        CoordSet changed = locked_transposeRegion(region);
+        internal_operationComplete();
+        return changed;
+    }
+
+    // Size of the largest colour class in the first cleanup wave over workingSet
+    int largestClass(const CoordSet& workingSet) const {
+        auto lock = lockReadOnly();
+        std::vector<Coord> ordered;
+        std::array<int, 4> classStart;
+        internal_orderCleanupWave(workingSet, ordered, classStart);
+        int result = 0;
+        for (int c = 0; c < 3; ++c) {
+            result = std::max(result, classStart[c + 1] - classStart[c]);
+        }
+        return result;
+    }
+};
+
+// Digits still needing a carryover under sign convention sc, among coords, or everywhere
+static int nUnsettled(const Mdn2d& a, SignConvention sc, const CoordSet* coords = nullptr) {
+    const Carryover wrongSign = sc == SignConvention::Positive ? Carryover::OptionalNegative
+        : sc == SignConvention::Negative ? Carryover::OptionalPositive : Carryover::Required;
+    auto unsettled = [&](const Coord& xy) {
+        const Carryover co = a.checkCarryover(xy);
+        return co == Carryover::Required || co == wrongSign;
+    };
+    int result = 0;
+    if (coords) {
+        for (const Coord& xy : *coords) {
+            result += unsettled(xy);
+        }
+    } else if (a.hasBounds()) {
+        const Rect b = a.bounds();
+        for (int y = b.min().y(); y <= b.max().y(); ++y) {
+            for (int x = b.min().x(); x <= b.max().x(); ++x) {
+                result += unsettled(Coord(x, y));
+            }
+        }
+    }
+    return result;
+}
+
+// op applied to a's digits within region with the whole-number operations, on a number of their
+//  own with region's min corner at the origin, added back to the rest of a
+static Mdn2d wholeNumberReference(
+    const Mdn2d& a, const Rect& region, int op, long long value, const Coord& by
+) {
+    Mdn2d rest(a, "rest");
+    Mdn2d part(a.config(), "part");
+    const Coord corner = region.min();
+    for (int y = region.min().y(); y <= region.max().y(); ++y) {
+        for (int x = region.min().x(); x <= region.max().x(); ++x) {
+            const Coord xy(x, y);
+            if (const Digit d = a.getValue(xy)) {
+                rest.setValue(xy, 0);
+                part.setValue(Coord(x - corner.x(), y - corner.y()), d);
+            }
+        }
+    }
+    switch (op) {
+        case 0: part.multiply(-1); break;
+        case 1: part.multiply(value); break;
+        case 2: part.shift(by); break;
+        case 3: part.transpose(); break;
+    }
+    part.shift(corner);
+    return rest + part;
+}
+
+// op with the public region operation, cleanup included
+static void publicOp(Mdn2d& a, const Rect& region, int op, long long value, const Coord& by) {
+    switch (op) {
+        case 0: a.negateRegion(region); break;
+        case 1: a.multiplyRegion(region, value); break;
+        case 2: a.shiftRegion(region, by); break;
+        case 3: a.transposeRegion(region); break;
+    }
+}
+
+// Random digits, nDigits attempts over -span to span-1 in x and y
+static void fill(Mdn2d& a, std::mt19937& rng, int nDigits, int span) {
+    for (int i = 0; i < nDigits; ++i) {
+        const int x = int(rng() % (2*span)) - span;
+        const int y = int(rng() % (2*span)) - span;
+        a.setValue(Coord(x, y), Digit(int(rng() % 19) - 9));
+    }
+}
+
+// One trial of op on a random region within the digits of a random number, its sides at least
+//  minSide long.  Returns the number of digits within the region.
+static int trial(std::mt19937& rng, int op, int nDigits, int span, int minSide) {
+    const Mdn2dConfig config(10, -1, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d a(config, "a");
+    fill(a, rng, nDigits, span);
+    const int w = minSide + int(rng() % (span - minSide + 1));
+    const int h = rng() % 3 == 0 ? w : minSide + int(rng() % (span - minSide + 1));
+    const int x0 = int(rng() % (2*span - w + 1)) - span;
+    const int y0 = int(rng() % (2*span - h + 1)) - span;
+    const Rect region(Coord(x0, y0), Coord(x0 + w - 1, y0 + h - 1));
+    const long long value = int(rng() % 41) - 20;
+    const Coord by(int(rng() % 9) - 4, int(rng() % 9) - 4);
+
+    // Expected: the number without its region, plus the region's digits transformed
+    long long expected = invariant(a);
+    int nInRegion = 0;
+    for (int y = y0; y < y0 + h; ++y) {
+        for (int x = x0; x < x0 + w; ++x) {
+            const Digit d = a.getValue(Coord(x, y));
+            if (!d) {
+                continue;
+            }
+            ++nInRegion;
+            expected = addTerm(expected, -d, x, y);
+            switch (op) {
+                case 0: expected = addTerm(expected, -d, x, y); break;
+                case 1: expected = addTerm(expected, value*d, x, y); break;
+                case 2: expected = addTerm(expected, d, x + by.x(), y + by.y()); break;
+                case 3: expected = addTerm(expected, d, x0 + y - y0, y0 + x - x0); break;
+            }
+        }
+    }
+
+    RawRegionOps got(a, "got");
+    switch (op) {
+        case 0: got.negateRegion(region); break;
+        case 1: got.multiply(region, value); break;
+        case 2: got.shift(region, by); break;
+        case 3: got.transpose(region); break;
+    }
+    MDN_CHECK(invariant(got) == expected);
+
+    // The public operation, cleanup and all, has the value of the whole-number operations
+    Mdn2d pub(a, "pub");
+    publicOp(pub, region, op, value, by);
+    MDN_CHECK(invariant(pub) == invariant(wholeNumberReference(a, region, op, value, by)));
+    MDN_CHECK(invariant(pub) == expected);
+
+    // Negated digits never carry, so the digits themselves are known
+    if (op == 0) {
+        int wrong = 0;
+        const Rect b = a.bounds();
+        for (int y = b.min().y(); y <= b.max().y(); ++y) {
+            for (int x = b.min().x(); x <= b.max().x(); ++x) {
+                const Coord xy(x, y);
+                const Digit d = a.getValue(xy);
+                wrong += got.getValue(xy) != (region.contains(xy) ? Digit(-d) : d);
+            }
+        }
+        MDN_CHECK(wrong == 0);
+    }
+    return nInRegion;
+}
+
+// A region over the whole of a number not yet cleaned up: the digits it touches are all the
+//  number has, so the cleanup that follows settles it all, and its colour classes are large
+//  enough to run on the ThreadPool (parallelCleanupMinCoords, 4096)
+static void testWholeNumberRegion(std::mt19937& rng) {
+    const Mdn2dConfig config(10, -1, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d a(config, "a");
+    fill(a, rng, 40000, 100);
+    MDN_CHECK(nUnsettled(a, SignConvention::Positive) > 0);
+    const Rect region = a.bounds();
+    for (int op = 1; op < 4; ++op) {
+        const long long value = 2 + int(rng() % 18);
+        const Coord by(int(rng() % 9) - 4, 1 + int(rng() % 4));
+        RawRegionOps raw(a, "raw");
+        CoordSet changed;
+        switch (op) {
+            case 1: changed = raw.multiply(region, value); break;
+            case 2: changed = raw.shift(region, by); break;
+            case 3: changed = raw.transpose(region); break;
+        }
+        MDN_CHECK(raw.largestClass(changed) >= 4096);
+
+        Mdn2d pub(a, "pub");
+        publicOp(pub, region, op, value, by);
+        MDN_CHECK(invariant(pub) == invariant(wholeNumberReference(a, region, op, value, by)));
+        MDN_CHECK(nUnsettled(pub, SignConvention::Positive) == 0);
+    }
+}
+
+static void testCleanupRegion(std::mt19937& rng) {
+    // -7 with a 1 to its right is 3 with a -1 above, either carryover being optional.  It is
+    //  settled only when region holds the origin, and the number's own neutral convention leaves
+    //  it be.
+    const Mdn2dConfig neutral(10, -1, SignConvention::Neutral);
+    Mdn2d a(neutral, "a");
+    a.setValue(COORD_ORIGIN, -7);
+    a.setValue(Coord(1, 0), 1);
+    MDN_CHECK(a.carryoverCleanupRegion(Rect(1, 1, 5, 5), SignConvention::Positive).empty());
+    MDN_CHECK(a.carryoverCleanupRegion(Rect::GetInvalid(), SignConvention::Positive).empty());
+    MDN_CHECK(a.carryoverCleanupRegion(Rect(-2, -2, 2, 2)).empty());
+    MDN_CHECK(a.getValue(COORD_ORIGIN) == -7);
+    const CoordSet changed = a.carryoverCleanupRegion(Rect(0, 0, 0, 0), SignConvention::Positive);
+    MDN_CHECK(changed.count(COORD_ORIGIN) && changed.count(Coord(1, 0)));
+    MDN_CHECK(changed.count(Coord(0, 1)));
+    MDN_CHECK(a.getValue(COORD_ORIGIN) == 3);
+    MDN_CHECK(a.getValue(Coord(1, 0)) == 0 && a.getValue(Coord(0, 1)) == -1);
+
+    // And back again under the negative convention
+    MDN_CHECK(!a.carryoverCleanupRegion(Rect(-1, -1, 1, 1), SignConvention::Negative).empty());
+    MDN_CHECK(a.getValue(COORD_ORIGIN) == -7);
+    MDN_CHECK(a.getValue(Coord(1, 0)) == 1 && a.getValue(Coord(0, 1)) == 0);
+
+    // Random numbers: the value is kept, only the returned coords change, and the region and
+    //  everything changed are left settled under sc
+    int wrong = 0;
+    for (int t = 0; t < 60; ++t) {
+        Mdn2d b(neutral, "b");
+        fill(b, rng, 120, 10);
+        const int x0 = int(rng() % 16) - 10;
+        const int y0 = int(rng() % 16) - 10;
+        const Rect region(x0, y0, x0 + int(rng() % 8), y0 + int(rng() % 8));
+        for (SignConvention sc : {
+            SignConvention::Positive, SignConvention::Negative, SignConvention::Neutral
+        }) {
+            Mdn2d c(b, "c");
+            const CoordSet cChanged = c.carryoverCleanupRegion(region, sc);
+            wrong += invariant(c) != invariant(b);
+            const Rect all = Rect::UnionOf(b.bounds(), c.bounds());
+            CoordSet settled(cChanged);
+            for (int y = all.min().y(); y <= all.max().y(); ++y) {
+                for (int x = all.min().x(); x <= all.max().x(); ++x) {
+                    const Coord xy(x, y);
+                    wrong += c.getValue(xy) != b.getValue(xy) && !cChanged.count(xy);
+                    if (region.contains(xy)) {
+                        settled.insert(xy);
+                    }
+                }
+            }
+            wrong += nUnsettled(c, sc, &settled);
+        }
+    }
+    MDN_CHECK(wrong == 0);
+}
+
+int main() {
+    std::mt19937 rng(50);
+    for (int t = 0; t < 200; ++t) {
+        trial(rng, t % 4, 80, 12, 1);
+    }
+    // Regions holding thousands of digits
+    for (int op = 0; op < 4; ++op) {
+        MDN_CHECK(trial(rng, op, 40000, 100, 100) >= 4096);
+    }
+    testWholeNumberRegion(rng);
+    testCleanupRegion(rng);
+    return mdn::test::result();
+}
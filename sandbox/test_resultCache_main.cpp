@@ -0,0 +1,133 @@
+// ResultCache: repeated operations are served from the cache, and always give what the operation
+//  itself would
+
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/ResultCache.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static Mdn2d randomNumber(const Mdn2dConfig& config, const char* name, std::mt19937& rng) {
+    Mdn2d result(config, name);
+    const int base = config.base();
+    for (int k = 0; k < 10; ++k) {
+        const Coord xy(static_cast<int>(rng() % 7) - 3, static_cast<int>(rng() % 7) - 3);
+        result.setValue(xy, static_cast<int>(rng() % (2*base - 1)) - (base - 1));
+    }
+    return result;
+}
+
+// Product of a and b without the cache, drops the cache's entries
+static std::vector<std::string> uncachedProduct(const Mdn2d& a, const Mdn2d& b) {
+    ResultCache& cache = ResultCache::shared();
+    const std::size_t budget = cache.budget();
+    cache.setBudget(0);
+    Mdn2d ans(a.config(), "uncached");
+    a.multiply(b, ans);
+    cache.setBudget(budget);
+    return ans.toStringRows();
+}
+
+static void testRepeats(SignConvention sc, std::mt19937& rng) {
+    ResultCache& cache = ResultCache::shared();
+    Mdn2dConfig config(10, 32, sc, 20, Fraxis::X);
+    Mdn2d a = randomNumber(config, "a", rng);
+    const Mdn2d b = randomNumber(config, "b", rng);
+    const std::vector<std::string> expected = uncachedProduct(a, b);
+    cache.resetCounters();
+
+    Mdn2d first(config, "first");
+    a.multiply(b, first);
+    MDN_CHECK(cache.misses() == 1 && cache.hits() == 0);
+    MDN_CHECK(cache.size() == 1);
+
+    Mdn2d second(config, "second");
+    a.multiply(b, second);
+    MDN_CHECK(cache.hits() == 1);
+    MDN_CHECK(first.toStringRows() == expected);
+    MDN_CHECK(second.toStringRows() == expected);
+
+    // The answer handed out is a copy, writing it leaves the entry alone
+    second.setValue(Coord(9, 9), 1);
+    Mdn2d third(config, "third");
+    a.multiply(b, third);
+    MDN_CHECK(cache.hits() == 2);
+    MDN_CHECK(third.toStringRows() == expected);
+
+    // A changed operand misses, and gets its own answer
+    a.setValue(Coord(0, 0), a.getValue(Coord(0, 0)) == 1 ? 2 : 1);
+    Mdn2d fourth(config, "fourth");
+    a.multiply(b, fourth);
+    MDN_CHECK(cache.misses() == 2);
+    MDN_CHECK(fourth.toStringRows() == uncachedProduct(a, b));
+}
+
+// divideIterate carries on from the incoming ans and rem, so they are part of the entry
+static void testDivideIterate(std::mt19937& rng) {
+    ResultCache& cache = ResultCache::shared();
+    cache.clear();
+    cache.resetCounters();
+    Mdn2dConfig config(10, 16, SignConvention::Positive, 20, Fraxis::X);
+    const Mdn2d a = randomNumber(config, "a", rng);
+    Mdn2d b(config, "b");
+    b.setValue(Coord(0, 0), 4);
+
+    Mdn2d ans(config, "ans");
+    Mdn2d rem(a, "rem");
+    long double remMag = 0.0;
+    a.divideIterate(3, b, ans, rem, remMag, Fraxis::X);
+    Mdn2d ansAgain(config, "ansAgain");
+    Mdn2d remAgain(a, "remAgain");
+    long double remMagAgain = 0.0;
+    a.divideIterate(3, b, ansAgain, remAgain, remMagAgain, Fraxis::X);
+    MDN_CHECK(cache.hits() == 1);
+    MDN_CHECK(ansAgain.toStringRows() == ans.toStringRows());
+    MDN_CHECK(remAgain.toStringRows() == rem.toStringRows());
+    MDN_CHECK(remMagAgain == remMag);
+
+    // Continuing from the first result is a different entry
+    a.divideIterate(3, b, ans, rem, remMag, Fraxis::X);
+    MDN_CHECK(cache.hits() == 1);
+    MDN_CHECK(cache.misses() == 2);
+}
+
+// The cache stays within its budget, and does nothing without one
+static void testBudget(std::mt19937& rng) {
+    ResultCache& cache = ResultCache::shared();
+    cache.clear();
+    Mdn2dConfig config(10, 32, SignConvention::Positive, 20, Fraxis::X);
+    const Mdn2d a = randomNumber(config, "a", rng);
+    const Mdn2d b = randomNumber(config, "b", rng);
+    Mdn2d ans(config, "ans");
+    a.plus(b, ans);
+    const std::size_t oneEntry = cache.bytes();
+    MDN_CHECK(cache.size() == 1 && oneEntry > 0);
+
+    cache.setBudget(oneEntry*3);
+    for (int i = 0; i < 10; ++i) {
+        Mdn2d c = randomNumber(config, "c", rng);
+        c.plus(b, ans);
+        MDN_CHECK(cache.bytes() <= cache.budget());
+    }
+    cache.setBudget(0);
+    MDN_CHECK(!cache.enabled());
+    MDN_CHECK(cache.size() == 0);
+    a.plus(b, ans);
+    MDN_CHECK(cache.size() == 0);
+}
+
+int main() {
+    std::mt19937 rng(43);
+    ResultCache& cache = ResultCache::shared();
+    MDN_CHECK(!cache.enabled());
+    cache.setBudget(16 << 20);
+    testRepeats(SignConvention::Positive, rng);
+    testRepeats(SignConvention::Neutral, rng);
+    testDivideIterate(rng);
+    testBudget(rng);
+    return mdn::test::result();
+}
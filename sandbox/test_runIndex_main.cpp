@@ -0,0 +1,102 @@
+// Mdn2d::jump, answered from the RunIndex, lands where stepping cell by cell used to
+
+#include <random>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Selection.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// The stepping loop jump used before the RunIndex, for starts it reached after its early returns
+static Coord steppingJump(const Mdn2d& a, const Coord& xy, CardinalDirection cd) {
+    const Coord step = CardinalDirectionToCoord(cd);
+    const Rect bounds = a.bounds();
+    bool withinBounds = bounds.contains(xy);
+    const bool fromNonZero = a.getValue(xy) != 0;
+    Coord go = xy;
+    Coord prev = xy;
+    while (true) {
+        prev = go;
+        go.translate(step);
+        const bool nonZero = a.getValue(go) != 0;
+        if (nonZero != fromNonZero) {
+            if (!fromNonZero) {
+                return go;
+            }
+            if (prev != xy) {
+                return prev;
+            }
+        }
+        const bool inside = bounds.contains(go);
+        if (!withinBounds) {
+            withinBounds = inside;
+        } else if (!inside) {
+            break;
+        }
+    }
+    return prev;
+}
+
+int main() {
+    std::mt19937 rng(49);
+    Mdn2dConfig config(10, 40, SignConvention::Positive, 20, Fraxis::X);
+    Mdn2d a(config, "a");
+    const CardinalDirection directions[4] = {
+        CardinalDirection::North,
+        CardinalDirection::South,
+        CardinalDirection::East,
+        CardinalDirection::West
+    };
+    // Each round writes more digits, some of them zeros, so indexed lines go stale
+    for (int round = 0; round < 20; ++round) {
+        for (int j = 0; j < 60; ++j) {
+            const Coord xy(static_cast<int>(rng() % 24) - 12, static_cast<int>(rng() % 24) - 12);
+            a.setValue(xy, rng() % 3 ? static_cast<int>(rng() % 19) - 9 : 0);
+        }
+        const Rect bounds = a.bounds();
+        int wrong = 0;
+        for (int t = 0; t < 400; ++t) {
+            const Coord xy(
+                bounds.min().x() + static_cast<int>(rng() % bounds.width()),
+                bounds.min().y() + static_cast<int>(rng() % bounds.height())
+            );
+            const CardinalDirection cd = directions[rng() % 4];
+            if (!bounds.contains(xy.translated(CardinalDirectionToCoord(cd)))) {
+                continue;
+            }
+            wrong += a.jump(xy, cd) != steppingJump(a, xy, cd);
+        }
+        // Approaching each row from outside the bounds
+        for (int y = bounds.min().y(); y <= bounds.max().y(); ++y) {
+            const Coord xy(bounds.min().x() - 3, y);
+            const CardinalDirection cd = CardinalDirection::East;
+            wrong += a.jump(xy, cd) != steppingJump(a, xy, cd);
+        }
+        MDN_CHECK(wrong == 0);
+
+        // The batch form gives the same landings
+        const std::vector<Coord> from{bounds.min(), Coord(bounds.min().x(), bounds.max().y())};
+        std::vector<Coord> out;
+        a.jump(from, CardinalDirection::East, out);
+        MDN_CHECK(out.size() == from.size());
+        for (std::size_t i = 0; i < from.size() && i < out.size(); ++i) {
+            MDN_CHECK(out[i] == a.jump(from[i], CardinalDirection::East));
+        }
+    }
+
+    // A multi-row selection jumps to the nearest landing over its rows
+    Mdn2d c(config, "c");
+    c.setValue(Coord(5, 0), 1);
+    c.setValue(Coord(3, 2), 1);
+    c.setValue(Coord(9, 1), 1);
+    Selection sel(c);
+    sel.setRect(Rect(Coord(0, 0), Coord(0, 2)));
+    sel.cursorJumpRt(true);
+    MDN_CHECK(sel.rect().max().x() == 3);
+    sel.cursorJumpRt(true);
+    MDN_CHECK(sel.rect().max().x() == 4);
+    return mdn::test::result();
+}
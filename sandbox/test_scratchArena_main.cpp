@@ -0,0 +1,177 @@
+// Scratch arenas: numbers backed by an arena compute the same digits as heap numbers, and nothing
+//  allocated from an arena, by the caller or inside an operation, outlives it
+
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/ScratchArena.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Heap memory, counted
+class CountingResource : public std::pmr::memory_resource {
+public:
+    long long nAllocations = 0;
+    long long bytesHeld = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++nAllocations;
+        bytesHeld += static_cast<long long>(bytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        bytesHeld -= static_cast<long long>(bytes);
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Makes counting the default resource, and so the upstream of any arena constructed meanwhile
+class CountingDefault {
+    std::pmr::memory_resource* m_previous;
+public:
+    CountingDefault(CountingResource& counting) :
+        m_previous(std::pmr::set_default_resource(&counting))
+    {}
+    ~CountingDefault() {
+        std::pmr::set_default_resource(m_previous);
+    }
+};
+
+static void fill(Mdn2d& a, std::mt19937& rng, int nDigits, int span) {
+    for (int i = 0; i < nDigits; ++i) {
+        const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/2);
+        a.setValue(xy, Digit(int(rng() % 19) - 9));
+    }
+}
+
+// The same operations on heap numbers and on numbers backed by an arena
+static void testSameDigits(std::mt19937& rng) {
+    const Mdn2dConfig config(10, -1, SignConvention::Positive);
+    for (int trial = 0; trial < 10; ++trial) {
+        ScratchArena arena;
+        Mdn2d a(config, "a");
+        Mdn2d b(config, "b");
+        Mdn2d ans(config, "ans");
+        Mdn2d sa(config, "sa", arena.resource());
+        Mdn2d sb(config, "sb", arena.resource());
+        Mdn2d sAns(config, "sAns", arena.resource());
+        fill(a, rng, 60, 14);
+        fill(b, rng, 40, 10);
+        sa = a;
+        sb = b;
+        MDN_CHECK(sa.toStringRows() == a.toStringRows());
+
+        a.plus(b, ans);
+        sa.plus(sb, sAns);
+        MDN_CHECK(sAns.toStringRows() == ans.toStringRows());
+
+        a.minus(b, ans);
+        sa.minus(sb, sAns);
+        MDN_CHECK(sAns.toStringRows() == ans.toStringRows());
+
+        a.multiply(b, ans);
+        sa.multiply(sb, sAns);
+        MDN_CHECK(sAns.toStringRows() == ans.toStringRows());
+
+        const long long k = int(rng() % 2001) - 1000;
+        ans.multiply(k);
+        sAns.multiply(k);
+        MDN_CHECK(sAns.toStringRows() == ans.toStringRows());
+
+        ans.carryoverCleanupAll(SignConvention::Negative);
+        sAns.carryoverCleanupAll(SignConvention::Negative);
+        MDN_CHECK(sAns.toStringRows() == ans.toStringRows());
+
+        // Mixed: arena operands, heap answer
+        Mdn2d mixed(config, "mixed");
+        sa.multiply(sb, mixed);
+        a.multiply(b, ans);
+        MDN_CHECK(mixed.toStringRows() == ans.toStringRows());
+    }
+}
+
+// A copy out of the arena takes none of the arena's memory, and survives it
+static void testCopyOut(std::mt19937& rng) {
+    const Mdn2dConfig config(10, -1, SignConvention::Positive);
+    CountingResource counting;
+    Mdn2d result(config, "result");
+    std::vector<std::string> expected;
+    {
+        std::unique_ptr<ScratchArena> arena;
+        {
+            CountingDefault scope(counting);
+            arena = std::make_unique<ScratchArena>(1024);
+        }
+        {
+            Mdn2d a(config, "a", arena->resource());
+            Mdn2d b(config, "b", arena->resource());
+            Mdn2d product(config, "product", arena->resource());
+            fill(a, rng, 200, 30);
+            fill(b, rng, 100, 20);
+            a.multiply(b, product);
+            expected = product.toStringRows();
+            MDN_CHECK(counting.nAllocations > 0);
+
+            const long long before = counting.nAllocations;
+            result = product;
+            MDN_CHECK(counting.nAllocations == before);
+            Mdn2d copy(product, "copy");
+            MDN_CHECK(counting.nAllocations == before);
+        }
+        arena->reset();
+        MDN_CHECK(counting.bytesHeld == 0);
+    }
+    MDN_CHECK(counting.bytesHeld == 0);
+    MDN_CHECK(result.toStringRows() == expected);
+}
+
+// Operations use arenas of their own, and release all of it before returning
+static void testOperationsRelease(std::mt19937& rng) {
+    const Mdn2dConfig config(10, -1, SignConvention::Positive);
+    Mdn2d a(config, "a");
+    Mdn2d b(config, "b");
+    Mdn2d ans(config, "ans");
+    Mdn2d divisor(config, "divisor");
+    Mdn2d quotient(config, "quotient");
+    fill(a, rng, 80, 16);
+    fill(b, rng, 40, 10);
+    divisor.setValue(COORD_ORIGIN, 4);
+
+    // Heap numbers take their memory resource at construction, only the arenas use counting
+    CountingResource counting;
+    {
+        CountingDefault scope(counting);
+        a.multiply(b, ans);
+        MDN_CHECK(counting.nAllocations > 0);
+        MDN_CHECK(counting.bytesHeld == 0);
+
+        ans.multiply(37LL);
+        MDN_CHECK(counting.bytesHeld == 0);
+
+        ans *= b;
+        MDN_CHECK(counting.bytesHeld == 0);
+
+        a.divide(divisor, quotient, Fraxis::X);
+        MDN_CHECK(counting.bytesHeld == 0);
+    }
+}
+
+int main() {
+    std::mt19937 rng(29);
+    testSameDigits(rng);
+    testCopyOut(rng);
+    testOperationsRelease(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,149 @@
+// ScriptEngine behaviour: scheduling, failure handling, integer ranges and reading damaged project
+//  files
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <mdn/MdnException.hpp>
+#include <mdn/ScriptEngine.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Statements only wait for earlier statements that touch the same numbers
+static void testSchedule() {
+    const std::vector<ScriptStatement> statements = ScriptEngine::parse(
+        "new a\n"
+        "new b\n"
+        "set a 0 0 3\n"
+        "set b 0 0 4\n"
+        "plus a b c\n"
+    );
+    const std::vector<int> waves = ScriptEngine::schedule(statements);
+    MDN_CHECK(waves.size() == 5);
+    MDN_CHECK(waves[0] == waves[1]);
+    MDN_CHECK(waves[2] == waves[3]);
+    MDN_CHECK(waves[2] > waves[0]);
+    MDN_CHECK(waves[4] > waves[2]);
+}
+
+// A failure skips only the statements after it in the script, even those that come before it
+//  in a later wave still run, and results are reported in statement order
+static void testFailure(bool parallel) {
+    ScriptEngine engine;
+    std::vector<int> reported;
+    const std::vector<ScriptResult> results = engine.run(
+        "new a\n"
+        "set a 0 0 1\n"
+        "print missing\n"
+        "new b\n"
+        "set b 0 0 2\n",
+        parallel,
+        [&reported](const ScriptResult& r) { reported.push_back(r.line); }
+    );
+    MDN_CHECK(results.size() == 5);
+    MDN_CHECK(reported == std::vector<int>({1, 2, 3, 4, 5}));
+    MDN_CHECK(results[0].ok);
+    MDN_CHECK(results[1].ok);
+    MDN_CHECK(results[1].wave > results[2].wave);
+    MDN_CHECK(!results[2].ok);
+    MDN_CHECK(!results[4].ok);
+    MDN_CHECK(results[4].wave == -1);
+    MDN_CHECK(results[4].output == "not run, line 3 failed");
+    const Mdn2d* a = engine.workspace().find("a");
+    MDN_CHECK(a && a->getValue(Coord(0, 0)) == 1);
+    const Mdn2d* b = engine.workspace().find("b");
+    MDN_CHECK(!b || b->getValue(Coord(0, 0)) == 0);
+}
+
+// Integer arguments outside int are parse errors, never wrapped into range
+static void testIntegerRange() {
+    for (const std::string& script : {
+        "set n 5000000000 0 1\n",
+        "set n 0 -2147483649 1\n",
+        "set n 0 0 4294967297\n",
+        "add n 2147483648 0 1\n",
+        "shift n 0 9999999999\n",
+        "carryover n -4294967296 0\n",
+        "divideIterate a b ans rem 4294967296\n",
+        "setConfig base=4294967306\n",
+        "setConfig maxCleanupWaves=-4294967297\n"
+    }) {
+        bool thrown = false;
+        try {
+            ScriptEngine::parse(script);
+        } catch (const InvalidArgument& err) {
+            thrown = std::string(err.what()).find("expecting an integer from") != std::string::npos;
+        }
+        MDN_CHECK(thrown);
+    }
+
+    // The limits themselves are fine, and values beyond int still reach add and multiply
+    ScriptEngine engine;
+    const std::vector<ScriptResult> results = engine.run(
+        "new n\n"
+        "shift n 2147483647 -2147483648\n"
+        "add n 0 0 5000000000\n"
+        "multiply n 5000000000\n"
+    );
+    MDN_CHECK(results.size() == 4);
+    for (const ScriptResult& r : results) {
+        MDN_CHECK(r.ok);
+    }
+}
+
+// Writes a project header, then name length and tab count as given
+static void writeProject(const std::string& path, std::uint32_t nameLength, std::uint32_t count) {
+    std::ofstream out(path, std::ios::binary);
+    const char magic[8] = {'M', 'D', 'N', 'P', 'R', 'J', 0, 0};
+    out.write(magic, 8);
+    const std::uint32_t version = 1;
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    const std::string name(nameLength < 16 ? nameLength : 0, 'p');
+    out.write(name.data(), name.size());
+    const std::int32_t header[6] = {
+        10,
+        -1,
+        static_cast<std::int32_t>(SignConvention::Positive),
+        Mdn2dConfig::defaultFraxisCascadeDepth(),
+        static_cast<std::int32_t>(Fraxis::X),
+        0
+    };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+}
+
+// Lengths and counts beyond the end of the file are read errors, not allocations
+static void testDamagedProject() {
+    const std::string path = "test_scriptEngine_damaged.mdnproj";
+    for (const auto& [nameLength, count] : {
+        std::pair<std::uint32_t, std::uint32_t>(0xfffffff0u, 0),
+        std::pair<std::uint32_t, std::uint32_t>(4, 0xfffffff0u)
+    }) {
+        writeProject(path, nameLength, count);
+        ScriptEngine engine;
+        const std::vector<ScriptResult> results = engine.run("loadProject " + path + "\n");
+        MDN_CHECK(results.size() == 1);
+        MDN_CHECK(!results[0].ok);
+        MDN_CHECK(results[0].output.find("truncated") != std::string::npos);
+    }
+    writeProject(path, 4, 0);
+    ScriptEngine engine;
+    const std::vector<ScriptResult> results = engine.run("loadProject " + path + "\n");
+    MDN_CHECK(results.size() == 1 && results[0].ok);
+    std::remove(path.c_str());
+}
+
+int main() {
+    testSchedule();
+    testFailure(false);
+    testFailure(true);
+    testIntegerRange();
+    testDamagedProject();
+    return mdn::test::result();
+}
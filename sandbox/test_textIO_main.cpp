@@ -0,0 +1,211 @@
+// Mdn2dIO: numbers saved as text or binary load back to the same digits, and malformed text -
+//  bad digits, short rows, CRLF line endings - loads predictably or throws
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mdn/Mdn2d.hpp>
+#include <mdn/Mdn2dIO.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+static void fill(Mdn2d& a, std::mt19937& rng, int nDigits, int span) {
+    const int base = a.config().base();
+    for (int i = 0; i < nDigits; ++i) {
+        const Coord xy(int(rng() % span) - span/2, int(rng() % span) - span/3);
+        a.setValue(xy, Digit(int(rng() % (2*base - 1)) - (base - 1)));
+    }
+}
+
+static bool sameRect(const Rect& a, const Rect& b) {
+    return a.min() == b.min() && a.max() == b.max();
+}
+
+static bool same(const Mdn2d& a, const Mdn2d& b) {
+    return a.name() == b.name()
+        && a.config().base() == b.config().base()
+        && a.config().signConvention() == b.config().signConvention()
+        && a.hasBounds() == b.hasBounds()
+        && (!a.hasBounds() || sameRect(a.bounds(), b.bounds()))
+        && a.toStringRows() == b.toStringRows();
+}
+
+static std::string toCrlf(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '\n') {
+            out += '\r';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// Loads text into a fresh number, the loader's config comes from the header
+static Mdn2d loaded(const std::string& text) {
+    Mdn2d b(Mdn2dConfig(10), "b");
+    std::istringstream is(text);
+    Mdn2dIO::loadText(is, b);
+    return b;
+}
+
+static void testTextRoundTrip(std::mt19937& rng) {
+    for (int base = 2; base <= 32; ++base) {
+        Mdn2d a(Mdn2dConfig(base, -1, SignConvention::Negative), "a" + std::to_string(base));
+        fill(a, rng, 40, 12);
+
+        // Every writer layout the loader reads, utility and pretty
+        std::vector<std::pair<TextWriteOptions, bool>> layouts;
+        for (CommaTabSpace delim :
+            {CommaTabSpace::Comma, CommaTabSpace::Tab, CommaTabSpace::Space}
+        ) {
+            TextWriteOptions opt = TextWriteOptions::DefaultUtility(delim);
+            layouts.emplace_back(opt, false);
+            opt.alphanumeric = false;
+            layouts.emplace_back(opt, false);
+        }
+        for (AxesOutput axes : {AxesOutput::BoxArt, AxesOutput::Simple}) {
+            TextWriteOptions opt = TextWriteOptions::DefaultPretty();
+            opt.axes = axes;
+            opt.alphanumeric = false;
+            opt.wideNegatives = false;
+            layouts.emplace_back(opt, true);
+        }
+
+        int mismatched = 0;
+        for (const auto& [opt, pretty] : layouts) {
+            std::ostringstream os;
+            if (pretty) {
+                Mdn2dIO::saveTextPretty(a, os, opt);
+            } else {
+                Mdn2dIO::saveTextUtility(a, os, opt);
+            }
+            mismatched += !same(loaded(os.str()), a);
+            mismatched += !same(loaded(toCrlf(os.str())), a);
+        }
+        MDN_CHECK(mismatched == 0);
+    }
+}
+
+static void testBinaryRoundTrip(std::mt19937& rng) {
+    for (int base = 2; base <= 32; ++base) {
+        Mdn2d a(Mdn2dConfig(base, -1, SignConvention::Positive), "bin" + std::to_string(base));
+        fill(a, rng, 60, 16);
+        std::ostringstream os;
+        Mdn2dIO::saveBinary(a, os);
+
+        Mdn2d b(Mdn2dConfig(10), "b");
+        std::istringstream is(os.str());
+        Mdn2dIO::loadBinary(is, b);
+        MDN_CHECK(same(b, a));
+
+        // load sniffs the binary marker
+        Mdn2d c(Mdn2dConfig(10), "c");
+        std::istringstream sniffed(os.str());
+        const TextReadSummary summary = Mdn2dIO::load(sniffed, c);
+        MDN_CHECK(same(c, a));
+        MDN_CHECK(sameRect(summary.parsedRect, a.bounds()));
+    }
+
+    // Empty numbers too
+    Mdn2d empty(Mdn2dConfig(16), "empty");
+    std::ostringstream os;
+    Mdn2dIO::saveBinary(empty, os);
+    Mdn2d b(Mdn2dConfig(10), "b");
+    b.setValue(COORD_ORIGIN, 3);
+    std::istringstream is(os.str());
+    Mdn2dIO::loadBinary(is, b);
+    MDN_CHECK(same(b, empty));
+
+    std::ostringstream text;
+    Mdn2dIO::saveTextUtility(empty, text);
+    MDN_CHECK(same(loaded(text.str()), empty));
+}
+
+static const std::string header =
+    "Mdn2d{m}\nBounds[(0,0)->(2,1)]\nConfig(b:10, p:-1, s:Positive, c:20, f:X)\n";
+
+static void testMalformedText() {
+    // CRLF line endings load like LF, with no phantom column from a trailing '\r'
+    const std::string rows = "1,2,3,\n4,5,6,\n";
+    const Mdn2d lf = loaded(header + rows);
+    const Mdn2d crlf = loaded(toCrlf(header + rows));
+    MDN_CHECK(lf.getValue(Coord(0, 1)) == 1);
+    MDN_CHECK(lf.getValue(Coord(2, 0)) == 6);
+    MDN_CHECK(sameRect(lf.bounds(), Rect(0, 0, 2, 1)));
+    MDN_CHECK(same(crlf, lf));
+
+    // Rows shorter than the first are padded with zeroes, longer ones truncated
+    const Mdn2d ragged = loaded(header + "1 2 3\n4\n5 6 7 8\n");
+    MDN_CHECK(ragged.getValue(Coord(0, 1)) == 4);
+    MDN_CHECK(ragged.getValue(Coord(1, 1)) == 0);
+    MDN_CHECK(ragged.getValue(Coord(2, 1)) == 0);
+    MDN_CHECK(ragged.getValue(Coord(2, 0)) == 7);
+    MDN_CHECK(ragged.getValue(Coord(3, 0)) == 0);
+    MDN_CHECK(sameRect(ragged.bounds(), Rect(0, 0, 2, 2)));
+
+    // Unparseable cells read as zero, as std::stoi would have failed them
+    const Mdn2d junk = loaded(header + "1,?,3\n");
+    MDN_CHECK(junk.getValue(Coord(0, 0)) == 1);
+    MDN_CHECK(junk.getValue(Coord(1, 0)) == 0);
+    MDN_CHECK(junk.getValue(Coord(2, 0)) == 3);
+
+    // Digits outside the base are rejected
+    for (const std::string& bad : {"1,q,3\n", "1,12,3\n", "-10 0 0\n"}) {
+        bool thrown = false;
+        try {
+            loaded(header + bad);
+        } catch (const OutOfRange&) {
+            thrown = true;
+        }
+        MDN_CHECK(thrown);
+    }
+
+    // A missing header loads nothing
+    const Mdn2d headless = loaded("1 2 3\n4 5 6\n");
+    MDN_CHECK(!headless.hasBounds());
+}
+
+static void testMalformedBinary(std::mt19937& rng) {
+    Mdn2d a(Mdn2dConfig(10, -1, SignConvention::Positive), "a");
+    fill(a, rng, 30, 10);
+    std::ostringstream os;
+    Mdn2dIO::saveBinary(a, os);
+    const std::string bytes = os.str();
+
+    auto throwsReadError = [](const std::string& data) {
+        Mdn2d b(Mdn2dConfig(10), "b");
+        std::istringstream is(data);
+        try {
+            Mdn2dIO::loadBinary(is, b);
+        } catch (const ReadError&) {
+            return true;
+        }
+        return false;
+    };
+
+    std::string badMarker = bytes;
+    badMarker[0] = 'X';
+    MDN_CHECK(throwsReadError(badMarker));
+
+    std::string badVersion = bytes;
+    badVersion[6] = 9;
+    MDN_CHECK(throwsReadError(badVersion));
+
+    MDN_CHECK(throwsReadError(bytes.substr(0, bytes.size() - 1)));
+    MDN_CHECK(!throwsReadError(bytes));
+}
+
+int main() {
+    std::mt19937 rng(31);
+    testTextRoundTrip(rng);
+    testBinaryRoundTrip(rng);
+    testMalformedText();
+    testMalformedBinary(rng);
+    return mdn::test::result();
+}
@@ -0,0 +1,90 @@
+// ThreadPool behaviour: submit, parallelFor coverage, nesting and exceptions
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <mdn/ThreadPool.hpp>
+
+#include "TestCheck.hpp"
+
+using namespace mdn;
+
+// Every index is visited exactly once, whatever the chunking
+static void testCoverage(ThreadPool& pool) {
+    for (int n : {0, 1, 7, 100, 10007}) {
+        for (int minChunk : {1, 3, 64}) {
+            std::vector<std::atomic<int>> visits(n);
+            pool.parallelFor(
+                0,
+                n,
+                [&visits](int i0, int i1) {
+                    for (int i = i0; i < i1; ++i) {
+                        ++visits[i];
+                    }
+                },
+                minChunk
+            );
+            int wrong = 0;
+            for (const std::atomic<int>& v : visits) {
+                wrong += v != 1;
+            }
+            MDN_CHECK(wrong == 0);
+        }
+    }
+}
+
+// parallelFor from inside a task completes, as the caller works on chunks too
+static void testNested(ThreadPool& pool) {
+    std::atomic<long long> total{0};
+    pool.parallelFor(0, 16, [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            pool.parallelFor(0, 1000, [&](int j0, int j1) {
+                total += j1 - j0;
+            });
+        }
+    });
+    MDN_CHECK(total == 16000);
+}
+
+// The first exception thrown by a chunk reaches the caller, after every chunk has finished
+static void testException(ThreadPool& pool) {
+    std::atomic<int> finished{0};
+    bool caught = false;
+    try {
+        pool.parallelFor(0, 1000, [&finished](int i0, int i1) {
+            finished += i1 - i0;
+            if (i0 == 0) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    MDN_CHECK(caught);
+    MDN_CHECK(finished == 1000);
+}
+
+static void testSubmit(ThreadPool& pool) {
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 50; ++i) {
+        results.push_back(pool.submit([i]() { return i*i; }));
+    }
+    int sum = 0;
+    for (std::future<int>& f : results) {
+        sum += f.get();
+    }
+    MDN_CHECK(sum == 40425);
+}
+
+int main() {
+    ThreadPool single(1);
+    ThreadPool several(4);
+    for (ThreadPool* pool : {&single, &several, &ThreadPool::shared()}) {
+        testCoverage(*pool);
+        testNested(*pool);
+        testException(*pool);
+        testSubmit(*pool);
+    }
+    return mdn::test::result();
+}